@@ -0,0 +1,91 @@
+/*
+  This file is part of the KMCLib project distributed under the terms of the
+  GNU General Public License version 3, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/*! \file  analysisplugin.cpp
+ *  \brief File for the implementation code of the AnalysisPlugin class.
+ */
+
+#include <cmath>
+#include <stdexcept>
+
+#include "analysisplugin.h"
+
+
+// -----------------------------------------------------------------------------
+//
+AnalysisPlugin::AnalysisPlugin() :
+    step_interval_(1),
+    start_step_(0),
+    end_step_(-1),
+    time_interval_(0.0),
+    next_time_(0.0)
+{
+}
+
+
+// -----------------------------------------------------------------------------
+//
+AnalysisPlugin::~AnalysisPlugin()
+{
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void AnalysisPlugin::setStepInterval(const int interval,
+                                     const int start,
+                                     const int end)
+{
+    if (interval < 1)
+    {
+        throw std::invalid_argument("The analysis step interval must be positive.");
+    }
+
+    step_interval_ = interval;
+    start_step_    = start;
+    end_step_      = end;
+    time_interval_ = 0.0;
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void AnalysisPlugin::setTimeInterval(const double interval,
+                                     const double start_time)
+{
+    if (!(interval > 0.0))
+    {
+        throw std::invalid_argument("The analysis time interval must be positive.");
+    }
+
+    step_interval_ = 0;
+    time_interval_ = interval;
+    next_time_     = start_time + interval;
+}
+
+
+// -----------------------------------------------------------------------------
+//
+bool AnalysisPlugin::due(const int step, const double time)
+{
+    // Step scheduling.
+    if (step_interval_ > 0)
+    {
+        return (step >= start_step_ &&
+                (end_step_ < 0 || step <= end_step_) &&
+                step % step_interval_ == 0);
+    }
+
+    // Time scheduling, skipping the intervals passed in a single step.
+    if (time < next_time_)
+    {
+        return false;
+    }
+
+    next_time_ += time_interval_*(std::floor((time - next_time_)/time_interval_) + 1.0);
+    return true;
+}
+
@@ -0,0 +1,114 @@
+/*
+  This file is part of the KMCLib project distributed under the terms of the
+  GNU General Public License version 3, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/*! \file  analysisplugin.h
+ *  \brief File for the AnalysisPlugin class definition.
+ */
+
+#ifndef __ANALYSISPLUGIN__
+#define __ANALYSISPLUGIN__
+
+// Forward declarations.
+class Configuration;
+class Process;
+
+
+/*! \brief Class for defining the interface of native analysis plugins,
+ *         called by the lattice model directly after the steps they are
+ *         scheduled for, without going through Python.
+ */
+class AnalysisPlugin {
+
+public:
+
+    /*! \brief Constructor for the analysis plugin, called at each step
+     *         until an interval is set.
+     */
+    AnalysisPlugin();
+
+    /*! \brief Destructor for the analysis plugin.
+     */
+    virtual ~AnalysisPlugin();
+
+    /*! \brief Called before the KMC loop to allow for custom setup.
+     *  \param step          : The step number of the simulation.
+     *  \param time          : The time of the simulation.
+     *  \param configuration : The configuration of the simulation.
+     */
+    virtual void setup(const int step,
+                       const double time,
+                       const Configuration & configuration) {}
+
+    /*! \brief Called by the lattice model after each step the plugin is
+     *         scheduled for.
+     *  \param step          : The step number of the simulation.
+     *  \param time          : The time of the simulation after the step.
+     *  \param delta_time    : The time increment of the step.
+     *  \param process       : The process performed in the step, holding
+     *                         the affected indices.
+     *  \param site_index    : The index of the site the process was performed on.
+     *  \param configuration : The configuration after the step.
+     */
+    virtual void registerStep(const int step,
+                              const double time,
+                              const double delta_time,
+                              const Process & process,
+                              const int site_index,
+                              const Configuration & configuration) = 0;
+
+    /*! \brief Called after the KMC loop to allow for custom finalization.
+     */
+    virtual void finalize() {}
+
+    /*! \brief Schedule the plugin at every interval steps within a range.
+     *  \param interval : The step interval.
+     *  \param start    : The first step of the range.
+     *  \param end      : The last step of the range, negative for no end.
+     */
+    void setStepInterval(const int interval,
+                         const int start=0,
+                         const int end=-1);
+
+    /*! \brief Schedule the plugin at the first step reaching each multiple
+     *         of a time interval after the given start time.
+     *  \param interval   : The time interval.
+     *  \param start_time : The time to count the intervals from.
+     */
+    void setTimeInterval(const double interval,
+                         const double start_time=0.0);
+
+    /*! \brief Query for the plugin being scheduled at a step. A time
+     *         scheduled plugin moves on to its next time when it is due.
+     *  \param step : The step number of the simulation.
+     *  \param time : The time of the simulation after the step.
+     *  \return : True if the plugin should be called for the step.
+     */
+    bool due(const int step, const double time);
+
+protected:
+
+private:
+
+    /// The step interval, zero for time scheduling.
+    int step_interval_;
+
+    /// The first step of the step range.
+    int start_step_;
+
+    /// The last step of the step range, negative for no end.
+    int end_step_;
+
+    /// The time interval, zero for step scheduling.
+    double time_interval_;
+
+    /// The next time at which the plugin is due.
+    double next_time_;
+
+};
+
+
+#endif // __ANALYSISPLUGIN__
+
@@ -0,0 +1,163 @@
+/*
+  This file is part of the KMCLib project distributed under the terms of the
+  GNU General Public License version 3, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/*! \file  checkpoint.h
+ *  \brief File for the utility functions reading and writing the binary
+ *         checkpoint format of the lattice model.
+ */
+
+#ifndef __CHECKPOINT__
+#define __CHECKPOINT__
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+
+/// The first bytes of a checkpoint file.
+const char CHECKPOINT_MAGIC[8] = {'K', 'M', 'C', 'L', 'I', 'B', 'C', 'P'};
+
+/// The version of the checkpoint format, increased on every change of the format.
+const int32_t CHECKPOINT_VERSION = 3;
+
+
+/*! \brief Write a value of a plain type to a binary stream.
+ *  \param stream : The stream to write to.
+ *  \param value  : The value to write.
+ */
+template <class T>
+void writeBinary(std::ostream & stream, const T & value)
+{
+    stream.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+
+/*! \brief Read a value of a plain type from a binary stream.
+ *  \param stream : The stream to read from.
+ *  \param value  : (out) The value read.
+ */
+template <class T>
+void readBinary(std::istream & stream, T & value)
+{
+    stream.read(reinterpret_cast<char *>(&value), sizeof(T));
+    if (!stream)
+    {
+        throw std::runtime_error("Unexpected end of the checkpoint data.");
+    }
+}
+
+
+/*! \brief Write a vector of a plain type to a binary stream, preceded by
+ *         its size.
+ *  \param stream : The stream to write to.
+ *  \param values : The values to write.
+ */
+template <class T>
+void writeBinary(std::ostream & stream, const std::vector<T> & values)
+{
+    writeBinary(stream, static_cast<uint64_t>(values.size()));
+    if (!values.empty())
+    {
+        stream.write(reinterpret_cast<const char *>(&values[0]), sizeof(T)*values.size());
+    }
+}
+
+
+/*! \brief Read a vector of a plain type from a binary stream.
+ *  \param stream : The stream to read from.
+ *  \param values : (out) The values read.
+ */
+template <class T>
+void readBinary(std::istream & stream, std::vector<T> & values)
+{
+    uint64_t size;
+    readBinary(stream, size);
+    values.resize(size);
+    if (size > 0)
+    {
+        stream.read(reinterpret_cast<char *>(&values[0]), sizeof(T)*size);
+        if (!stream)
+        {
+            throw std::runtime_error("Unexpected end of the checkpoint data.");
+        }
+    }
+}
+
+
+/*! \brief Write a vector of flags to a binary stream, one byte per flag.
+ *  \param stream : The stream to write to.
+ *  \param values : The flags to write.
+ */
+inline
+void writeBinary(std::ostream & stream, const std::vector<bool> & values)
+{
+    writeBinary(stream, std::vector<char>(values.begin(), values.end()));
+}
+
+
+/*! \brief Read a vector of flags from a binary stream.
+ *  \param stream : The stream to read from.
+ *  \param values : (out) The flags read.
+ */
+inline
+void readBinary(std::istream & stream, std::vector<bool> & values)
+{
+    std::vector<char> bytes;
+    readBinary(stream, bytes);
+    values.assign(bytes.begin(), bytes.end());
+}
+
+
+/*! \brief Write a string to a binary stream, preceded by its size.
+ *  \param stream : The stream to write to.
+ *  \param value  : The string to write.
+ */
+inline
+void writeBinary(std::ostream & stream, const std::string & value)
+{
+    writeBinary(stream, std::vector<char>(value.begin(), value.end()));
+}
+
+
+/*! \brief Read a string from a binary stream.
+ *  \param stream : The stream to read from.
+ *  \param value  : (out) The string read.
+ */
+inline
+void readBinary(std::istream & stream, std::string & value)
+{
+    std::vector<char> bytes;
+    readBinary(stream, bytes);
+    value.assign(bytes.begin(), bytes.end());
+}
+
+
+/*! \brief Read a size from a binary stream and check it against the
+ *         size expected from the objects set up for the restart.
+ *  \param stream   : The stream to read from.
+ *  \param expected : The expected size.
+ *  \param what     : The name of the counted items, for the error message.
+ */
+inline
+void checkBinarySize(std::istream & stream,
+                     const size_t expected,
+                     const std::string & what)
+{
+    uint64_t size;
+    readBinary(stream, size);
+    if (size != expected)
+    {
+        throw std::runtime_error("The number of " + what + " in the checkpoint " +
+                                 "does not match the model to restart.");
+    }
+}
+
+
+#endif // __CHECKPOINT__
+
@@ -31,9 +31,7 @@
 #include "latticemap.h"
 #include "process.h"
 #include "coordinate.h"
-
-// Temporary data for the match list return.
-static ConfigMatchList tmp_config_match_list__(0);
+#include "checkpoint.h"
 
 // -----------------------------------------------------------------------------
 //
@@ -41,11 +39,8 @@ Configuration::Configuration(std::vector<std::vector<double> > const & coordinat
                              std::vector<std::string> const & elements,
                              const std::map<std::string, int> & possible_types) :
     n_moved_(0),
-    elements_(elements),
     possible_types_(possible_types),
-    atom_id_elements_(elements),
-    match_lists_(elements_.size()),
-    slow_flags_(elements_.size(), true)
+    slow_flags_(elements.size(), true)
 {
     // {{{
 
@@ -89,8 +84,11 @@ Configuration::Configuration(std::vector<std::vector<double> > const & coordinat
         types_.push_back(it->second);
     }
 
+    // The atom ids start out at the lattice sites with the same index.
+    atom_id_types_ = types_;
+
     // Setup indices.
-    for (size_t i = 0; i < elements_.size(); ++i)
+    for (size_t i = 0; i < types_.size(); ++i)
     {
         indices_.push_back(i);
     }
@@ -111,11 +109,9 @@ Configuration::Configuration(const std::vector<std::vector<double> > & coordinat
     //       construction, so we set the lengths of them to zero by default.
     n_moved_(0),
     atom_id_coordinates_(0),
-    elements_(elements),
     possible_types_(possible_types),
-    atom_id_elements_(0),
+    atom_id_types_(0),
     atom_id_(atom_id),
-    match_lists_(elements_.size()),
     slow_flags_(slow_flags)
 {
     // {{{
@@ -157,7 +153,7 @@ Configuration::Configuration(const std::vector<std::vector<double> > & coordinat
     }
 
     // Setup indices.
-    for (size_t i = 0; i < elements_.size(); ++i)
+    for (size_t i = 0; i < types_.size(); ++i)
     {
         indices_.push_back(i);
     }
@@ -171,65 +167,37 @@ Configuration::Configuration(const std::vector<std::vector<double> > & coordinat
 void Configuration::initMatchLists( const LatticeMap & lattice_map,
                                     const int range )
 {
-    // {{{
-
-    // Store the max size of minimal_match_list_
-    size_t max_size = 0;
-    size_t tmp_size;
-
-    // Loop over all lattice sites.
-    for (size_t i = 0; i < types_.size(); ++i)
-    {
-        // Calculate and store the match list.
-        const int origin_index = i;
-        const std::vector<int> neighbourhood = lattice_map.neighbourIndices(origin_index, range);
-        match_lists_[i] = matchList(origin_index, neighbourhood, lattice_map);
-
-        // Store the maximum size
-        tmp_size = match_lists_[i].size();
-        if ( tmp_size > max_size )
-        {
-            max_size = tmp_size;
-        }
-    }
+    // Calculate the neighbourhood templates.
+    neighbourhoods_.init(coordinates_, lattice_map, range);
 
     // Now that we know the size of the match lists we can allocate
     // memory for the moved_atom_ids_ vector.
+    const size_t max_size = neighbourhoods_.maxSize();
     moved_atom_ids_.resize(max_size, -1);
     recent_move_vectors_.resize(max_size, Coordinate(0.0, 0.0, 0.0));
-
-    // }}}
 }
 
 
 // -----------------------------------------------------------------------------
 //
-void Configuration::updateMatchList(const int index)
+ConfigMatchList Configuration::matchList(const int index) const
 {
-    // {{{
-
-    // Update the match list's types information.
-    ConfigMatchList::iterator it1   = match_lists_[index].begin();
-    const ConfigMatchList::const_iterator end = match_lists_[index].end();
-    for ( ; it1 != end; ++it1 )
-    {
-        (*it1).match_type = types_[(*it1).index];
-    }
-
-    // }}}
+    ConfigMatchList match_list;
+    neighbourhoods_.matchList(index, types_, match_list);
+    return match_list;
 }
 
 
 // -----------------------------------------------------------------------------
 //
-const ConfigMatchList & Configuration::matchList(const int origin_index,
-                                                 const std::vector<int> & indices,
-                                                 const LatticeMap & lattice_map) const
+ConfigMatchList Configuration::matchList(const int origin_index,
+                                         const std::vector<int> & indices,
+                                         const LatticeMap & lattice_map) const
 {
     // {{{
 
     // Setup the return data.
-    tmp_config_match_list__.resize(indices.size());
+    ConfigMatchList match_list(indices.size());
 
     // Extract the coordinate of the first index.
     const Coordinate center = coordinates_[origin_index];
@@ -237,7 +205,7 @@ const ConfigMatchList & Configuration::matchList(const int origin_index,
     // Setup the needed iterators.
     std::vector<int>::const_iterator it_index  = indices.begin();
     const std::vector<int>::const_iterator end = indices.end();
-    ConfigMatchList::iterator it_match_list = tmp_config_match_list__.begin();
+    ConfigMatchList::iterator it_match_list = match_list.begin();
 
     const bool periodic_a = lattice_map.periodicA();
     const bool periodic_b = lattice_map.periodicB();
@@ -330,9 +298,9 @@ const ConfigMatchList & Configuration::matchList(const int origin_index,
     }
 
     // Sort and return.
-    std::sort(tmp_config_match_list__.begin(), tmp_config_match_list__.end());
+    std::sort(match_list.begin(), match_list.end());
 
-    return tmp_config_match_list__;
+    return match_list;
 
     // }}}
 }
@@ -347,13 +315,15 @@ void Configuration::performProcess(Process & process, const int site_index)
     // PERFORMME
     // Need to time and optimize the new parts of the routine.
 
-    // Get the proper match lists.
+    // Get the process match list and the configuration match list indices,
+    // into a buffer kept between the steps.
     const ProcessMatchList & process_match_list = process.matchList();
-    const ConfigMatchList & config_match_list = matchList(site_index);
+    matchListIndices(site_index, process_indices_);
+    const std::vector<int> & config_indices = process_indices_;
 
     // Iterators to the match list entries.
     ProcessMatchList::const_iterator proc_it = process_match_list.begin();
-    ConfigMatchList::const_iterator conf_it = config_match_list.begin();
+    std::vector<int>::const_iterator conf_it = config_indices.begin();
 
     // Iterators to the info storages.
     std::vector<int>::iterator affected_it = process.affectedIndices().begin();
@@ -370,7 +340,7 @@ void Configuration::performProcess(Process & process, const int site_index)
         const int update_type = (*proc_it).update_type;
 
         // Get the index out of the configuration match list.
-        const int index = (*conf_it).index;
+        const int index = (*conf_it);
 
         // NOTE: The > 0 is needed for handling the wildcard match.
         if (types_[index] != update_type && update_type > 0)
@@ -382,13 +352,12 @@ void Configuration::performProcess(Process & process, const int site_index)
             atom_id_coordinates_[atom_id] += (*proc_it).move_coordinate;
 
             // Set the type at this index.
-            types_[index]    = update_type;
-            elements_[index] = type_names_[update_type];
+            types_[index] = update_type;
 
-            // Update the atom id element.
+            // Update the atom id type.
             if (!(*proc_it).has_move_coordinate)
             {
-                atom_id_elements_[atom_id] = elements_[index];
+                atom_id_types_[atom_id] = update_type;
             }
 
             // Mark this index as affected.
@@ -420,8 +389,8 @@ void Configuration::performProcess(Process & process, const int site_index)
         const int match_list_index_from = process_id_moves[i].first;
         const int match_list_index_to   = process_id_moves[i].second;
 
-        const int lattice_index_from = config_match_list[match_list_index_from].index;
-        const int lattice_index_to   = config_match_list[match_list_index_to].index;
+        const int lattice_index_from = config_indices[match_list_index_from];
+        const int lattice_index_to   = config_indices[match_list_index_to];
 
         id_updates[i].first  = atom_id_[lattice_index_from];
         id_updates[i].second = lattice_index_to;
@@ -435,7 +404,7 @@ void Configuration::performProcess(Process & process, const int site_index)
 
         // Set the atom id at this lattice site index.
         atom_id_[index] = id;
-        atom_id_elements_[id] = elements_[index];
+        atom_id_types_[id] = types_[index];
 
     }
 
@@ -460,20 +429,11 @@ void Configuration::resetSlowFlags(const std::vector<std::string> & fast_element
     }
     else
     {
+        const std::vector<bool> fast_types = typeFlags(fast_elements);
+
         for (size_t i = 0; i < slow_flags_.size(); ++i)
         {
-            const std::string element = elements_[i];
-            auto it = std::find(fast_elements.begin(),
-                                fast_elements.end(),
-                                element);
-            if ( it != fast_elements.end() )
-            {
-                slow_flags_[i] = false;
-            }
-            else
-            {
-                slow_flags_[i] = true;
-            }
+            slow_flags_[i] = !fast_types[types_[i]];
         }
     }
     // }}}
@@ -498,26 +458,19 @@ void Configuration::extractFastSpecies(const std::vector<std::string> & fast_ele
     else
     {
         const int replace_type = possible_types_[replace_species];
+        const std::vector<bool> fast_types = typeFlags(fast_elements);
 
         // Loop to extract all fast species from configuration.
         for (size_t i = 0; i < slow_flags_.size(); ++i)
         {
-            if (!slow_flags_[i])
+            if (!slow_flags_[i] && fast_types[types_[i]])
             {
-                const std::string & element = elements_[i];
-                auto it = std::find(fast_elements.begin(),
-                                    fast_elements.end(),
-                                    element);
-                if ( it != fast_elements.end() )
-                {
-                    // Collect fast species and indices.
-                    fast_species.push_back(element);
-                    fast_indices.push_back(i);
-
-                    // Change types and elements of configuration.
-                    types_[i] = replace_type;
-                    elements_[i] = replace_species;
-                }
+                // Collect fast species and indices.
+                fast_species.push_back(type_names_[types_[i]]);
+                fast_indices.push_back(i);
+
+                // Change the type of configuration.
+                types_[i] = replace_type;
             }
         }
     }
@@ -557,8 +510,7 @@ SubConfiguration Configuration::subConfiguration(const LatticeMap & lattice_map,
         global_indices.push_back(global_index);
 
         // Collect elements.
-        const std::string & element = elements_[global_index];
-        elements.push_back(element);
+        elements.push_back(type_names_[types_[global_index]]);
 
         // Collect coordinates.
         const Coordinate & coord = coordinates_[global_index];
@@ -642,6 +594,40 @@ std::vector<int> Configuration::slowIndices() const
 }
 
 
+// ----------------------------------------------------------------------------
+//
+std::vector<std::string> Configuration::typeNames(const std::vector<int> & types) const
+{
+    std::vector<std::string> names(types.size());
+
+    for (size_t i = 0; i < types.size(); ++i)
+    {
+        names[i] = type_names_[types[i]];
+    }
+
+    return names;
+}
+
+
+// ----------------------------------------------------------------------------
+//
+std::vector<bool> Configuration::typeFlags(const std::vector<std::string> & names) const
+{
+    std::vector<bool> flags(type_names_.size(), false);
+
+    for (const std::string & name : names)
+    {
+        std::map<std::string, int>::const_iterator it = possible_types_.find(name);
+        if (it != possible_types_.end())
+        {
+            flags[it->second] = true;
+        }
+    }
+
+    return flags;
+}
+
+
 // ----------------------------------------------------------------------------
 // Functions definitions for SubConfiguration class.
 // ----------------------------------------------------------------------------
@@ -661,3 +647,62 @@ SubConfiguration(const std::vector<std::vector<double> > & coordinates,
     // NOTHING HERE.
 }
 
+
+// -----------------------------------------------------------------------------
+//
+void Configuration::writeCheckpoint(std::ostream & stream) const
+{
+    // {{{
+    writeBinary(stream, static_cast<uint64_t>(types_.size()));
+    writeBinary(stream, types_);
+    writeBinary(stream, atom_id_);
+    writeBinary(stream, atom_id_types_);
+
+    // The atom id coordinates as x, y, z after each other.
+    std::vector<double> xyz(3*atom_id_coordinates_.size());
+    for (size_t i = 0; i < atom_id_coordinates_.size(); ++i)
+    {
+        xyz[3*i]   = atom_id_coordinates_[i].x();
+        xyz[3*i+1] = atom_id_coordinates_[i].y();
+        xyz[3*i+2] = atom_id_coordinates_[i].z();
+    }
+    writeBinary(stream, xyz);
+
+    writeBinary(stream, slow_flags_);
+    // }}}
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void Configuration::readCheckpoint(std::istream & stream)
+{
+    // {{{
+    checkBinarySize(stream, types_.size(), "lattice sites");
+    readBinary(stream, types_);
+    readBinary(stream, atom_id_);
+    readBinary(stream, atom_id_types_);
+
+    std::vector<double> xyz;
+    readBinary(stream, xyz);
+
+    if (types_.size() != coordinates_.size() ||
+        atom_id_.size() != coordinates_.size() ||
+        atom_id_types_.size() != coordinates_.size() ||
+        xyz.size() != 3*coordinates_.size())
+    {
+        throw std::runtime_error("Inconsistent configuration in the checkpoint.");
+    }
+
+    for (size_t i = 0; i < atom_id_coordinates_.size(); ++i)
+    {
+        atom_id_coordinates_[i] = Coordinate(xyz[3*i], xyz[3*i+1], xyz[3*i+2]);
+    }
+
+    readBinary(stream, slow_flags_);
+
+    // No moves since the last step are known after a restart.
+    n_moved_ = 0;
+    // }}}
+}
+
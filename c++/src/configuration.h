@@ -29,9 +29,11 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <iosfwd>
 
 #include "matchlist.h"
 #include "distributor.h"
+#include "neighbourhoodtemplates.h"
 
 
 // Forward declarations.
@@ -102,16 +104,24 @@ public:
     { return atom_id_coordinates_; }
 
     /*! \brief Const query for the elements.
-     *  \return : The elements of the configuration.
+     *  \return : A copy of the elements of the configuration, constructed
+     *            from the types.
      */
-    const std::vector<std::string> & elements() const
-    { return elements_; }
+    std::vector<std::string> elements() const
+    { return typeNames(types_); }
 
     /*! \brief Const query for the atom id types.
+     *  \return : A copy of the atom id elements of the configuration,
+     *            constructed from the atom id types.
+     */
+    std::vector<std::string> atomIDElements() const
+    { return typeNames(atom_id_types_); }
+
+    /*! \brief Const query for the atom id types in integer representation.
      *  \return : The atom id types of the configuration.
      */
-    const std::vector<std::string> & atomIDElements() const
-    { return atom_id_elements_; }
+    const std::vector<int> & atomIDTypes() const
+    { return atom_id_types_; }
 
     /*! \brief Const query for the types.
      *  \return : The types of the configuration.
@@ -143,23 +153,43 @@ public:
      *  \param indices      : The indices to get the match list for.
      *  \param lattice_map  : The lattice map needed for calculating distances
      *                        using correct boundaries.
-     *  \return : The match list.
+     *  \return : The match list, constructed for each call so that the
+     *            threads can construct match lists at the same time.
      */
-    const ConfigMatchList & matchList(const int origin_index,
-                                      const std::vector<int> & indices,
-                                      const LatticeMap & lattice_map) const;
+    ConfigMatchList matchList(const int origin_index,
+                              const std::vector<int> & indices,
+                              const LatticeMap & lattice_map) const;
 
-    /*! \brief Update the cached match list for the given index.
-     *  \param index : The index to update the match list for.
+    /*! \brief Construct the match list for the given index from the
+     *         neighbourhood template and the current types.
+     *  \param index : The index to get the match list for.
+     *  \return : The match list, empty if initMatchLists() was not called.
      */
-    void updateMatchList(const int index);
+    ConfigMatchList matchList(const int index) const;
 
-    /*! \brief Return the cached match list without update.
-     *  \param index : The index to get the match list for.
-     *  \return : The match list.
+    /*! \brief Get the indices of the match list for the given index, without
+     *         constructing the match list.
+     *  \param index   : The index to get the match list indices for.
+     *  \param indices : (out) The lattice indices in match list order.
      */
-    const ConfigMatchList & matchList(const int index) const
-    { return match_lists_[index]; }
+    void matchListIndices(const int index, std::vector<int> & indices) const
+    { neighbourhoods_.neighbourIndices(index, indices); }
+
+    /*! \brief Query for the geometry of the match list of an index.
+     *  \param index : The index to get the match list geometry for.
+     *  \return : The neighbourhood template of the index, one for each
+     *            basis site and boundary class, see
+     *            NeighbourhoodTemplates::geometry(), or -1 if the
+     *            neighbourhood is not given by a template.
+     */
+    int matchListGeometry(const int index) const
+    { return neighbourhoods_.geometry(index); }
+
+    /*! \brief Query for the match list neighbourhoods.
+     *  \return : The neighbourhood templates set up by initMatchLists().
+     */
+    const NeighbourhoodTemplates & neighbourhoods() const
+    { return neighbourhoods_; }
 
     /*! \brief Perform the given process.
      *  \param process : The process to perform, which will be updated with
@@ -171,6 +201,18 @@ public:
      */
     void performProcess(Process & process, const int site_index);
 
+    /*! \brief Write the types, atom ids and slow flags to a binary
+     *         checkpoint stream.
+     *  \param stream : The stream to write to.
+     */
+    void writeCheckpoint(std::ostream & stream) const;
+
+    /*! \brief Restore the types, atom ids and slow flags from a binary
+     *         checkpoint stream written for a configuration of the same size.
+     *  \param stream : The stream to read from.
+     */
+    void readCheckpoint(std::istream & stream);
+
     /*! \brief Extract a sub-configuration from a global configuration.
      *  \param lattice_map : The global lattie map.
      *  \param sub_lattice_map : The corresponding sub-lattice map of the
@@ -231,6 +273,19 @@ public:
     const std::string & typeName(const int type) const
     { return type_names_[type]; }
 
+    /*! \brief Query for the type names of a list of types.
+     *  \param types : The type integers to get the names for.
+     *  \return : The string representations of the type integers.
+     */
+    std::vector<std::string> typeNames(const std::vector<int> & types) const;
+
+    /*! \brief Flag the types of the given type names.
+     *  \param names : The type names to flag, names that are not possible
+     *                 types are ignored.
+     *  \return : A flag for each type integer, true for the given names.
+     */
+    std::vector<bool> typeFlags(const std::vector<std::string> & names) const;
+
     /*! \brief Get the atom id coordinates.
      *  \return : The list of atom id coordinates.
      */
@@ -277,14 +332,11 @@ protected:
     /// The coordinates for each atom id.
     std::vector<Coordinate> atom_id_coordinates_;
 
-    /// The lattice elements.
-    std::vector<std::string> elements_;
-
     /// The possible types.
     std::map<std::string, int> possible_types_;
 
-    /// The elements per atom id.
-    std::vector<std::string> atom_id_elements_;
+    /// The types per atom id, in integer representation.
+    std::vector<int> atom_id_types_;
 
     /// The the lattice elements in integer representation.
     std::vector<int> types_;
@@ -298,11 +350,14 @@ protected:
     /// The first n_moved_ elements hold the moved atoms move vectors (listed on id).
     std::vector<Coordinate> recent_move_vectors_;
 
+    /// The match list indices of the site the last process was performed at.
+    std::vector<int> process_indices_;
+
     /// The mapping from type integers to names.
     std::vector<std::string> type_names_;
 
-    /// The match lists for all indices.
-    std::vector<ConfigMatchList> match_lists_;
+    /// The neighbourhoods of all indices, to construct match lists from.
+    NeighbourhoodTemplates neighbourhoods_;
 
     /// The species fast/slow flags, true if slow.
     std::vector<bool> slow_flags_;
@@ -10,12 +10,9 @@
  *  \brief File for the implementation code of the CustomRateProcess class.
  */
 
-#include <algorithm>
-#include <cstdio>
-#include <numeric>
-
 #include "customrateprocess.h"
 #include "random.h"
+#include "checkpoint.h"
 
 
 // -----------------------------------------------------------------------------
@@ -51,78 +48,78 @@ CustomRateProcess::CustomRateProcess(const Configuration & first,
 //
 double CustomRateProcess::totalRate() const
 {
-    // Sum all individual rates.
-    return std::accumulate(site_rates_.begin(),site_rates_.end(), 0.0);
+    // The total is kept at the root of the rate tree.
+    return site_rates_.total();
 }
 
 // -----------------------------------------------------------------------------
 //
 void CustomRateProcess::addSite(const int index, const double rate)
 {
-    sites_.push_back(index);
-    site_rates_.push_back(rate);
+    Process::addSite(index);
+    site_rates_.pushBack(rate);
 }
 
 // -----------------------------------------------------------------------------
 //
 void CustomRateProcess::removeSite(const int index)
 {
-    // Find the index to remove.
-    std::vector<int>::iterator it1 = std::find(sites_.begin(),
-                                               sites_.end(),
-                                               index);
-
-    // Swap the index to remove with the last index.
-    std::vector<int>::iterator last = sites_.end()-1;
-    std::swap((*it1), (*last));
+    // Move the last rate into the place of the removed one, the same
+    // way as the sites are moved.
+    const size_t position = site_positions_.find(index)->second;
+    const size_t last = sites_.size() - 1;
 
-    // Remove the last index from the list.
-    sites_.pop_back();
+    site_rates_.update(position, site_rates_.value(last));
+    site_rates_.popBack();
 
-    // Calculate the positions in the site_rates_ vector.
-    std::vector<double>::iterator it2 = site_rates_.begin() + (it1-sites_.begin());
-    std::vector<double>::iterator last_rate = site_rates_.end()-1;
-
-    // Swap and remove.
-    std::swap((*it2), (*last_rate));
-    site_rates_.pop_back();
+    Process::removeSite(index);
 }
 
 // -----------------------------------------------------------------------------
 //
-int CustomRateProcess::pickSite() const
+void CustomRateProcess::updateSite(const int index, const double rate)
 {
-    // Get the total rate.
-    const double total_rate = incremental_rate_table_.back();
-
-    // Get a random number between 0.0 and the total rate.
-    const double rnd = randomDouble01() * total_rate;
+    // Set the rate at the position of the index.
+    site_rates_.update(site_positions_.find(index)->second, rate);
+}
 
-    // Pick the site.
-    const std::vector<double>::const_iterator begin = incremental_rate_table_.begin();
-    const std::vector<double>::const_iterator end   = incremental_rate_table_.end();
-    const std::vector<double>::const_iterator it1   = std::lower_bound( begin, end, rnd);
+// -----------------------------------------------------------------------------
+//
+int CustomRateProcess::selectSite(const double rnd) const
+{
+    // Pick the site at the random fraction of the total rate.
+    return sites_[site_rates_.pick(rnd * site_rates_.total())];
+}
 
-    // Get the site index.
-    const int site_index = it1-begin;
+// -----------------------------------------------------------------------------
+//
+void CustomRateProcess::writeCheckpoint(std::ostream & stream) const
+{
+    Process::writeCheckpoint(stream);
 
-    // Return the site.
-    return sites_[site_index];
+    std::vector<double> rates(sites_.size());
+    for (size_t i = 0; i < rates.size(); ++i)
+    {
+        rates[i] = site_rates_.value(i);
+    }
+    writeBinary(stream, rates);
 }
 
 // -----------------------------------------------------------------------------
 //
-void CustomRateProcess::updateRateTable()
+void CustomRateProcess::readCheckpoint(std::istream & stream)
 {
-    // Resize and update the incremental rate table.
-    incremental_rate_table_.resize(site_rates_.size());
-    double previous = 0.0;
-    for (size_t i = 0; i < site_rates_.size(); ++i)
+    Process::readCheckpoint(stream);
+
+    std::vector<double> rates;
+    readBinary(stream, rates);
+    if (rates.size() != sites_.size())
     {
-        incremental_rate_table_[i] = previous + site_rates_[i];
-        previous = incremental_rate_table_[i];
+        throw std::runtime_error("Inconsistent site rates in the checkpoint.");
     }
 
-    // DONE
+    // The sums of the tree only depend on the rates, so the rebuilt tree
+    // gives the same picks as the one written.
+    site_rates_.build(rates);
 }
 
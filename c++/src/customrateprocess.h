@@ -15,6 +15,7 @@
 #define __CUSTOMRATEPROCESS__
 
 #include "process.h"
+#include "sumtree.h"
 
 /*! \brief Class for defining a possible process int the system.
  */
@@ -78,25 +79,47 @@ public:
      */
     virtual void removeSite(const int index);
 
-    /*! \brief Pick an available process with probability determined by
-     *         its individual rate.
-     *  \return : A correctly drawn available process.
+    /*! \brief Update the rate of an index in the list of available sites
+     *         in place, without changing the order of the listed sites.
+     *  \param index : The index to update, which must be listed.
+     *  \param rate  : The new rate of the site.
      */
-    virtual int pickSite() const;
+    virtual void updateSite(const int index, const double rate);
 
-    /*! \brief Update the rate table prior to drawing a rate.
+    /*! \brief Select the available site corresponding to a random number,
+     *         with probability determined by its individual rate.
+     *  \param rnd : A random number on the interval (0.0,1.0).
+     *  \return : The selected site.
      */
-    virtual void updateRateTable();
+    virtual int selectSite(const double rnd) const;
+
+    /*! \brief Query for the rate of a listed site.
+     *  \param i : The position of the site in sites().
+     *  \return : The rate of the site.
+     */
+    double siteRate(const int i) const { return site_rates_.value(i); }
+
+    /*! \brief Write the listed sites and their rates to a binary
+     *         checkpoint stream.
+     *  \param stream : The stream to write to.
+     */
+    virtual void writeCheckpoint(std::ostream & stream) const;
+
+    /*! \brief Replace the listed sites and their rates with the ones of
+     *         a binary checkpoint stream, in the same order.
+     *  \param stream : The stream to read from.
+     */
+    virtual void readCheckpoint(std::istream & stream);
 
 protected:
 
 private:
 
-    /// The list of individual site rates.
-    std::vector<double> site_rates_;
-
-    /// The incremental rates.
-    std::vector<double> incremental_rate_table_;
+    /*! \brief The individual site rates, in the same order as the sites.
+     *         The tree keeps the running total up to date on every
+     *         change so no separate rate table needs to be updated.
+     */
+    SumTree site_rates_;
 
 };
 
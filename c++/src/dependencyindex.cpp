@@ -0,0 +1,309 @@
+/*
+  This file is part of the KMCLib project distributed under the terms of the
+  GNU General Public License version 3, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/*! \file  dependencyindex.cpp
+ *  \brief File for the implementation code of the DependencyIndex class.
+ */
+
+#include <algorithm>
+
+#include "dependencyindex.h"
+#include "interactions.h"
+#include "configuration.h"
+#include "sitesmap.h"
+#include "latticemap.h"
+#include "process.h"
+
+
+// -----------------------------------------------------------------------------
+//
+DependencyIndex::DependencyIndex() :
+    n_basis_(1),
+    repetitions_(3, 1),
+    periodic_(3, false)
+{
+    // NOTHING HERE.
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void DependencyIndex::init(const Interactions & interactions,
+                           const Configuration & configuration,
+                           const LatticeMap & lattice_map)
+{
+    // {{{
+
+    n_basis_     = lattice_map.nBasis();
+    repetitions_ = lattice_map.repetitions();
+    periodic_[0] = lattice_map.periodicA();
+    periodic_[1] = lattice_map.periodicB();
+    periodic_[2] = lattice_map.periodicC();
+    cell_order_  = lattice_map.cellOrder();
+
+    dependencies_.assign(n_basis_, std::vector<Dependency>());
+    site_dependents_.clear();
+
+    const NeighbourhoodTemplates & neighbourhoods = configuration.neighbourhoods();
+    const std::vector<Process *> & process_ptrs = interactions.processes();
+    const std::vector< std::vector<int> > & basis_site_processes = \
+        interactions.basisSiteProcesses();
+
+    for (int geometry = 0; geometry < neighbourhoods.nTemplates(); ++geometry)
+    {
+        const NeighbourhoodTemplates::GeometryArrays & template_arrays = \
+            neighbourhoods.templateArrays(geometry);
+        const size_t b = neighbourhoods.templateBasisSite(geometry);
+
+        if (template_arrays.empty() || b >= basis_site_processes.size())
+        {
+            continue;
+        }
+
+        // The processes reading each template position.
+        std::vector< std::vector<int> > slot_processes(template_arrays.size());
+        const std::vector<int> & process_indices = basis_site_processes[b];
+
+        for (size_t i = 0; i < process_indices.size(); ++i)
+        {
+            const int p_idx = process_indices[i];
+            const Process & process = *process_ptrs[p_idx];
+
+            // The process never matches at a site with this template.
+            if (process.hasCompiledMatchList() && !process.geometryMatches(geometry))
+            {
+                continue;
+            }
+
+            std::vector<bool> reads(template_arrays.size(), false);
+
+            if (process.hasCompiledMatchList())
+            {
+                const CompiledMatchList & compiled_list = process.compiledMatchList();
+                for (size_t j = 0; j < compiled_list.size(); ++j)
+                {
+                    reads[compiled_list[j].slot] = true;
+                }
+            }
+            else
+            {
+                const size_t size = std::min(process.matchList().size(), template_arrays.size());
+                std::fill(reads.begin(), reads.begin() + size, true);
+            }
+
+            // The custom rate depends on all types within the cutoff.
+            if (interactions.useCustomRates())
+            {
+                for (size_t j = 0; j < template_arrays.size(); ++j)
+                {
+                    if (template_arrays.distances[j] <= process.cutoff())
+                    {
+                        reads[j] = true;
+                    }
+                }
+            }
+
+            for (size_t j = 0; j < reads.size(); ++j)
+            {
+                if (reads[j])
+                {
+                    slot_processes[j].push_back(p_idx);
+                }
+            }
+        }
+
+        // Store the dependencies reversed, from the changed site back to
+        // the reading site.
+        const std::vector<NeighbourhoodTemplates::CellOffset> & offsets = \
+            neighbourhoods.cellOffsets(geometry);
+
+        for (size_t j = 0; j < offsets.size(); ++j)
+        {
+            if (slot_processes[j].empty())
+            {
+                continue;
+            }
+
+            Dependency dependency;
+            dependency.i         = -offsets[j].i;
+            dependency.j         = -offsets[j].j;
+            dependency.k         = -offsets[j].k;
+            dependency.basis     = b;
+            dependency.geometry  = geometry;
+            dependency.processes = slot_processes[j];
+
+            dependencies_[offsets[j].basis].push_back(dependency);
+        }
+    }
+
+    // List the sites without template for each site in their neighbourhood.
+    std::vector<int> neighbours;
+    const int n_sites = configuration.types().size();
+
+    for (int index = 0; index < n_sites; ++index)
+    {
+        if (configuration.matchListGeometry(index) >= 0)
+        {
+            continue;
+        }
+
+        configuration.matchListIndices(index, neighbours);
+        for (size_t j = 0; j < neighbours.size(); ++j)
+        {
+            site_dependents_[neighbours[j]].push_back(index);
+        }
+    }
+
+    // }}}
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void DependencyIndex::indexProcessToMatch(const std::vector<int> & indices,
+                                          const Interactions & interactions,
+                                          const Configuration & configuration,
+                                          const SitesMap & sitesmap,
+                                          std::vector<std::pair<int, int> > & index_process_to_match) const
+{
+    // {{{
+
+    index_process_to_match.clear();
+
+    const std::vector< std::vector<int> > & basis_site_processes = \
+        interactions.basisSiteProcesses();
+
+    for (size_t i = 0; i < indices.size(); ++i)
+    {
+        const int index = indices[i];
+        const int basis_site = index % n_basis_;
+
+        // The cell of the changed site.
+        int cell_i, cell_j, cell_k;
+        cell_order_.cell(index / n_basis_, cell_i, cell_j, cell_k);
+
+        // The template sites reading the changed site.
+        const std::vector<Dependency> & dependencies = dependencies_[basis_site];
+
+        for (size_t j = 0; j < dependencies.size(); ++j)
+        {
+            const Dependency & dependency = dependencies[j];
+            int ii = cell_i + dependency.i;
+            int jj = cell_j + dependency.j;
+            int kk = cell_k + dependency.k;
+
+            // Wrap in the periodic directions and skip cells outside the
+            // lattice in the others.
+            if (periodic_[0]) { ii = ((ii % repetitions_[0]) + repetitions_[0]) % repetitions_[0]; }
+            if (periodic_[1]) { jj = ((jj % repetitions_[1]) + repetitions_[1]) % repetitions_[1]; }
+            if (periodic_[2]) { kk = ((kk % repetitions_[2]) + repetitions_[2]) % repetitions_[2]; }
+
+            if (ii < 0 || ii >= repetitions_[0] ||
+                jj < 0 || jj >= repetitions_[1] ||
+                kk < 0 || kk >= repetitions_[2])
+            {
+                continue;
+            }
+
+            const int reading_index = \
+                cell_order_.number(ii, jj, kk) * n_basis_ + dependency.basis;
+
+            // Sites with another template have their own dependencies, and
+            // sites without template are listed below.
+            if (configuration.matchListGeometry(reading_index) != dependency.geometry)
+            {
+                continue;
+            }
+
+            for (size_t p = 0; p < dependency.processes.size(); ++p)
+            {
+                index_process_to_match.push_back(std::pair<int, int>(reading_index,
+                                                                     dependency.processes[p]));
+            }
+        }
+
+        // The sites without template reading the changed site, with all
+        // their processes.
+        const std::map<int, std::vector<int> >::const_iterator it = \
+            site_dependents_.find(index);
+
+        if (it != site_dependents_.end())
+        {
+            const std::vector<int> & dependents = it->second;
+            for (size_t j = 0; j < dependents.size(); ++j)
+            {
+                const int reading_index = dependents[j];
+                const size_t reading_basis = reading_index % n_basis_;
+
+                if (reading_basis >= basis_site_processes.size())
+                {
+                    continue;
+                }
+
+                const std::vector<int> & processes = basis_site_processes[reading_basis];
+                for (size_t p = 0; p < processes.size(); ++p)
+                {
+                    index_process_to_match.push_back(std::pair<int, int>(reading_index,
+                                                                         processes[p]));
+                }
+            }
+        }
+    }
+
+    // Sort and remove duplicates, which gives the pairs in the same order
+    // as when matching all processes for all indices within range.
+    std::sort(index_process_to_match.begin(), index_process_to_match.end());
+    index_process_to_match.erase(std::unique(index_process_to_match.begin(),
+                                             index_process_to_match.end()),
+                                 index_process_to_match.end());
+
+    // Remove the processes not matching the site types.
+    const std::vector<Process *> & process_ptrs = interactions.processes();
+    SiteMatchList site_matchlist;
+    int site_matchlist_index = -1;
+    size_t n_kept = 0;
+
+    for (size_t i = 0; i < index_process_to_match.size(); ++i)
+    {
+        const int index = index_process_to_match[i].first;
+        const Process & process = *process_ptrs[index_process_to_match[i].second];
+
+        if (process.hasSiteTypes())
+        {
+            if (index != site_matchlist_index)
+            {
+                site_matchlist = sitesmap.matchList(index);
+                site_matchlist_index = index;
+            }
+
+            if (!whateverMatch(process.matchList(), site_matchlist))
+            {
+                continue;
+            }
+        }
+
+        index_process_to_match[n_kept] = index_process_to_match[i];
+        ++n_kept;
+    }
+
+    index_process_to_match.resize(n_kept);
+
+    // }}}
+}
+
+
+// -----------------------------------------------------------------------------
+//
+size_t DependencyIndex::nDependencies() const
+{
+    size_t n_dependencies = 0;
+    for (size_t i = 0; i < dependencies_.size(); ++i)
+    {
+        n_dependencies += dependencies_[i].size();
+    }
+    return n_dependencies;
+}
+
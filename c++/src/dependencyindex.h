@@ -0,0 +1,126 @@
+/*
+  This file is part of the KMCLib project distributed under the terms of the
+  GNU General Public License version 3, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/*! \file  dependencyindex.h
+ *  \brief File for the DependencyIndex class definition.
+ */
+
+#ifndef __DEPENDENCYINDEX__
+#define __DEPENDENCYINDEX__
+
+#include <vector>
+#include <map>
+#include <utility>
+
+#include "latticemap.h"
+
+
+// Forward declarations.
+class Interactions;
+class Configuration;
+class SitesMap;
+
+
+/*! \brief Class for finding the (index, process) pairs that need to be
+ *         re-matched when the types at some lattice sites change.
+ *
+ *  The stencil of a process at a neighbourhood template is the set of match
+ *  list positions it reads, i.e. the non-wildcard positions and, with custom
+ *  rates, all positions within the rate cutoff. The stencils are stored
+ *  in reverse, as cell offsets from a changed site back to the sites whose
+ *  processes read it. Sites without a neighbourhood template are listed
+ *  with all their processes for each site in their neighbourhood.
+ */
+class DependencyIndex {
+
+public:
+
+    /*! \brief Default constructor, nothing is re-matched until init() is
+     *         called.
+     */
+    DependencyIndex();
+
+    /*! \brief Setup the process stencils and the reverse dependencies.
+     *  \param interactions  : The interactions with compiled process match lists.
+     *  \param configuration : The configuration with initialized match lists.
+     *  \param lattice_map   : The lattice map of the configuration.
+     */
+    void init(const Interactions & interactions,
+              const Configuration & configuration,
+              const LatticeMap & lattice_map);
+
+    /*! \brief Build the list of indices and processes to re-match after the
+     *         types at the given indices changed.
+     *  \param indices       : The indices with changed types.
+     *  \param interactions  : The interactions the index was set up with.
+     *  \param configuration : The configuration the index was set up with.
+     *  \param sitesmap      : The sites map to check process site types against.
+     *  \param index_process_to_match : (out) The sorted pairs of index and
+     *                                  process to match.
+     */
+    void indexProcessToMatch(const std::vector<int> & indices,
+                             const Interactions & interactions,
+                             const Configuration & configuration,
+                             const SitesMap & sitesmap,
+                             std::vector<std::pair<int, int> > & index_process_to_match) const;
+
+    /*! \brief Query for the number of reverse dependencies.
+     *  \return : The number of (cell offset, template) entries, summed over
+     *            the changed basis sites.
+     */
+    size_t nDependencies() const;
+
+    /*! \brief Query for the number of sites read by sites without template.
+     *  \return : The number of changed sites with listed reading sites.
+     */
+    size_t nSiteDependents() const { return site_dependents_.size(); }
+
+protected:
+
+private:
+
+    /// The sites reading a changed site through a neighbourhood template.
+    struct Dependency {
+
+        /// The cell offset from the changed site to the reading site.
+        int i;
+        int j;
+        int k;
+
+        /// The basis site of the reading site.
+        int basis;
+
+        /// The template of the reading site.
+        int geometry;
+
+        /// The processes reading the changed site from the reading site.
+        std::vector<int> processes;
+
+    };
+
+    /// The number of basis sites.
+    int n_basis_;
+
+    /// The lattice repetitions.
+    std::vector<int> repetitions_;
+
+    /// The lattice periodicity.
+    std::vector<bool> periodic_;
+
+    /// The numbering of the lattice cells.
+    CellOrder cell_order_;
+
+    /// The dependencies for each basis site of the changed site.
+    std::vector< std::vector<Dependency> > dependencies_;
+
+    /// The sites without template reading each changed site.
+    std::map<int, std::vector<int> > site_dependents_;
+
+};
+
+
+#endif // __DEPENDENCYINDEX__
+
@@ -38,6 +38,41 @@
 #endif  // DEBUG
 
 
+// ----------------------------------------------------------------------------
+//
+double BaseDistributor::drawDouble01() const
+{
+    return (rng_ == NULL) ? randomDouble01() : rng_->randomDouble01();
+}
+
+// ----------------------------------------------------------------------------
+//
+void BaseDistributor::shuffleIndices(std::vector<int> & v) const
+{
+    if (rng_ == NULL)
+    {
+        shuffleIntVector(v);
+    }
+    else
+    {
+        std::shuffle(v.begin(), v.end(), *rng_);
+    }
+}
+
+// ----------------------------------------------------------------------------
+//
+void BaseDistributor::shuffleProcesses(std::vector<Process *> & v) const
+{
+    if (rng_ == NULL)
+    {
+        shuffleProcessPtrVector(v);
+    }
+    else
+    {
+        std::shuffle(v.begin(), v.end(), *rng_);
+    }
+}
+
 // ----------------------------------------------------------------------------
 // TODO: OpenMp
 //
@@ -48,7 +83,6 @@ std::vector<int> RandomDistributor::redistribute(Configuration & configuration)
     // Get the PRIVATE member variables of Configuration.
     std::vector<int> & types = configuration.types_;
     std::vector<int> & atom_id = configuration.atom_id_;
-    std::vector<std::string> & elements = configuration.elements_;
 
     const std::vector<bool> & slow_flags = configuration.slowFlags();
     const std::vector<int> & global_indices = configuration.globalIndices();
@@ -56,7 +90,6 @@ std::vector<int> RandomDistributor::redistribute(Configuration & configuration)
     // Extract all fast species to a list.
     std::vector<int> fast_types;
     std::vector<int> fast_atom_id;
-    std::vector<std::string> fast_elements;
     std::vector<int> fast_global_indices;
     std::vector<int> fast_local_indices;
 
@@ -68,7 +101,6 @@ std::vector<int> RandomDistributor::redistribute(Configuration & configuration)
             fast_global_indices.push_back(global_indices[i]);
             fast_atom_id.push_back(atom_id[i]);
             fast_types.push_back(types[i]);
-            fast_elements.push_back(elements[i]);
         }
     }
 
@@ -83,7 +115,7 @@ std::vector<int> RandomDistributor::redistribute(Configuration & configuration)
     }
 
     // Shuffle the indices vector.
-    shuffleIntVector(shuffle_indices);
+    shuffleIndices(shuffle_indices);
 
     for (int i = 0; i < n_fast; ++i)
     {
@@ -96,7 +128,6 @@ std::vector<int> RandomDistributor::redistribute(Configuration & configuration)
         // Put the shuffled entries into configuration.
         types[config_index] = fast_types[index];
         atom_id[config_index] = fast_atom_id[index];
-        elements[config_index] = fast_elements[index];
     }
 
     return fast_global_indices;
@@ -109,8 +140,9 @@ bool RandomDistributor::metropolisAccept(int site_index,
                                          const Configuration & configuration,
                                          const LatticeMap & latticemap) const
 {
-    const std::vector<std::string> & elements = configuration.elements_;
-    const std::vector<int> neighbour_indices = latticemap.neighbourIndices(site_index);
+    const std::vector<int> & types = configuration.types();
+    std::vector<int> buffer;
+    const IndexSpan neighbour_indices = latticemap.neighbourSpan(site_index, 1, buffer);
     std::vector<int> env_global_indices {};
 
     double delta_E = 0.0;
@@ -123,7 +155,7 @@ bool RandomDistributor::metropolisAccept(int site_index,
     // Calculate new adsorption energy
     for (int env_idx : env_global_indices)
     {
-        const std::string & env_element = elements[env_idx];
+        const std::string & env_element = configuration.typeName(types[env_idx]);
         if (env_element == "O")
         {
             delta_E += 0.18;
@@ -140,7 +172,7 @@ bool RandomDistributor::metropolisAccept(int site_index,
         const double T = 500.0;
         const double kB = 8.6173324e-5;
         double acc_prob = std::exp(static_cast<float>(-delta_E/(kB*T)));
-        double randn = randomDouble01();
+        double randn = drawDouble01();
         if (randn > acc_prob)
         {
             return false;
@@ -171,9 +203,10 @@ std::vector<int> RandomDistributor::processRedistribute(Configuration & configur
                                      extracted_indices);
 
     // Run the rematching of the affected sites of extraction.
-    std::vector<int> && matching_indices = \
-        latticemap.supersetNeighbourIndices(extracted_indices,
-                                            interactions.maxRange());
+    const std::vector<int> & matching_indices = \
+        superset_builder_.build(latticemap,
+                                extracted_indices,
+                                interactions.maxRange());
 
     matcher.calculateMatching(interactions,
                               configuration,
@@ -226,7 +259,7 @@ std::vector<int> RandomDistributor::scatterSpecies(std::vector<std::string> & sp
     {
         // Shuffle the space indices.
         std::vector<int> shuffle_space_indices = space_indices;
-        shuffleIntVector(shuffle_space_indices);
+        shuffleIndices(shuffle_space_indices);
 
         // Flag for successful species scattering.
         bool scatter_success = false;
@@ -239,7 +272,7 @@ std::vector<int> RandomDistributor::scatterSpecies(std::vector<std::string> & sp
 
             // Get all redistribution process and shuffle them.
             std::vector<Process *> redist_process_ptrs = interactions.redistProcesses();
-            shuffleProcessPtrVector(redist_process_ptrs);
+            shuffleProcesses(redist_process_ptrs);
 
             // Loop over all redistribution process to check if it can happen here.
             for ( const auto & process_ptr : redist_process_ptrs )
@@ -255,9 +288,10 @@ std::vector<int> RandomDistributor::scatterSpecies(std::vector<std::string> & sp
 #ifdef DEBUG
                     assert(affected_indices.size() == 1 && affected_indices[0] == site_index);
 #endif // DEBUG
-                    const std::vector<int> && matching_indices = \
-                        latticemap.supersetNeighbourIndices(affected_indices,
-                                                            interactions.maxRange());
+                    const std::vector<int> & matching_indices = \
+                        superset_builder_.build(latticemap,
+                                                affected_indices,
+                                                interactions.maxRange());
                     // Extend all affected indices.
                     all_affected_indices.insert(all_affected_indices.end(),
                                                 affected_indices.begin(),
@@ -307,7 +341,7 @@ std::vector<int> RandomDistributor::scatterSpeciesMetro(std::vector<std::string>
     std::vector<int> all_affected_indices = {};
     // Shuffle the space indices.
     std::vector<int> shuffle_space_indices = space_indices;
-    shuffleIntVector(shuffle_space_indices);
+    shuffleIndices(shuffle_space_indices);
     // Space indices queue.
     std::queue<int, std::deque<int>> space_indices_queue(std::deque<int>(shuffle_space_indices.begin(),
                                                                          shuffle_space_indices.end()));
@@ -330,7 +364,7 @@ std::vector<int> RandomDistributor::scatterSpeciesMetro(std::vector<std::string>
 
             // Get all redistribution process and shuffle them.
             std::vector<Process *> redist_process_ptrs = interactions.redistProcesses();
-            shuffleProcessPtrVector(redist_process_ptrs);
+            shuffleProcesses(redist_process_ptrs);
 
             // Loop over all redistribution process to check if it can happen here.
             for ( const auto & process_ptr : redist_process_ptrs )
@@ -348,9 +382,10 @@ std::vector<int> RandomDistributor::scatterSpeciesMetro(std::vector<std::string>
                     configuration.performProcess(*process_ptr, site_index);
                     // Re-matching the affected indices.
                     const std::vector<int> & affected_indices = process_ptr->affectedIndices();
-                    const std::vector<int> && matching_indices = \
-                        latticemap.supersetNeighbourIndices(affected_indices,
-                                                            interactions.maxRange());
+                    const std::vector<int> & matching_indices = \
+                        superset_builder_.build(latticemap,
+                                                affected_indices,
+                                                interactions.maxRange());
                     // Extend all affected indices.
                     all_affected_indices.insert(all_affected_indices.end(),
                                                 affected_indices.begin(),
@@ -395,15 +430,16 @@ double RandomDistributor::calcInteractionEnergy(const Configuration & configurat
                                                 const std::vector<int> & env_local_indices) const
 {
     double E = 0.0;
-    const std::vector<std::string> & elements = configuration.elements_;
+    const std::vector<int> & types = configuration.types();
+    std::vector<int> buffer;
 
     for (const auto & idx: configuration.indices())
     {
-        const std::string & element = elements[idx];
+        const std::string & element = configuration.typeName(types[idx]);
         if (element == "C")
         {
             std::vector<int> env_global_indices {};
-            const std::vector<int> & neighbour_indices = latticemap.neighbourIndices(idx);
+            const IndexSpan neighbour_indices = latticemap.neighbourSpan(idx, 1, buffer);
             for (const auto & local_idx : env_local_indices)
             {
                 env_global_indices.push_back(neighbour_indices[local_idx]);
@@ -411,7 +447,7 @@ double RandomDistributor::calcInteractionEnergy(const Configuration & configurat
 
             for (const auto & env_idx : env_global_indices)
             {
-                const std::string & env_element = elements[env_idx];
+                const std::string & env_element = configuration.typeName(types[env_idx]);
                 if (env_element == "O")
                 {
                     E += 0.18;
@@ -445,7 +481,6 @@ updateLocalFromSubConfig(Configuration & global_config,
 
         // Use at() to do bound check here.
         global_config.types_.at(global_index) = sub_config.types()[i];
-        global_config.elements_.at(global_index) = sub_config.elements()[i];
         global_config.atom_id_.at(global_index) = sub_config.atomID()[i];
     }
 
@@ -503,7 +538,6 @@ std::vector<int> ConstrainedRandomDistributor:: \
     std::vector<int> env_local_indices;
     std::vector<int> ori_types;
     std::vector<int> ori_atom_id;
-    std::vector<std::string> ori_elements;
 
     if (metropolis_acceptance)
     {
@@ -515,7 +549,6 @@ std::vector<int> ConstrainedRandomDistributor:: \
         // Backup original configuration members
         ori_types = configuration.types_;
         ori_atom_id = configuration.atom_id_;
-        ori_elements = configuration.elements_;
     }
 
     std::vector<SubConfiguration> && sub_configs = configuration.split(latticemap,
@@ -552,9 +585,10 @@ std::vector<int> ConstrainedRandomDistributor:: \
     }
 
     // Run the rematching of the affected sites of extraction.
-    std::vector<int> && matching_indices = \
-        latticemap.supersetNeighbourIndices(extracted_global_indices,
-                                            interactions.maxRange());
+    const std::vector<int> & matching_indices = \
+        superset_builder_.build(latticemap,
+                                extracted_global_indices,
+                                interactions.maxRange());
 
     matcher.calculateMatching(interactions,
                               configuration,
@@ -597,13 +631,12 @@ std::vector<int> ConstrainedRandomDistributor:: \
             const double T = 500.0;
             const double kB = 8.6173324e-5;
             double acc_prob = std::exp(static_cast<float>(-delta/(kB*T)));
-            double randn = randomDouble01();
+            double randn = drawDouble01();
             if (randn > acc_prob)
             {
                 // Not accepted, revert configuration.
                 configuration.types_ = ori_types;
                 configuration.atom_id_ = ori_atom_id;
-                configuration.elements_ = ori_elements;
 
                 // Rematching all affected indices.
                 matcher.calculateMatching(interactions,
@@ -27,6 +27,8 @@
 #include <vector>
 #include <string>
 
+#include "supersetbuilder.h"
+
 // Forward declarations.
 class Configuration;
 class SubConfiguration;
@@ -34,6 +36,8 @@ class Matcher;
 class LatticeMap;
 class SitesMap;
 class Interactions;
+class Process;
+class CounterRandom;
 
 /*! \brief Class for configuration/geometries redistribution.
  *  NOTE: The class is a friend class of Configuration/SubConfiguration.
@@ -44,7 +48,7 @@ public:
 
     /*! \brief Default constructor.
      */
-    BaseDistributor() {}
+    BaseDistributor() : rng_(NULL) {}
 
     /*! \brief Destructor.
      */
@@ -57,8 +61,39 @@ public:
      */
     virtual std::vector<int> redistribute(Configuration & configuration) const = 0;
 
+    /*! \brief Draw the random numbers of the redistribution from a random
+     *         stream instead of the global generator.
+     *  \param rng : The random stream to draw from, not owned, or NULL to
+     *               go back to the global generator.
+     */
+    void setRandomStream(CounterRandom * rng) { rng_ = rng; }
+
 protected:
 
+    /*! \brief Draw a random number from the random stream if set, else from
+     *         the global generator.
+     *  \return : A pseudo random number on the interval (0.0,1.0)
+     */
+    double drawDouble01() const;
+
+    /*! \brief Shuffle site indices with the random stream if set, else with
+     *         the global generator.
+     *  \param v : The indices to shuffle.
+     */
+    void shuffleIndices(std::vector<int> & v) const;
+
+    /*! \brief Shuffle process pointers with the random stream if set, else
+     *         with the global generator.
+     *  \param v : The process pointers to shuffle.
+     */
+    void shuffleProcesses(std::vector<Process *> & v) const;
+
+    /// The builder of the neighbourhoods to re-match, reused between calls.
+    mutable SupersetBuilder superset_builder_;
+
+    /// The random stream to draw from, or NULL for the global generator.
+    CounterRandom * rng_;
+
 private:
 
 };
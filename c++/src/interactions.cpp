@@ -23,6 +23,7 @@
  */
 
 #include <algorithm>
+#include <stdexcept>
 
 #include "interactions.h"
 #include "random.h"
@@ -30,6 +31,7 @@
 #include "latticemap.h"
 #include "ratecalculator.h"
 #include "process.h"
+#include "checkpoint.h"
 
 
 // -----------------------------------------------------------------------------
@@ -56,7 +58,12 @@ Interactions::Interactions(const std::vector<Process> & processes,
     processes_(processes),
     custom_rate_processes_(0),
     process_pointers_(processes.size(), NULL),
+    slow_indices_(processes.size(), -1),
+    updated_flags_(processes.size(), false),
+    selection_type_(TREE_SELECTION),
+    use_match_trie_(false),
     process_available_sites_(processes.size(), 0),
+    available_sites_(0),
     implicit_wildcards_(implicit_wildcards),
     use_custom_rates_(false),
     rate_calculator_placeholder_(RateCalculator()),
@@ -82,6 +89,7 @@ Interactions::Interactions(const std::vector<Process> & processes,
         }
         else
         {
+            slow_indices_[i] = slow_process_pointers_.size();
             slow_process_pointers_.push_back(process_ptr);
         }
     }
@@ -89,6 +97,9 @@ Interactions::Interactions(const std::vector<Process> & processes,
     // Initialize probablity table after processes are classified.
     probability_table_.resize(slow_process_pointers_.size(),
                               std::pair<double, int>(0.0, 0));
+    probability_tree_.resize(slow_process_pointers_.size());
+
+    setupBasisSiteProcesses();
 }
 
 
@@ -102,7 +113,12 @@ Interactions::Interactions(const std::vector<CustomRateProcess> & processes,
     custom_rate_processes_(processes),
     process_pointers_(processes.size(), NULL),
     probability_table_(processes.size(), std::pair<double,int>(0.0,0)),
+    slow_indices_(processes.size(), -1),
+    updated_flags_(processes.size(), false),
+    selection_type_(TREE_SELECTION),
+    use_match_trie_(false),
     process_available_sites_(processes.size(), 0),
+    available_sites_(0),
     implicit_wildcards_(implicit_wildcards),
     use_custom_rates_(true),
     rate_calculator_(rate_calculator),
@@ -127,6 +143,7 @@ Interactions::Interactions(const std::vector<CustomRateProcess> & processes,
         }
         else
         {
+            slow_indices_[i] = slow_process_pointers_.size();
             slow_process_pointers_.push_back(process_ptr);
         }
     }
@@ -134,6 +151,49 @@ Interactions::Interactions(const std::vector<CustomRateProcess> & processes,
     // Initialize probablity table after processes are classified.
     probability_table_.resize(slow_process_pointers_.size(),
                               std::pair<double, int>(0.0, 0));
+    probability_tree_.resize(slow_process_pointers_.size());
+
+    setupBasisSiteProcesses();
+}
+
+
+// -----------------------------------------------------------------------------
+// Function for listing the indices of the processes for each basis site.
+static void basisSiteTable(const std::vector<Process *> & process_ptrs,
+                           std::vector< std::vector<int> > & table)
+{
+    table.clear();
+
+    for (size_t i = 0; i < process_ptrs.size(); ++i)
+    {
+        const std::vector<int> & basis_sites = process_ptrs[i]->basisSites();
+
+        for (size_t j = 0; j < basis_sites.size(); ++j)
+        {
+            const int basis_site = basis_sites[j];
+
+            if (static_cast<size_t>(basis_site) >= table.size())
+            {
+                table.resize(basis_site + 1);
+            }
+
+            // Skip basis sites listed more than once.
+            std::vector<int> & process_indices = table[basis_site];
+            if (process_indices.empty() || process_indices.back() != static_cast<int>(i))
+            {
+                process_indices.push_back(i);
+            }
+        }
+    }
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void Interactions::setupBasisSiteProcesses()
+{
+    basisSiteTable(process_pointers_, basis_site_processes_);
+    basisSiteTable(fast_process_pointers_, basis_site_fast_processes_);
 }
 
 
@@ -250,6 +310,64 @@ void Interactions::updateProcessMatchLists(const Configuration & configuration,
 }
 
 
+// -----------------------------------------------------------------------------
+//
+void Interactions::compileProcessMatchLists(const Configuration & configuration,
+                                            const LatticeMap & lattice_map)
+{
+    // {{{
+
+    for (size_t i = 0; i < process_pointers_.size(); ++i)
+    {
+        process_pointers_[i]->compileMatchList(configuration, lattice_map);
+    }
+
+    // Setup the match trie for each neighbourhood template with the
+    // processes that can match there.
+    const NeighbourhoodTemplates & neighbourhoods = configuration.neighbourhoods();
+    match_tries_.assign(neighbourhoods.nTemplates(), MatchTrie());
+
+    for (int geometry = 0; geometry < neighbourhoods.nTemplates(); ++geometry)
+    {
+        const size_t basis_site = neighbourhoods.templateBasisSite(geometry);
+        if (basis_site >= basis_site_processes_.size())
+        {
+            continue;
+        }
+
+        const std::vector<int> & process_indices = basis_site_processes_[basis_site];
+
+        for (size_t i = 0; i < process_indices.size(); ++i)
+        {
+            const Process & p = (*process_pointers_[process_indices[i]]);
+            if (p.geometryMatches(geometry))
+            {
+                match_tries_[geometry].insert(p.compiledMatchList(), process_indices[i]);
+            }
+        }
+    }
+
+    // The number of template positions within the cutoff of each process,
+    // for the custom rates.
+    cutoff_lengths_.assign(process_pointers_.size(),
+                           std::vector<int>(neighbourhoods.nTemplates(), 0));
+
+    for (size_t p = 0; p < process_pointers_.size(); ++p)
+    {
+        const double cutoff = process_pointers_[p]->cutoff();
+
+        for (int geometry = 0; geometry < neighbourhoods.nTemplates(); ++geometry)
+        {
+            const std::vector<double> & distances = neighbourhoods.templateArrays(geometry).distances;
+            cutoff_lengths_[p][geometry] = \
+                std::upper_bound(distances.begin(), distances.end(), cutoff) - distances.begin();
+        }
+    }
+
+    // }}}
+}
+
+
 // -----------------------------------------------------------------------------
 //
 int Interactions::totalAvailableSites() const
@@ -277,7 +395,7 @@ void Interactions::updateProbabilityTable()
     const std::vector<Process *>::const_iterator end = slow_process_pointers_.end();
 
     double previous_rate = 0.0;
-    for ( ; it1 != end; ++it1, ++it2 )
+    for (size_t i = 0; it1 != end; ++it1, ++it2, ++i)
     {
         // Find out its total probability.
         const int n_sites = (**it1).nSites();
@@ -287,12 +405,235 @@ void Interactions::updateProbabilityTable()
         previous_rate += total_rate;
         // Store the number of available processes to filter out zeroes later.
         (*it2).second = n_sites;
+
+        // Store the rate in the tree.
+        if (selection_type_ == TREE_SELECTION)
+        {
+            probability_tree_.update(i, total_rate);
+        }
+    }
+
+    // }}}
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void Interactions::writeCheckpoint(std::ostream & stream) const
+{
+    writeBinary(stream, static_cast<int32_t>(selection_type_));
+    writeBinary(stream, static_cast<uint64_t>(process_pointers_.size()));
+
+    for (const Process * process : process_pointers_)
+    {
+        process->writeCheckpoint(stream);
+    }
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void Interactions::readCheckpoint(std::istream & stream)
+{
+    // {{{
+    int32_t selection_type;
+    readBinary(stream, selection_type);
+    if (selection_type != LINEAR_SELECTION && selection_type != TREE_SELECTION)
+    {
+        throw std::runtime_error("Invalid process selection method in the checkpoint.");
+    }
+    selection_type_ = static_cast<SELECTION_TYPE>(selection_type);
+
+    checkBinarySize(stream, process_pointers_.size(), "processes");
+
+    for (Process * process : process_pointers_)
+    {
+        process->readCheckpoint(stream);
     }
 
+    // The processes listing each site follow the restored sites.
+    setupSiteProcesses();
+
+    // The probabilities are recalculated from the restored rates, giving
+    // the same table and tree as the ones of the written model.
+    updateProbabilityTable();
+    updateProcessAvailableSites();
     // }}}
 }
 
 
+// -----------------------------------------------------------------------------
+//
+void Interactions::markProcessUpdated(const int process_index)
+{
+    if (!updated_flags_[process_index])
+    {
+        updated_flags_[process_index] = true;
+        updated_processes_.push_back(process_index);
+    }
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void Interactions::updateMarkedProcesses()
+{
+    // {{{
+
+    // The linear table needs to be recalculated in full.
+    if (selection_type_ == LINEAR_SELECTION)
+    {
+        updateProbabilityTable();
+    }
+
+    for (const int process_index : updated_processes_)
+    {
+        const Process & process = *process_pointers_[process_index];
+
+        // Update the available sites, and the total of the slow processes.
+        const int slow_index = slow_indices_[process_index];
+        if (slow_index >= 0)
+        {
+            available_sites_ += process.nSites() - process_available_sites_[process_index];
+        }
+        process_available_sites_[process_index] = process.nSites();
+
+        // Update the rate of slow processes in the tree.
+        if (selection_type_ == TREE_SELECTION && slow_index >= 0)
+        {
+            probability_tree_.update(slow_index, process.totalRate());
+        }
+
+        // Clear the mark.
+        updated_flags_[process_index] = false;
+    }
+
+    updated_processes_.clear();
+
+    // }}}
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void Interactions::setSelectionType(const SELECTION_TYPE selection_type)
+{
+    selection_type_ = selection_type;
+    updateProbabilityTable();
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void Interactions::setUseMatchTrie(const bool use_match_trie)
+{
+    use_match_trie_ = use_match_trie;
+    setupSiteProcesses();
+}
+
+
+// -----------------------------------------------------------------------------
+//
+const std::vector<int> & Interactions::siteProcesses(const int index) const
+{
+    static const std::vector<int> no_processes;
+
+    if (static_cast<size_t>(index) >= site_processes_.size())
+    {
+        return no_processes;
+    }
+
+    return site_processes_[index];
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void Interactions::addSiteProcess(const int index, const int process_index)
+{
+    if (!use_match_trie_)
+    {
+        return;
+    }
+
+    if (static_cast<size_t>(index) >= site_processes_.size())
+    {
+        site_processes_.resize(index + 1);
+    }
+
+    site_processes_[index].push_back(process_index);
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void Interactions::removeSiteProcess(const int index, const int process_index)
+{
+    if (!use_match_trie_)
+    {
+        return;
+    }
+
+    std::vector<int> & processes = site_processes_[index];
+    std::vector<int>::iterator it = std::find(processes.begin(), processes.end(), process_index);
+
+    // Move the last process into its place.
+    *it = processes.back();
+    processes.pop_back();
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void Interactions::setupSiteProcesses()
+{
+    // {{{
+
+    std::vector< std::vector<int> >().swap(site_processes_);
+
+    for (size_t p = 0; p < process_pointers_.size(); ++p)
+    {
+        const std::vector<int> & sites = process_pointers_[p]->sites();
+        for (size_t i = 0; i < sites.size(); ++i)
+        {
+            addSiteProcess(sites[i], p);
+        }
+    }
+
+    // }}}
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void Interactions::setRateCacheCapacity(const size_t capacity)
+{
+    if (capacity > 0 && !rate_calculator_.pureLocalRates())
+    {
+        std::string msg = "Rates can only be cached with a rate calculator ";
+        msg += "declaring pure local rates.";
+        throw std::invalid_argument(msg);
+    }
+
+    rate_cache_.setCapacity(capacity);
+}
+
+
+// -----------------------------------------------------------------------------
+//
+double Interactions::totalRate() const
+{
+    if (selection_type_ == TREE_SELECTION)
+    {
+        return probability_tree_.total();
+    }
+    else
+    {
+        return probability_table_.back().first;
+    }
+}
+
+
 // -----------------------------------------------------------------------------
 //
 void Interactions::updateProcessAvailableSites()
@@ -307,6 +648,8 @@ void Interactions::updateProcessAvailableSites()
         // Update availability for each process.
         *it2 = (*it1)->nSites();
     }
+
+    available_sites_ = totalAvailableSites();
 }
 
 
@@ -314,15 +657,34 @@ void Interactions::updateProcessAvailableSites()
 //
 int Interactions::pickProcessIndex()
 {
-    // PERFORMME:
-    // This implements the O(N) SSA algorithm.
-    // One could consider implementing the O(logN) SSA-GB algorithm,
-    // or the O(1) algorithm described in J.Chem.Phys. 128, 205101, (2008)
-    // but it is typically the re-matching after an event that sets the
-    // limit in terms of scaling with the number of processes.
+    return selectProcessIndex(randomDouble01());
+}
+
+
+// -----------------------------------------------------------------------------
+//
+int Interactions::pickProcessIndex(CounterRandom & rng)
+{
+    return selectProcessIndex(rng.randomDouble01());
+}
 
+
+// -----------------------------------------------------------------------------
+//
+int Interactions::selectProcessIndex(const double rnd01)
+{
     // Get a random number between 0.0 and the total imcremented rate.
-    const double rnd = randomDouble01() * totalRate();
+    const double rnd = rnd01 * totalRate();
+
+    // The O(logN) selection by descending the sum tree.
+    if (selection_type_ == TREE_SELECTION)
+    {
+        picked_index_ = static_cast<int>(probability_tree_.pick(rnd));
+        return picked_index_;
+    }
+
+    // The reference O(N) SSA algorithm on the linear table, which
+    // needs the full table to be recalculated after each step.
     const std::pair<double,int> rnd_pair(rnd,1);
 
     // Find the lower bound - corresponding to the first element for which
@@ -349,8 +711,22 @@ int Interactions::pickProcessIndex()
 //
 Process* Interactions::pickProcess()
 {
-    const int index = pickProcessIndex();
+    return pickedProcess(pickProcessIndex());
+}
+
+
+// -----------------------------------------------------------------------------
+//
+Process* Interactions::pickProcess(CounterRandom & rng)
+{
+    return pickedProcess(pickProcessIndex(rng));
+}
+
 
+// -----------------------------------------------------------------------------
+//
+Process* Interactions::pickedProcess(const int index)
+{
     // Update the process internal probablility table if needed.
     slow_process_pointers_[index]->updateRateTable();
 
@@ -27,15 +27,23 @@
 
 
 #include <vector>
+#include <iosfwd>
 
 #include "customrateprocess.h"
 #include "ratecalculator.h"
+#include "sumtree.h"
+#include "matchtrie.h"
+#include "ratecache.h"
 
 
 // Forward declarations.
 class Configuration;
 class LatticeMap;
 class Process;
+class CounterRandom;
+
+/// The supported process selection methods.
+enum SELECTION_TYPE {LINEAR_SELECTION, TREE_SELECTION};
 
 /*! \brief Class for holding information about all interactions and possible
  *         processes in the system.
@@ -80,6 +88,14 @@ public:
     void updateProcessMatchLists( const Configuration & configuration,
                                   const LatticeMap & lattice_map);
 
+    /*! \brief Compile the process matchlists for type-only matching, with the
+     *         geometry checked once against the configuration.
+     *  \param configuration : The configuration with initialized match lists.
+     *  \param lattice_map   : The lattice map of the configuration.
+     */
+    void compileProcessMatchLists(const Configuration & configuration,
+                                  const LatticeMap & lattice_map);
+
     /*! \brief Query for the processes.
      *  \return : The processes of the system.
      */
@@ -128,8 +144,19 @@ public:
      */
     int totalAvailableSites() const;
 
+    /*! \brief Const query for the number of available sites in the whole
+     *         system as of the latest update, kept by updateMarkedProcesses()
+     *         and updateProcessAvailableSites() without summing over all
+     *         processes.
+     *  \return : The number of available sites of the slow processes.
+     */
+    int availableSites() const { return available_sites_; }
+
     /*! \brief Const query for the probability table.
      *  \return : A handle to the present probability table.
+     *
+     *  NOTE: With the tree selection method the table is only refreshed
+     *        by the full updateProbabilityTable() call.
      */
     const std::vector<std::pair<double,int> > & probabilityTable() const
     { return probability_table_; }
@@ -149,10 +176,135 @@ public:
      */
     void updateProcessAvailableSites();
 
+    /*! \brief Write the selection method and the listed sites and rates of
+     *         all processes to a binary checkpoint stream.
+     *  \param stream : The stream to write to.
+     */
+    void writeCheckpoint(std::ostream & stream) const;
+
+    /*! \brief Restore the selection method and the listed sites and rates
+     *         of all processes from a binary checkpoint stream, and
+     *         recalculate the probability table and available sites from
+     *         them. The processes must be the ones the checkpoint was
+     *         written with.
+     *  \param stream : The stream to read from.
+     */
+    void readCheckpoint(std::istream & stream);
+
+    /*! \brief Mark a process as updated, such that its probability and
+     *         available sites are recalculated by updateMarkedProcesses().
+     *  \param process_index : The index of the process in processes().
+     */
+    void markProcessUpdated(const int process_index);
+
+    /*! \brief Recalculate the probabilities and available sites of the
+     *         processes marked as updated since the last call only, and
+     *         clear the marks. With the linear selection method the whole
+     *         probability table is recalculated.
+     */
+    void updateMarkedProcesses();
+
+    /*! \brief Set the method used to pick processes. The probabilities
+     *         are recalculated for the new method.
+     *  \param selection_type : The process selection method to use.
+     */
+    void setSelectionType(const SELECTION_TYPE selection_type);
+
+    /*! \brief Query for the process selection method.
+     *  \return : The process selection method in use.
+     */
+    SELECTION_TYPE selectionType() const { return selection_type_; }
+
+    /*! \brief Set if all processes should be matched against a site in one
+     *         walk of a match trie, instead of one process at a time. The
+     *         tries are set up by compileProcessMatchLists().
+     *  \param use_match_trie : True to use the match tries.
+     */
+    void setUseMatchTrie(const bool use_match_trie);
+
+    /*! \brief Query for the match trie flag.
+     *  \return : True if the match tries are set up and should be used.
+     */
+    bool useMatchTrie() const
+    { return use_match_trie_ && !match_tries_.empty(); }
+
+    /*! \brief Query for the match trie of a neighbourhood template.
+     *  \param geometry : The match list geometry to get the match trie for.
+     *  \return : The trie with the compiled match lists of all processes
+     *            that can match at sites with the geometry.
+     */
+    const MatchTrie & matchTrie(const int geometry) const
+    { return match_tries_[geometry]; }
+
+    /*! \brief Query for the number of sites within the cutoff of a process
+     *         at a neighbourhood template, set up by compileProcessMatchLists().
+     *  \param process_index : The index of the process.
+     *  \param geometry      : The match list geometry (template).
+     *  \return : The number of template positions within the cutoff.
+     */
+    int cutoffLength(const int process_index, const int geometry) const
+    { return cutoff_lengths_[process_index][geometry]; }
+
+    /*! \brief Query for the processes listing a site, kept while the match
+     *         tries are used so that all processes can be matched against a
+     *         site without checking each process of its basis site.
+     *  \param index : The index to get the processes for.
+     *  \return : The indices of the processes with the index in their list
+     *            of sites, in no particular order.
+     */
+    const std::vector<int> & siteProcesses(const int index) const;
+
+    /*! \brief Register that a process was added to a site, only kept while
+     *         the match tries are used.
+     *  \param index         : The index added to the process.
+     *  \param process_index : The index of the process.
+     */
+    void addSiteProcess(const int index, const int process_index);
+
+    /*! \brief Register that a process was removed from a site, only kept
+     *         while the match tries are used.
+     *  \param index         : The index removed from the process.
+     *  \param process_index : The index of the process.
+     */
+    void removeSiteProcess(const int index, const int process_index);
+
+    /*! \brief Set the number of custom rates to cache by their local
+     *         environment, 0 to not cache any. Only allowed with a rate
+     *         calculator declaring pure local rates. Only the rates at
+     *         sites with a neighbourhood template are cached.
+     *  \param capacity : The maximum number of cached rates.
+     */
+    void setRateCacheCapacity(const size_t capacity);
+
+    /*! \brief Query for the rate cache.
+     *  \return : The rate cache, with a capacity of 0 if not used.
+     */
+    const RateCache & rateCache() const { return rate_cache_; }
+
+    /*! \brief Query for the rate cache.
+     *  \return : The rate cache, with a capacity of 0 if not used.
+     */
+    RateCache & rateCache() { return rate_cache_; }
+
+    /*! \brief Query for the processes that can take place at each basis site.
+     *  \return : The indices in processes() of all processes that list each
+     *            basis site, in increasing order.
+     */
+    const std::vector< std::vector<int> > & basisSiteProcesses() const
+    { return basis_site_processes_; }
+
+    /*! \brief Query for the fast processes that can take place at each
+     *         basis site.
+     *  \return : The indices in fastProcesses() of all fast processes that
+     *            list each basis site, in increasing order.
+     */
+    const std::vector< std::vector<int> > & basisSiteFastProcesses() const
+    { return basis_site_fast_processes_; }
+
     /*! \brief Query for the total rate of the system.
      *  \return : The total rate.
      */
-    double totalRate() const { return probability_table_.back().first; }
+    double totalRate() const;
 
     /*! \brief Pick an availabe process according to its probability.
      *  \return : The index of a possible available process picked according
@@ -162,6 +314,14 @@ public:
      */
     int pickProcessIndex();
 
+    /*! \brief Pick an availabe process according to its probability,
+     *         drawing from the given random stream instead of the global
+     *         generator.
+     *  \param rng : The random stream to draw from.
+     *  \return : The index in the slow processes of the picked process.
+     */
+    int pickProcessIndex(CounterRandom & rng);
+
     /*! \brief Pick an availabe process according to its probability and return
      *         a reference to that process.
      *  \return : A reference to a possible available process picked according
@@ -169,6 +329,14 @@ public:
      */
     Process* pickProcess();
 
+    /*! \brief Pick an availabe process according to its probability,
+     *         drawing from the given random stream instead of the global
+     *         generator.
+     *  \param rng : The random stream to draw from.
+     *  \return : A pointer to the picked process.
+     */
+    Process* pickProcess(CounterRandom & rng);
+
     /*! \brief Query for the index of process which was picked in last step.
      *  \return : The index number.
      */
@@ -180,6 +348,29 @@ protected:
 
 private:
 
+    /*! \brief Setup the process and fast process indices for each basis
+     *         site from the basis sites of the processes.
+     */
+    void setupBasisSiteProcesses();
+
+    /*! \brief Setup the processes listing each site from the sites of the
+     *         processes.
+     */
+    void setupSiteProcesses();
+
+    /*! \brief Select the process index corresponding to a random number
+     *         according to the process probabilities.
+     *  \param rnd01 : A random number on the interval (0.0,1.0).
+     *  \return : The index in the slow processes of the selected process.
+     */
+    int selectProcessIndex(const double rnd01);
+
+    /*! \brief Update the rate table of a picked process and return it.
+     *  \param index : The index in the slow processes of the picked process.
+     *  \return : A pointer to the picked process.
+     */
+    Process* pickedProcess(const int index);
+
     /// The processes.
     std::vector<Process> processes_;
 
@@ -201,9 +392,45 @@ private:
     /// The probability table.
     std::vector<std::pair<double,int> > probability_table_;
 
+    /// The sum tree over the total rates of the slow processes.
+    SumTree probability_tree_;
+
+    /// The index in the slow processes for each process, -1 if fast.
+    std::vector<int> slow_indices_;
+
+    /// The indices of the processes marked as updated.
+    std::vector<int> updated_processes_;
+
+    /// The flags for processes marked as updated.
+    std::vector<bool> updated_flags_;
+
+    /// The process selection method.
+    SELECTION_TYPE selection_type_;
+
+    /// The match tries for each neighbourhood template.
+    std::vector<MatchTrie> match_tries_;
+
+    /// The flag indicating if the match tries should be used.
+    bool use_match_trie_;
+
+    /// The cutoff length of each process at each neighbourhood template.
+    std::vector< std::vector<int> > cutoff_lengths_;
+
+    /// The processes listing each site, while the match tries are used.
+    std::vector< std::vector<int> > site_processes_;
+
+    /// The process indices for each basis site.
+    std::vector< std::vector<int> > basis_site_processes_;
+
+    /// The fast process indices for each basis site.
+    std::vector< std::vector<int> > basis_site_fast_processes_;
+
     /// The available numbers for each process.
     std::vector<int> process_available_sites_;
 
+    /// The sum of the available numbers of the slow processes.
+    int available_sites_;
+
     /// The flag indicating if implicit wildcards should  be used.
     bool implicit_wildcards_;
 
@@ -216,6 +443,9 @@ private:
     /// A reference to the rate calculator to use.
     const RateCalculator & rate_calculator_;
 
+    /// The cache of custom rates.
+    RateCache rate_cache_;
+
     /// The index of process picked in the latest step.
     int picked_index_;
 
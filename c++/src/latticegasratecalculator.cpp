@@ -0,0 +1,626 @@
+/*
+  This file is part of the KMCLib project distributed under the terms of the
+  GNU General Public License version 3, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/*! \file  latticegasratecalculator.cpp
+ *  \brief File for the implementation code of the LatticeGasRateCalculator class.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "latticegasratecalculator.h"
+#include "configuration.h"
+#include "neighbourhoodtemplates.h"
+#include "process.h"
+
+
+// The tolerance for assigning distances to shells.
+static const double epsi__ = 1.0e-5;
+
+// The Boltzmann constant in eV/K.
+static const double kB__ = 8.617333262e-5;
+
+
+// -----------------------------------------------------------------------------
+// Get the type of a site with the changes at the positions before the given
+// position applied.
+//
+static int typeBefore(const KMCRatePluginEnvironment & environment,
+                      const int position,
+                      const int index,
+                      const int type)
+{
+    for (int p = 0; p < position; ++p)
+    {
+        const int update_type = environment.update_types[p];
+        if (environment.indices[p] == index && update_type > 0)
+        {
+            return update_type;
+        }
+    }
+    return type;
+}
+
+
+// -----------------------------------------------------------------------------
+//
+LatticeGasRateCalculator::LatticeGasRateCalculator() :
+    ThreadSafeRateCalculator(true),
+    n_types_(0),
+    has_triplets_(false),
+    temperature_(300.0),
+    configuration_(NULL)
+{
+    // NOTHING HERE.
+}
+
+
+// -----------------------------------------------------------------------------
+//
+LatticeGasRateCalculator::~LatticeGasRateCalculator()
+{
+    // NOTHING HERE.
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void LatticeGasRateCalculator::setShells(const std::vector<double> & shells,
+                                         const int n_types)
+{
+    if (shells.empty() || n_types < 1)
+    {
+        throw std::invalid_argument("At least one shell and one type are needed for the lattice gas.");
+    }
+
+    for (size_t i = 0; i < shells.size(); ++i)
+    {
+        if (shells[i] <= 0.0)
+        {
+            throw std::invalid_argument("The lattice gas shell distances must be positive.");
+        }
+    }
+
+    shells_  = shells;
+    n_types_ = n_types;
+    pair_energies_.assign(shells_.size() * n_types_ * n_types_, 0.0);
+    triplet_energies_.clear();
+    has_triplets_ = false;
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void LatticeGasRateCalculator::setPairEnergy(const int type_a,
+                                             const int type_b,
+                                             const int shell,
+                                             const double energy)
+{
+    const int n_shells = shells_.size();
+    if (type_a < 0 || type_a >= n_types_ || type_b < 0 || type_b >= n_types_ ||
+        shell < 0 || shell >= n_shells)
+    {
+        throw std::invalid_argument("Lattice gas pair type or shell out of range.");
+    }
+
+    pair_energies_[(shell*n_types_ + type_a)*n_types_ + type_b] = energy;
+    pair_energies_[(shell*n_types_ + type_b)*n_types_ + type_a] = energy;
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void LatticeGasRateCalculator::setTripletEnergy(const int type_a,
+                                                const int type_b,
+                                                const int type_c,
+                                                const int shell_ab,
+                                                const int shell_bc,
+                                                const int shell_ca,
+                                                const double energy)
+{
+    // {{{
+
+    const int n_shells = shells_.size();
+    const int types[3]  = {type_a, type_b, type_c};
+    const int shells[3] = {shell_ab, shell_bc, shell_ca};
+
+    for (int i = 0; i < 3; ++i)
+    {
+        if (types[i] < 0 || types[i] >= n_types_ || shells[i] < 0 || shells[i] >= n_shells)
+        {
+            throw std::invalid_argument("Lattice gas triplet type or shell out of range.");
+        }
+    }
+
+    if (!has_triplets_)
+    {
+        triplet_energies_.assign(n_types_*n_types_*n_types_*n_shells*n_shells*n_shells, 0.0);
+        has_triplets_ = true;
+    }
+
+    // The shell between each two vertices.
+    int edge[3][3];
+    edge[0][1] = edge[1][0] = shell_ab;
+    edge[1][2] = edge[2][1] = shell_bc;
+    edge[2][0] = edge[0][2] = shell_ca;
+
+    // Store the energy for all orders of the vertices, so that no
+    // canonical order is needed in the look up.
+    int order[3] = {0, 1, 2};
+    do
+    {
+        const int x = order[0];
+        const int y = order[1];
+        const int z = order[2];
+
+        triplet_energies_[((((types[x]*n_types_ + types[y])*n_types_ + types[z])*n_shells + \
+                            edge[x][y])*n_shells + edge[y][z])*n_shells + edge[z][x]] = energy;
+    }
+    while (std::next_permutation(order, order + 3));
+
+    // }}}
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void LatticeGasRateCalculator::setBEPParameters(const int process_number,
+                                                const double barrier,
+                                                const double alpha)
+{
+    bep_parameters_[process_number] = std::pair<double, double>(barrier, alpha);
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void LatticeGasRateCalculator::setTemperature(const double temperature)
+{
+    if (temperature <= 0.0)
+    {
+        throw std::invalid_argument("The lattice gas temperature must be positive.");
+    }
+    temperature_ = temperature;
+}
+
+
+// -----------------------------------------------------------------------------
+//
+double LatticeGasRateCalculator::siteEnergy(const int index, const int type) const
+{
+    if (site_energies_.empty())
+    {
+        return 0.0;
+    }
+    return site_energies_[index*n_types_ + type];
+}
+
+
+// -----------------------------------------------------------------------------
+//
+double LatticeGasRateCalculator::energyChange(const KMCRatePluginEnvironment & environment) const
+{
+    // {{{
+
+    if (site_energies_.empty())
+    {
+        return 0.0;
+    }
+
+    const NeighbourhoodTemplates & neighbourhoods = configuration_->neighbourhoods();
+    double energy_change = 0.0;
+    bool changed_before = false;
+
+    // Change the sites one after the other. The site energies give the change
+    // for the first site, the clusters also holding a site changed before are
+    // then corrected for its new type.
+    for (int p = 0; p < environment.n_update; ++p)
+    {
+        const int index    = environment.indices[p];
+        const int old_type = environment.types[index];
+        const int new_type = environment.update_types[p];
+
+        if (new_type <= 0 || new_type == old_type)
+        {
+            continue;
+        }
+
+        energy_change += site_energies_[index*n_types_ + new_type] - \
+            site_energies_[index*n_types_ + old_type];
+
+        if (changed_before)
+        {
+            const SiteClusters & site_clusters = clusters(index);
+
+            for (size_t i = 0; i < site_clusters.pair_positions.size(); ++i)
+            {
+                const int j     = neighbourhoods.neighbourIndex(index, site_clusters.pair_positions[i]);
+                const int shell = site_clusters.pair_shells[i];
+                const int tj    = environment.types[j];
+                const int vj    = typeBefore(environment, p, j, tj);
+
+                if (vj != tj)
+                {
+                    energy_change += pairEnergy(new_type, vj, shell) - pairEnergy(old_type, vj, shell) - \
+                        pairEnergy(new_type, tj, shell) + pairEnergy(old_type, tj, shell);
+                }
+            }
+
+            for (size_t i = 0; i < site_clusters.triplet_positions.size() / 2; ++i)
+            {
+                const int j  = neighbourhoods.neighbourIndex(index, site_clusters.triplet_positions[2*i]);
+                const int k  = neighbourhoods.neighbourIndex(index, site_clusters.triplet_positions[2*i + 1]);
+                const int tj = environment.types[j];
+                const int tk = environment.types[k];
+                const int vj = typeBefore(environment, p, j, tj);
+                const int vk = typeBefore(environment, p, k, tk);
+
+                if (vj != tj || vk != tk)
+                {
+                    const int s_ij = site_clusters.triplet_shells[3*i];
+                    const int s_jk = site_clusters.triplet_shells[3*i + 1];
+                    const int s_ki = site_clusters.triplet_shells[3*i + 2];
+
+                    energy_change += \
+                        tripletEnergy(new_type, vj, vk, s_ij, s_jk, s_ki) - \
+                        tripletEnergy(old_type, vj, vk, s_ij, s_jk, s_ki) - \
+                        tripletEnergy(new_type, tj, tk, s_ij, s_jk, s_ki) + \
+                        tripletEnergy(old_type, tj, tk, s_ij, s_jk, s_ki);
+                }
+            }
+        }
+
+        changed_before = true;
+    }
+
+    return energy_change;
+
+    // }}}
+}
+
+
+// -----------------------------------------------------------------------------
+//
+double LatticeGasRateCalculator::backendIntegerRateCallback(const KMCRatePluginEnvironment & environment) const
+{
+    const std::map<int, std::pair<double, double> >::const_iterator it = \
+        bep_parameters_.find(environment.process_number);
+
+    if (it == bep_parameters_.end())
+    {
+        return environment.rate_constant;
+    }
+
+    const double energy_change = energyChange(environment);
+    const double barrier = std::max(0.0, std::max(energy_change,
+                                                  it->second.first + it->second.second*energy_change));
+
+    return environment.rate_constant * std::exp(-barrier / (kB__ * temperature_));
+}
+
+
+// -----------------------------------------------------------------------------
+//
+double LatticeGasRateCalculator::requiredCutoff(const Process & process) const
+{
+    if (shells_.empty())
+    {
+        return 0.0;
+    }
+
+    // The energy of a changed site depends on the types up to the largest
+    // shell away from it.
+    double max_distance = 0.0;
+    const ProcessMatchList & match_list = process.matchList();
+
+    for (size_t i = 0; i < match_list.size(); ++i)
+    {
+        const ProcessMatchListEntry & entry = match_list[i];
+        if (entry.update_type > 0 && entry.update_type != entry.match_type)
+        {
+            max_distance = std::max(max_distance, entry.distance);
+        }
+    }
+
+    return max_distance + *std::max_element(shells_.begin(), shells_.end());
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void LatticeGasRateCalculator::initLocalState(const Configuration & configuration,
+                                              const std::vector<Process*> & processes) const
+{
+    // {{{
+
+    configuration_ = &configuration;
+    template_clusters_.clear();
+    site_clusters_.clear();
+    types_.clear();
+    site_energies_.clear();
+
+    // Nothing to keep without interactions.
+    if (shells_.empty())
+    {
+        return;
+    }
+
+    // A process with a shorter cutoff would keep its rate when the energy
+    // of a site it changes does.
+    for (size_t p = 0; p < processes.size(); ++p)
+    {
+        if (processes[p]->cutoff() < requiredCutoff(*processes[p]) - epsi__)
+        {
+            throw std::runtime_error("The cutoff of a process is too short for the lattice gas shells around its changed sites.");
+        }
+    }
+
+    const NeighbourhoodTemplates & neighbourhoods = configuration.neighbourhoods();
+    const std::vector<int> & types = configuration.types();
+    const int n_sites = types.size();
+
+    for (int i = 0; i < n_sites; ++i)
+    {
+        if (types[i] < 0 || types[i] >= n_types_)
+        {
+            throw std::runtime_error("The configuration has types not given to the lattice gas.");
+        }
+    }
+
+    // Setup the clusters of the templates. The templates cut off by a
+    // non-periodic boundary are shorter, so the range is checked against
+    // the longest template of each basis site.
+    const double max_shell = *std::max_element(shells_.begin(), shells_.end());
+    template_clusters_.resize(neighbourhoods.nTemplates());
+    std::vector<double> max_distances(neighbourhoods.nTemplates(), -1.0);
+
+    for (int t = 0; t < neighbourhoods.nTemplates(); ++t)
+    {
+        const NeighbourhoodTemplates::GeometryArrays & arrays = neighbourhoods.templateArrays(t);
+        setupClusters(arrays.distances, arrays.coordinates, template_clusters_[t]);
+
+        if (!arrays.distances.empty())
+        {
+            double & max_distance = max_distances[neighbourhoods.templateBasisSite(t)];
+            max_distance = std::max(max_distance, arrays.distances.back());
+        }
+    }
+
+    for (size_t b = 0; b < max_distances.size(); ++b)
+    {
+        if (max_distances[b] >= 0.0 && max_distances[b] < max_shell - epsi__)
+        {
+            throw std::runtime_error("The lattice gas shells are outside of the match list range.");
+        }
+    }
+
+    // And of the sites without a template.
+    for (int i = 0; i < n_sites; ++i)
+    {
+        if (neighbourhoods.geometry(i) < 0)
+        {
+            const NeighbourhoodTemplates::GeometryArrays & arrays = neighbourhoods.geometryArrays(i);
+            setupClusters(arrays.distances, arrays.coordinates, site_clusters_[i]);
+        }
+    }
+
+    // Sum up the energies of the clusters with each site.
+    types_ = types;
+    site_energies_.assign(n_sites * n_types_, 0.0);
+    std::vector<int> indices;
+
+    for (int i = 0; i < n_sites; ++i)
+    {
+        const SiteClusters & site_clusters = clusters(i);
+        configuration.matchListIndices(i, indices);
+        double * energies = &site_energies_[i*n_types_];
+
+        for (size_t n = 0; n < site_clusters.pair_positions.size(); ++n)
+        {
+            const int tj    = types[indices[site_clusters.pair_positions[n]]];
+            const int shell = site_clusters.pair_shells[n];
+
+            for (int t = 0; t < n_types_; ++t)
+            {
+                energies[t] += pairEnergy(t, tj, shell);
+            }
+        }
+
+        for (size_t n = 0; n < site_clusters.triplet_positions.size() / 2; ++n)
+        {
+            const int tj = types[indices[site_clusters.triplet_positions[2*n]]];
+            const int tk = types[indices[site_clusters.triplet_positions[2*n + 1]]];
+            const int s_ij = site_clusters.triplet_shells[3*n];
+            const int s_jk = site_clusters.triplet_shells[3*n + 1];
+            const int s_ki = site_clusters.triplet_shells[3*n + 2];
+
+            for (int t = 0; t < n_types_; ++t)
+            {
+                energies[t] += tripletEnergy(t, tj, tk, s_ij, s_jk, s_ki);
+            }
+        }
+    }
+
+    // }}}
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void LatticeGasRateCalculator::updateLocalState(const Configuration & configuration,
+                                                const std::vector<int> & indices) const
+{
+    if (configuration_ != &configuration)
+    {
+        throw std::runtime_error("The lattice gas state was not set up for the configuration.");
+    }
+
+    if (site_energies_.empty())
+    {
+        return;
+    }
+
+    const std::vector<int> & types = configuration.types();
+    const int n_sites = types_.size();
+
+    for (size_t i = 0; i < indices.size(); ++i)
+    {
+        const int index = indices[i];
+        if (index >= 0 && index < n_sites && types[index] != types_[index])
+        {
+            applyTypeChange(index, types_[index], types[index]);
+        }
+    }
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void LatticeGasRateCalculator::applyTypeChange(const int index,
+                                               const int old_type,
+                                               const int new_type) const
+{
+    // {{{
+
+    const SiteClusters & site_clusters = clusters(index);
+    const NeighbourhoodTemplates & neighbourhoods = configuration_->neighbourhoods();
+
+    for (size_t n = 0; n < site_clusters.pair_positions.size(); ++n)
+    {
+        const int j     = neighbourhoods.neighbourIndex(index, site_clusters.pair_positions[n]);
+        const int shell = site_clusters.pair_shells[n];
+        double * energies = &site_energies_[j*n_types_];
+
+        for (int t = 0; t < n_types_; ++t)
+        {
+            energies[t] += pairEnergy(t, new_type, shell) - pairEnergy(t, old_type, shell);
+        }
+    }
+
+    for (size_t n = 0; n < site_clusters.triplet_positions.size() / 2; ++n)
+    {
+        const int j = neighbourhoods.neighbourIndex(index, site_clusters.triplet_positions[2*n]);
+        const int k = neighbourhoods.neighbourIndex(index, site_clusters.triplet_positions[2*n + 1]);
+        const int tj = types_[j];
+        const int tk = types_[k];
+
+        // The shells index-j, j-k and k-index.
+        const int s_mj = site_clusters.triplet_shells[3*n];
+        const int s_jk = site_clusters.triplet_shells[3*n + 1];
+        const int s_km = site_clusters.triplet_shells[3*n + 2];
+
+        double * energies_j = &site_energies_[j*n_types_];
+        double * energies_k = &site_energies_[k*n_types_];
+
+        for (int t = 0; t < n_types_; ++t)
+        {
+            energies_j[t] += tripletEnergy(t, tk, new_type, s_jk, s_km, s_mj) - \
+                tripletEnergy(t, tk, old_type, s_jk, s_km, s_mj);
+            energies_k[t] += tripletEnergy(t, new_type, tj, s_km, s_mj, s_jk) - \
+                tripletEnergy(t, old_type, tj, s_km, s_mj, s_jk);
+        }
+    }
+
+    types_[index] = new_type;
+
+    // }}}
+}
+
+
+// -----------------------------------------------------------------------------
+//
+const LatticeGasRateCalculator::SiteClusters & \
+LatticeGasRateCalculator::clusters(const int index) const
+{
+    static const SiteClusters empty_clusters;
+
+    const int geometry = configuration_->neighbourhoods().geometry(index);
+    if (geometry >= 0)
+    {
+        return template_clusters_[geometry];
+    }
+
+    const std::map<int, SiteClusters>::const_iterator it = site_clusters_.find(index);
+    if (it != site_clusters_.end())
+    {
+        return it->second;
+    }
+
+    return empty_clusters;
+}
+
+
+// -----------------------------------------------------------------------------
+//
+int LatticeGasRateCalculator::shell(const double distance) const
+{
+    for (size_t s = 0; s < shells_.size(); ++s)
+    {
+        if (std::fabs(distance - shells_[s]) < epsi__)
+        {
+            return s;
+        }
+    }
+    return -1;
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void LatticeGasRateCalculator::setupClusters(const std::vector<double> & distances,
+                                             const std::vector<double> & coordinates,
+                                             SiteClusters & clusters) const
+{
+    // {{{
+
+    clusters = SiteClusters();
+
+    // The pairs with the central site, which is at position 0.
+    for (size_t q = 1; q < distances.size(); ++q)
+    {
+        const int s = shell(distances[q]);
+        if (s >= 0)
+        {
+            clusters.pair_positions.push_back(q);
+            clusters.pair_shells.push_back(s);
+        }
+    }
+
+    if (!has_triplets_)
+    {
+        return;
+    }
+
+    // The triplets of the central site and two of its pair neighbours.
+    const size_t n_pairs = clusters.pair_positions.size();
+
+    for (size_t a = 0; a < n_pairs; ++a)
+    {
+        for (size_t b = a + 1; b < n_pairs; ++b)
+        {
+            const int qa = clusters.pair_positions[a];
+            const int qb = clusters.pair_positions[b];
+
+            const double dx = coordinates[3*qa]     - coordinates[3*qb];
+            const double dy = coordinates[3*qa + 1] - coordinates[3*qb + 1];
+            const double dz = coordinates[3*qa + 2] - coordinates[3*qb + 2];
+            const int s_jk = shell(std::sqrt(dx*dx + dy*dy + dz*dz));
+
+            if (s_jk >= 0)
+            {
+                clusters.triplet_positions.push_back(qa);
+                clusters.triplet_positions.push_back(qb);
+                clusters.triplet_shells.push_back(clusters.pair_shells[a]);
+                clusters.triplet_shells.push_back(s_jk);
+                clusters.triplet_shells.push_back(clusters.pair_shells[b]);
+            }
+        }
+    }
+
+    // }}}
+}
+
@@ -0,0 +1,256 @@
+/*
+  This file is part of the KMCLib project distributed under the terms of the
+  GNU General Public License version 3, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/*! \file  latticegasratecalculator.h
+ *  \brief File for the LatticeGasRateCalculator class definition.
+ */
+
+#ifndef __LATTICEGASRATECALCULATOR__
+#define __LATTICEGASRATECALCULATOR__
+
+#include <vector>
+#include <map>
+
+#include "ratecalculator.h"
+
+
+/*! \brief Class for a native rate calculator with lateral interactions of
+ *         a lattice gas, giving the barriers from a Bronsted-Evans-Polanyi
+ *         relation.
+ *
+ *  The energy is a sum of pair energies by the types and the distance shell
+ *  of the two sites, and triplet energies by the types and the distance
+ *  shells of the three sites. For each site and type the energy of all
+ *  clusters with the site, given the types of the other sites, is kept up
+ *  to date as the types change. The energy change of a process is then
+ *  found from these site energies, and the rate is
+ *
+ *      k = A exp(-Ea / kB T),  Ea = max(0, dE, E0 + alpha dE)
+ *
+ *  with A the rate constant of the process and E0 and alpha the BEP
+ *  parameters of the process. Processes without BEP parameters keep their
+ *  rate constant. Energies are given in eV and the temperature in K.
+ *
+ *  The interaction shells must be within the match list range, and the
+ *  cutoff of the custom rate processes must cover the shells around every
+ *  site the process changes, for the rates to be re-matched when the site
+ *  energies change. Both are checked in initLocalState().
+ */
+class LatticeGasRateCalculator : public ThreadSafeRateCalculator {
+
+public:
+
+    /*! \brief Constructor, without interactions.
+     */
+    LatticeGasRateCalculator();
+
+    /*! \brief Destructor.
+     */
+    virtual ~LatticeGasRateCalculator();
+
+    /*! \brief Set the distance shells and the number of types, removing
+     *         all interaction energies.
+     *  \param shells  : The distance of each shell.
+     *  \param n_types : The number of types, including the wildcard type 0.
+     */
+    void setShells(const std::vector<double> & shells, const int n_types);
+
+    /*! \brief Set the energy of a pair.
+     *  \param type_a : The type of the first site.
+     *  \param type_b : The type of the second site.
+     *  \param shell  : The distance shell of the pair.
+     *  \param energy : The energy of the pair.
+     */
+    void setPairEnergy(const int type_a,
+                       const int type_b,
+                       const int shell,
+                       const double energy);
+
+    /*! \brief Set the energy of a triplet.
+     *  \param type_a   : The type of the first site.
+     *  \param type_b   : The type of the second site.
+     *  \param type_c   : The type of the third site.
+     *  \param shell_ab : The distance shell between the first and second site.
+     *  \param shell_bc : The distance shell between the second and third site.
+     *  \param shell_ca : The distance shell between the third and first site.
+     *  \param energy   : The energy of the triplet.
+     */
+    void setTripletEnergy(const int type_a,
+                          const int type_b,
+                          const int type_c,
+                          const int shell_ab,
+                          const int shell_bc,
+                          const int shell_ca,
+                          const double energy);
+
+    /*! \brief Set the BEP parameters of a process.
+     *  \param process_number : The id number of the process.
+     *  \param barrier        : The barrier E0 at zero energy change.
+     *  \param alpha          : The BEP slope.
+     */
+    void setBEPParameters(const int process_number,
+                          const double barrier,
+                          const double alpha);
+
+    /*! \brief Set the temperature.
+     *  \param temperature : The temperature in K.
+     */
+    void setTemperature(const double temperature);
+
+    /*! \brief Query for the temperature.
+     *  \return : The temperature in K.
+     */
+    double temperature() const { return temperature_; }
+
+    /*! \brief Query for the energy of the clusters with a site.
+     *  \param index : The index of the site.
+     *  \param type  : The type to give the site.
+     *  \return : The energy of all clusters with the site, 0 before
+     *            initLocalState() was called.
+     */
+    double siteEnergy(const int index, const int type) const;
+
+    /*! \brief Calculate the energy change of a process.
+     *  \param environment : The local environment of the process.
+     *  \return : The energy after minus the energy before the process.
+     */
+    double energyChange(const KMCRatePluginEnvironment & environment) const;
+
+    /*! \brief The integer backend callback, giving the BEP rate.
+     *  \param environment : The local environment of the process.
+     *  \return : The rate of the process.
+     */
+    virtual double backendIntegerRateCallback(const KMCRatePluginEnvironment & environment) const;
+
+    /*! \brief Setup the clusters and the site energies of the configuration.
+     *  \param configuration : The configuration, with the match lists set up.
+     *  \param processes     : The processes, which must have a cutoff of at
+     *                         least requiredCutoff().
+     */
+    virtual void initLocalState(const Configuration & configuration,
+                                const std::vector<Process*> & processes) const;
+
+    /*! \brief Get the smallest cutoff of a process for its rate to be
+     *         re-matched whenever the energies of the sites it changes do.
+     *  \param process : The process.
+     *  \return : The largest distance of a changed site plus the largest
+     *            shell, or 0 without shells.
+     */
+    double requiredCutoff(const Process & process) const;
+
+    /*! \brief Update the site energies around the changed types.
+     *  \param configuration : The configuration with the new types.
+     *  \param indices       : The indices where the types may have changed.
+     */
+    virtual void updateLocalState(const Configuration & configuration,
+                                  const std::vector<int> & indices) const;
+
+protected:
+
+private:
+
+    /// The clusters of a site, by the positions in its match list.
+    struct SiteClusters {
+
+        /// The position of each pair neighbour.
+        std::vector<int> pair_positions;
+
+        /// The shell of each pair.
+        std::vector<int> pair_shells;
+
+        /// The positions j, k of the two other sites of each triplet.
+        std::vector<int> triplet_positions;
+
+        /// The shells ij, jk, ki of each triplet.
+        std::vector<int> triplet_shells;
+
+    };
+
+    /*! \brief Get the clusters of a site.
+     *  \param index : The index of the site.
+     *  \return : The clusters, shared by all sites with the same template.
+     */
+    const SiteClusters & clusters(const int index) const;
+
+    /*! \brief Get the shell of a distance.
+     *  \param distance : The distance.
+     *  \return : The shell, or -1 if the distance is not in any shell.
+     */
+    int shell(const double distance) const;
+
+    /*! \brief Setup the clusters from the relative coordinates of the sites.
+     *  \param distances   : The distance of each site from the central site.
+     *  \param coordinates : The coordinates of each site, x, y, z after each other.
+     *  \param clusters    : (out) The clusters.
+     */
+    void setupClusters(const std::vector<double> & distances,
+                       const std::vector<double> & coordinates,
+                       SiteClusters & clusters) const;
+
+    /*! \brief Get the pair energy.
+     */
+    double pairEnergy(const int type_a, const int type_b, const int shell) const
+    { return pair_energies_[(shell*n_types_ + type_a)*n_types_ + type_b]; }
+
+    /*! \brief Get the triplet energy.
+     */
+    double tripletEnergy(const int type_a, const int type_b, const int type_c,
+                         const int shell_ab, const int shell_bc, const int shell_ca) const
+    {
+        const int n_shells = shells_.size();
+        return triplet_energies_[((((type_a*n_types_ + type_b)*n_types_ + type_c)*n_shells + \
+                                   shell_ab)*n_shells + shell_bc)*n_shells + shell_ca];
+    }
+
+    /*! \brief Add the change of a site type to the energies of the other
+     *         sites in its clusters.
+     *  \param index    : The index of the site.
+     *  \param old_type : The type before the change.
+     *  \param new_type : The type after the change.
+     */
+    void applyTypeChange(const int index, const int old_type, const int new_type) const;
+
+    /// The distance of each shell.
+    std::vector<double> shells_;
+
+    /// The number of types.
+    int n_types_;
+
+    /// The pair energies, by shell and types.
+    std::vector<double> pair_energies_;
+
+    /// The triplet energies, by types and shells.
+    std::vector<double> triplet_energies_;
+
+    /// If any triplet energy is set.
+    bool has_triplets_;
+
+    /// The BEP barrier and slope by process number.
+    std::map<int, std::pair<double, double> > bep_parameters_;
+
+    /// The temperature.
+    double temperature_;
+
+    /// The configuration the state was set up for.
+    mutable const Configuration * configuration_;
+
+    /// The clusters of each template.
+    mutable std::vector<SiteClusters> template_clusters_;
+
+    /// The clusters of the sites without a template.
+    mutable std::map<int, SiteClusters> site_clusters_;
+
+    /// The types the site energies were calculated for.
+    mutable std::vector<int> types_;
+
+    /// The energy of the clusters with each site, for each type.
+    mutable std::vector<double> site_energies_;
+
+};
+
+
+#endif // __LATTICEGASRATECALCULATOR__
+
@@ -32,19 +32,111 @@
 #include <stdexcept>
 
 
+// -----------------------------------------------------------------------------
+//
+CellOrder::CellOrder() :
+    repetitions_j_(1),
+    repetitions_k_(1)
+{
+    // NOTHING HERE.
+}
+
+
+// -----------------------------------------------------------------------------
+//
+CellOrder::CellOrder(const std::vector<int> & repetitions,
+                     const bool morton) :
+    repetitions_j_(repetitions[1]),
+    repetitions_k_(repetitions[2])
+{
+    // {{{
+
+    if (!morton)
+    {
+        return;
+    }
+
+    // Interleave the bits of the cell indices to the Morton key of each cell.
+    const int n_cells = repetitions[0] * repetitions[1] * repetitions[2];
+    std::vector<std::pair<unsigned long long, int> > keys(n_cells);
+
+    for (int cell = 0; cell < n_cells; ++cell)
+    {
+        int index[3];
+        index[2] = cell % repetitions_k_;
+        index[1] = (cell / repetitions_k_) % repetitions_j_;
+        index[0] = cell / (repetitions_k_ * repetitions_j_);
+
+        unsigned long long key = 0;
+        for (int bit = 0; bit < 21; ++bit)
+        {
+            for (int d = 0; d < 3; ++d)
+            {
+                key |= static_cast<unsigned long long>((index[d] >> bit) & 1) << (3 * bit + 2 - d);
+            }
+        }
+        keys[cell] = std::make_pair(key, cell);
+    }
+
+    // Number the cells in the order of their keys.
+    std::sort(keys.begin(), keys.end());
+
+    numbers_.resize(n_cells);
+    cells_.resize(n_cells);
+
+    for (int number = 0; number < n_cells; ++number)
+    {
+        cells_[number] = keys[number].second;
+        numbers_[keys[number].second] = number;
+    }
+
+    // }}}
+}
+
+
 // -----------------------------------------------------------------------------
 //
 LatticeMap::LatticeMap(const int n_basis,
                        const std::vector<int> repetitions,
-                       const std::vector<bool> periodic) :
+                       const std::vector<bool> periodic,
+                       const bool morton_order) :
     n_basis_(n_basis),
     repetitions_(repetitions),
-    periodic_(periodic)
+    periodic_(periodic),
+    cell_order_(repetitions, morton_order)
 {
     // NOTHING HERE.
 }
 
 
+// -----------------------------------------------------------------------------
+//
+std::vector<int> LatticeMap::rowMajorIndices() const
+{
+    const int n_cells = repetitions_[0] * repetitions_[1] * repetitions_[2];
+    std::vector<int> row_major_indices(n_cells * n_basis_);
+
+    for (int i = 0; i < repetitions_[0]; ++i)
+    {
+        for (int j = 0; j < repetitions_[1]; ++j)
+        {
+            for (int k = 0; k < repetitions_[2]; ++k)
+            {
+                const int first = firstIndex(i, j, k);
+                const int row_major_first = ((i * repetitions_[1] + j) * repetitions_[2] + k) * n_basis_;
+
+                for (int b = 0; b < n_basis_; ++b)
+                {
+                    row_major_indices[first + b] = row_major_first + b;
+                }
+            }
+        }
+    }
+
+    return row_major_indices;
+}
+
+
 // -----------------------------------------------------------------------------
 //
 std::vector<int> LatticeMap::neighbourIndices(const int index,
@@ -52,100 +144,126 @@ std::vector<int> LatticeMap::neighbourIndices(const int index,
 {
     // {{{
 
-    // PERFORMME
+    std::vector<int> neighbours;
+    const IndexSpan span = neighbourSpan(index, shells, neighbours);
 
-    // Get the cell index.
-    CellIndex c;
-    indexToCell(index, c.i, c.j, c.k);
+    // Copy from the neighbour table if there is one.
+    if (hasNeighbourTable(shells))
+    {
+        neighbours.assign(span.begin(), span.end());
+    }
 
-    const CellIndex & cell = c;
+    return neighbours;
 
-    // Setup the return data structure.
-    const int n_neighbours = static_cast<int>(std::pow((2.0*shells + 1), 3) * n_basis_);
-    std::vector<int> neighbours(n_neighbours);
+    // }}}
+}
+
+
+// -----------------------------------------------------------------------------
+//
+IndexSpan LatticeMap::neighbourSpan(const int index,
+                                    const int shells,
+                                    std::vector<int> & buffer) const
+{
+    // {{{
 
-    // Get a pointer to the neighbours data for direct write access.
-    int* neighbours_ptr = &neighbours[0];
+    const std::map<int, NeighbourTable>::const_iterator it = \
+        neighbour_tables_.find(shells);
 
-    // A counter to know how much we have added.
-    int counter = 0;
+    IndexSpan span;
 
-    for (int i = cell.i - shells; i <= cell.i + shells; ++i)
+    if (it != neighbour_tables_.end())
     {
-        int ii = i;
-        // Handle periodicity.
-        if (periodic_[0])
-        {
-            if (ii < 0)
-            {
-                ii += repetitions_[0];
-            }
-            else if (ii >= repetitions_[0])
-            {
-                ii -= repetitions_[0];
-            }
-        }
-        // Go on only if i is within bounds.
-        if (ii >= 0 && ii < repetitions_[0])
+        // Point into the table.
+        const NeighbourTable & table = it->second;
+        const int cell = index / n_basis_;
+        span.first = table.neighbours.data() + table.offsets[cell];
+        span.last  = table.neighbours.data() + table.offsets[cell + 1];
+    }
+    else
+    {
+        // Calculate the neighbours into the buffer.
+        CellIndex cell;
+        indexToCell(index, cell.i, cell.j, cell.k);
+
+        buffer.clear();
+        appendNeighbourIndices(cell, shells, buffer);
+
+        span.first = buffer.data();
+        span.last  = buffer.data() + buffer.size();
+    }
+
+    return span;
+
+    // }}}
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void LatticeMap::initNeighbourTable(const int shells)
+{
+    // {{{
+
+    if (hasNeighbourTable(shells))
+    {
+        return;
+    }
+
+    const int width = 2 * shells + 1;
+    const int n_offsets = width * width * width;
+    const int n_cells = repetitions_[0] * repetitions_[1] * repetitions_[2];
+
+    // Skip tables too large to keep.
+    if (static_cast<size_t>(n_cells) * n_offsets * (n_basis_ + 1) > maxNeighbourTableSize())
+    {
+        return;
+    }
+
+    NeighbourTable table;
+    table.offsets.resize(n_cells + 1);
+    table.neighbours.reserve(static_cast<size_t>(n_cells) * n_offsets * n_basis_);
+    table.cell_indices.resize(static_cast<size_t>(n_cells) * n_offsets);
+
+    // Go through the cells in the order of their numbers.
+    for (int cell_number = 0; cell_number < n_cells; ++cell_number)
+    {
+        CellIndex cell;
+        cell_order_.cell(cell_number, cell.i, cell.j, cell.k);
+
+        table.offsets[cell_number] = table.neighbours.size();
+        appendNeighbourIndices(cell, shells, table.neighbours);
+
+        // The first index of the cell at each offset.
+        int * cell_indices = &table.cell_indices[cell_number * n_offsets];
+
+        for (int di = -shells; di <= shells; ++di)
         {
-            for (int j = cell.j - shells; j <= cell.j + shells; ++j)
+            const int ii = wrapCell(cell.i + di, 0);
+            for (int dj = -shells; dj <= shells; ++dj)
             {
-                int jj = j;
-                // Handle periodicity.
-                if (periodic_[1])
+                const int jj = wrapCell(cell.j + dj, 1);
+                for (int dk = -shells; dk <= shells; ++dk)
                 {
-                    if (jj < 0)
-                    {
-                        jj += repetitions_[1];
-                    }
-                    else if (jj >= repetitions_[1])
+                    const int kk = wrapCell(cell.k + dk, 2);
+
+                    if (ii < 0 || jj < 0 || kk < 0)
                     {
-                        jj -= repetitions_[1];
+                        *cell_indices = -1;
                     }
-                }
-                // Go on only if j is within bounds.
-                if (jj >= 0 && jj < repetitions_[1])
-                {
-                    for (int k = cell.k - shells; k <= cell.k + shells; ++k)
+                    else
                     {
-                        int kk = k;
-                        // Check that k is within bounds.
-                        if (periodic_[2])
-                        {
-                            if (kk < 0)
-                            {
-                                kk += repetitions_[2];
-                            }
-                            else if (kk >= repetitions_[2])
-                            {
-                                kk -= repetitions_[2];
-                            }
-                        }
-
-                        // Go on only if k is within bounds.
-                        if (0 <= kk && kk < repetitions_[2])
-                        {
-                            // Take a reference to the mapped data.
-                            const std::vector<int> && indices = indicesFromCell(ii,jj,kk);
-                            // Copy data over from the neighbour cell.
-                            size_t size = n_basis_ * sizeof(int);
-                            std::memcpy(neighbours_ptr, &indices[0], size);
-
-                            // Increment the pointer.
-                            neighbours_ptr += n_basis_;
-
-                            // Increment the counter.
-                            counter += n_basis_;
-                        }
+                        *cell_indices = firstIndex(ii, jj, kk);
                     }
+                    ++cell_indices;
                 }
             }
         }
     }
 
-    // Resize and return.
-    neighbours.resize(counter);
-    return neighbours;
+    table.offsets[n_cells] = table.neighbours.size();
+
+    std::swap(neighbour_tables_[shells], table);
 
     // }}}
 }
@@ -153,29 +271,92 @@ std::vector<int> LatticeMap::neighbourIndices(const int index,
 
 // -----------------------------------------------------------------------------
 //
-std::vector<int> LatticeMap::supersetNeighbourIndices(const std::vector<int> & indices,
-                                                      const int shells) const
+int LatticeMap::wrapCell(const int cell, const int direction) const
 {
-    // PERFORMME:
-    // We can use several different stategies here and this might
-    // be performance critical, thus we need to time it. So, for now,
-    // use the simplest possible naive implementation.
+    int wrapped = cell;
 
-    std::vector<int> superset;
+    // Handle periodicity.
+    if (periodic_[direction])
+    {
+        if (wrapped < 0)
+        {
+            wrapped += repetitions_[direction];
+        }
+        else if (wrapped >= repetitions_[direction])
+        {
+            wrapped -= repetitions_[direction];
+        }
+    }
 
-    for (size_t i = 0; i < indices.size(); ++i)
+    // Go on only if the cell is within bounds.
+    if (wrapped < 0 || wrapped >= repetitions_[direction])
     {
-        // Get the index.
-        const int index = indices[i];
+        return -1;
+    }
+
+    return wrapped;
+}
 
-        // And its neighbours.
-        const std::vector<int> neighbours = neighbourIndices(index, shells);
 
-        // Add its neighbourlist to the superset.
-        for (size_t j = 0; j < neighbours.size(); ++j)
+// -----------------------------------------------------------------------------
+//
+void LatticeMap::appendNeighbourIndices(const CellIndex & cell,
+                                        const int shells,
+                                        std::vector<int> & neighbours) const
+{
+    // {{{
+
+    for (int i = cell.i - shells; i <= cell.i + shells; ++i)
+    {
+        const int ii = wrapCell(i, 0);
+        if (ii < 0)
         {
-            superset.push_back(neighbours[j]);
+            continue;
         }
+
+        for (int j = cell.j - shells; j <= cell.j + shells; ++j)
+        {
+            const int jj = wrapCell(j, 1);
+            if (jj < 0)
+            {
+                continue;
+            }
+
+            for (int k = cell.k - shells; k <= cell.k + shells; ++k)
+            {
+                const int kk = wrapCell(k, 2);
+                if (kk < 0)
+                {
+                    continue;
+                }
+
+                // Add the indices of the neighbour cell.
+                const int first = firstIndex(ii, jj, kk);
+                for (int l = 0; l < n_basis_; ++l)
+                {
+                    neighbours.push_back(first + l);
+                }
+            }
+        }
+    }
+
+    // }}}
+}
+
+
+// -----------------------------------------------------------------------------
+//
+std::vector<int> LatticeMap::supersetNeighbourIndices(const std::vector<int> & indices,
+                                                      const int shells) const
+{
+    std::vector<int> superset;
+    std::vector<int> buffer;
+
+    for (size_t i = 0; i < indices.size(); ++i)
+    {
+        // Add the neighbours of the index to the superset.
+        const IndexSpan neighbours = neighbourSpan(indices[i], shells, buffer);
+        superset.insert(superset.end(), neighbours.begin(), neighbours.end());
     }
 
     // Sort the superset.
@@ -198,13 +379,11 @@ const std::vector<int> LatticeMap::indicesFromCell(const int i,
     std::vector<int> cell_indices(n_basis_, 0);
 
     // Get the indices that are in cell i,j,k.
-    const int tmp1 = i * repetitions_[1] + j;
-    const int tmp2 = tmp1 * repetitions_[2] + k;
-    const int tmp3 = tmp2 * n_basis_;
+    const int first = firstIndex(i, j, k);
 
     for (int l = 0; l < n_basis_; ++l)
     {
-        cell_indices[l] = tmp3 + l;
+        cell_indices[l] = first + l;
     }
 
     return cell_indices;
@@ -220,7 +399,26 @@ int LatticeMap::indexFromMoveInfo(const int index,
                                   const int basis) const
 {
     // {{{
-    // PERFORMME
+
+    const int basis_index = basis + basisSiteFromIndex(index);
+
+    // Look the cell up in the smallest neighbour table covering the move.
+    const int shells = std::max(std::abs(i), std::max(std::abs(j), std::abs(k)));
+    const std::map<int, NeighbourTable>::const_iterator it = \
+        neighbour_tables_.lower_bound(shells);
+
+    if (it != neighbour_tables_.end())
+    {
+        const int s = it->first;
+        const int width = 2 * s + 1;
+        const int offset = ((i + s) * width + (j + s)) * width + (k + s);
+        const int first = it->second.cell_indices[(index / n_basis_) * width * width * width + offset];
+
+        if (first >= 0)
+        {
+            return first + basis_index;
+        }
+    }
 
     // Find out which cell the index is in.
     int cell_i, cell_j, cell_k;
@@ -268,10 +466,9 @@ int LatticeMap::indexFromMoveInfo(const int index,
         }
     }
 
-    // Get the indices in the wrapped cell and return the
+    // Get the first index in the wrapped cell and return the
     // index at the given relative basis position.
-    const int basis_index = basis + basisSiteFromIndex(index);
-    return indicesFromCell(cell_i, cell_j, cell_k)[basis_index];
+    return firstIndex(cell_i, cell_j, cell_k) + basis_index;
 
     // }}}
 }
@@ -285,30 +482,32 @@ void LatticeMap::indexToCell(const int index,
                              int & cell_k) const
 {
     // {{{
-    // Given an index, calculate the cell i,j,k.
-    const double eps   = 1.0e-9;
-    const int idx      = index / n_basis_ + 1;
-    const int factor_i = repetitions_[1] * repetitions_[2];
-    const int ii       = static_cast<int>((idx - eps) / factor_i);
-
-    const int ci       = ii * factor_i;
-    const int factor_j = repetitions_[2];
-    const int idx_j    = idx - ci;
-    const int jj       = static_cast<int>((idx_j - eps) / factor_j);
-
-    const int cij      = ci + jj * factor_j;
-    const int idx_k    = idx - cij;
-    const int kk       = static_cast<int>(idx_k - eps);
-
-    // Set the result.
-    cell_i = ii;
-    cell_j = jj;
-    cell_k = kk;
+    // Given an index, get the cell i,j,k from the cell number.
+    cell_order_.cell(index / n_basis_, cell_i, cell_j, cell_k);
 
     // }}}
 }
 
 
+// -----------------------------------------------------------------------------
+//
+void LatticeMap::wrap(double * values,
+                      const size_t n,
+                      const int direction) const
+{
+    const double length = repetitions_[direction];
+    const double half_cell = 1.0 * repetitions_[direction] / 2.0;
+
+    // Both conditions are taken on the unwrapped value, as at most one of
+    // them holds, and select the shift without branching.
+    for (size_t i = 0; i < n; ++i)
+    {
+        const double value = values[i];
+        values[i] = value - length * (value >= half_cell) + length * (value < -half_cell);
+    }
+}
+
+
 // -----------------------------------------------------------------------------
 //
 std::vector<SubLatticeMap> LatticeMap::split(int nx, int ny, int nz) const
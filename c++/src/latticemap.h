@@ -38,6 +38,85 @@ struct CellIndex {
 };
 
 
+// A minimal struct for a read only view of a contiguous range of indices.
+struct IndexSpan {
+    // The first index.
+    const int * first;
+    // One past the last index.
+    const int * last;
+
+    const int * begin() const { return first; }
+    const int * end() const { return last; }
+    size_t size() const { return last - first; }
+    int operator[](const size_t i) const { return first[i]; }
+};
+
+
+/// Class for the numbering of the cells of a lattice, either in row-major
+/// (i, j, k) order or along a Morton (Z-order) curve through the cells.
+class CellOrder {
+
+public:
+
+    /*! \brief Default constructor, for a single cell.
+     */
+    CellOrder();
+
+    /*! \brief Constructor.
+     *  \param repetitions : The number of repetitions along the a, b and c axes.
+     *  \param morton      : If the cells should be numbered along a Morton curve.
+     */
+    CellOrder(const std::vector<int> & repetitions,
+              const bool morton);
+
+    /*! \brief Get the number of a cell.
+     *  \param i : The cell index in the a direction.
+     *  \param j : The cell index in the b direction.
+     *  \param k : The cell index in the c direction.
+     *  \return : The cell number.
+     */
+    int number(const int i, const int j, const int k) const
+    {
+        const int cell = (i * repetitions_j_ + j) * repetitions_k_ + k;
+        return numbers_.empty() ? cell : numbers_[cell];
+    }
+
+    /*! \brief Get the cell with a given number.
+     *  \param number : The cell number.
+     *  \param i (out): The cell index in the a direction.
+     *  \param j (out): The cell index in the b direction.
+     *  \param k (out): The cell index in the c direction.
+     */
+    void cell(const int number, int & i, int & j, int & k) const
+    {
+        const int cell = cells_.empty() ? number : cells_[number];
+        k = cell % repetitions_k_;
+        j = (cell / repetitions_k_) % repetitions_j_;
+        i = cell / (repetitions_k_ * repetitions_j_);
+    }
+
+    /*! \brief Query for the Morton order.
+     *  \return : True if the cells are numbered along a Morton curve.
+     */
+    bool morton() const { return !cells_.empty(); }
+
+protected:
+
+private:
+
+    /// The number of repetitions along the b and c directions.
+    int repetitions_j_;
+    int repetitions_k_;
+
+    /// The number of each cell by its row-major number, empty in row-major order.
+    std::vector<int> numbers_;
+
+    /// The row-major number of each cell by its number, empty in row-major order.
+    std::vector<int> cells_;
+
+};
+
+
 // Forward declarations.
 class Configuration;
 class SubLatticeMap;
@@ -51,10 +130,14 @@ public:
      *  \param n_basis     : The number of basis points.
      *  \param repetitions : The number of repetitions along the a, b and c axes.
      *  \param periodic    : Indicating periodicity along the a, b and c axes.
+     *  \param morton_order: If the cells are ordered along a Morton curve
+     *                       instead of in row-major order, to keep the
+     *                       indices of nearby cells close in memory.
      */
     LatticeMap(const int n_basis,
                const std::vector<int> repetitions,
-               const std::vector<bool> periodic);
+               const std::vector<bool> periodic,
+               const bool morton_order = false);
 
     /*! \brief Destructor for map.
      */
@@ -68,6 +151,40 @@ public:
      */
     std::vector<int> neighbourIndices(const int index, const int shells=1) const;
 
+    /*! \brief Get a view of the neighbouring indices of a given index, in the
+     *         same order as neighbourIndices(). The view points into the
+     *         neighbour table if one is set up for the number of shells, and
+     *         into the buffer otherwise.
+     *  \param index  : The index to query for.
+     *  \param shells : The number of shells to include.
+     *  \param buffer : Storage for the indices if there is no neighbour table.
+     *  \return : The view of the indices, valid until the buffer or the
+     *            neighbour tables are changed.
+     */
+    IndexSpan neighbourSpan(const int index,
+                            const int shells,
+                            std::vector<int> & buffer) const;
+
+    /*! \brief Setup the table of neighbouring indices of all cells for the
+     *         given number of shells, used by the neighbour queries from then
+     *         on. The table is not set up if it would be larger than
+     *         maxNeighbourTableSize().
+     *  \param shells : The number of shells to set up the table for.
+     */
+    void initNeighbourTable(const int shells);
+
+    /*! \brief Query for a neighbour table being set up.
+     *  \param shells : The number of shells.
+     *  \return : True if there is a neighbour table for the number of shells.
+     */
+    bool hasNeighbourTable(const int shells) const
+    { return neighbour_tables_.find(shells) != neighbour_tables_.end(); }
+
+    /*! \brief Query for the largest number of indices in a neighbour table.
+     *  \return : The maximum number of indices.
+     */
+    static size_t maxNeighbourTableSize() { return 1 << 26; }
+
     /*! \brief Get the unique neighbouring indices of a set of given indices.
      *  \param indices : The vector of indices to get the neighbours for.
      *  \return : The list of indices.
@@ -110,6 +227,17 @@ public:
                      int & cell_j,
                      int & cell_k) const;
 
+    /*! \brief Query for the cell ordering.
+     *  \return : The numbering of the cells.
+     */
+    const CellOrder & cellOrder() const { return cell_order_; }
+
+    /*! \brief Get the row-major index of each index, i.e. the index the
+     *         site would have with the cells in row-major order.
+     *  \return : The row-major index of each index.
+     */
+    std::vector<int> rowMajorIndices() const;
+
     /*! \brief Get the basis site for a given index.
      *  \param index: The index get the basis site for.
      *  \return: The basis site for this index.
@@ -171,6 +299,15 @@ public:
     inline
     void wrap(Coordinate & c, const int direction) const;
 
+    /*! \brief Wrap a block of coordinate components in the given direction,
+     *         with the same result as wrap() in that direction for each
+     *         component, in a loop without branches.
+     *  \param values (in/out): The coordinate components to wrap.
+     *  \param n              : The number of components.
+     *  \param direction      : The direction to wrap.
+     */
+    void wrap(double * values, const size_t n, const int direction) const;
+
     /*! \brief Split lattice to sub-lattice.
      *  \param nx : Split number on x axis.
      *  \param ny : Split number on y axis.
@@ -183,12 +320,57 @@ protected:
 
 private:
 
+    /// The neighbour indices of all cells for a number of shells.
+    struct NeighbourTable {
+
+        /// The start of the neighbours of each cell, and the total size last.
+        std::vector<int> offsets;
+
+        /// The neighbour indices of all cells after each other.
+        std::vector<int> neighbours;
+
+        /// The first index of the cell at each cell offset in the range of
+        /// each cell, -1 if the cell is outside a non-periodic lattice.
+        std::vector<int> cell_indices;
+
+    };
+
+    /*! \brief Get the wrapped cell index in a direction.
+     *  \param cell      : The cell index, possibly outside the lattice.
+     *  \param direction : The direction.
+     *  \return : The wrapped cell index, or -1 if the cell is outside a
+     *            non-periodic lattice.
+     */
+    int wrapCell(const int cell, const int direction) const;
+
+    /*! \brief Add the neighbouring indices of a cell to a vector.
+     *  \param cell       : The cell to add the neighbours for.
+     *  \param shells     : The number of shells to include.
+     *  \param neighbours : (in/out) The vector to add the neighbours to.
+     */
+    void appendNeighbourIndices(const CellIndex & cell,
+                                const int shells,
+                                std::vector<int> & neighbours) const;
+
+    /*! \brief Get the first index of a cell.
+     *  \param i : The cell index in the a direction.
+     *  \param j : The cell index in the b direction.
+     *  \param k : The cell index in the c direction.
+     *  \return : The index of the first basis site in the cell.
+     */
+    int firstIndex(const int i, const int j, const int k) const
+    { return cell_order_.number(i, j, k) * n_basis_; }
+
     /// The number of basis points in the elemntary unitcell.
     int n_basis_;
     /// The number of repetitions along the a, b and c directions.
     std::vector<int> repetitions_;
     /// The periodicity in the a, b and c directions.
     std::vector<bool> periodic_;
+    /// The numbering of the cells.
+    CellOrder cell_order_;
+    /// The neighbour tables by number of shells.
+    std::map<int, NeighbourTable> neighbour_tables_;
 };
 
 
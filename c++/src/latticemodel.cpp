@@ -26,8 +26,10 @@
 #include "simulationtimer.h"
 #include "random.h"
 #include "sitesmap.h"
+#include "checkpoint.h"
 
 #include <cstdio>
+#include <fstream>
 
 // -----------------------------------------------------------------------------
 //
@@ -40,8 +42,14 @@ LatticeModel::LatticeModel(Configuration & configuration,
     sitesmap_(sitesmap),
     simulation_timer_(simulation_timer),
     lattice_map_(lattice_map),
-    interactions_(interactions)
+    interactions_(interactions),
+    step_(0),
+    use_random_stream_(false)
 {
+    // Setup the neighbour tables for the re-matching and the distributor.
+    lattice_map_.initNeighbourTable(interactions_.maxRange());
+    lattice_map_.initNeighbourTable(1);
+
     // Setup the mapping between coordinates and processes.
     calculateInitialMatching();
 
@@ -55,7 +63,114 @@ LatticeModel::LatticeModel(Configuration & configuration,
 
 // -----------------------------------------------------------------------------
 //
-void LatticeModel::calculateInitialMatching()
+LatticeModel::LatticeModel(Configuration & configuration,
+                           SitesMap & sitesmap,
+                           SimulationTimer & simulation_timer,
+                           const LatticeMap & lattice_map,
+                           Interactions & interactions,
+                           const std::string & checkpoint_file) :
+    configuration_(configuration),
+    sitesmap_(sitesmap),
+    simulation_timer_(simulation_timer),
+    lattice_map_(lattice_map),
+    interactions_(interactions),
+    step_(0),
+    use_random_stream_(false)
+{
+    // {{{
+    std::ifstream stream(checkpoint_file.c_str(), std::ios::binary);
+    if (!stream)
+    {
+        throw std::runtime_error("Could not open the checkpoint file " + checkpoint_file + ".");
+    }
+
+    // Check the header.
+    char magic[sizeof(CHECKPOINT_MAGIC)];
+    stream.read(magic, sizeof(magic));
+    if (!stream || !std::equal(magic, magic + sizeof(magic), CHECKPOINT_MAGIC))
+    {
+        throw std::runtime_error(checkpoint_file + " is not a KMCLib checkpoint file.");
+    }
+
+    int32_t version;
+    readBinary(stream, version);
+    if (version != CHECKPOINT_VERSION)
+    {
+        throw std::runtime_error("Unsupported checkpoint format version in " + checkpoint_file + ".");
+    }
+
+    // Setup the neighbour tables and the match lists as at construction.
+    lattice_map_.initNeighbourTable(interactions_.maxRange());
+    lattice_map_.initNeighbourTable(1);
+    setupMatchLists();
+
+    // Restore the types, and the state the rate calculator keeps of them.
+    configuration_.readCheckpoint(stream);
+    interactions_.rateCalculator().initLocalState(configuration_, interactions_.processes());
+
+    // Restore the matched sites instead of matching them again.
+    interactions_.readCheckpoint(stream);
+
+    simulation_timer_.readCheckpoint(stream);
+
+    // Continue the step counter the analysis plugins are scheduled by.
+    int32_t step;
+    readBinary(stream, step);
+    step_ = step;
+
+    readRandomState(stream);
+
+    // Restore the random stream of the model, if any.
+    char use_random_stream;
+    readBinary(stream, use_random_stream);
+    if (use_random_stream)
+    {
+        random_stream_.readState(stream);
+        use_random_stream_ = true;
+        distributor_.setRandomStream(&random_stream_);
+    }
+    // }}}
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void LatticeModel::writeCheckpoint(const std::string & checkpoint_file) const
+{
+    // {{{
+    std::ofstream stream(checkpoint_file.c_str(), std::ios::binary);
+    if (!stream)
+    {
+        throw std::runtime_error("Could not open the checkpoint file " + checkpoint_file + ".");
+    }
+
+    stream.write(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+    writeBinary(stream, CHECKPOINT_VERSION);
+
+    configuration_.writeCheckpoint(stream);
+    interactions_.writeCheckpoint(stream);
+    simulation_timer_.writeCheckpoint(stream);
+    writeBinary(stream, static_cast<int32_t>(step_));
+    writeRandomState(stream);
+
+    writeBinary(stream, static_cast<char>(use_random_stream_));
+    if (use_random_stream_)
+    {
+        random_stream_.writeState(stream);
+    }
+
+    stream.close();
+    if (!stream)
+    {
+        throw std::runtime_error("Could not write the checkpoint file " + checkpoint_file + ".");
+    }
+    // }}}
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void LatticeModel::setupMatchLists()
 {
     // Calculate the match lists of configuration.
     configuration_.initMatchLists(lattice_map_, interactions_.maxRange());
@@ -66,10 +181,28 @@ void LatticeModel::calculateInitialMatching()
     // Update the interactions matchlists.
     interactions_.updateProcessMatchLists(configuration_, lattice_map_);
 
+    // Compile the interactions matchlists for matching on types only.
+    interactions_.compileProcessMatchLists(configuration_, lattice_map_);
+
+    // Setup the process stencils for finding the pairs to re-match.
+    dependency_index_.init(interactions_, configuration_, lattice_map_);
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void LatticeModel::calculateInitialMatching()
+{
+    // Setup the match lists and the process dependencies.
+    setupMatchLists();
+
+    // Setup the state the rate calculator keeps of the configuration.
+    interactions_.rateCalculator().initLocalState(configuration_, interactions_.processes());
+
     // Match all centeres.
     std::vector<int> indices;
 
-    for(size_t i = 0; i < configuration_.elements().size(); ++i)
+    for(size_t i = 0; i < configuration_.types().size(); ++i)
     {
         indices.push_back(i);
     }
@@ -85,34 +218,111 @@ void LatticeModel::calculateInitialMatching()
 //
 void LatticeModel::singleStep()
 {
-    // Select a process.
-    Process & process = (*interactions_.pickProcess());
+    // Select a process and a site, drawing from the random stream of the
+    // model if it has one.
+    Process & process = use_random_stream_ ? \
+        (*interactions_.pickProcess(random_stream_)) : (*interactions_.pickProcess());
 
-    // Select a site.
-    const int site_index = process.pickSite();
+    const int site_index = use_random_stream_ ? \
+        process.pickSite(random_stream_) : process.pickSite();
 
     // Perform the operation.
     configuration_.performProcess(process, site_index);
 
+    // Let the rate calculator follow the changed types.
+    interactions_.rateCalculator().updateLocalState(configuration_, process.affectedIndices());
+
     // Propagate the time.
-    simulation_timer_.propagateTime(interactions_.totalRate());
+    if (use_random_stream_)
+    {
+        simulation_timer_.propagateTime(interactions_.totalRate(), random_stream_);
+    }
+    else
+    {
+        simulation_timer_.propagateTime(interactions_.totalRate());
+    }
 
-    // Run the re-matching of the affected sites and their neighbours.
-    const std::vector<int> && indices = \
-        lattice_map_.supersetNeighbourIndices(process.affectedIndices(),
-                                              interactions_.maxRange());
+    // Run the re-matching of the processes reading the affected sites.
+    dependency_index_.indexProcessToMatch(process.affectedIndices(),
+                                          interactions_,
+                                          configuration_,
+                                          sitesmap_,
+                                          index_process_to_match_);
 
     matcher_.calculateMatching(interactions_,
                                configuration_,
-                               sitesmap_,
-                               lattice_map_,
-                               indices);
+                               index_process_to_match_);
 
-    // Update the interactions' probability table.
-    interactions_.updateProbabilityTable();
+    // Update the interactions' probabilities and process available sites
+    // for the processes changed by the re-matching.
+    interactions_.updateMarkedProcesses();
 
-    // Update the interactions' process available sites.
-    interactions_.updateProcessAvailableSites();
+    // Call the analysis plugins scheduled for this step.
+    ++step_;
+    const double time = simulation_timer_.simulationTime();
+
+    for (size_t i = 0; i < analysis_plugins_.size(); ++i)
+    {
+        AnalysisPlugin & plugin = *analysis_plugins_[i];
+        if (plugin.due(step_, time))
+        {
+            plugin.registerStep(step_,
+                                time,
+                                simulation_timer_.deltaTime(),
+                                process,
+                                site_index,
+                                configuration_);
+        }
+    }
+}
+
+
+// ----------------------------------------------------------------------------
+//
+void LatticeModel::addAnalysisPlugin(AnalysisPlugin & plugin)
+{
+    analysis_plugins_.push_back(&plugin);
+}
+
+
+// ----------------------------------------------------------------------------
+//
+void LatticeModel::setRandomStream(const int seed, const int stream)
+{
+    random_stream_.seed(static_cast<uint32_t>(seed), static_cast<uint32_t>(stream));
+    use_random_stream_ = true;
+    distributor_.setRandomStream(&random_stream_);
+}
+
+
+// ----------------------------------------------------------------------------
+//
+void LatticeModel::clearRandomStream()
+{
+    use_random_stream_ = false;
+    distributor_.setRandomStream(NULL);
+}
+
+
+// ----------------------------------------------------------------------------
+//
+int LatticeModel::run(const int n_steps, const double time_limit)
+{
+    int step = 0;
+
+    // Take the steps as long as there is a process to perform.
+    while (step < n_steps && interactions_.availableSites() > 0)
+    {
+        singleStep();
+        ++step;
+
+        if (simulation_timer_.simulationTime() > time_limit)
+        {
+            break;
+        }
+    }
+
+    return step;
 }
 
 // ----------------------------------------------------------------------------
@@ -135,10 +345,14 @@ LatticeModel::redistribute(const std::vector<std::string> & fast_species,
     const std::vector<int> affected_indices = \
         distributor_.constrainedRedistribute(configuration_, lattice_map_, x, y, z);
 
+    // Setup the state of the rate calculator again for the new configuration.
+    interactions_.rateCalculator().initLocalState(configuration_, interactions_.processes());
+
     // Run the re-matching of the affected sites and their neighbours.
-    const std::vector<int> && indices = \
-        lattice_map_.supersetNeighbourIndices(affected_indices,
-                                              interactions_.maxRange());
+    const std::vector<int> & indices = \
+        superset_builder_.build(lattice_map_,
+                                affected_indices,
+                                interactions_.maxRange());
 
     matcher_.calculateMatching(interactions_,
                                configuration_,
@@ -186,10 +400,14 @@ LatticeModel::processRedistribute(const std::string & replace_elements,
                                                     x, y, z,
                                                     metropolis_acceptance);
 
+    // Setup the state of the rate calculator again for the new configuration.
+    interactions_.rateCalculator().initLocalState(configuration_, interactions_.processes());
+
     // Run the re-matching of the affected sites and their neighbors.
-    const std::vector<int> && indices = \
-        lattice_map_.supersetNeighbourIndices(affected_indices,
-                                              interactions_.maxRange());
+    const std::vector<int> & indices = \
+        superset_builder_.build(lattice_map_,
+                                affected_indices,
+                                interactions_.maxRange());
 
     matcher_.calculateMatching(interactions_,
                                configuration_,
@@ -28,7 +28,11 @@
 #include "latticemap.h"
 #include "interactions.h"
 #include "matcher.h"
+#include "supersetbuilder.h"
 #include "distributor.h"
+#include "dependencyindex.h"
+#include "analysisplugin.h"
+#include "random.h"
 
 // Forward declarations.
 class Configuration;
@@ -54,10 +58,86 @@ public:
                  const LatticeMap & lattice_map,
                  Interactions & interactions);
 
+    /*! \brief Constructor for restarting a model from a checkpoint file,
+     *         restoring the state written by writeCheckpoint() without
+     *         re-matching the processes.
+     *  \param configuration    : The configuration the checkpoint was written
+     *                            for, to restore the types of.
+     *  \param sitesmap         : The sites map of the model.
+     *  \param simulation_timer : The timer, to restore the time of.
+     *  \param lattice_map      : A lattice map object describing the lattice.
+     *  \param interactions     : The interactions the checkpoint was written
+     *                            for, to restore the process sites and rates of.
+     *  \param checkpoint_file  : The name of the checkpoint file to read.
+     */
+    LatticeModel(Configuration & configuration,
+                 SitesMap & sitesmap,
+                 SimulationTimer & simulation_timer,
+                 const LatticeMap & lattice_map,
+                 Interactions & interactions,
+                 const std::string & checkpoint_file);
+
     /*! \brief Function for taking one time step in the KMC lattice model.
      */
     void singleStep();
 
+    /*! \brief Function for taking a number of time steps in a row, without
+     *         returning to the caller in between.
+     *  \param n_steps    : The largest number of steps to take.
+     *  \param time_limit : The steps stop after the first step that takes
+     *                      the simulation time past this limit.
+     *  \return : The number of steps taken, less than n_steps if the time
+     *            limit was passed or if no process was available for the
+     *            next step.
+     */
+    int run(const int n_steps, const double time_limit);
+
+    /*! \brief Write the state of the model to a binary checkpoint file: the
+     *         types and atom ids of the configuration, the sites and rates
+     *         of every process, the simulation time, the step counter and
+     *         the state of the random number generator.
+     *  \param checkpoint_file : The name of the checkpoint file to write.
+     */
+    void writeCheckpoint(const std::string & checkpoint_file) const;
+
+    /*! \brief Add a native analysis plugin, called directly after each
+     *         step it is scheduled for. The plugin is not owned by the model.
+     *  \param plugin : The analysis plugin to add.
+     */
+    void addAnalysisPlugin(AnalysisPlugin & plugin);
+
+    /*! \brief Remove all native analysis plugins from the model.
+     */
+    void clearAnalysisPlugins() { analysis_plugins_.clear(); }
+
+    /*! \brief Set the step counter the analysis plugins are scheduled by.
+     *  \param step : The number of the last step taken.
+     */
+    void setStep(const int step) { step_ = step; }
+
+    /*! \brief Query for the step counter, increased by one at each step.
+     *  \return : The number of the last step taken.
+     */
+    int step() const { return step_; }
+
+    /*! \brief Draw the random numbers of the steps and redistributions
+     *         from a counter based random stream of the model instead of
+     *         the global generator. Models given different stream ids,
+     *         e.g. replicas, draw independent reproducible sequences.
+     *  \param seed   : The seed of the stream.
+     *  \param stream : The id of the stream.
+     */
+    void setRandomStream(const int seed, const int stream);
+
+    /*! \brief Go back to drawing from the global random number generator.
+     */
+    void clearRandomStream();
+
+    /*! \brief Query for if the model draws from its own random stream.
+     *  \return : True if a random stream is set.
+     */
+    bool hasRandomStream() const { return use_random_stream_; }
+
     /*! \brief Function for redistributing configuration completely randomly
      *                  in KMC iteration.
      *  \param fast_species : The list of default fast species.
@@ -116,6 +196,11 @@ private:
      *         processes with all indices in the configuration.
      */
     void calculateInitialMatching();
+
+    /*! \brief Private helper function to setup the match lists and the
+     *         process dependencies, which do not depend on the types.
+     */
+    void setupMatchLists();
     
     /// A reference to the configuration given at construction.
     Configuration & configuration_;
@@ -137,6 +222,27 @@ private:
 
     /// The random Distributor for re-distributing configuration.
     ConstrainedRandomDistributor distributor_;
+
+    /// The reverse process dependencies used to find the pairs to re-match.
+    DependencyIndex dependency_index_;
+
+    /// The pairs of indices and processes to re-match after a step.
+    std::vector<std::pair<int, int> > index_process_to_match_;
+
+    /// The builder of the neighbourhoods to re-match after a redistribution.
+    SupersetBuilder superset_builder_;
+
+    /// The native analysis plugins, called after the steps.
+    std::vector<AnalysisPlugin *> analysis_plugins_;
+
+    /// The number of the last step taken.
+    int step_;
+
+    /// If the model draws from its own random stream.
+    bool use_random_stream_;
+
+    /// The random stream of the model.
+    CounterRandom random_stream_;
 };
 
 
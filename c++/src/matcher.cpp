@@ -25,7 +25,10 @@
 
 #include <cstdio>
 #include <algorithm>
+#include <exception>
 #include <memory>
+#include <map>
+#include <stdexcept>
 
 #ifdef DEBUG
 #include <iostream>
@@ -39,10 +42,291 @@
 #include "latticemap.h"
 #include "matchlist.h"
 #include "sitesmap.h"
+#include "ratecalculator.h"
 
 #include "mpicommons.h"
 #include "mpiroutines.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+
+// -----------------------------------------------------------------------------
+// The number of loop iterations below which the threads are not started,
+// as for the few pairs re-matched after a typical step.
+//
+static const int min_parallel_size__ = 2048;
+
+
+// -----------------------------------------------------------------------------
+// The maximum number of threads a parallel region in the matcher may use.
+//
+static int maxThreads()
+{
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+
+// -----------------------------------------------------------------------------
+// The number of the calling thread in the current parallel region.
+//
+static int threadNumber()
+{
+#ifdef _OPENMP
+    return omp_get_thread_num();
+#else
+    return 0;
+#endif
+}
+
+
+// -----------------------------------------------------------------------------
+// Append the per thread buffers in thread order. With a static schedule
+// each thread holds one contiguous chunk of the loop and the chunks are
+// given out in thread order, so the result is the same as for a serial loop.
+//
+template <class T>
+static void joinThreadBuffers(std::vector< std::vector<T> > & thread_buffers,
+                              std::vector<T> & result)
+{
+    size_t size = result.size();
+    for (size_t i = 0; i < thread_buffers.size(); ++i)
+    {
+        size += thread_buffers[i].size();
+    }
+    result.reserve(size);
+
+    for (size_t i = 0; i < thread_buffers.size(); ++i)
+    {
+        result.insert(result.end(), thread_buffers[i].begin(), thread_buffers[i].end());
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Get the number of sites within the cutoff from the sorted distances.
+//
+static int cutoffLength(const std::vector<double> & distances,
+                        const double cutoff)
+{
+    return std::upper_bound(distances.begin(), distances.end(), cutoff) - distances.begin();
+}
+
+
+// -----------------------------------------------------------------------------
+// Get the types after the process, 0 where unchanged, taken from the match
+// list into the buffer if it was not compiled.
+//
+static const std::vector<int> & processUpdateTypes(const Process & process,
+                                                   std::vector<int> & buffer)
+{
+    if (process.hasCompiledMatchList())
+    {
+        return process.updateTypes();
+    }
+
+    const ProcessMatchList & process_match_list = process.matchList();
+    buffer.assign(process_match_list.size(), 0);
+
+    for (size_t i = 0; i < process_match_list.size(); ++i)
+    {
+        if (process_match_list[i].update_type != process_match_list[i].match_type)
+        {
+            buffer[i] = process_match_list[i].update_type;
+        }
+    }
+
+    return buffer;
+}
+
+
+// -----------------------------------------------------------------------------
+// Calculate the rates of the given tasks with a single call to the batch
+// callback of the rate calculator, with the data of all tasks after each
+// other in contiguous arrays.
+//
+static void updateBatchRates(std::vector<double> & new_rates,
+                             const std::vector<RateTask> & tasks,
+                             const std::vector<int> & to_calculate,
+                             const std::vector<int> & lengths,
+                             const std::vector<Process *> & processes,
+                             const Configuration & configuration,
+                             const RateCalculator & rate_calculator)
+{
+    // {{{
+
+    const int n_calculate = to_calculate.size();
+    const std::vector<int> & types = configuration.types();
+
+    int n_sites = 0;
+    for (int j = 0; j < n_calculate; ++j)
+    {
+        n_sites += lengths[to_calculate[j]];
+    }
+
+    std::vector<double> geometry;
+    std::vector<int> batch_lengths(n_calculate);
+    std::vector<int> types_before;
+    std::vector<int> types_after;
+    std::vector<double> rate_constants(n_calculate);
+    std::vector<int> process_numbers(n_calculate);
+    std::vector<double> global_coordinates(3*n_calculate);
+
+    geometry.reserve(3*n_sites);
+    types_before.reserve(n_sites);
+    types_after.reserve(n_sites);
+
+    std::vector<int> indices;
+    std::vector<int> update_types_buffer;
+
+    for (int j = 0; j < n_calculate; ++j)
+    {
+        const int i       = to_calculate[j];
+        const int index   = tasks[i].index;
+        const int len     = lengths[i];
+        const Process & process = (*processes[tasks[i].process]);
+
+        const std::vector<double> & coordinates = \
+            configuration.neighbourhoods().geometryArrays(index).coordinates;
+        geometry.insert(geometry.end(), coordinates.begin(), coordinates.begin() + 3*len);
+
+        configuration.matchListIndices(index, indices);
+        const std::vector<int> & update_types = processUpdateTypes(process, update_types_buffer);
+        const int n_update = std::min(len, static_cast<int>(update_types.size()));
+
+        for (int k = 0; k < len; ++k)
+        {
+            const int type_before = types[indices[k]];
+            const int update_type = k < n_update ? update_types[k] : 0;
+            types_before.push_back(type_before);
+            types_after.push_back(update_type > 0 ? update_type : type_before);
+        }
+
+        const Coordinate & global_coordinate = configuration.coordinates()[index];
+
+        batch_lengths[j]           = len;
+        rate_constants[j]          = process.rateConstant();
+        process_numbers[j]         = process.processNumber();
+        global_coordinates[3*j]    = global_coordinate.x();
+        global_coordinates[3*j+1]  = global_coordinate.y();
+        global_coordinates[3*j+2]  = global_coordinate.z();
+    }
+
+    const std::vector<double> rates = \
+        rate_calculator.backendBatchRateCallback(geometry,
+                                                 batch_lengths,
+                                                 types_before,
+                                                 types_after,
+                                                 rate_constants,
+                                                 process_numbers,
+                                                 global_coordinates);
+
+    if (static_cast<int>(rates.size()) != n_calculate)
+    {
+        throw std::runtime_error("The batch rate callback must return one rate for each task.");
+    }
+
+    for (int j = 0; j < n_calculate; ++j)
+    {
+        new_rates[to_calculate[j]] = rates[j];
+    }
+
+    // }}}
+}
+
+
+// -----------------------------------------------------------------------------
+// Append the pairs of an index with the given processes, in the given order,
+// leaving out the processes not matching the site types.
+//
+static void appendCandidates(const int index,
+                             const std::vector<int> & process_indices,
+                             const std::vector<Process *> & process_ptrs,
+                             const SitesMap & sitesmap,
+                             std::vector<std::pair<int, int> > & pairs)
+{
+    // {{{
+
+    // The site match list is constructed when first needed.
+    SiteMatchList site_matchlist;
+
+    for (size_t j = 0; j < process_indices.size(); ++j)
+    {
+        // Pick out the process.
+        const int process_index = process_indices[j];
+        const Process * process_ptr = process_ptrs[process_index];
+
+        // Check if process site types is set.
+        if (process_ptr->hasSiteTypes())
+        {
+            // Get process match list.
+            const ProcessMatchList & process_matchlist = process_ptr->matchList();
+
+            if (site_matchlist.empty())
+            {
+                site_matchlist = sitesmap.matchList(index);
+            }
+
+            // Check if the process matches with site types.
+            bool is_match = whateverMatch(process_matchlist, site_matchlist);
+
+            if (is_match)
+            {
+                // Register the candidate.
+                pairs.push_back(std::pair<int, int>(index, process_index));
+            }
+        }
+        else
+        {
+            // Register the candidate.
+            pairs.push_back(std::pair<int, int>(index, process_index));
+        }
+    }
+
+    // }}}
+}
+
+
+// -----------------------------------------------------------------------------
+// Get the rate cache key of a task: the process, the neighbourhood template
+// and the types of the len sites within the cutoff of the process. All
+// sites of a regular lattice have a template, also at the non-periodic
+// boundaries. Sites without one, on an irregular lattice, have no key as
+// their geometry is not shared, and their rates are always calculated.
+//
+static bool rateCacheKey(const RateTask & task,
+                         const int len,
+                         const Configuration & configuration,
+                         std::vector<int> & indices,
+                         std::vector<int> & key)
+{
+    const int geometry = configuration.matchListGeometry(task.index);
+    if (geometry < 0)
+    {
+        key.clear();
+        return false;
+    }
+
+    configuration.matchListIndices(task.index, indices);
+    const std::vector<int> & types = configuration.types();
+
+    key.resize(2 + len);
+    key[0] = task.process;
+    key[1] = geometry;
+
+    for (int i = 0; i < len; ++i)
+    {
+        key[2 + i] = types[indices[i]];
+    }
+
+    return true;
+}
+
+
 // -----------------------------------------------------------------------------
 //
 Matcher::Matcher()
@@ -53,10 +337,9 @@ Matcher::Matcher()
 
 // -----------------------------------------------------------------------------
 //
-// TODO: OpenMP.
-//
 std::vector<std::pair<int, int> > \
 Matcher::indexProcessToMatch(const std::vector<Process *> & process_ptrs,
+                             const std::vector< std::vector<int> > & basis_site_processes,
                              Configuration      & configuration,
                              const SitesMap     & sitesmap,
                              const LatticeMap   & lattice_map,
@@ -64,70 +347,122 @@ Matcher::indexProcessToMatch(const std::vector<Process *> & process_ptrs,
 {
     // {{{
 
-    // PERFORMME: May use OpenMP here to parallelize the check loop.
+    // The candidates found by each thread.
+    std::vector< std::vector<std::pair<int, int> > > thread_pairs(maxThreads());
+    const int n_indices = indices.size();
 
-    // The pair list to be returned.
+#pragma omp parallel if(n_indices > min_parallel_size__)
+    {
+        std::vector<std::pair<int, int> > & pairs = thread_pairs[threadNumber()];
+
+#pragma omp for schedule(static)
+        for (int i = 0; i < n_indices; ++i)
+        {
+            // Get the index.
+            const int index = indices[i];
+
+            // Get the basis site.
+            const int basis_site = lattice_map.basisSiteFromIndex(index);
+
+            // Only the processes listed for the basis site are checked.
+            if (static_cast<size_t>(basis_site) >= basis_site_processes.size())
+            {
+                continue;
+            }
+            appendCandidates(index,
+                             basis_site_processes[basis_site],
+                             process_ptrs,
+                             sitesmap,
+                             pairs);
+        }
+    }
+
+    // The pair list to be returned, in the order of the indices.
     std::vector<std::pair<int, int> > index_process_to_match;
+    joinThreadBuffers(thread_pairs, index_process_to_match);
 
-    for (size_t i = 0; i < indices.size(); ++i)
-    {
-        // Get the index.
-        const int index = indices[i];
-        bool use_index = false;
+    return index_process_to_match;
 
-        // Get the basis site.
-        const int basis_site = lattice_map.basisSiteFromIndex(index);
+    // }}}
+}
 
-        // Get site match list.
-        const SiteMatchList & site_matchlist = sitesmap.matchList(index);
 
-        // For each process, check if we should try to match.
-        for (size_t j = 0; j < process_ptrs.size(); ++j)
+// -----------------------------------------------------------------------------
+//
+std::vector<std::pair<int, int> > \
+Matcher::trieIndexProcessToMatch(const Interactions & interactions,
+                                 Configuration      & configuration,
+                                 const SitesMap     & sitesmap,
+                                 const LatticeMap   & lattice_map,
+                                 const std::vector<int> & indices) const
+{
+    // {{{
+
+    const std::vector<Process *> & process_ptrs = interactions.processes();
+    const std::vector< std::vector<int> > & basis_site_processes = \
+        interactions.basisSiteProcesses();
+
+    // The candidates found by each thread.
+    std::vector< std::vector<std::pair<int, int> > > thread_pairs(maxThreads());
+    const int n_indices = indices.size();
+
+#pragma omp parallel if(n_indices > min_parallel_size__)
+    {
+        std::vector<std::pair<int, int> > & pairs = thread_pairs[threadNumber()];
+
+        // Scratch space reused between the indices.
+        std::vector<int> match_list_indices;
+        std::vector<int> candidates;
+        std::vector<int> stack;
+
+#pragma omp for schedule(static)
+        for (int i = 0; i < n_indices; ++i)
         {
-            // Check if the basis site is listed.
-            const std::vector<int> & process_basis_sites = \
-                (*process_ptrs[j]).basisSites();
-
-            if ( std::find(process_basis_sites.begin(),
-                           process_basis_sites.end(),
-                           basis_site) \
-                  != process_basis_sites.end() )
+            const int index = indices[i];
+            const int basis_site = lattice_map.basisSiteFromIndex(index);
+
+            if (static_cast<size_t>(basis_site) >= basis_site_processes.size())
             {
-                // Pick out the process.
-                const Process * process_ptr = process_ptrs[j];
+                continue;
+            }
 
-                // Check if process site types is set.
-                if (process_ptr->hasSiteTypes())
-                {
-                    // Get process match list.
-                    const ProcessMatchList & process_matchlist = process_ptr->matchList();
+            // Sites without template are checked against all processes of
+            // the basis site.
+            const int geometry = configuration.matchListGeometry(index);
+            if (geometry < 0)
+            {
+                appendCandidates(index,
+                                 basis_site_processes[basis_site],
+                                 process_ptrs,
+                                 sitesmap,
+                                 pairs);
+                continue;
+            }
 
-                    // Check if the process matches with site types.
-                    bool is_match = whateverMatch(process_matchlist, site_matchlist);
+            // Only the processes matching now or listing the index can give
+            // a task, found without checking each process of the basis site.
+            configuration.matchListIndices(index, match_list_indices);
+            interactions.matchTrie(geometry).match(match_list_indices,
+                                                   configuration.types(),
+                                                   candidates,
+                                                   stack);
 
-                    if (is_match)
-                    {
-                        // Register the candidate.
-                        index_process_to_match.push_back(std::pair<int, int>(index, j));
-                        use_index = true;
-                    }
-                }
-                else
-                {
-                    // Register the candidate.
-                    index_process_to_match.push_back(std::pair<int, int>(index, j));
-                    use_index = true;
-                }
-            }
-        }
+            const std::vector<int> & listing = interactions.siteProcesses(index);
+            candidates.insert(candidates.end(), listing.begin(), listing.end());
 
-        // Update the configuration match list for this index if it will be used.
-        if ( use_index )
-        {
-            configuration.updateMatchList(index);
+            // In process order, as for all processes of the basis site.
+            std::sort(candidates.begin(), candidates.end());
+            candidates.erase(std::unique(candidates.begin(), candidates.end()),
+                             candidates.end());
+
+            appendCandidates(index, candidates, process_ptrs, sitesmap, pairs);
         }
     }
 
+    // The pair list to be returned, in the order of the indices.
+    std::vector<std::pair<int, int> > index_process_to_match;
+    joinThreadBuffers(thread_pairs, index_process_to_match);
+
     return index_process_to_match;
 
     // }}}
@@ -144,11 +479,28 @@ void Matcher::calculateMatching(Interactions & interactions,
 {
     // {{{
 
-    // Build the list of indices and processes to match.
+    // Build the list of indices and processes to match, with the match
+    // tries only the processes that can give a task.
     const std::vector<Process *> & process_ptrs = interactions.processes();
     const std::vector<std::pair<int,int> > && index_process_to_match = \
-        indexProcessToMatch(process_ptrs, configuration, sitesmap,
-                            lattice_map, indices);
+        interactions.useMatchTrie() ?
+        trieIndexProcessToMatch(interactions, configuration, sitesmap, lattice_map, indices) :
+        indexProcessToMatch(process_ptrs, interactions.basisSiteProcesses(),
+                            configuration, sitesmap, lattice_map, indices);
+
+    calculateMatching(interactions, configuration, index_process_to_match);
+
+    // }}}
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void Matcher::calculateMatching(Interactions & interactions,
+                                Configuration & configuration,
+                                const std::vector<std::pair<int,int> > & index_process_to_match) const
+{
+    // {{{
 
     // Generate the lists of tasks.
     std::vector<RemoveTask> remove_tasks;
@@ -178,7 +530,13 @@ void Matcher::calculateMatching(Interactions & interactions,
         std::vector<double> local_tasks_rates(local_tasks.size(), 0.0);
 
         // Update.
-        updateRates(local_tasks_rates, local_tasks, interactions, configuration);
+        RateCache * rate_cache = NULL;
+        if (interactions.rateCache().capacity() > 0)
+        {
+            rate_cache = &interactions.rateCache();
+        }
+
+        updateRates(local_tasks_rates, local_tasks, interactions, configuration, rate_cache);
 
         // Join the results.
         const std::vector<double> global_tasks_rates = joinOverProcesses(local_tasks_rates);
@@ -224,82 +582,160 @@ void Matcher::matchIndicesWithProcesses(const std::vector<std::pair<int,int> > &
     const int n_local_tasks = local_index_process_to_match.size();
     std::vector<int> local_task_types(n_local_tasks, 0);
 
-    // Loop over pairs to match.
-    for (size_t i = 0; i < local_index_process_to_match.size(); ++i)
+    // The processes are only read while matching, so the pairs are split
+    // over the threads with each thread keeping its own match list cache.
+    const bool use_match_trie = interactions.useMatchTrie();
+
+#pragma omp parallel if(n_local_tasks > min_parallel_size__)
     {
-        // Get the process and index to match.
-        const int index = local_index_process_to_match[i].first;
-        const int p_idx = local_index_process_to_match[i].second;
-        Process & process = (*interactions.processes()[p_idx]);
+        // The match list indices of the latest index, the pairs are listed
+        // with all processes for one index after each other.
+        std::vector<int> match_list_indices;
+        int match_list_index = -1;
+
+        // The processes matching the latest index when using the match tries.
+        std::vector<int> trie_matches;
+        std::vector<int> trie_stack;
+        std::vector<bool> trie_match_flags(use_match_trie ? interactions.processes().size() : 0, false);
+
+        // Loop over pairs to match.
+#pragma omp for schedule(static)
+        for (int i = 0; i < n_local_tasks; ++i)
+        {
+            // Get the process and index to match.
+            const int index = local_index_process_to_match[i].first;
+            const int p_idx = local_index_process_to_match[i].second;
+            const Process & process = (*interactions.processes()[p_idx]);
 
-        // Perform the matching.
-        const bool in_list = process.isListed(index);
+            // Perform the matching.
+            const bool in_list = process.isListed(index);
 
-        const ProcessMatchList & process_match_list = process.matchList();
-        const ConfigMatchList & index_match_list = configuration.matchList(index);
+            // Only the types need to be compared if the geometry was checked
+            // when the process match list was compiled.
+            const int geometry = configuration.matchListGeometry(index);
+            bool is_match;
 
-        const bool is_match = whateverMatch(process_match_list,
-                                            index_match_list);
+            if (geometry >= 0 && process.hasCompiledMatchList())
+            {
+                if (index != match_list_index)
+                {
+                    configuration.matchListIndices(index, match_list_indices);
+                    match_list_index = index;
 
-        // Determine what to do with this pair of processes and indices.
-        if (!is_match && in_list)
-        {
-            // If no match and previous match - remove.
-            local_task_types[i] = 1;
-        }
-        else if (is_match && in_list)
-        {
-            // If match and previous match - update the rate.
-            local_task_types[i] = 2;
-        }
-        else if (is_match && !in_list)
-        {
-            // If match and not previous match - add.
-            local_task_types[i] = 3;
+                    // Walk the match trie once for all processes.
+                    if (use_match_trie)
+                    {
+                        for (size_t j = 0; j < trie_matches.size(); ++j)
+                        {
+                            trie_match_flags[trie_matches[j]] = false;
+                        }
+
+                        interactions.matchTrie(geometry).match(match_list_indices,
+                                                               configuration.types(),
+                                                               trie_matches,
+                                                               trie_stack);
+
+                        for (size_t j = 0; j < trie_matches.size(); ++j)
+                        {
+                            trie_match_flags[trie_matches[j]] = true;
+                        }
+                    }
+                }
+
+                if (use_match_trie)
+                {
+                    is_match = trie_match_flags[p_idx];
+                }
+                else
+                {
+                    is_match = process.geometryMatches(geometry) && \
+                        compiledMatch(process.compiledMatchList(),
+                                      match_list_indices,
+                                      configuration.types());
+                }
+            }
+            else
+            {
+                is_match = whateverMatch(process.matchList(),
+                                         configuration.matchList(index));
+            }
+
+            // Determine what to do with this pair of processes and indices.
+            if (!is_match && in_list)
+            {
+                // If no match and previous match - remove.
+                local_task_types[i] = 1;
+            }
+            else if (is_match && in_list)
+            {
+                // If match and previous match - update the rate.
+                local_task_types[i] = 2;
+            }
+            else if (is_match && !in_list)
+            {
+                // If match and not previous match - add.
+                local_task_types[i] = 3;
+            }
         }
     }
 
     // Join the result - parallel.
     const std::vector<int> task_types = joinOverProcesses(local_task_types);
 
-    // Loop again (not in parallel) and add the tasks to the tasks vectors.
-    const size_t n_tasks = index_process_to_match.size();
-    for (size_t i = 0; i < n_tasks; ++i)
+    // Loop again and add the tasks to the thread task buffers, which are
+    // joined in order to give the same task lists for any number of threads.
+    const int n_threads = maxThreads();
+    std::vector< std::vector<RemoveTask> > thread_remove_tasks(n_threads);
+    std::vector< std::vector<RateTask> >   thread_update_tasks(n_threads);
+    std::vector< std::vector<RateTask> >   thread_add_tasks(n_threads);
+    const int n_tasks = index_process_to_match.size();
+
+#pragma omp parallel if(n_tasks > min_parallel_size__)
     {
-        const int index = index_process_to_match[i].first;
-        const int p_idx = index_process_to_match[i].second;
-        const Process & process = (*interactions.processes()[p_idx]);
+        const int thread = threadNumber();
 
-        // If no match and previous match - remove.
-        if (task_types[i] == 1)
+#pragma omp for schedule(static)
+        for (int i = 0; i < n_tasks; ++i)
         {
-            RemoveTask t;
-            t.index   = index;
-            t.process = p_idx;
-            remove_tasks.push_back(t);
-        }
+            const int index = index_process_to_match[i].first;
+            const int p_idx = index_process_to_match[i].second;
+            const Process & process = (*interactions.processes()[p_idx]);
 
-        // If match and previous match - update the rate.
-        else if (task_types[i] == 2)
-        {
-            RateTask t;
-            t.index   = index;
-            t.process = p_idx;
-            t.rate    = process.rateConstant();
-            update_tasks.push_back(t);
-        }
+            // If no match and previous match - remove.
+            if (task_types[i] == 1)
+            {
+                RemoveTask t;
+                t.index   = index;
+                t.process = p_idx;
+                thread_remove_tasks[thread].push_back(t);
+            }
 
-        // If match and not previous match - add.
-        else if (task_types[i] == 3)
-        {
-            RateTask t;
-            t.index   = index;
-            t.process = p_idx;
-            t.rate    = process.rateConstant();
-            add_tasks.push_back(t);
+            // If match and previous match - update the rate.
+            else if (task_types[i] == 2)
+            {
+                RateTask t;
+                t.index   = index;
+                t.process = p_idx;
+                t.rate    = process.rateConstant();
+                thread_update_tasks[thread].push_back(t);
+            }
+
+            // If match and not previous match - add.
+            else if (task_types[i] == 3)
+            {
+                RateTask t;
+                t.index   = index;
+                t.process = p_idx;
+                t.rate    = process.rateConstant();
+                thread_add_tasks[thread].push_back(t);
+            }
         }
     }
 
+    joinThreadBuffers(thread_remove_tasks, remove_tasks);
+    joinThreadBuffers(thread_update_tasks, update_tasks);
+    joinThreadBuffers(thread_add_tasks,    add_tasks);
+
     // }}}
 }
 
@@ -321,6 +757,8 @@ void Matcher::updateProcesses(const std::vector<RemoveTask> & remove_tasks,
         const int index = remove_tasks[i].index;
         const int p_idx = remove_tasks[i].process;
         interactions.processes()[p_idx]->removeSite(index);
+        interactions.removeSiteProcess(index, p_idx);
+        interactions.markProcessUpdated(p_idx);
     }
 
     // Update.
@@ -329,8 +767,8 @@ void Matcher::updateProcesses(const std::vector<RemoveTask> & remove_tasks,
         const int index   = update_tasks[i].index;
         const int p_idx   = update_tasks[i].process;
         const double rate = update_tasks[i].rate;
-        interactions.processes()[p_idx]->removeSite(index);
-        interactions.processes()[p_idx]->addSite(index, rate);
+        interactions.processes()[p_idx]->updateSite(index, rate);
+        interactions.markProcessUpdated(p_idx);
     }
 
     // Add.
@@ -340,6 +778,8 @@ void Matcher::updateProcesses(const std::vector<RemoveTask> & remove_tasks,
         const int p_idx   = add_tasks[i].process;
         const double rate = add_tasks[i].rate;
         interactions.processes()[p_idx]->addSite(index, rate);
+        interactions.addSiteProcess(index, p_idx);
+        interactions.markProcessUpdated(p_idx);
     }
 
     // }}}
@@ -351,7 +791,8 @@ void Matcher::updateProcesses(const std::vector<RemoveTask> & remove_tasks,
 void Matcher::updateRates(std::vector<double>         & new_rates,
                           const std::vector<RateTask> & tasks,
                           const Interactions          & interactions,
-                          const Configuration         & configuration) const
+                          const Configuration         & configuration,
+                          RateCache                   * rate_cache) const
 {
     // {{{
 
@@ -359,17 +800,182 @@ void Matcher::updateRates(std::vector<double>         & new_rates,
     // interactions object, to get an updated rate for each process.
 
     const RateCalculator & rate_calculator = interactions.rateCalculator();
+    const std::vector<Process *> & processes = interactions.processes();
+    const int n_tasks = tasks.size();
+
+    // The number of sites within the cutoff of each task, looked up for the
+    // templates of compiled processes and searched for the other sites.
+    const NeighbourhoodTemplates & neighbourhoods = configuration.neighbourhoods();
 
-    for (size_t i = 0; i < tasks.size(); ++i)
+    std::vector<int> lengths(n_tasks);
+    for (int i = 0; i < n_tasks; ++i)
     {
-        // Get the rate process to use.
-        const Process & process = (*interactions.processes()[tasks[i].process]);
+        const int index    = tasks[i].index;
+        const int geometry = neighbourhoods.geometry(index);
+        const Process & process = *processes[tasks[i].process];
+
+        if (geometry >= 0 && process.hasCompiledMatchList())
+        {
+            lengths[i] = interactions.cutoffLength(tasks[i].process, geometry);
+        }
+        else
+        {
+            lengths[i] = cutoffLength(neighbourhoods.geometryArrays(index).distances,
+                                      process.cutoff());
+        }
+    }
+
+    // The positions in the task list of the rates to calculate.
+    std::vector<int> to_calculate;
 
-        // Get the coordinate index.
-        const int index = tasks[i].index;
+    // With the cache, only the rates not found are calculated, once for
+    // each key. The other tasks with the same key copy the rate afterwards.
+    const bool use_cache = rate_cache != NULL && rate_cache->capacity() > 0 && \
+        rate_calculator.pureLocalRates();
 
-        // Send this information to the updateSingleRate function.
-        new_rates[i] = updateSingleRate(index, process, configuration, rate_calculator);
+    std::vector< std::vector<int> > keys;
+    std::vector<int> same_key_as;
+
+    if (use_cache)
+    {
+        keys.resize(n_tasks);
+        same_key_as.assign(n_tasks, -1);
+        std::map<std::vector<int>, int> first_with_key;
+        std::vector<int> indices;
+
+        for (int i = 0; i < n_tasks; ++i)
+        {
+            if (!rateCacheKey(tasks[i], lengths[i], configuration, indices, keys[i]))
+            {
+                to_calculate.push_back(i);
+            }
+            else if (!rate_cache->find(keys[i], new_rates[i]))
+            {
+                const std::pair<std::map<std::vector<int>, int>::iterator, bool> result = \
+                    first_with_key.insert(std::pair<std::vector<int>, int>(keys[i], i));
+
+                if (result.second)
+                {
+                    to_calculate.push_back(i);
+                }
+                else
+                {
+                    same_key_as[i] = result.first->second;
+                }
+            }
+        }
+    }
+    else
+    {
+        to_calculate.resize(n_tasks);
+        for (int i = 0; i < n_tasks; ++i)
+        {
+            to_calculate[i] = i;
+        }
+    }
+
+    const int n_calculate = to_calculate.size();
+
+    // A rate calculator with a batch callback gets all rates at once, e.g.
+    // to vectorise the rate expression over the tasks in Python.
+    if (n_calculate > 0 && !rate_calculator.integerTypes() && rate_calculator.batchCallback())
+    {
+        updateBatchRates(new_rates, tasks, to_calculate, lengths, processes,
+                         configuration, rate_calculator);
+    }
+    else
+    {
+        // Only a rate calculator declared thread safe is called from the
+        // threads, the Python callbacks are serialised on the interpreter
+        // lock anyway and must stay outside any parallel region, since an
+        // exception raised in Python may not leave an OpenMP region.
+        if (!rate_calculator.threadSafe() || n_calculate <= 1)
+        {
+            RateBuffers buffers;
+
+            for (int j = 0; j < n_calculate; ++j)
+            {
+                const int i = to_calculate[j];
+
+                // Get the rate process to use.
+                const Process & process = (*processes[tasks[i].process]);
+
+                // Get the coordinate index.
+                const int index = tasks[i].index;
+
+                // Send this information to the updateSingleRate function.
+                new_rates[i] = updateSingleRate(index, process, configuration, rate_calculator,
+                                                lengths[i], buffers);
+            }
+        }
+        else
+        {
+            // The first exception thrown in the threads is rethrown after
+            // the parallel region.
+            std::exception_ptr error;
+
+            // The rates differ in cost, so the tasks are handed out dynamically.
+#pragma omp parallel
+            {
+                // Each thread reuses its own scratch buffers.
+                RateBuffers buffers;
+
+#pragma omp for schedule(dynamic, 16)
+                for (int j = 0; j < n_calculate; ++j)
+                {
+                    try
+                    {
+                        const int i = to_calculate[j];
+
+                        // Get the rate process to use.
+                        const Process & process = (*processes[tasks[i].process]);
+
+                        // Get the coordinate index.
+                        const int index = tasks[i].index;
+
+                        // Send this information to the updateSingleRate function.
+                        new_rates[i] = updateSingleRate(index, process, configuration,
+                                                        rate_calculator, lengths[i], buffers);
+                    }
+                    catch (...)
+                    {
+#pragma omp critical (matcher_update_rates_error)
+                        {
+                            if (!error)
+                            {
+                                error = std::current_exception();
+                            }
+                        }
+                    }
+                }
+            }
+
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+    // Store the new rates and copy them to the tasks with the same key.
+    if (use_cache)
+    {
+        for (int j = 0; j < n_calculate; ++j)
+        {
+            const int i = to_calculate[j];
+            if (!keys[i].empty())
+            {
+                rate_cache->insert(keys[i], new_rates[i]);
+            }
+        }
+
+        for (int i = 0; i < n_tasks; ++i)
+        {
+            if (same_key_as[i] >= 0)
+            {
+                new_rates[i] = new_rates[same_key_as[i]];
+            }
+        }
     }
 
     // }}}
@@ -383,89 +989,95 @@ double Matcher::updateSingleRate(const int index,
                                  const Configuration  & configuration,
                                  const RateCalculator & rate_calculator) const
 {
-    // {{{
-
-    // Get the match lists.
-    const ProcessMatchList & process_match_list = process.matchList();
-    const ConfigMatchList & config_match_list  = configuration.matchList(index);
+    const std::vector<double> & distances = \
+        configuration.neighbourhoods().geometryArrays(index).distances;
 
-    // We will also need the elements.
-    const std::vector<std::string> & elements = configuration.elements();
+    RateBuffers buffers;
+    return updateSingleRate(index, process, configuration, rate_calculator,
+                            cutoffLength(distances, process.cutoff()), buffers);
+}
 
-    // Get cutoff distance from the process.
-    const double cutoff = process.cutoff();
-    ConfigMatchList::const_iterator it1 = config_match_list.begin();
-    int len = 0;
-    while ( (*it1).distance <= cutoff && it1 != config_match_list.end())
-    {
-        ++it1;
-        ++len;
-    }
-    const ConfigMatchList::const_iterator new_end = it1;
 
-    // Allocate memory for the numpy geometry and copy the data over.
-    std::vector<double> numpy_geo(len*3);
-    std::vector<double>::iterator it_geo = numpy_geo.begin();
-    std::vector<std::string> types_before;
+// -----------------------------------------------------------------------------
+//
+double Matcher::updateSingleRate(const int index,
+                                 const Process        & process,
+                                 const Configuration  & configuration,
+                                 const RateCalculator & rate_calculator,
+                                 const int len,
+                                 RateBuffers & buffers) const
+{
+    // {{{
 
-    it1 = config_match_list.begin();
-    for ( ; it1 != new_end; ++it1 )
-    {
-        const Coordinate & coord   = (*it1).coordinate;
+    // The geometry is shared by all sites with the same template.
+    const NeighbourhoodTemplates::GeometryArrays & geometry = \
+        configuration.neighbourhoods().geometryArrays(index);
 
-        (*it_geo) = coord.x();
-        ++it_geo;
+    configuration.matchListIndices(index, buffers.indices);
+    const std::vector<int> & indices = buffers.indices;
+    const std::vector<int> & types = configuration.types();
 
-        (*it_geo) = coord.y();
-        ++it_geo;
+    const std::vector<int> & update_types = processUpdateTypes(process, buffers.update_types);
+    const int n_update = std::min(len, static_cast<int>(update_types.size()));
 
-        (*it_geo) = coord.z();
-        ++it_geo;
+    const Coordinate & global_coordinate = configuration.coordinates()[index];
 
-        const int idx = (*it1).index;
-        types_before.push_back(elements[idx]);
+    // Call the integer callback directly on the backend storage.
+    if (rate_calculator.integerTypes())
+    {
+        KMCRatePluginEnvironment environment;
+        environment.len            = len;
+        environment.indices        = indices.data();
+        environment.types          = types.data();
+        environment.n_update       = n_update;
+        environment.update_types   = update_types.data();
+        environment.distances      = geometry.distances.data();
+        environment.coordinates    = geometry.coordinates.data();
+        environment.rate_constant  = process.rateConstant();
+        environment.process_number = process.processNumber();
+        environment.index          = index;
+        environment.global_x       = global_coordinate.x();
+        environment.global_y       = global_coordinate.y();
+        environment.global_z       = global_coordinate.z();
+
+        return rate_calculator.backendIntegerRateCallback(environment);
     }
 
-    // Types after the process.
-    std::vector<std::string> types_after = types_before;
-
-    // Rewind the config match list iterator.
-    it1 = config_match_list.begin();
+    // Otherwise give the type names to the string callback, reusing the
+    // strings of the buffers.
+    buffers.geometry.assign(geometry.coordinates.begin(),
+                            geometry.coordinates.begin() + 3*len);
+    buffers.types_before.resize(len);
+    buffers.types_after.resize(len);
 
-    // Get the iterators to the process match list and types after.
-    ProcessMatchList::const_iterator it2 = process_match_list.begin();
-    std::vector<std::string>::iterator it3 = types_after.begin();
-    const ProcessMatchList::const_iterator end = process_match_list.end();
-
-    // Loop over the process match list and update the types_after vector.
-    for ( ; it2 != end; ++it1, ++it2, ++it3 )
+    for (int i = 0; i < len; ++i)
     {
-        const int update_type = (*it2).update_type;
-        const int match_type  = (*it1).match_type;
+        buffers.types_before[i] = configuration.typeName(types[indices[i]]);
+    }
 
-        // Set the type after process. NOTE: The > 0 is needed for handling wildcards.
-        if ( match_type != update_type  && update_type > 0)
+    for (int i = 0; i < len; ++i)
+    {
+        // NOTE: The > 0 is needed for handling wildcards.
+        const int update_type = i < n_update ? update_types[i] : 0;
+        if (update_type > 0 && update_type != types[indices[i]])
         {
-            (*it3) = configuration.typeName(update_type);
+            buffers.types_after[i] = configuration.typeName(update_type);
+        }
+        else
+        {
+            buffers.types_after[i] = buffers.types_before[i];
         }
     }
 
-    // Calculate the rate using the provided rate calculator.
-    const double rate_constant = process.rateConstant();
-    const int process_number   = process.processNumber();
-    const double global_x = configuration.coordinates()[index].x();
-    const double global_y = configuration.coordinates()[index].y();
-    const double global_z = configuration.coordinates()[index].z();
-
-    return rate_calculator.backendRateCallback(numpy_geo,
+    return rate_calculator.backendRateCallback(buffers.geometry,
                                                len,
-                                               types_before,
-                                               types_after,
-                                               rate_constant,
-                                               process_number,
-                                               global_x,
-                                               global_y,
-                                               global_z);
+                                               buffers.types_before,
+                                               buffers.types_after,
+                                               process.rateConstant(),
+                                               process.processNumber(),
+                                               global_coordinate.x(),
+                                               global_coordinate.y(),
+                                               global_coordinate.z());
 
     // }}}
 }
@@ -493,8 +1105,8 @@ void Matcher::classifyConfiguration(const Interactions & interactions,
     // Get the list of indices and process to match.
     const std::vector<Process *> & fast_process_ptrs = interactions.fastProcesses();
     const std::vector<std::pair<int, int> > && index_process_to_match = \
-        indexProcessToMatch(fast_process_ptrs, configuration, sitesmap,
-                            lattice_map, indices);
+        indexProcessToMatch(fast_process_ptrs, interactions.basisSiteFastProcesses(),
+                            configuration, sitesmap, lattice_map, indices);
 
     // Setup local variables for running in parallel.
     std::vector<std::pair<int, int> > && local_index_process_to_match = \
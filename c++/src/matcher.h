@@ -38,6 +38,7 @@ class SitesMap;
 class Process;
 class LatticeMap;
 class RateCalculator;
+class RateCache;
 
 /// A minimal struct for representing a task with a rate.
 struct RateTask
@@ -56,6 +57,18 @@ struct RemoveTask
 };
 
 
+/// Scratch buffers for calculating single rates, reused between the calls
+/// made by a thread to avoid allocating for each rate.
+struct RateBuffers
+{
+    std::vector<int> indices;
+    std::vector<int> update_types;
+    std::vector<double> geometry;
+    std::vector<std::string> types_before;
+    std::vector<std::string> types_after;
+};
+
+
 /*! \brief Class for matching local geometries.
  */
 class Matcher {
@@ -69,20 +82,46 @@ public:
 
     /* \brief Build the list of indices and processes to match later.
      *  \param process_ptrs  : The pointers of processes to be checked.
+     *  \param basis_site_processes : The indices in process_ptrs of the
+     *                                processes to check at each basis site.
      *  \param configuration : The configuration which the list of indices refers to.
      *  \param sitesmap      : The sites map which the list of inidices refers to.
      *  \param lattice_map   : The lattice map describing the configuration.
      *  \param indices       : The configuration indices that will be checked.
-     *  \return index_process_to_match: The list of index and process to match.
+     *  \return index_process_to_match: The list of index and process to match,
+     *                                  in the same order for any number of
+     *                                  OpenMP threads.
      */
     std::vector<std::pair<int, int> > \
     indexProcessToMatch(const std::vector<Process *> & process_ptrs,
+                        const std::vector< std::vector<int> > & basis_site_processes,
                         Configuration & configuration,
                         const SitesMap & sitesmap,
                         const LatticeMap & lattice_map,
                         const std::vector<int> & indices) const;
 
 
+    /* \brief Build the list of indices and processes to match later, using
+     *         the match tries. Only the processes matching the site now or
+     *         listing it are included, which give the same tasks as all
+     *         processes of the basis site.
+     *  \param interactions  : The interactions with the match tries set up.
+     *  \param configuration : The configuration which the list of indices refers to.
+     *  \param sitesmap      : The sites map which the list of inidices refers to.
+     *  \param lattice_map   : The lattice map describing the configuration.
+     *  \param indices       : The configuration indices that will be checked.
+     *  \return index_process_to_match: The list of index and process to match,
+     *                                  in the same order for any number of
+     *                                  OpenMP threads.
+     */
+    std::vector<std::pair<int, int> > \
+    trieIndexProcessToMatch(const Interactions & interactions,
+                            Configuration & configuration,
+                            const SitesMap & sitesmap,
+                            const LatticeMap & lattice_map,
+                            const std::vector<int> & indices) const;
+
+
     /*! \brief Calculate/update the matching of provided indices with
      *         all possible processes.
      *  \param interactions  : The interactions object holding info on possible processes.
@@ -99,8 +138,21 @@ public:
                            const std::vector<int> & indices) const;
 
 
+    /*! \brief Calculate/update the matching of provided pairs of indices and
+     *         processes, and update the processes with the result.
+     *  \param interactions  : The interactions object holding info on possible processes.
+     *  \param configuration : The configuration which the list of indices refers to.
+     *  \param index_process_to_match : The list of indices and process numbers
+     *                                  to match, e.g. from the DependencyIndex.
+     */
+    void calculateMatching(Interactions & interactions,
+                           Configuration & configuration,
+                           const std::vector<std::pair<int,int> > & index_process_to_match) const;
+
+
     /*! \brief Calculate the matching for a list of match tasks (pairs of indices
-     *         and processes).
+     *         and processes). The pairs are matched over the OpenMP threads
+     *         and the tasks are listed in the order of the pairs.
      *  \param index_process_to_match : The list of indices and process numbers
      *                                  to match.
      *  \param interactions           : The interactions to get the processes from.
@@ -122,16 +174,21 @@ public:
 
     /*! \brief Update the rates of the rate tasks by calling the
      *         backend call-back function of the RateCalculator stored
-     *         on the interactions object.
+     *         on the interactions object. The tasks are run over the OpenMP
+     *         threads if the rate calculator is declared thread safe.
      *  \param new_rates(out): The vector to place the updated rates in.
      *  \param tasks         : A vector with tasks to update.
      *  \param interactions  : The interactions to get the rate calculator from.
      *  \param configuration : The configuration to use.
+     *  \param rate_cache    : The cache to look up and store the rates in, only
+     *                         used with a rate calculator declaring pure
+     *                         local rates.
      */
     void updateRates(std::vector<double>         & new_rates,
                      const std::vector<RateTask> & tasks,
                      const Interactions          & interactions,
-                     const Configuration         & configuration) const;
+                     const Configuration         & configuration,
+                     RateCache                   * rate_cache = NULL) const;
 
 
     /*! \brief Update the processes with the given tasks.
@@ -157,6 +214,25 @@ public:
                             const Configuration  & configuration,
                             const RateCalculator & rate_calculator) const;
 
+    /*! \brief Calculate the rate for a single process using the rate calculator,
+     *         with the integer callback if the rate calculator uses integer
+     *         types and the string callback otherwise.
+     *  \param index           : The index to perform the process at.
+     *  \param process         : The process to perform.
+     *  \param configuration   : The configuration the index is referring to.
+     *  \param rate_calculator : The rate calculator to use.
+     *  \param len             : The number of sites within the cutoff of the
+     *                           process.
+     *  \param buffers         : The scratch buffers to use.
+     *  \returns : The calculated rate for the process at the given index.
+     */
+    double updateSingleRate(const int index,
+                            const Process        & process,
+                            const Configuration  & configuration,
+                            const RateCalculator & rate_calculator,
+                            const int len,
+                            RateBuffers & buffers) const;
+
     /*! \brief Classify slow/fast species in configuration.
      *  \param interactions       : The interactions object holding info on possible
      *                              processes.
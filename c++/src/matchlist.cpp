@@ -43,7 +43,7 @@ void configurationsToMatchList(const Configuration & first,
     const Coordinate origin = coords[0];
 
     // Transform the configurations into match lists.
-    for (size_t i = 0; i < first.elements().size(); ++i)
+    for (size_t i = 0; i < first.types().size(); ++i)
     {
         // Get the types as integers.
         const int first_type  = first.types()[i];
@@ -35,6 +35,72 @@ typedef std::vector<ConfigMatchListEntry> ConfigMatchList;
 typedef std::vector<SiteMatchListEntry> SiteMatchList;
 
 
+/*! \brief A configuration or sites match list stored as one contiguous
+ *         array per field of the entries, for storing many match lists
+ *         and for loops over a single field.
+ */
+struct MatchListArrays {
+
+    /// The match type of each entry.
+    std::vector<int> match_types;
+
+    /// The index in the global structure of each entry.
+    std::vector<int> indices;
+
+    /// The distance of each entry from the central site.
+    std::vector<double> distances;
+
+    /// The relative coordinates, x, y, z for each entry.
+    std::vector<double> coordinates;
+
+    /*! \brief Query for the number of entries.
+     */
+    size_t size() const { return indices.size(); }
+
+    /*! \brief Query for no entries.
+     */
+    bool empty() const { return indices.empty(); }
+
+    /*! \brief Query for the coordinate of an entry.
+     *  \param i : The position of the entry.
+     *  \return : The relative coordinate of the entry.
+     */
+    Coordinate coordinate(const size_t i) const
+    { return Coordinate(coordinates[3*i], coordinates[3*i+1], coordinates[3*i+2]); }
+
+    /*! \brief Store the fields of a match list.
+     *  \param match_list : The configuration or sites match list to store.
+     */
+    template <class T>
+    void assign(const std::vector<T> & match_list);
+
+    /*! \brief Construct the entries of a match list from the arrays.
+     *  \param match_list : (out) The configuration or sites match list.
+     */
+    template <class T>
+    void toList(std::vector<T> & match_list) const;
+
+};
+
+
+/*! \brief A compiled process match list record, holding only the position
+ *         in the configuration match list and the type required there.
+ *         Wildcard entries are left out of the compiled list.
+ */
+struct CompiledMatchListEntry {
+
+    /// The position (neighbour slot) in the configuration match list.
+    int slot;
+
+    /// The required match type.
+    int match_type;
+
+};
+
+/// Define the compiled match list.
+typedef std::vector<CompiledMatchListEntry> CompiledMatchList;
+
+
 /*! \brief Set up a process matchlist from two local configurations.
  *  \param first            : (in) The first (before) configuration.
  *  \param second           : (in) The second (after) configuration.
@@ -82,5 +148,74 @@ bool whateverMatch(const T1 & m1, const T2 & m2)
 }
 
 
+/*! \brief Determines if the types around a site match a compiled process
+ *         match list. The geometry is assumed to have been checked when the
+ *         compiled match list was set up.
+ *  \param compiled_list : The compiled process match list.
+ *  \param indices       : The lattice indices of the configuration match
+ *                         list of the site.
+ *  \param types         : The types of all lattice sites.
+ *  \return : True if all types match.
+ */
+inline
+bool compiledMatch(const CompiledMatchList & compiled_list,
+                   const std::vector<int> & indices,
+                   const std::vector<int> & types)
+{
+    // Accumulate the type differences without branching on each entry.
+    int mismatch = 0;
+    const size_t size = compiled_list.size();
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        const CompiledMatchListEntry & entry = compiled_list[i];
+        mismatch |= entry.match_type ^ types[indices[entry.slot]];
+    }
+
+    return mismatch == 0;
+}
+
+
+// -----------------------------------------------------------------------------
+//
+template <class T>
+void MatchListArrays::assign(const std::vector<T> & match_list)
+{
+    const size_t size = match_list.size();
+    match_types.resize(size);
+    indices.resize(size);
+    distances.resize(size);
+    coordinates.resize(3*size);
+
+    for (size_t i = 0; i < size; ++i)
+    {
+        match_types[i]     = match_list[i].match_type;
+        indices[i]         = match_list[i].index;
+        distances[i]       = match_list[i].distance;
+        coordinates[3*i]   = match_list[i].coordinate.x();
+        coordinates[3*i+1] = match_list[i].coordinate.y();
+        coordinates[3*i+2] = match_list[i].coordinate.z();
+    }
+}
+
+
+// -----------------------------------------------------------------------------
+//
+template <class T>
+void MatchListArrays::toList(std::vector<T> & match_list) const
+{
+    const size_t n = size();
+    match_list.resize(n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        match_list[i].match_type = match_types[i];
+        match_list[i].index      = indices[i];
+        match_list[i].distance   = distances[i];
+        match_list[i].coordinate = coordinate(i);
+    }
+}
+
+
 #endif  // __MATCHLIST__
 
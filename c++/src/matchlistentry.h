@@ -28,7 +28,12 @@
 #include "coordinate.h"
 
 
-/// The base class for the match list entries.
+/*! \brief The base class for the match list entries.
+ *
+ *  The entries have no virtual functions, so that they are stored without
+ *  a virtual table pointer and compared with direct calls. An entry must
+ *  not be deleted through a pointer to a base class.
+ */
 class MinimalMatchListEntry {
 
 public:
@@ -46,24 +51,20 @@ public:
      */
     inline MinimalMatchListEntry();
 
-    /*! \brief virtual destructor function
-     */
-    virtual ~MinimalMatchListEntry() {}
-    
     /*! \brief 'less than' operator overloading for sorting matchlists.
      */
-    virtual bool operator<(const MinimalMatchListEntry & other) const;
+    bool operator<(const MinimalMatchListEntry & other) const;
 
     /*! \brief 'equal' for comparing points(positions) of matchlist entry.
      *  NOTE: This == operator dose not compare match types.
      */
-    virtual bool samePoint(const MinimalMatchListEntry & other) const;
+    bool samePoint(const MinimalMatchListEntry & other) const;
 
     /*! \brief 'equal' for comparing type and positions.
      *  NOTE: This function compare type firstly,
      *        then compare distance and coordinate
      */
-    virtual bool match(const MinimalMatchListEntry & other) const;
+    bool match(const MinimalMatchListEntry & other) const;
 };
 
 
@@ -83,10 +84,6 @@ public:
      */
     inline ConfigMatchListEntry();
 
-    /* \brief Defualt destructor.
-     */
-    virtual ~ConfigMatchListEntry() {}
-    
     /*! \brief explicit type coversion
      *         ProcessMatchListEntry -> ConfigMatchListEntry.
      */
@@ -132,10 +129,6 @@ public:
      */
     inline ProcessMatchListEntry();
 
-    /* \brief Defualt destructor.
-     */
-    virtual ~ProcessMatchListEntry() {}
-
     /*! \brief explicit type coversion
      *         ConfigMatchListEntry -> ProcessMatchListEntry.
      */
@@ -170,10 +163,6 @@ public:
      */
     inline SiteMatchListEntry();
 
-    /* \brief Defualt destructor.
-     */
-    virtual ~SiteMatchListEntry() {}
-
     /* \brief overloaded match function.
      */
     using MinimalMatchListEntry::match;
@@ -0,0 +1,105 @@
+/*
+  This file is part of the KMCLib project distributed under the terms of the
+  GNU General Public License version 3, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/*! \file  matchtrie.cpp
+ *  \brief File for the implementation code of the MatchTrie class.
+ */
+
+#include "matchtrie.h"
+
+
+// -----------------------------------------------------------------------------
+//
+MatchTrie::MatchTrie() :
+    nodes_(1)
+{
+    nodes_[0].slot = -1;
+    nodes_[0].match_type = 0;
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void MatchTrie::insert(const CompiledMatchList & compiled_list,
+                       const int process_index)
+{
+    // {{{
+
+    int node = 0;
+
+    for (size_t i = 0; i < compiled_list.size(); ++i)
+    {
+        const int slot = compiled_list[i].slot;
+        const int match_type = compiled_list[i].match_type;
+
+        // Follow the existing edge if there is one.
+        int next = -1;
+        const std::vector<int> & children = nodes_[node].children;
+        for (size_t j = 0; j < children.size(); ++j)
+        {
+            const Node & child = nodes_[children[j]];
+            if (child.slot == slot && child.match_type == match_type)
+            {
+                next = children[j];
+                break;
+            }
+        }
+
+        // Otherwise add a new node.
+        if (next < 0)
+        {
+            next = nodes_.size();
+            nodes_.push_back(Node());
+            nodes_[next].slot = slot;
+            nodes_[next].match_type = match_type;
+            nodes_[node].children.push_back(next);
+        }
+
+        node = next;
+    }
+
+    nodes_[node].processes.push_back(process_index);
+
+    // }}}
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void MatchTrie::match(const std::vector<int> & indices,
+                      const std::vector<int> & types,
+                      std::vector<int> & process_indices,
+                      std::vector<int> & stack) const
+{
+    // {{{
+
+    process_indices.clear();
+
+    // Depth first walk along the matching edges.
+    stack.assign(1, 0);
+
+    while (!stack.empty())
+    {
+        const Node & node = nodes_[stack.back()];
+        stack.pop_back();
+
+        process_indices.insert(process_indices.end(),
+                               node.processes.begin(),
+                               node.processes.end());
+
+        for (size_t i = 0; i < node.children.size(); ++i)
+        {
+            const Node & child = nodes_[node.children[i]];
+            if (types[indices[child.slot]] == child.match_type)
+            {
+                stack.push_back(node.children[i]);
+            }
+        }
+    }
+
+    // }}}
+}
+
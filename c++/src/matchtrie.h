@@ -0,0 +1,88 @@
+/*
+  This file is part of the KMCLib project distributed under the terms of the
+  GNU General Public License version 3, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/*! \file  matchtrie.h
+ *  \brief File for the MatchTrie class definition.
+ */
+
+#ifndef __MATCHTRIE__
+#define __MATCHTRIE__
+
+#include <vector>
+
+#include "matchlist.h"
+
+
+/*! \brief Class for matching the types around a site against many compiled
+ *         process match lists at once.
+ *
+ *  The compiled match lists are stored as paths in a trie, where each edge
+ *  checks the type at one match list position. Processes with the same
+ *  leading entries share the path, so each check is done once per site no
+ *  matter how many processes start with it.
+ */
+class MatchTrie {
+
+public:
+
+    /*! \brief Constructor for an empty trie.
+     */
+    MatchTrie();
+
+    /*! \brief Add a compiled process match list to the trie.
+     *  \param compiled_list : The compiled match list of the process.
+     *  \param process_index : The process index to return on a match.
+     */
+    void insert(const CompiledMatchList & compiled_list,
+                const int process_index);
+
+    /*! \brief Find all processes matching the types around a site.
+     *  \param indices       : The lattice indices of the configuration match
+     *                         list of the site.
+     *  \param types         : The types of all lattice sites.
+     *  \param process_indices : (out) The indices of the matching processes.
+     *  \param stack         : Scratch space for the walk, reused between
+     *                         calls to avoid allocating it for each site.
+     */
+    void match(const std::vector<int> & indices,
+               const std::vector<int> & types,
+               std::vector<int> & process_indices,
+               std::vector<int> & stack) const;
+
+    /*! \brief Query for the number of nodes.
+     *  \return : The number of nodes in the trie, including the root.
+     */
+    size_t nNodes() const { return nodes_.size(); }
+
+protected:
+
+private:
+
+    /// A node in the trie.
+    struct Node {
+
+        /// The match list position checked on the edge to this node.
+        int slot;
+
+        /// The type required on the edge to this node.
+        int match_type;
+
+        /// The child nodes.
+        std::vector<int> children;
+
+        /// The processes that match when this node is reached.
+        std::vector<int> processes;
+
+    };
+
+    /// The nodes, with the root first.
+    std::vector<Node> nodes_;
+
+};
+
+
+#endif // __MATCHTRIE__
+
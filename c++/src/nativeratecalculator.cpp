@@ -0,0 +1,72 @@
+/*
+  This file is part of the KMCLib project distributed under the terms of the
+  GNU General Public License version 3, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/*! \file  nativeratecalculator.cpp
+ *  \brief File for the implementation code of the NativeRateCalculator class.
+ */
+
+#include <dlfcn.h>
+#include <sstream>
+#include <stdexcept>
+
+#include "nativeratecalculator.h"
+
+
+// -----------------------------------------------------------------------------
+//
+NativeRateCalculator::NativeRateCalculator(const std::string & library_path) :
+    ThreadSafeRateCalculator(true),
+    library_path_(library_path),
+    handle_(NULL),
+    rate_function_(NULL)
+{
+    // {{{
+
+    handle_ = dlopen(library_path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (handle_ == NULL)
+    {
+        const std::string msg = "Could not load the rate plugin library: " + \
+                                std::string(dlerror());
+        throw std::runtime_error(msg);
+    }
+
+    // Check the interface version before using the rate function.
+    KMCRatePluginVersionFunction version_function = \
+        reinterpret_cast<KMCRatePluginVersionFunction>(dlsym(handle_, KMC_RATE_PLUGIN_VERSION_SYMBOL));
+
+    rate_function_ = \
+        reinterpret_cast<KMCRatePluginRateFunction>(dlsym(handle_, KMC_RATE_PLUGIN_RATE_SYMBOL));
+
+    std::string msg;
+    if (version_function == NULL || rate_function_ == NULL)
+    {
+        msg = "The rate plugin library " + library_path + " must export " + \
+              KMC_RATE_PLUGIN_VERSION_SYMBOL + " and " + KMC_RATE_PLUGIN_RATE_SYMBOL + ".";
+    }
+    else if (version_function() != KMC_RATE_PLUGIN_ABI_VERSION)
+    {
+        std::stringstream ss;
+        ss << "The rate plugin library " << library_path << " has interface version "
+           << version_function() << ", expected " << KMC_RATE_PLUGIN_ABI_VERSION << ".";
+        msg = ss.str();
+    }
+
+    if (!msg.empty())
+    {
+        dlclose(handle_);
+        throw std::runtime_error(msg);
+    }
+
+    // }}}
+}
+
+
+// -----------------------------------------------------------------------------
+//
+NativeRateCalculator::~NativeRateCalculator()
+{
+    dlclose(handle_);
+}
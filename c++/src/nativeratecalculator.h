@@ -0,0 +1,83 @@
+/*
+  This file is part of the KMCLib project distributed under the terms of the
+  GNU General Public License version 3, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/*! \file  nativeratecalculator.h
+ *  \brief File for the NativeRateCalculator class definition.
+ */
+
+#ifndef __NATIVERATECALCULATOR__
+#define __NATIVERATECALCULATOR__
+
+#include <string>
+
+#include "ratecalculator.h"
+#include "rateplugin.h"
+
+
+/*! \brief Class for a thread safe rate calculator loaded from a native
+ *         shared library implementing the C interface in rateplugin.h.
+ *
+ *  The plugin is called through backendIntegerRateCallback, with the integer
+ *  types and the precomputed neighbourhood geometry, instead of through
+ *  backendRateCallback with copied coordinates and type names.
+ */
+class NativeRateCalculator : public ThreadSafeRateCalculator {
+
+public:
+
+    /*! \brief Constructor, loading the plugin library.
+     *  \param library_path : The path to the shared library to load.
+     *  \throws std::runtime_error if the library or its symbols could not
+     *          be loaded, or if the interface version does not match.
+     */
+    explicit NativeRateCalculator(const std::string & library_path);
+
+    /*! \brief Destructor, unloading the plugin library.
+     */
+    virtual ~NativeRateCalculator();
+
+    /*! \brief Calculate a rate with the plugin.
+     *  \param environment : The local environment of the process.
+     *  \return : The rate returned by the plugin.
+     */
+    double rate(const KMCRatePluginEnvironment & environment) const
+    { return rate_function_(&environment); }
+
+    /*! \brief The integer backend callback, calling the plugin.
+     *  \param environment : The local environment of the process.
+     *  \return : The rate returned by the plugin.
+     */
+    virtual double backendIntegerRateCallback(const KMCRatePluginEnvironment & environment) const
+    { return rate(environment); }
+
+    /*! \brief Query for the path of the loaded library.
+     *  \return : The library path given at construction.
+     */
+    const std::string & libraryPath() const { return library_path_; }
+
+protected:
+
+private:
+
+    /// Not copyable, the library handle is owned by the object.
+    NativeRateCalculator(const NativeRateCalculator & other);
+
+    /// Not assignable, the library handle is owned by the object.
+    NativeRateCalculator & operator=(const NativeRateCalculator & other);
+
+    /// The path of the loaded library.
+    std::string library_path_;
+
+    /// The handle of the loaded library.
+    void * handle_;
+
+    /// The rate function of the library.
+    KMCRatePluginRateFunction rate_function_;
+
+};
+
+
+#endif // __NATIVERATECALCULATOR__
@@ -0,0 +1,475 @@
+/*
+  This file is part of the KMCLib project distributed under the terms of the
+  GNU General Public License version 3, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/*! \file  neighbourhoodtemplates.cpp
+ *  \brief File for the implementation code of the NeighbourhoodTemplates class.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "neighbourhoodtemplates.h"
+#include "latticemap.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+
+/*! \brief The epsilon value for comparing lattice positions.
+ */
+static const double epsi__ = 1.0e-5;
+
+
+// -----------------------------------------------------------------------------
+//
+static void cellFromIndex(const int index,
+                          const int n_basis,
+                          const CellOrder & cell_order,
+                          int cell[3])
+{
+    cell_order.cell(index / n_basis, cell[0], cell[1], cell[2]);
+}
+
+
+// -----------------------------------------------------------------------------
+// The maximum number of threads a parallel region may use.
+//
+static int maxThreads()
+{
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+
+// -----------------------------------------------------------------------------
+// The number of the calling thread in the current parallel region.
+//
+static int threadNumber()
+{
+#ifdef _OPENMP
+    return omp_get_thread_num();
+#else
+    return 0;
+#endif
+}
+
+
+/// Scratch arrays for the geometry of a neighbourhood relative to its
+/// origin, reused between the sites handled by a thread.
+struct RelativeGeometry {
+
+    /// The relative x coordinates.
+    std::vector<double> x;
+
+    /// The relative y coordinates.
+    std::vector<double> y;
+
+    /// The relative z coordinates.
+    std::vector<double> z;
+
+    /// The distances from the origin.
+    std::vector<double> distances;
+
+};
+
+
+// -----------------------------------------------------------------------------
+// Calculate the wrapped coordinates of the indices relative to the origin.
+// Each component array is wrapped as a block, with the same result as
+// wrapping each coordinate with LatticeMap::wrap().
+//
+static void relativeCoordinates(const int origin_index,
+                                const std::vector<int> & indices,
+                                const std::vector<Coordinate> & coordinates,
+                                const LatticeMap & lattice_map,
+                                RelativeGeometry & geometry)
+{
+    const size_t n = indices.size();
+    geometry.x.resize(n);
+    geometry.y.resize(n);
+    geometry.z.resize(n);
+
+    const Coordinate & center = coordinates[origin_index];
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const Coordinate & c = coordinates[indices[i]];
+        geometry.x[i] = c.x() - center.x();
+        geometry.y[i] = c.y() - center.y();
+        geometry.z[i] = c.z() - center.z();
+    }
+
+    if (lattice_map.periodicA()) { lattice_map.wrap(geometry.x.data(), n, 0); }
+    if (lattice_map.periodicB()) { lattice_map.wrap(geometry.y.data(), n, 1); }
+    if (lattice_map.periodicC()) { lattice_map.wrap(geometry.z.data(), n, 2); }
+}
+
+
+// -----------------------------------------------------------------------------
+// Calculate the distances from the origin of the relative coordinates, as
+// Coordinate::distanceToOrigin() does.
+//
+static void relativeDistances(RelativeGeometry & geometry)
+{
+    const size_t n = geometry.x.size();
+    geometry.distances.resize(n);
+
+    const double * x = geometry.x.data();
+    const double * y = geometry.y.data();
+    const double * z = geometry.z.data();
+    double * distances = geometry.distances.data();
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        distances[i] = std::sqrt(x[i]*x[i] + y[i]*y[i] + z[i]*z[i]);
+    }
+}
+
+
+// -----------------------------------------------------------------------------
+//
+static void sortedGeometryList(const int origin_index,
+                               const std::vector<int> & indices,
+                               const std::vector<Coordinate> & coordinates,
+                               const LatticeMap & lattice_map,
+                               RelativeGeometry & geometry,
+                               ConfigMatchList & match_list)
+{
+    // All coordinates in the list are relative to the origin.
+    relativeCoordinates(origin_index, indices, coordinates, lattice_map, geometry);
+    relativeDistances(geometry);
+
+    match_list.resize(indices.size());
+
+    for (size_t i = 0; i < indices.size(); ++i)
+    {
+        match_list[i].distance   = geometry.distances[i];
+        match_list[i].coordinate = Coordinate(geometry.x[i], geometry.y[i], geometry.z[i]);
+        match_list[i].index      = indices[i];
+    }
+
+    std::sort(match_list.begin(), match_list.end());
+}
+
+
+// -----------------------------------------------------------------------------
+//
+NeighbourhoodTemplates::NeighbourhoodTemplates() :
+    n_basis_(1),
+    repetitions_(3, 1),
+    periodic_(3, false),
+    max_size_(0)
+{
+    // NOTHING HERE.
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void NeighbourhoodTemplates::init(const std::vector<Coordinate> & coordinates,
+                                  const LatticeMap & lattice_map,
+                                  const int range)
+{
+    // {{{
+
+    n_basis_     = lattice_map.nBasis();
+    repetitions_ = lattice_map.repetitions();
+    periodic_[0] = lattice_map.periodicA();
+    periodic_[1] = lattice_map.periodicB();
+    periodic_[2] = lattice_map.periodicC();
+    cell_order_  = lattice_map.cellOrder();
+
+    site_arrays_.clear();
+    max_size_ = 0;
+
+    // The boundary class of each cell coordinate, given by how far the
+    // neighbourhood reaches on each side before a non-periodic boundary,
+    // and the coordinate each class is set up from. All coordinates are in
+    // the same class in the periodic directions.
+    std::vector<int> coordinate_classes[3];
+    std::vector<int> class_origins[3];
+    for (int d = 0; d < 3; ++d)
+    {
+        const int repetitions = repetitions_[d];
+        coordinate_classes[d].assign(repetitions, 0);
+
+        std::vector<std::pair<int, int> > reaches;
+        for (int c = 0; c < repetitions && !periodic_[d]; ++c)
+        {
+            const std::pair<int, int> reach(std::min(c, range),
+                                            std::min(repetitions - 1 - c, range));
+            const int n = std::find(reaches.begin(), reaches.end(), reach) - reaches.begin();
+            if (n == static_cast<int>(reaches.size()))
+            {
+                reaches.push_back(reach);
+            }
+            coordinate_classes[d][c] = n;
+        }
+
+        // Prefer the most central coordinate.
+        class_origins[d].assign(std::max(reaches.size(), size_t(1)), -1);
+        class_origins[d][coordinate_classes[d][repetitions / 2]] = repetitions / 2;
+        for (int c = 0; c < repetitions; ++c)
+        {
+            if (class_origins[d][coordinate_classes[d][c]] < 0)
+            {
+                class_origins[d][coordinate_classes[d][c]] = c;
+            }
+        }
+    }
+
+    const int n_classes_b = class_origins[1].size();
+    const int n_classes_c = class_origins[2].size();
+    const int n_templates = class_origins[0].size() * n_classes_b * n_classes_c * n_basis_;
+
+    offsets_.assign(n_templates, std::vector<CellOffset>());
+    template_origins_.assign(n_templates, -1);
+    geometries_.assign(coordinates.size(), -1);
+    template_arrays_.assign(n_templates, GeometryArrays());
+
+    // The sorted geometry lists are only kept until stored as arrays.
+    RelativeGeometry geometry;
+    ConfigMatchList geometry_list;
+
+    // Setup the templates from the origin cell of each boundary class, with
+    // the templates of one class numbered by basis site.
+    for (int t = 0; t < n_templates; ++t)
+    {
+        const int class_index = t / n_basis_;
+        const int b = t % n_basis_;
+
+        int origin_cell[3];
+        origin_cell[0] = class_origins[0][class_index / (n_classes_b * n_classes_c)];
+        origin_cell[1] = class_origins[1][(class_index / n_classes_c) % n_classes_b];
+        origin_cell[2] = class_origins[2][class_index % n_classes_c];
+
+        const int origin_index = \
+            lattice_map.indicesFromCell(origin_cell[0], origin_cell[1], origin_cell[2])[b];
+        template_origins_[t] = origin_index;
+
+        sortedGeometryList(origin_index,
+                           lattice_map.neighbourIndices(origin_index, range),
+                           coordinates,
+                           lattice_map,
+                           geometry,
+                           geometry_list);
+
+        template_arrays_[t].assign(geometry_list);
+
+        // Store the cell offset of each neighbour, taking the shortest
+        // offset in the periodic directions.
+        const std::vector<int> & template_indices = template_arrays_[t].indices;
+        offsets_[t].resize(template_indices.size());
+
+        for (size_t i = 0; i < template_indices.size(); ++i)
+        {
+            int cell[3];
+            cellFromIndex(template_indices[i], n_basis_, cell_order_, cell);
+
+            int offset[3];
+            for (int d = 0; d < 3; ++d)
+            {
+                offset[d] = cell[d] - origin_cell[d];
+                if (periodic_[d])
+                {
+                    while (offset[d] > range)  { offset[d] -= repetitions_[d]; }
+                    while (offset[d] < -range) { offset[d] += repetitions_[d]; }
+                }
+            }
+
+            offsets_[t][i].i     = offset[0];
+            offsets_[t][i].j     = offset[1];
+            offsets_[t][i].k     = offset[2];
+            offsets_[t][i].basis = template_indices[i] % n_basis_;
+        }
+    }
+
+    // Use the template of the boundary class for each index where the
+    // relative coordinates agree, and store the arrays for all other
+    // indices. The indices are independent and handled over the threads,
+    // each keeping the arrays it sets up until they are stored after the
+    // loop.
+    const int n_sites = coordinates.size();
+    std::vector< std::vector<std::pair<int, GeometryArrays> > > thread_arrays(maxThreads());
+    std::vector<size_t> thread_max_size(thread_arrays.size(), 0);
+
+#pragma omp parallel
+    {
+        const int thread = threadNumber();
+        std::vector<std::pair<int, GeometryArrays> > & arrays = thread_arrays[thread];
+        size_t & max_size = thread_max_size[thread];
+
+        RelativeGeometry relative;
+        ConfigMatchList site_list;
+        std::vector<int> indices;
+
+#pragma omp for schedule(static)
+        for (int index = 0; index < n_sites; ++index)
+        {
+            int cell[3];
+            cellFromIndex(index, n_basis_, cell_order_, cell);
+
+            const int class_index = \
+                (coordinate_classes[0][cell[0]] * n_classes_b +
+                 coordinate_classes[1][cell[1]]) * n_classes_c +
+                coordinate_classes[2][cell[2]];
+
+            const int t = class_index * n_basis_ + index % n_basis_;
+            geometries_[index] = t;
+            neighbourIndices(index, indices);
+            relativeCoordinates(index, indices, coordinates, lattice_map, relative);
+
+            const std::vector<double> & ref = template_arrays_[t].coordinates;
+
+            for (size_t i = 0; i < indices.size(); ++i)
+            {
+                if (std::fabs(relative.x[i] - ref[3*i])   > epsi__ ||
+                    std::fabs(relative.y[i] - ref[3*i+1]) > epsi__ ||
+                    std::fabs(relative.z[i] - ref[3*i+2]) > epsi__)
+                {
+                    geometries_[index] = -1;
+                    break;
+                }
+            }
+
+            if (geometries_[index] < 0)
+            {
+                sortedGeometryList(index,
+                                   lattice_map.neighbourIndices(index, range),
+                                   coordinates,
+                                   lattice_map,
+                                   relative,
+                                   site_list);
+
+                arrays.push_back(std::pair<int, GeometryArrays>(index, GeometryArrays()));
+                arrays.back().second.assign(site_list);
+                max_size = std::max(max_size, site_list.size());
+            }
+            else
+            {
+                max_size = std::max(max_size, template_arrays_[geometries_[index]].size());
+            }
+        }
+    }
+
+    // With a static schedule the threads hold contiguous chunks of the
+    // indices in thread order, so the arrays are stored in increasing index
+    // order.
+    for (size_t t = 0; t < thread_arrays.size(); ++t)
+    {
+        for (size_t i = 0; i < thread_arrays[t].size(); ++i)
+        {
+            std::map<int, GeometryArrays>::iterator it = \
+                site_arrays_.insert(site_arrays_.end(),
+                                    std::pair<int, GeometryArrays>(thread_arrays[t][i].first,
+                                                                   GeometryArrays()));
+            std::swap(it->second, thread_arrays[t][i].second);
+        }
+        std::vector<std::pair<int, GeometryArrays> >().swap(thread_arrays[t]);
+        max_size_ = std::max(max_size_, thread_max_size[t]);
+    }
+
+    // }}}
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void NeighbourhoodTemplates::neighbourIndices(const int index,
+                                              std::vector<int> & indices) const
+{
+    // {{{
+
+    const int t = geometry(index);
+
+    // Copy the indices of stored arrays.
+    if (t < 0)
+    {
+        indices = geometryArrays(index).indices;
+        return;
+    }
+
+    // Resolve the template offsets from the cell of the index.
+    int cell[3];
+    cellFromIndex(index, n_basis_, cell_order_, cell);
+
+    const std::vector<CellOffset> & offsets = offsets_[t];
+    indices.resize(offsets.size());
+
+    for (size_t i = 0; i < offsets.size(); ++i)
+    {
+        indices[i] = indexFromOffset(cell, offsets[i]);
+    }
+
+    // }}}
+}
+
+
+// -----------------------------------------------------------------------------
+//
+int NeighbourhoodTemplates::neighbourIndex(const int index,
+                                          const int position) const
+{
+    const int t = geometry(index);
+
+    if (t < 0)
+    {
+        return geometryArrays(index).indices[position];
+    }
+
+    int cell[3];
+    cellFromIndex(index, n_basis_, cell_order_, cell);
+    return indexFromOffset(cell, offsets_[t][position]);
+}
+
+
+// -----------------------------------------------------------------------------
+//
+int NeighbourhoodTemplates::indexFromOffset(const int cell[3],
+                                           const CellOffset & offset) const
+{
+    int ii = cell[0] + offset.i;
+    int jj = cell[1] + offset.j;
+    int kk = cell[2] + offset.k;
+
+    // Wrap, the offsets can only take us out of the lattice in the
+    // periodic directions.
+    while (ii < 0)                { ii += repetitions_[0]; }
+    while (ii >= repetitions_[0]) { ii -= repetitions_[0]; }
+    while (jj < 0)                { jj += repetitions_[1]; }
+    while (jj >= repetitions_[1]) { jj -= repetitions_[1]; }
+    while (kk < 0)                { kk += repetitions_[2]; }
+    while (kk >= repetitions_[2]) { kk -= repetitions_[2]; }
+
+    return cell_order_.number(ii, jj, kk) * n_basis_ + offset.basis;
+}
+
+
+// -----------------------------------------------------------------------------
+//
+const NeighbourhoodTemplates::GeometryArrays & \
+NeighbourhoodTemplates::geometryArrays(const int index) const
+{
+    const int t = geometry(index);
+
+    if (t >= 0)
+    {
+        return template_arrays_[t];
+    }
+
+    const std::map<int, GeometryArrays>::const_iterator it = site_arrays_.find(index);
+    if (it != site_arrays_.end())
+    {
+        return it->second;
+    }
+
+    return empty_arrays_;
+}
+
@@ -0,0 +1,222 @@
+/*
+  This file is part of the KMCLib project distributed under the terms of the
+  GNU General Public License version 3, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/*! \file  neighbourhoodtemplates.h
+ *  \brief File for the NeighbourhoodTemplates class definition.
+ */
+
+#ifndef __NEIGHBOURHOODTEMPLATES__
+#define __NEIGHBOURHOODTEMPLATES__
+
+#include <vector>
+#include <map>
+
+#include "matchlist.h"
+#include "latticemap.h"
+
+
+/*! \brief Class for storing the sorted neighbourhood geometry of all lattice
+ *         sites, used to construct match lists on demand.
+ *
+ *  The neighbourhood of a site is the same, up to translation, for all
+ *  sites with the same basis site and boundary class. The boundary class
+ *  of a cell is given by how far the neighbourhood reaches in each
+ *  non-periodic direction before it is cut off by the lattice boundary.
+ *  Each neighbourhood is stored once as an ordered template of relative
+ *  coordinates and cell offsets, and the neighbour indices are resolved
+ *  from the cell of the site. Sites where the neighbourhood differs from
+ *  the template, e.g. on an irregular lattice, get their own sorted list.
+ */
+class NeighbourhoodTemplates {
+
+public:
+
+    /*! \brief Default constructor, no sites have a neighbourhood until
+     *         init() is called.
+     */
+    NeighbourhoodTemplates();
+
+    /*! \brief Calculate the neighbourhood templates.
+     *  \param coordinates : The coordinates of all lattice sites.
+     *  \param lattice_map : The lattice map needed to get coordinates wrapped.
+     *  \param range       : The number of shells to include.
+     */
+    void init(const std::vector<Coordinate> & coordinates,
+              const LatticeMap & lattice_map,
+              const int range);
+
+    /*! \brief Query for the geometry of the neighbourhood of an index.
+     *  \param index : The index to get the geometry for.
+     *  \return : The template if the neighbourhood is given by a template,
+     *            otherwise -1.
+     */
+    int geometry(const int index) const
+    { return geometries_.empty() ? -1 : geometries_[index]; }
+
+    /*! \brief Query for the largest neighbourhood size.
+     *  \return : The largest number of sites in a neighbourhood.
+     */
+    size_t maxSize() const { return max_size_; }
+
+    /// The relative cell and absolute basis of a template neighbour.
+    struct CellOffset {
+        int i;
+        int j;
+        int k;
+        int basis;
+    };
+
+    /*! \brief Query for the cell offsets of a template.
+     *  \param geometry : The template to get the offsets for.
+     *  \return : The cell offset of each neighbour in the template.
+     */
+    const std::vector<CellOffset> & cellOffsets(const int geometry) const
+    { return offsets_[geometry]; }
+
+    /// The geometry of a neighbourhood as contiguous arrays, with wildcard
+    /// match types.
+    typedef MatchListArrays GeometryArrays;
+
+    /*! \brief Query for the geometry arrays of an index.
+     *  \param index : The index to get the geometry arrays for.
+     *  \return : The distances and coordinates in match list order, shared
+     *            by all indices with the same template. The indices are
+     *            those of the site the arrays were set up from.
+     */
+    const GeometryArrays & geometryArrays(const int index) const;
+
+    /*! \brief Query for the number of templates.
+     *  \return : The number of basis sites times the number of boundary
+     *            classes, 0 before init() was called.
+     */
+    int nTemplates() const { return template_arrays_.size(); }
+
+    /*! \brief Query for the geometry arrays of a template.
+     *  \param geometry : The template to get the arrays for.
+     *  \return : The sorted relative geometry of the template, set up from
+     *            the origin of the template.
+     */
+    const GeometryArrays & templateArrays(const int geometry) const
+    { return template_arrays_[geometry]; }
+
+    /*! \brief Query for the basis site of a template.
+     *  \param geometry : The template to get the basis site for.
+     *  \return : The basis site of all indices using the template.
+     */
+    int templateBasisSite(const int geometry) const
+    { return geometry % n_basis_; }
+
+    /*! \brief Query for the origin of a template.
+     *  \param geometry : The template to get the origin for.
+     *  \return : The index the template was set up from, in the most
+     *            central cell of its boundary class.
+     */
+    int templateOrigin(const int geometry) const
+    { return template_origins_[geometry]; }
+
+    /*! \brief Get the sorted neighbour indices of an index.
+     *  \param index   : The index to get the neighbours for.
+     *  \param indices : (out) The neighbour indices, in match list order.
+     */
+    void neighbourIndices(const int index, std::vector<int> & indices) const;
+
+    /*! \brief Get a single sorted neighbour index of an index.
+     *  \param index    : The index to get the neighbour for.
+     *  \param position : The position of the neighbour in match list order.
+     *  \return : The neighbour index.
+     */
+    int neighbourIndex(const int index, const int position) const;
+
+    /*! \brief Construct the match list of an index.
+     *  \param index      : The index to construct the match list for.
+     *  \param types      : The current types of all lattice sites.
+     *  \param match_list : (out) The match list, with the coordinates and
+     *                      distances relative to the index.
+     */
+    template <class T>
+    void matchList(const int index,
+                   const std::vector<int> & types,
+                   std::vector<T> & match_list) const;
+
+protected:
+
+private:
+
+    /*! \brief Get the index at a cell offset from a cell, wrapped in the
+     *         periodic directions.
+     *  \param cell   : The cell to start from.
+     *  \param offset : The offset to the index.
+     *  \return : The index.
+     */
+    int indexFromOffset(const int cell[3], const CellOffset & offset) const;
+
+    /// The number of basis sites.
+    int n_basis_;
+
+    /// The lattice repetitions.
+    std::vector<int> repetitions_;
+
+    /// The lattice periodicity.
+    std::vector<bool> periodic_;
+
+    /// The numbering of the lattice cells.
+    CellOrder cell_order_;
+
+    /// The largest neighbourhood size.
+    size_t max_size_;
+
+    /// The cell offsets of each template.
+    std::vector< std::vector<CellOffset> > offsets_;
+
+    /// The origin index of each template.
+    std::vector<int> template_origins_;
+
+    /// The geometry of each index, see geometry().
+    std::vector<int> geometries_;
+
+    /// The geometry arrays of the templates.
+    std::vector<GeometryArrays> template_arrays_;
+
+    /// The geometry arrays for the indices not given by a template.
+    std::map<int, GeometryArrays> site_arrays_;
+
+    /// The empty arrays returned for indices without geometry.
+    GeometryArrays empty_arrays_;
+
+};
+
+
+// -----------------------------------------------------------------------------
+// Inlined function definitions follow.
+// -----------------------------------------------------------------------------
+
+
+// -----------------------------------------------------------------------------
+//
+template <class T>
+void NeighbourhoodTemplates::matchList(const int index,
+                                       const std::vector<int> & types,
+                                       std::vector<T> & match_list) const
+{
+    const GeometryArrays & arrays = geometryArrays(index);
+    const size_t size = arrays.size();
+
+    std::vector<int> indices;
+    neighbourIndices(index, indices);
+
+    match_list.resize(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        match_list[i].distance   = arrays.distances[i];
+        match_list[i].coordinate = arrays.coordinate(i);
+        match_list[i].index      = indices[i];
+        match_list[i].match_type = types[indices[i]];
+    }
+}
+
+
+#endif // __NEIGHBOURHOODTEMPLATES__
+
@@ -24,11 +24,11 @@ OnTheFlyMSD::OnTheFlyMSD(const Configuration & configuration,
                          const std::string track_type,
                          const std::vector<Coordinate> & abc_to_xyz,
                          const int blocksize) :
-    history_buffer_(configuration.elements().size(), std::vector<std::pair<Coordinate, double> >(0)),
+    history_buffer_(configuration.types().size(), std::vector<std::pair<Coordinate, double> >(0)),
     histogram_buffer_(n_bins, Coordinate(0.0, 0.0, 0.0)),
     histogram_buffer_sqr_(n_bins, Coordinate(0.0, 0.0, 0.0)),
     histogram_bin_counts_(n_bins, 0),
-    track_type_(track_type),
+    track_type_(-1),
     t_max_(t_max),
     bin_size_(t_max_/n_bins),
     history_steps_(history_steps),
@@ -37,9 +37,17 @@ OnTheFlyMSD::OnTheFlyMSD(const Configuration & configuration,
     hstep_counts_(history_steps, 0),
     blocker_(n_bins, blocksize)
 {
+    // Get the integer representation of the tracking type.
+    const std::map<std::string, int> & possible_types = configuration.possibleTypes();
+    std::map<std::string, int>::const_iterator it = possible_types.find(track_type);
+    if (it != possible_types.end())
+    {
+        track_type_ = it->second;
+    }
+
     // Populate the history buffer with initial coordinates for tracked atoms.
     const std::vector<Coordinate> & atom_id_coords = configuration.atomIDCoordinates();
-    const std::vector<std::string> & types  = configuration.atomIDElements();
+    const std::vector<int> & types = configuration.atomIDTypes();
 
     for (size_t i = 0; i < atom_id_coords.size(); ++i)
     {
@@ -58,7 +66,7 @@ void OnTheFlyMSD::registerStep(const double time,
 {
     // Get the moved atom IDs.
     const std::vector<int> & moved_atom_ids = configuration.movedAtomIDs();
-    const std::vector<std::string> & types  = configuration.atomIDElements();
+    const std::vector<int> & types = configuration.atomIDTypes();
 
     for (size_t i = 0; i < moved_atom_ids.size(); ++i)
     {
@@ -116,8 +116,8 @@ private:
     /// The histogram bin counts.
     std::vector<int> histogram_bin_counts_;
 
-    /// The tracking type.
-    std::string track_type_;
+    /// The tracking type in integer representation, -1 if not a possible type.
+    int track_type_;
 
     /// The max time for binning.
     double t_max_;
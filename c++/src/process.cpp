@@ -30,6 +30,8 @@
 #include "process.h"
 #include "random.h"
 #include "configuration.h"
+#include "latticemap.h"
+#include "checkpoint.h"
 
 // -----------------------------------------------------------------------------
 //
@@ -154,6 +156,7 @@ Process::Process(const Configuration & first,
 //
 void Process::addSite(const int index, const double rate)
 {
+    site_positions_[index] = sites_.size();
     sites_.push_back(index);
 }
 
@@ -161,31 +164,112 @@ void Process::addSite(const int index, const double rate)
 //
 void Process::removeSite(const int index)
 {
-    // Find the index to remove.
-    std::vector<int>::iterator it1 = std::find(sites_.begin(),
-                                               sites_.end(),
-                                               index);
-    // Swap the index to remove with the last index.
-    std::vector<int>::iterator last = sites_.end()-1;
-    std::swap((*it1), (*last));
-    // Remove the last index from the list.
+    // Look up the position of the index to remove.
+    std::unordered_map<int, size_t>::iterator it = site_positions_.find(index);
+    const size_t position = it->second;
+    site_positions_.erase(it);
+
+    // Move the last index into its place and remove the last.
+    const int last = sites_.back();
     sites_.pop_back();
+
+    if (position < sites_.size())
+    {
+        sites_[position] = last;
+        site_positions_[last] = position;
+    }
 }
 
 // -----------------------------------------------------------------------------
 //
 int Process::pickSite() const
 {
-    // Draw an integer between 0 and sites_.size() - 1
-    const int rnd = static_cast<int>(randomDouble01() * sites_.size());
-    return sites_[rnd];
+    return selectSite(randomDouble01());
+}
+
+// -----------------------------------------------------------------------------
+//
+int Process::pickSite(CounterRandom & rng) const
+{
+    return selectSite(rng.randomDouble01());
+}
+
+// -----------------------------------------------------------------------------
+//
+int Process::selectSite(const double rnd) const
+{
+    // Get an integer between 0 and sites_.size() - 1
+    const int index = static_cast<int>(rnd * sites_.size());
+    return sites_[index];
+}
+
+// -----------------------------------------------------------------------------
+//
+void Process::writeCheckpoint(std::ostream & stream) const
+{
+    writeBinary(stream, sites_);
+}
+
+// -----------------------------------------------------------------------------
+//
+void Process::readCheckpoint(std::istream & stream)
+{
+    readBinary(stream, sites_);
+
+    site_positions_.clear();
+    for (size_t i = 0; i < sites_.size(); ++i)
+    {
+        site_positions_[sites_[i]] = i;
+    }
 }
 
 // -----------------------------------------------------------------------------
 //
-bool Process::isListed(const int index) const
+void Process::compileMatchList(const Configuration & configuration,
+                               const LatticeMap & lattice_map)
 {
-    // Search in the list to find out if it is added.
-    return std::find(sites_.begin(), sites_.end(), index) != sites_.end();
+    // {{{
+
+    // Keep the non-wildcard entries, and the changed types.
+    compiled_match_list_.clear();
+    update_types_.assign(match_list_.size(), 0);
+
+    for (size_t i = 0; i < match_list_.size(); ++i)
+    {
+        if (match_list_[i].match_type != 0)
+        {
+            CompiledMatchListEntry entry;
+            entry.slot = i;
+            entry.match_type = match_list_[i].match_type;
+            compiled_match_list_.push_back(entry);
+        }
+
+        if (match_list_[i].update_type != match_list_[i].match_type)
+        {
+            update_types_[i] = match_list_[i].update_type;
+        }
+    }
+
+    // Check the geometry against the configuration match list at the
+    // origin of each neighbourhood template.
+    const NeighbourhoodTemplates & neighbourhoods = configuration.neighbourhoods();
+    geometry_matches_.resize(neighbourhoods.nTemplates());
+
+    for (int t = 0; t < neighbourhoods.nTemplates(); ++t)
+    {
+        const ConfigMatchList & config_matchlist = \
+            configuration.matchList(neighbourhoods.templateOrigin(t));
+
+        bool same = (config_matchlist.size() >= match_list_.size());
+        for (size_t i = 0; same && i < compiled_match_list_.size(); ++i)
+        {
+            const int slot = compiled_match_list_[i].slot;
+            same = match_list_[slot].samePoint(config_matchlist[slot]);
+        }
+
+        geometry_matches_[t] = same;
+    }
+
+    // }}}
 }
 
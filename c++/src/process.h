@@ -28,11 +28,15 @@
 #include <vector>
 #include <map>
 #include <string>
+#include <unordered_map>
+#include <iosfwd>
 
 #include "matchlist.h"
 
 // Forward declarations.
 class Configuration;
+class LatticeMap;
+class CounterRandom;
 
 /*! \brief Class for defining a possible process int the system.
  */
@@ -128,15 +132,48 @@ public:
      */
     virtual void addSite(const int index, const double rate=0.0);
 
-    /*! \brief Remove the index from the list of available sites.
-     *  \param index : The index to remove.
+    /*! \brief Remove the index from the list of available sites. The last
+     *         listed site is moved into the place of the removed one.
+     *  \param index : The index to remove, which must be listed.
      */
     virtual void removeSite(const int index);
 
+    /*! \brief Update the rate of an index in the list of available sites.
+     *         This function does nothing if not overloaded, since all sites
+     *         share the same rate constant.
+     *  \param index : The index to update, which must be listed.
+     *  \param rate  : Dummy argument needed for common interface.
+     */
+    virtual void updateSite(const int index, const double rate) {}
+
     /*! \brief Pick a random available process.
      *  \return : A random available process.
      */
-    virtual int pickSite() const;
+    int pickSite() const;
+
+    /*! \brief Pick a random available process, drawing from the given
+     *         random stream instead of the global generator.
+     *  \param rng : The random stream to draw from.
+     *  \return : A random available process.
+     */
+    int pickSite(CounterRandom & rng) const;
+
+    /*! \brief Select the available site corresponding to a random number.
+     *  \param rnd : A random number on the interval (0.0,1.0).
+     *  \return : The selected site.
+     */
+    virtual int selectSite(const double rnd) const;
+
+    /*! \brief Write the listed sites to a binary checkpoint stream.
+     *  \param stream : The stream to write to.
+     */
+    virtual void writeCheckpoint(std::ostream & stream) const;
+
+    /*! \brief Replace the listed sites with the ones of a binary checkpoint
+     *         stream, in the same order.
+     *  \param stream : The stream to read from.
+     */
+    virtual void readCheckpoint(std::istream & stream);
 
     /*! \brief Interface function for inherited classes.
      *         This function does nothing if not overloaded.
@@ -157,7 +194,8 @@ public:
      *  \param index : The index to check.
      *  \return : True if match.
      */
-    bool isListed(const int index) const;
+    bool isListed(const int index) const
+    { return site_positions_.find(index) != site_positions_.end(); }
 
     /*! \brief Query for the available sites for this process.
      *         Convenient when testing other functionality of the class.
@@ -175,6 +213,41 @@ public:
      */
     ProcessMatchList & matchList() { return match_list_; }
 
+    /*! \brief Compile the match list into the types to check at each
+     *         position, and check the geometry against the match list at
+     *         the origin of each neighbourhood template of the configuration.
+     *         Must be called again if the match list is changed.
+     *  \param configuration : The configuration with initialized match lists.
+     *  \param lattice_map   : The lattice map of the configuration.
+     */
+    void compileMatchList(const Configuration & configuration,
+                          const LatticeMap & lattice_map);
+
+    /*! \brief Query for the compiled match list flag.
+     *  \return : True if compileMatchList() has been called.
+     */
+    bool hasCompiledMatchList() const { return !geometry_matches_.empty(); }
+
+    /*! \brief Query for the compiled match list.
+     *  \return : The non-wildcard positions and types of the match list.
+     */
+    const CompiledMatchList & compiledMatchList() const
+    { return compiled_match_list_; }
+
+    /*! \brief Query for the types after the process.
+     *  \return : The type after the process at each match list position,
+     *            0 where the type is not changed, set by compileMatchList().
+     */
+    const std::vector<int> & updateTypes() const { return update_types_; }
+
+    /*! \brief Query for the geometry match of the compiled match list.
+     *  \param geometry : The match list geometry (template) to check for.
+     *  \return : True if the process can match a configuration match list
+     *            with the given geometry.
+     */
+    bool geometryMatches(const int geometry) const
+    { return geometry_matches_[geometry]; }
+
     /*! \brief Query for the latest affected indices.
      *  \return : The affected indices from the last time the process was
      *            performed on a calculation.
@@ -254,9 +327,23 @@ protected:
     /// The available sites for this process.
     std::vector<int> sites_;
 
+    /*! \brief The position of each available site in the sites_ list,
+     *         giving constant time membership tests and removals.
+     */
+    std::unordered_map<int, size_t> site_positions_;
+
     /// The match list for comparing against local configurations.
     ProcessMatchList match_list_;
 
+    /// The compiled match list with the types to check.
+    CompiledMatchList compiled_match_list_;
+
+    /// The types after the process at each match list position.
+    std::vector<int> update_types_;
+
+    /// The geometry match flag for each basis site.
+    std::vector<bool> geometry_matches_;
+
     /*! \brief: The configuration indices that were affected last time
      *          the process was used to update a configuration.
      */
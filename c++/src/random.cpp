@@ -15,11 +15,13 @@
 #include "random.h"
 #include "mpicommons.h"
 #include "mpiroutines.h"
+#include "checkpoint.h"
 #include <ctime>
 #include <stdexcept>
 
 // c++11
 #include <random>
+#include <sstream>
 
 // On systems where std::random_device isn't implemented in the
 // standard <random> header this definition must be commented out,
@@ -35,6 +37,7 @@ static std::mt19937       rng_mt__;
 static std::minstd_rand   rng_minstd__;
 static std::ranlux24      rng_ranlux24__;
 static std::ranlux48      rng_ranlux48__;
+static CounterRandom      rng_philox__;
 
 #ifdef __DEVICE__
 static std::random_device rng_device__;
@@ -42,6 +45,182 @@ static std::random_device rng_device__;
 
 static RNG_TYPE rng_type__ = MT;
 
+
+// -----------------------------------------------------------------------------
+// The Philox4x32 multipliers and Weyl key increments.
+static const uint32_t PHILOX_M0 = 0xD2511F53;
+static const uint32_t PHILOX_M1 = 0xCD9E8D57;
+static const uint32_t PHILOX_W0 = 0x9E3779B9;
+static const uint32_t PHILOX_W1 = 0xBB67AE85;
+
+
+// -----------------------------------------------------------------------------
+//
+CounterRandom::CounterRandom(const uint64_t seed,
+                             const uint64_t stream)
+{
+    this->seed(seed, stream);
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void CounterRandom::seed(const uint64_t seed, const uint64_t stream)
+{
+    key_[0] = static_cast<uint32_t>(seed);
+    key_[1] = static_cast<uint32_t>(seed >> 32);
+
+    counter_[0] = 0;
+    counter_[1] = 0;
+    counter_[2] = static_cast<uint32_t>(stream);
+    counter_[3] = static_cast<uint32_t>(stream >> 32);
+
+    generateBlock();
+    position_ = 0;
+}
+
+
+// -----------------------------------------------------------------------------
+//
+uint64_t CounterRandom::streamId() const
+{
+    return (static_cast<uint64_t>(counter_[3]) << 32) | counter_[2];
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void CounterRandom::setKeyAndCounter(const uint32_t key[2],
+                                     const uint32_t counter[4])
+{
+    std::copy(key, key + 2, key_);
+    std::copy(counter, counter + 4, counter_);
+    generateBlock();
+    position_ = 0;
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void CounterRandom::generateBlock()
+{
+    // {{{
+    uint32_t x[4] = {counter_[0], counter_[1], counter_[2], counter_[3]};
+    uint32_t k[2] = {key_[0], key_[1]};
+
+    // Ten rounds, bumping the key between the rounds.
+    for (int round = 0; round < 10; ++round)
+    {
+        const uint64_t p0 = static_cast<uint64_t>(PHILOX_M0) * x[0];
+        const uint64_t p1 = static_cast<uint64_t>(PHILOX_M1) * x[2];
+
+        const uint32_t hi0 = static_cast<uint32_t>(p0 >> 32);
+        const uint32_t lo0 = static_cast<uint32_t>(p0);
+        const uint32_t hi1 = static_cast<uint32_t>(p1 >> 32);
+        const uint32_t lo1 = static_cast<uint32_t>(p1);
+
+        x[0] = hi1 ^ x[1] ^ k[0];
+        x[1] = lo1;
+        x[2] = hi0 ^ x[3] ^ k[1];
+        x[3] = lo0;
+
+        k[0] += PHILOX_W0;
+        k[1] += PHILOX_W1;
+    }
+
+    std::copy(x, x + 4, block_);
+    // }}}
+}
+
+
+// -----------------------------------------------------------------------------
+//
+CounterRandom::result_type CounterRandom::operator()()
+{
+    // Move on to the next block in the stream when this one is used up.
+    // Only the lower half of the counter is incremented, so the stream
+    // id in the upper half is kept.
+    if (position_ == 4)
+    {
+        if (++counter_[0] == 0)
+        {
+            ++counter_[1];
+        }
+        generateBlock();
+        position_ = 0;
+    }
+
+    return block_[position_++];
+}
+
+
+// -----------------------------------------------------------------------------
+//
+double CounterRandom::randomDouble01()
+{
+    // Combine 27 and 26 bits to 53 bits, and shift by half a unit to stay
+    // off both 0.0 and 1.0.
+    const uint64_t a = (*this)() >> 5;
+    const uint64_t b = (*this)() >> 6;
+    return ((a << 26) + b + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void CounterRandom::fill(double * buffer, const size_t size)
+{
+    for (size_t i = 0; i < size; ++i)
+    {
+        buffer[i] = randomDouble01();
+    }
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void CounterRandom::writeState(std::ostream & stream) const
+{
+    for (int i = 0; i < 2; ++i)
+    {
+        writeBinary(stream, key_[i]);
+    }
+    for (int i = 0; i < 4; ++i)
+    {
+        writeBinary(stream, counter_[i]);
+    }
+    writeBinary(stream, static_cast<int32_t>(position_));
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void CounterRandom::readState(std::istream & stream)
+{
+    uint32_t key[2];
+    uint32_t counter[4];
+    int32_t position;
+
+    for (int i = 0; i < 2; ++i)
+    {
+        readBinary(stream, key[i]);
+    }
+    for (int i = 0; i < 4; ++i)
+    {
+        readBinary(stream, counter[i]);
+    }
+    readBinary(stream, position);
+
+    if (position < 0 || position > 4)
+    {
+        throw std::runtime_error("Invalid counter based random number generator state.");
+    }
+
+    // The block is a function of the key and counter and is regenerated.
+    setKeyAndCounter(key, counter);
+    position_ = position;
+}
+
 // -----------------------------------------------------------------------------
 //
 bool setRngType(const RNG_TYPE rng_type)
@@ -114,6 +293,10 @@ void seedRandom(const bool time_seed, int seed)
         rng_ranlux48__.seed(seed);
         break;
 
+    case PHILOX:
+        rng_philox__.seed(static_cast<uint32_t>(seed));
+        break;
+
     case DEVICE:
         // No seeding functionality for DEVICE.
         break;
@@ -144,6 +327,9 @@ double randomDouble01()
     case RANLUX48:
         return std::generate_canonical<double, 32>(rng_ranlux48__);
 
+    case PHILOX:
+        return rng_philox__.randomDouble01();
+
 #ifdef __DEVICE__
     case DEVICE:
         return std::generate_canonical<double, 32>(rng_device__);
@@ -179,6 +365,10 @@ void shuffleVector(VectorType & v)
         std::shuffle(v.begin(), v.end(), rng_ranlux48__);
         break;
 
+    case PHILOX:
+        std::shuffle(v.begin(), v.end(), rng_philox__);
+        break;
+
 #ifdef __DEVICE__
     case DEVICE:
         std::shuffle(v.begin(), v.end(), rng_device__);
@@ -192,6 +382,103 @@ void shuffleVector(VectorType & v)
 }
 
 
+// -----------------------------------------------------------------------------
+//
+void writeRandomState(std::ostream & stream)
+{
+    // {{{
+    // The standard engines write their full state as text.
+    std::ostringstream state;
+
+    switch (rng_type__)
+    {
+    case MT:
+        state << rng_mt__;
+        break;
+
+    case MINSTD:
+        state << rng_minstd__;
+        break;
+
+    case RANLUX24:
+        state << rng_ranlux24__;
+        break;
+
+    case RANLUX48:
+        state << rng_ranlux48__;
+        break;
+
+    case PHILOX:
+        rng_philox__.writeState(state);
+        break;
+
+    case DEVICE:
+        // No state to write for DEVICE.
+        break;
+
+    default:
+        // This can never happen from previous checks.
+        throw std::runtime_error("Invalid random number generator.");
+    }
+
+    writeBinary(stream, static_cast<int32_t>(rng_type__));
+    writeBinary(stream, state.str());
+    // }}}
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void readRandomState(std::istream & stream)
+{
+    // {{{
+    int32_t rng_type;
+    readBinary(stream, rng_type);
+
+    std::string text;
+    readBinary(stream, text);
+    std::istringstream state(text);
+
+    switch (rng_type)
+    {
+    case MT:
+        state >> rng_mt__;
+        break;
+
+    case MINSTD:
+        state >> rng_minstd__;
+        break;
+
+    case RANLUX24:
+        state >> rng_ranlux24__;
+        break;
+
+    case RANLUX48:
+        state >> rng_ranlux48__;
+        break;
+
+    case PHILOX:
+        rng_philox__.readState(state);
+        break;
+
+    case DEVICE:
+        // No state to read for DEVICE.
+        break;
+
+    default:
+        throw std::runtime_error("Invalid random number generator in the checkpoint.");
+    }
+
+    if (!state)
+    {
+        throw std::runtime_error("Invalid random number generator state in the checkpoint.");
+    }
+
+    rng_type__ = static_cast<RNG_TYPE>(rng_type);
+    // }}}
+}
+
+
 // ----------------------------------------------------------------------------
 //
 void shuffleIntVector(std::vector<int> & v)
@@ -226,6 +513,9 @@ int randomPickInt(const std::vector<int> & v)
     case RANLUX48:
         return *randomPick(v.begin(), v.end(), rng_ranlux48__);
 
+    case PHILOX:
+        return *randomPick(v.begin(), v.end(), rng_philox__);
+
 #ifdef __DEVICE__
     case DEVICE:
         return *randomPick(v.begin(), v.end(), rng_device__);
@@ -24,13 +24,124 @@
 #define __RANDOM__
 
 #include <algorithm>
+#include <cstdint>
 #include <vector>
+#include <iosfwd>
 
 // Forward declarations.
 class Process;
 
 /// The supported random number generator types.
-enum RNG_TYPE {MT, MINSTD, RANLUX24, RANLUX48, DEVICE};
+enum RNG_TYPE {MT, MINSTD, RANLUX24, RANLUX48, DEVICE, PHILOX};
+
+
+/*! \brief Counter based random number generator (Philox4x32-10, Salmon et al.,
+ *         SC'11). Each number is a pure function of the key, given by the
+ *         seed, and a counter, of which the upper half holds the stream id.
+ *         Streams with different ids are independent, which lets each thread
+ *         or replica draw its own reproducible sequence without sharing an
+ *         engine, and the full state is a handful of integers.
+ *         The class fulfills the uniform random bit generator requirements
+ *         and can be passed to the standard library algorithms.
+ */
+class CounterRandom {
+
+public:
+
+    /// The type of the generated integers.
+    typedef uint32_t result_type;
+
+    /*! \brief Constructor.
+     *  \param seed   : The seed, used as the key of the generator.
+     *  \param stream : The id of the stream to draw from.
+     */
+    CounterRandom(const uint64_t seed = 0, const uint64_t stream = 0);
+
+    /*! \brief Restart the generator at the beginning of a stream.
+     *  \param seed   : The seed, used as the key of the generator.
+     *  \param stream : The id of the stream to draw from.
+     */
+    void seed(const uint64_t seed, const uint64_t stream = 0);
+
+    /*! \brief Query for the id of the stream.
+     *  \return : The stream id.
+     */
+    uint64_t streamId() const;
+
+    /*! \brief The smallest generated integer.
+     */
+    static constexpr result_type min() { return 0; }
+
+    /*! \brief The largest generated integer.
+     */
+    static constexpr result_type max() { return 0xFFFFFFFF; }
+
+    /*! \brief Draw the next 32-bit integer of the stream.
+     *  \return : A pseudo random integer on [min(), max()].
+     */
+    result_type operator()();
+
+    /*! \brief Draw a pseudo random number from 53 bits of the stream.
+     *  \return : A pseudo random number on the interval (0.0,1.0)
+     */
+    double randomDouble01();
+
+    /*! \brief Fill a buffer with pseudo random numbers on (0.0,1.0), taking
+     *         the same numbers as repeated calls to randomDouble01().
+     *  \param buffer : The buffer to fill.
+     *  \param size   : The number of values to write to the buffer.
+     */
+    void fill(double * buffer, const size_t size);
+
+    /*! \brief Fill a vector with pseudo random numbers on (0.0,1.0).
+     *  \param buffer : The vector to fill, keeping its size.
+     */
+    void fill(std::vector<double> & buffer)
+    { if (!buffer.empty()) { fill(&buffer[0], buffer.size()); } }
+
+    /*! \brief Write the key, counter and position in the present block to
+     *         a binary stream.
+     *  \param stream : The stream to write to.
+     */
+    void writeState(std::ostream & stream) const;
+
+    /*! \brief Restore the state written by writeState, such that the same
+     *         sequence of numbers follows as after the writing.
+     *  \param stream : The stream to read from.
+     */
+    void readState(std::istream & stream);
+
+    /*! \brief Query for the present block, for testing.
+     *  \return : The four words generated from the present counter.
+     */
+    std::vector<uint32_t> block() const
+    { return std::vector<uint32_t>(block_, block_ + 4); }
+
+    /*! \brief Set the key and counter explicitly and generate the block.
+     *  \param key     : The two key words.
+     *  \param counter : The four counter words.
+     */
+    void setKeyAndCounter(const uint32_t key[2], const uint32_t counter[4]);
+
+private:
+
+    /*! \brief Generate the block of the present counter.
+     */
+    void generateBlock();
+
+    /// The key.
+    uint32_t key_[2];
+
+    /// The counter, with the block index in the lower and the stream id in the upper half.
+    uint32_t counter_[4];
+
+    /// The four words generated from the present counter.
+    uint32_t block_[4];
+
+    /// The position of the next word to return from the block.
+    int position_;
+
+};
 
 
 /*! \brief Set the type of random number generator to use.
@@ -47,8 +158,23 @@ bool setRngType(const RNG_TYPE rng_type);
 void seedRandom(const bool time_seed, int seed);
 
 
+/*! \brief Write the type and the engine state of the random number
+ *         generator to a binary checkpoint stream.
+ *  \param stream : The stream to write to.
+ */
+void writeRandomState(std::ostream & stream);
+
+
+/*! \brief Restore the type and the engine state of the random number
+ *         generator from a binary checkpoint stream, such that the same
+ *         sequence of random numbers follows as after the writing.
+ *  \param stream : The stream to read from.
+ */
+void readRandomState(std::istream & stream);
+
+
 /*! \brief Get a pseudo random number between 0.0 and 1.0 using the
- *         std::mt19937 random number generator.
+ *         selected global random number generator.
  *  \return : A pseudo random number on the interval (0.0,1.0)
  */
 double randomDouble01();
@@ -0,0 +1,142 @@
+/*
+  This file is part of the KMCLib project distributed under the terms of the
+  GNU General Public License version 3, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/*! \file  ratecache.cpp
+ *  \brief File for the implementation code of the RateCache class.
+ */
+
+#include "ratecache.h"
+
+
+// -----------------------------------------------------------------------------
+//
+size_t RateCache::KeyHash::operator()(const std::vector<int> & key) const
+{
+    // FNV-1a over the bytes of the integers.
+    size_t hash = 2166136261u;
+    for (size_t i = 0; i < key.size(); ++i)
+    {
+        unsigned int value = static_cast<unsigned int>(key[i]);
+        for (int b = 0; b < 4; ++b)
+        {
+            hash ^= (value & 0xff);
+            hash *= 16777619u;
+            value >>= 8;
+        }
+    }
+    return hash;
+}
+
+
+// -----------------------------------------------------------------------------
+//
+RateCache::RateCache(const size_t capacity) :
+    capacity_(capacity),
+    hand_(0),
+    hits_(0),
+    misses_(0)
+{
+    // NOTHING HERE.
+}
+
+
+// -----------------------------------------------------------------------------
+//
+bool RateCache::find(const std::vector<int> & key, double & rate)
+{
+    const std::unordered_map<std::vector<int>, size_t, KeyHash>::const_iterator it = \
+        positions_.find(key);
+
+    if (it == positions_.end())
+    {
+        ++misses_;
+        return false;
+    }
+
+    Entry & entry = entries_[it->second];
+    entry.referenced = true;
+    rate = entry.rate;
+    ++hits_;
+    return true;
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void RateCache::insert(const std::vector<int> & key, const double rate)
+{
+    // {{{
+
+    if (capacity_ == 0)
+    {
+        return;
+    }
+
+    // Update an existing entry.
+    const std::unordered_map<std::vector<int>, size_t, KeyHash>::const_iterator it = \
+        positions_.find(key);
+
+    if (it != positions_.end())
+    {
+        entries_[it->second].rate       = rate;
+        entries_[it->second].referenced = true;
+        return;
+    }
+
+    // Add while there is space left.
+    if (entries_.size() < capacity_)
+    {
+        Entry entry;
+        entry.key        = key;
+        entry.rate       = rate;
+        entry.referenced = false;
+        positions_[key] = entries_.size();
+        entries_.push_back(entry);
+        return;
+    }
+
+    // Move the hand to the first entry not used since it last passed,
+    // giving the used entries a second chance.
+    while (entries_[hand_].referenced)
+    {
+        entries_[hand_].referenced = false;
+        hand_ = (hand_ + 1) % entries_.size();
+    }
+
+    // Replace it.
+    Entry & entry = entries_[hand_];
+    positions_.erase(entry.key);
+    entry.key        = key;
+    entry.rate       = rate;
+    entry.referenced = false;
+    positions_[key] = hand_;
+
+    hand_ = (hand_ + 1) % entries_.size();
+
+    // }}}
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void RateCache::clear()
+{
+    entries_.clear();
+    positions_.clear();
+    hand_   = 0;
+    hits_   = 0;
+    misses_ = 0;
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void RateCache::setCapacity(const size_t capacity)
+{
+    clear();
+    capacity_ = capacity;
+}
+
@@ -0,0 +1,124 @@
+/*
+  This file is part of the KMCLib project distributed under the terms of the
+  GNU General Public License version 3, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/*! \file  ratecache.h
+ *  \brief File for the RateCache class definition.
+ */
+
+#ifndef __RATECACHE__
+#define __RATECACHE__
+
+#include <vector>
+#include <unordered_map>
+#include <cstddef>
+
+
+/*! \brief Class for storing custom rates by the local environment they were
+ *         calculated for, with a bounded number of entries.
+ *
+ *  A key is a list of integers, e.g. the process, the neighbourhood
+ *  geometry and the types within the cutoff. When the cache is full the
+ *  entry to replace is picked with the clock algorithm: the hand sweeps the
+ *  entries and replaces the first one not used since it last passed.
+ */
+class RateCache {
+
+public:
+
+    /*! \brief Constructor.
+     *  \param capacity : The maximum number of rates to store, 0 disables
+     *                    the cache.
+     */
+    explicit RateCache(const size_t capacity = 0);
+
+    /*! \brief Look up a rate.
+     *  \param key  : The key to look up.
+     *  \param rate : (out) The stored rate, if found.
+     *  \return : True if the key was found.
+     */
+    bool find(const std::vector<int> & key, double & rate);
+
+    /*! \brief Store a rate, replacing an old entry if the cache is full.
+     *  \param key  : The key to store the rate for.
+     *  \param rate : The rate to store.
+     */
+    void insert(const std::vector<int> & key, const double rate);
+
+    /*! \brief Remove all stored rates and reset the statistics.
+     */
+    void clear();
+
+    /*! \brief Set the capacity, removing all stored rates.
+     *  \param capacity : The maximum number of rates to store, 0 disables
+     *                    the cache.
+     */
+    void setCapacity(const size_t capacity);
+
+    /*! \brief Query for the capacity.
+     *  \return : The maximum number of rates stored.
+     */
+    size_t capacity() const { return capacity_; }
+
+    /*! \brief Query for the number of stored rates.
+     *  \return : The number of rates in the cache.
+     */
+    size_t size() const { return entries_.size(); }
+
+    /*! \brief Query for the number of successful look ups.
+     *  \return : The number of hits since the last clear().
+     */
+    unsigned long hits() const { return hits_; }
+
+    /*! \brief Query for the number of failed look ups.
+     *  \return : The number of misses since the last clear().
+     */
+    unsigned long misses() const { return misses_; }
+
+protected:
+
+private:
+
+    /// Hash function for the integer keys.
+    struct KeyHash {
+        size_t operator()(const std::vector<int> & key) const;
+    };
+
+    /// A stored rate.
+    struct Entry {
+
+        /// The key of the rate.
+        std::vector<int> key;
+
+        /// The rate.
+        double rate;
+
+        /// The flag set when the entry is used, cleared by the clock hand.
+        bool referenced;
+
+    };
+
+    /// The maximum number of entries.
+    size_t capacity_;
+
+    /// The entries, in the order swept by the clock hand.
+    std::vector<Entry> entries_;
+
+    /// The position of each key in the entries.
+    std::unordered_map<std::vector<int>, size_t, KeyHash> positions_;
+
+    /// The position of the clock hand.
+    size_t hand_;
+
+    /// The number of hits.
+    unsigned long hits_;
+
+    /// The number of misses.
+    unsigned long misses_;
+
+};
+
+
+#endif // __RATECACHE__
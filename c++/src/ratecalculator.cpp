@@ -17,7 +17,19 @@
 
 // -----------------------------------------------------------------------------
 //
-RateCalculator::RateCalculator()
+RateCalculator::RateCalculator() :
+    thread_safe_(false),
+    integer_types_(false)
+{
+}
+
+
+// -----------------------------------------------------------------------------
+//
+RateCalculator::RateCalculator(const bool thread_safe,
+                               const bool integer_types) :
+    thread_safe_(thread_safe),
+    integer_types_(integer_types)
 {
 }
 
@@ -28,6 +40,29 @@ RateCalculator::~RateCalculator()
 {
 }
 
+
+// -----------------------------------------------------------------------------
+//
+ThreadSafeRateCalculator::ThreadSafeRateCalculator() :
+    RateCalculator(true)
+{
+}
+
+
+// -----------------------------------------------------------------------------
+//
+ThreadSafeRateCalculator::ThreadSafeRateCalculator(const bool integer_types) :
+    RateCalculator(true, integer_types)
+{
+}
+
+
+// -----------------------------------------------------------------------------
+//
+ThreadSafeRateCalculator::~ThreadSafeRateCalculator()
+{
+}
+
 // -----------------------------------------------------------------------------
 // -----------------------------------------------------------------------------
 // PROTOTYPE AND TEST CODE FOLLOW
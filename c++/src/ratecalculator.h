@@ -17,6 +17,11 @@
 #include <string>
 
 #include "coordinate.h"
+#include "rateplugin.h"
+
+// Forward declarations.
+class Configuration;
+class Process;
 
 /*! \brief Class for defining the interface for making a custom Python
  *         rate calculator function called from within the inner C++ loop.
@@ -58,8 +63,133 @@ public:
                                        const double global_y,
                                        const double global_z) const { return rate_constant; }
 
+    /*! \brief The backend callback function for calculating the rates of
+     *         many processes at once, used if batchCallback() returns true.
+     *         The KMCRateCalculatorPlugin class in python overloads this
+     *         function to pass the data on as NumPy arrays.
+     * \param geometry           : The geometries of all tasks after each other,
+     *                             with x,y,z coordinates for each site.
+     * \param lengths            : The number of sites of each task.
+     * \param types_before       : The integer types before the process, for the
+     *                             sites of all tasks after each other.
+     * \param types_after        : The integer types after the process, for the
+     *                             sites of all tasks after each other.
+     * \param rate_constants     : The rate constant of the process of each task.
+     * \param process_numbers    : The id number of the process of each task.
+     * \param global_coordinates : The global coordinate of the central site of
+     *                             each task, x,y,z after each other.
+     * \return : The rate of each task. The base class implementation returns
+     *           the rate constants unmodified.
+     */
+    virtual std::vector<double> backendBatchRateCallback(const std::vector<double> & geometry,
+                                                         const std::vector<int> & lengths,
+                                                         const std::vector<int> & types_before,
+                                                         const std::vector<int> & types_after,
+                                                         const std::vector<double> & rate_constants,
+                                                         const std::vector<int> & process_numbers,
+                                                         const std::vector<double> & global_coordinates) const
+    { return rate_constants; }
+
+    /*! \brief Query for the rates being calculated with the batch callback.
+     *  \return : The base class implementation returns false.
+     */
+    virtual bool batchCallback() const { return false; }
+
+    /*! \brief The backend callback function for rate calculators using the
+     *         integer types, see integerTypes(). The environment has the same
+     *         layout as for the native rate plugins and points into the
+     *         backend storage, so no copies or type names are made.
+     * \param environment : The local environment of the process.
+     * \return : The base class implementation returns the rate constant unmodified.
+     */
+    virtual double backendIntegerRateCallback(const KMCRatePluginEnvironment & environment) const
+    { return environment.rate_constant; }
+
+    /*! \brief Set up any state the rate calculator keeps of the configuration,
+     *         called by the lattice model once the match lists are set up.
+     *         The state is a cache of the configuration, so this and
+     *         updateLocalState() are const.
+     * \param configuration : The configuration to set up the state for.
+     * \param processes     : The processes the rates are calculated for.
+     */
+    virtual void initLocalState(const Configuration & configuration,
+                                const std::vector<Process*> & processes) const {}
+
+    /*! \brief Update the state kept of the configuration, called by the
+     *         lattice model after the types changed.
+     * \param configuration : The configuration with the new types.
+     * \param indices       : The indices where the types may have changed.
+     */
+    virtual void updateLocalState(const Configuration & configuration,
+                                  const std::vector<int> & indices) const {}
+
+    /*! \brief Query for the rates being pure functions of the local
+     *         environment, i.e. of the process and the types within its
+     *         cutoff only, and not of e.g. the global coordinate or the time.
+     *         The rates may then be cached, see Interactions::setRateCacheCapacity().
+     *  \return : The base class implementation returns false.
+     */
+    virtual bool pureLocalRates() const { return false; }
+
+    /*! \brief Query for the thread safety of the rate calculator.
+     *  \return : True if backendRateCallback may be called concurrently
+     *            from several threads.
+     */
+    bool threadSafe() const { return thread_safe_; }
+
+    /*! \brief Query for the callback to use.
+     *  \return : True if backendIntegerRateCallback should be called instead
+     *            of backendRateCallback.
+     */
+    bool integerTypes() const { return integer_types_; }
+
+protected:
+
+    /*! \brief Constructor for rate calculators declaring their thread safety.
+     *  \param thread_safe   : If the backend callback is thread safe.
+     *  \param integer_types : If the integer backend callback should be used.
+     */
+    explicit RateCalculator(const bool thread_safe,
+                            const bool integer_types = false);
+
+private:
+
+    /// The flag for a thread safe backend callback.
+    bool thread_safe_;
+
+    /// The flag for using the integer backend callback.
+    bool integer_types_;
+
+};
+
+
+/*! \brief Class for defining the interface for a native C++ rate calculator
+ *         that is thread safe and reentrant. The rates of the matched tasks
+ *         are then calculated over the OpenMP threads.
+ *
+ *  Classes inheriting from this one must not modify any state in
+ *  backendRateCallback, and must not call back into Python.
+ */
+class ThreadSafeRateCalculator : public RateCalculator {
+
+public:
+
+    /*! \brief Constructor for the thread safe rate calculator.
+     */
+    ThreadSafeRateCalculator();
+
+    /*! \brief Destructor for the thread safe rate calculator.
+     */
+    virtual ~ThreadSafeRateCalculator();
+
 protected:
 
+    /*! \brief Constructor for thread safe rate calculators using the
+     *         integer backend callback.
+     *  \param integer_types : If the integer backend callback should be used.
+     */
+    explicit ThreadSafeRateCalculator(const bool integer_types);
+
 private:
 
 };
@@ -0,0 +1,89 @@
+/*
+  This file is part of the KMCLib project distributed under the terms of the
+  GNU General Public License version 3, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/*! \file  rateplugin.h
+ *  \brief File for the C interface of native rate calculator plugins.
+ *
+ *  A native rate plugin is a shared library exporting the two functions
+ *  declared below with C linkage. It is loaded by the NativeRateCalculator
+ *  and called from the matcher for each rate to calculate, possibly from
+ *  several threads at once, so the rate function must be reentrant.
+ *
+ *  This header is plain C and may be included from C or C++ plugins.
+ */
+
+#ifndef __RATEPLUGIN__
+#define __RATEPLUGIN__
+
+/// The version of the plugin interface, bumped on any change of the layout.
+#define KMC_RATE_PLUGIN_ABI_VERSION 1
+
+/// The name of the exported version function.
+#define KMC_RATE_PLUGIN_VERSION_SYMBOL "kmc_rate_plugin_abi_version"
+
+/// The name of the exported rate function.
+#define KMC_RATE_PLUGIN_RATE_SYMBOL "kmc_rate_plugin_rate"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! \brief The local environment of a process at a lattice site.
+ *
+ *  All arrays are owned by the backend and are only valid during the call.
+ *  The sites are listed in match list order, sorted by the distance from
+ *  the central site, which is the first one.
+ */
+typedef struct KMCRatePluginEnvironment {
+
+    /// The number of sites within the cutoff of the process.
+    int len;
+
+    /// The lattice index of each site.
+    const int * indices;
+
+    /// The types of all lattice sites, the type of site i is types[indices[i]].
+    const int * types;
+
+    /// The number of entries in update_types, at most len.
+    int n_update;
+
+    /// The type of each site after the process, 0 where it is unchanged.
+    const int * update_types;
+
+    /// The distance of each site from the central site.
+    const double * distances;
+
+    /// The coordinates relative to the central site, x, y, z for each site.
+    const double * coordinates;
+
+    /// The rate constant of the process.
+    double rate_constant;
+
+    /// The id number of the process.
+    int process_number;
+
+    /// The lattice index of the central site.
+    int index;
+
+    /// The global coordinate of the central site.
+    double global_x;
+    double global_y;
+    double global_z;
+
+} KMCRatePluginEnvironment;
+
+/// The exported version function, returns KMC_RATE_PLUGIN_ABI_VERSION.
+typedef int (*KMCRatePluginVersionFunction)(void);
+
+/// The exported rate function, returns the rate for the environment.
+typedef double (*KMCRatePluginRateFunction)(const KMCRatePluginEnvironment * environment);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __RATEPLUGIN__
@@ -13,6 +13,7 @@
 
 #include "simulationtimer.h"
 #include "random.h"
+#include "checkpoint.h"
 #include <cmath>
 
 
@@ -29,11 +30,44 @@ SimulationTimer::SimulationTimer(double start_time) :
 // -----------------------------------------------------------------------------
 //
 void SimulationTimer::propagateTime(const double total_rate)
+{
+    propagate(total_rate, randomDouble01());
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void SimulationTimer::propagateTime(const double total_rate, CounterRandom & rng)
+{
+    propagate(total_rate, rng.randomDouble01());
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void SimulationTimer::propagate(const double total_rate, const double rnd)
 {
     // Propagate the time of the system.
-    const double rnd = randomDouble01();
     const double dt  = -std::log(rnd)/total_rate;
     delta_time_ = dt;
     simulation_time_ += dt;
 }
 
+
+// -----------------------------------------------------------------------------
+//
+void SimulationTimer::writeCheckpoint(std::ostream & stream) const
+{
+    writeBinary(stream, simulation_time_);
+    writeBinary(stream, delta_time_);
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void SimulationTimer::readCheckpoint(std::istream & stream)
+{
+    readBinary(stream, simulation_time_);
+    readBinary(stream, delta_time_);
+}
+
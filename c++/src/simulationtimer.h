@@ -14,6 +14,11 @@
 #ifndef __SIMULATIONTIMER__
 #define __SIMULATIONTIMER__
 
+#include <iosfwd>
+
+// Forward declarations.
+class CounterRandom;
+
 /*! \brief Class for keeping track of simulation (KMC) time.
  */
 class SimulationTimer {
@@ -29,6 +34,13 @@ public:
      */
     void propagateTime(const double total_rate);
 
+    /*! \brief Propagate the time, drawing from the given random stream
+     *         instead of the global generator.
+     *  \param total_rate: The total rate of the system.
+     *  \param rng       : The random stream to draw from.
+     */
+    void propagateTime(const double total_rate, CounterRandom & rng);
+
     /*! \brief Query for the simulation time.
      *  \return : The current simulation time.
      */
@@ -39,10 +51,26 @@ public:
      */
     double deltaTime() const { return delta_time_; }
 
+    /*! \brief Write the time to a binary checkpoint stream.
+     *  \param stream : The stream to write to.
+     */
+    void writeCheckpoint(std::ostream & stream) const;
+
+    /*! \brief Restore the time from a binary checkpoint stream.
+     *  \param stream : The stream to read from.
+     */
+    void readCheckpoint(std::istream & stream);
+
 protected:
 
 private:
 
+    /*! \brief Propagate the time with an exponentially distributed step.
+     *  \param total_rate: The total rate of the system.
+     *  \param rnd       : A random number on the interval (0.0,1.0).
+     */
+    void propagate(const double total_rate, const double rnd);
+
     /// The time of the KMC simulation.
     double simulation_time_;
 
@@ -27,17 +27,13 @@
 #include "matchlist.h"
 #include "latticemap.h"
 
-// Temporary data for the match list return.
-static SiteMatchList tmp_site_match_list__(0);
-
 // -------------------------------------------------------------------------------
 //
 SitesMap::SitesMap(const std::vector< std::vector<double> > & coordinates,
                    const std::vector<std::string> & sites,
                    const std::map<std::string, int> & possible_types) :
     sites_(sites),
-    possible_types_(possible_types),
-    match_lists_(sites.size())
+    possible_types_(possible_types)
 {
     // Initialize all site coordinates.
     for (const std::vector<double> & c : coordinates)
@@ -59,32 +55,31 @@ SitesMap::SitesMap(const std::vector< std::vector<double> > & coordinates,
 void SitesMap::initMatchLists(const LatticeMap & lattice_map,
                               const int range)
 {
-    // {{{
-    
-    // Loop over all lattice sites to initialize the match lists.
-    for (size_t i = 0; i < types_.size(); ++i)
-    {
-        // Calculate and store the match list.
-        const int origin_index = i;
-        const std::vector<int> neighbourhood = lattice_map.neighbourIndices(origin_index,
-                                                                            range);
-        match_lists_[i] = matchList(origin_index, neighbourhood, lattice_map);
-    }
+    // Calculate the neighbourhood templates.
+    neighbourhoods_.init(coordinates_, lattice_map, range);
+}
 
-    // }}}
+
+// -------------------------------------------------------------------------------
+//
+SiteMatchList SitesMap::matchList(const int index) const
+{
+    SiteMatchList match_list;
+    neighbourhoods_.matchList(index, types_, match_list);
+    return match_list;
 }
 
 
 // -------------------------------------------------------------------------------
 //
-const SiteMatchList & SitesMap::matchList(const int origin_index,
-                                          const std::vector<int> & indices,
-                                          const LatticeMap & lattice_map) const
+SiteMatchList SitesMap::matchList(const int origin_index,
+                                  const std::vector<int> & indices,
+                                  const LatticeMap & lattice_map) const
 {
     // {{{
 
     // Setup the return data.
-    tmp_site_match_list__.resize(indices.size());
+    SiteMatchList match_list(indices.size());
 
     // Extract the coordinate of the first index.
     const Coordinate center = coordinates_[origin_index];
@@ -92,7 +87,7 @@ const SiteMatchList & SitesMap::matchList(const int origin_index,
     // Setup the needed iterators.
     std::vector<int>::const_iterator it_index  = indices.begin();
     const std::vector<int>::const_iterator end = indices.end();
-    SiteMatchList::iterator it_match_list = tmp_site_match_list__.begin();
+    SiteMatchList::iterator it_match_list = match_list.begin();
 
     const bool periodic_a = lattice_map.periodicA();
     const bool periodic_b = lattice_map.periodicB();
@@ -185,9 +180,9 @@ const SiteMatchList & SitesMap::matchList(const int origin_index,
     }
 
     // Sort and return.
-    std::sort(tmp_site_match_list__.begin(), tmp_site_match_list__.end());
+    std::sort(match_list.begin(), match_list.end());
 
-    return tmp_site_match_list__;
+    return match_list;
 
     // }}}
 }
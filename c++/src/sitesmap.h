@@ -27,6 +27,8 @@
 #include <string>
 #include <map>
 
+#include "neighbourhoodtemplates.h"
+
 // Forward declaration.
 class LatticeMap;
 class Coordinate;
@@ -62,17 +64,19 @@ public:
      *  \param indices      : The indices to get the match list for.
      *  \param lattice_map  : The lattice map needed for calculating distances
      *                        using correct boundaries.
-     *  \return : The sitesmap match list.
+     *  \return : The sitesmap match list, constructed for each call so that
+     *            the threads can construct match lists at the same time.
      */
-    const SiteMatchList & matchList(const int origin_index,
-                                    const std::vector<int> & indices,
-                                    const LatticeMap & lattice_map) const;
+    SiteMatchList matchList(const int origin_index,
+                            const std::vector<int> & indices,
+                            const LatticeMap & lattice_map) const;
 
-    /*! \brief Return the cached match list without update.
+    /*! \brief Construct the match list for the given index from the
+     *         neighbourhood template.
      *  \param index : The index to get the match list for.
-     *  \return : The match list.
+     *  \return : The match list, empty if initMatchLists() was not called.
      */
-    const SiteMatchList & matchList(const int index) const { return match_lists_[index]; }
+    SiteMatchList matchList(const int index) const;
 
     /*! \brief Const query for the site coordinates.
      *  \return : The coordinates of all sites on lattice.
@@ -97,8 +101,8 @@ private:
     /// Mapping from type string to type int.
     const std::map<std::string, int> possible_types_;
 
-    /// Site match lists.
-    std::vector<SiteMatchList> match_lists_;
+    /// The neighbourhoods of all sites, to construct match lists from.
+    NeighbourhoodTemplates neighbourhoods_;
 
     /// The site coordinates on lattice.
     std::vector<Coordinate> coordinates_;
@@ -0,0 +1,162 @@
+/*
+  This file is part of the KMCLib project distributed under the terms of the
+  GNU General Public License version 3, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/*! \file  sumtree.cpp
+ *  \brief File for the implementation code of the SumTree class.
+ */
+
+#include <algorithm>
+
+#include "sumtree.h"
+
+
+// -----------------------------------------------------------------------------
+//
+SumTree::SumTree(const size_t size) :
+    size_(0),
+    capacity_(1),
+    tree_(2, 0.0)
+{
+    resize(size);
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void SumTree::build(const std::vector<double> & values)
+{
+    resize(values.size());
+    std::copy(values.begin(), values.end(), tree_.begin() + capacity_);
+    rebuild();
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void SumTree::resize(const size_t size)
+{
+    // {{{
+
+    if (size > capacity_)
+    {
+        // Grow to the next power of two and move the leaves over.
+        size_t capacity = capacity_;
+        while (capacity < size)
+        {
+            capacity *= 2;
+        }
+
+        std::vector<double> tree(2*capacity, 0.0);
+        std::copy(tree_.begin() + capacity_,
+                  tree_.begin() + capacity_ + size_,
+                  tree.begin() + capacity);
+
+        tree_.swap(tree);
+        capacity_ = capacity;
+        size_ = size;
+        rebuild();
+    }
+    else
+    {
+        // Zero the weights that are dropped, one at a time.
+        while (size_ > size)
+        {
+            popBack();
+        }
+        size_ = size;
+    }
+
+    // }}}
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void SumTree::update(const size_t i, const double value)
+{
+    // Set the leaf and recalculate the sums on the path to the root.
+    // NOTE: The sums are recalculated rather than incremented to avoid
+    //       accumulating round-off errors over many updates.
+    size_t node = capacity_ + i;
+    tree_[node] = value;
+    node /= 2;
+
+    while (node > 0)
+    {
+        tree_[node] = tree_[2*node] + tree_[2*node + 1];
+        node /= 2;
+    }
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void SumTree::pushBack(const double value)
+{
+    if (size_ == capacity_)
+    {
+        resize(size_ + 1);
+    }
+    else
+    {
+        ++size_;
+    }
+    update(size_ - 1, value);
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void SumTree::popBack()
+{
+    update(size_ - 1, 0.0);
+    --size_;
+}
+
+
+// -----------------------------------------------------------------------------
+//
+size_t SumTree::pick(const double rnd) const
+{
+    // {{{
+
+    double remainder = rnd;
+    size_t node = 1;
+
+    while (node < capacity_)
+    {
+        const double left  = tree_[2*node];
+        const double right = tree_[2*node + 1];
+
+        // Go right only if there is something to pick there, this
+        // guards against round-off in the sums of the inner nodes.
+        if (remainder < left || right <= 0.0)
+        {
+            node = 2*node;
+        }
+        else
+        {
+            remainder -= left;
+            node = 2*node + 1;
+        }
+    }
+
+    return node - capacity_;
+
+    // }}}
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void SumTree::rebuild()
+{
+    for (size_t node = capacity_ - 1; node > 0; --node)
+    {
+        tree_[node] = tree_[2*node] + tree_[2*node + 1];
+    }
+}
+
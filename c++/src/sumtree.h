@@ -0,0 +1,103 @@
+/*
+  This file is part of the KMCLib project distributed under the terms of the
+  GNU General Public License version 3, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/*! \file  sumtree.h
+ *  \brief File for the SumTree class definition.
+ */
+
+#ifndef __SUMTREE__
+#define __SUMTREE__
+
+#include <vector>
+#include <cstddef>
+
+
+/*! \brief Class for a binary sum tree over a list of non-negative weights,
+ *         supporting O(log N) updates and O(log N) weighted picks.
+ *
+ *  The weights are stored as the leaves of a complete binary tree kept in
+ *  a flat array, where each inner node holds the sum of its two children.
+ */
+class SumTree {
+
+public:
+
+    /*! \brief Constructor.
+     *  \param size : The number of (zero) weights to start with.
+     */
+    SumTree(const size_t size = 0);
+
+    /*! \brief Set all weights in one go, O(N).
+     *  \param values : The weights to store.
+     */
+    void build(const std::vector<double> & values);
+
+    /*! \brief Change the number of weights. New weights are set to zero.
+     *  \param size : The new number of weights.
+     */
+    void resize(const size_t size);
+
+    /*! \brief Set the weight at the given position, O(log N).
+     *  \param i     : The position of the weight.
+     *  \param value : The new weight.
+     */
+    void update(const size_t i, const double value);
+
+    /*! \brief Append a weight at the end of the list.
+     *  \param value : The weight to append.
+     */
+    void pushBack(const double value);
+
+    /*! \brief Remove the last weight of the list.
+     */
+    void popBack();
+
+    /*! \brief Find the position such that the accumulated weight up to and
+     *         including it is the first to exceed the given value, O(log N).
+     *  \param rnd : A value between 0.0 and the total weight.
+     *  \return : The picked position. Positions with zero weight are never
+     *            picked as long as the total weight is larger than zero.
+     */
+    size_t pick(const double rnd) const;
+
+    /*! \brief Query for the weight at the given position.
+     *  \param i : The position.
+     *  \return : The weight.
+     */
+    double value(const size_t i) const { return tree_[capacity_ + i]; }
+
+    /*! \brief Query for the sum of all weights.
+     *  \return : The total weight.
+     */
+    double total() const { return tree_[1]; }
+
+    /*! \brief Query for the number of weights.
+     *  \return : The number of weights stored.
+     */
+    size_t size() const { return size_; }
+
+protected:
+
+private:
+
+    /*! \brief Recalculate all inner nodes from the leaves, O(N).
+     */
+    void rebuild();
+
+    /// The number of weights.
+    size_t size_;
+
+    /// The number of leaves, a power of two not smaller than size_.
+    size_t capacity_;
+
+    /// The tree nodes, with the root at position 1 and leaves from capacity_.
+    std::vector<double> tree_;
+
+};
+
+
+#endif // __SUMTREE__
+
@@ -0,0 +1,78 @@
+/*
+  This file is part of the KMCLib project distributed under the terms of the
+  GNU General Public License version 3, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/*! \file  supersetbuilder.cpp
+ *  \brief File for the implementation code of the SupersetBuilder class.
+ */
+
+
+#include "supersetbuilder.h"
+
+#include "latticemap.h"
+
+#include <algorithm>
+
+
+// -----------------------------------------------------------------------------
+//
+SupersetBuilder::SupersetBuilder() :
+    generation_(0)
+{
+    // NOTHING HERE.
+}
+
+
+// -----------------------------------------------------------------------------
+//
+const std::vector<int> & SupersetBuilder::build(const LatticeMap & lattice_map,
+                                                const std::vector<int> & indices,
+                                                const int shells)
+{
+    // {{{
+
+    // Fit the stamps to the lattice.
+    const size_t n_sites = static_cast<size_t>(lattice_map.nBasis()) *
+        lattice_map.repetitionsA() * lattice_map.repetitionsB() * lattice_map.repetitionsC();
+
+    if (stamps_.size() != n_sites)
+    {
+        stamps_.assign(n_sites, 0);
+        generation_ = 0;
+    }
+
+    // Start a new generation, clearing the stamps when it wraps around.
+    ++generation_;
+    if (generation_ == 0)
+    {
+        std::fill(stamps_.begin(), stamps_.end(), 0);
+        generation_ = 1;
+    }
+
+    superset_.clear();
+
+    for (size_t i = 0; i < indices.size(); ++i)
+    {
+        const IndexSpan neighbours = lattice_map.neighbourSpan(indices[i], shells, buffer_);
+
+        // Add the neighbours not added before in this generation.
+        for (const int * it = neighbours.begin(); it != neighbours.end(); ++it)
+        {
+            if (stamps_[*it] != generation_)
+            {
+                stamps_[*it] = generation_;
+                superset_.push_back(*it);
+            }
+        }
+    }
+
+    // Sort the unique indices.
+    std::sort(superset_.begin(), superset_.end());
+
+    return superset_;
+
+    // }}}
+}
+
@@ -0,0 +1,74 @@
+/*
+  This file is part of the KMCLib project distributed under the terms of the
+  GNU General Public License version 3, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/*! \file  supersetbuilder.h
+ *  \brief File for the SupersetBuilder class definition.
+ */
+
+#ifndef __SUPERSETBUILDER__
+#define __SUPERSETBUILDER__
+
+#include <vector>
+
+
+// Forward declarations.
+class LatticeMap;
+
+
+/*! \brief Class for building the unique neighbouring indices of a set of
+ *         indices, as LatticeMap::supersetNeighbourIndices(), reusing its
+ *         buffers between the calls.
+ *
+ *  The duplicates are removed while the neighbours are collected, by
+ *  stamping each site with the generation of the call it was added in.
+ *  Only the unique indices are then sorted, so the superset is given in
+ *  the same ascending order as by the lattice map.
+ */
+class SupersetBuilder {
+
+public:
+
+    /*! \brief Default constructor.
+     */
+    SupersetBuilder();
+
+    /*! \brief Build the unique neighbouring indices of a set of indices.
+     *  \param lattice_map : The lattice map to get the neighbours from.
+     *  \param indices     : The indices to get the neighbours for.
+     *  \param shells      : The number of shells to include.
+     *  \return : The sorted unique neighbour indices, valid until the next
+     *            call.
+     */
+    const std::vector<int> & build(const LatticeMap & lattice_map,
+                                   const std::vector<int> & indices,
+                                   const int shells);
+
+    /*! \brief Query for the last built superset.
+     *  \return : The sorted unique neighbour indices.
+     */
+    const std::vector<int> & superset() const { return superset_; }
+
+protected:
+
+private:
+
+    /// The generation each site was last added in.
+    std::vector<unsigned int> stamps_;
+
+    /// The generation of the current call.
+    unsigned int generation_;
+
+    /// The superset.
+    std::vector<int> superset_;
+
+    /// Storage for the neighbours if the lattice map has no neighbour table.
+    std::vector<int> buffer_;
+
+};
+
+
+#endif // __SUPERSETBUILDER__
+
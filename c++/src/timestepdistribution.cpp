@@ -0,0 +1,72 @@
+/*
+  This file is part of the KMCLib project distributed under the terms of the
+  GNU General Public License version 3, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/*! \file  timestepdistribution.cpp
+ *  \brief File for the implementation code of the TimeStepDistribution class.
+ */
+
+#include <stdexcept>
+
+#include "timestepdistribution.h"
+
+
+// -----------------------------------------------------------------------------
+//
+TimeStepDistribution::TimeStepDistribution(const double binsize) :
+    binsize_(binsize),
+    last_time_(0.0),
+    histogram_(10, 0)
+{
+    if (!(binsize > 0.0))
+    {
+        throw std::invalid_argument("The time step distribution binsize must be positive.");
+    }
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void TimeStepDistribution::setup(const int step,
+                                 const double time,
+                                 const Configuration & configuration)
+{
+    last_time_ = time;
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void TimeStepDistribution::registerStep(const int step,
+                                        const double time,
+                                        const double delta_time,
+                                        const Process & process,
+                                        const int site_index,
+                                        const Configuration & configuration)
+{
+    registerTime(time);
+}
+
+
+// -----------------------------------------------------------------------------
+//
+void TimeStepDistribution::registerTime(const double time)
+{
+    // Calculate the bin of the time since the last time.
+    const size_t b = static_cast<size_t>((time - last_time_) / binsize_);
+    last_time_ = time;
+
+    // Make sure we have place for the bin, growing by a tenth at a time.
+    size_t size = histogram_.size();
+    while (size <= b)
+    {
+        size += size / 10;
+    }
+    histogram_.resize(size, 0);
+
+    // Increment the value at this bin.
+    ++histogram_[b];
+}
+
@@ -0,0 +1,93 @@
+/*
+  This file is part of the KMCLib project distributed under the terms of the
+  GNU General Public License version 3, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/*! \file  timestepdistribution.h
+ *  \brief File for the TimeStepDistribution class definition.
+ */
+
+#ifndef __TIMESTEPDISTRIBUTION__
+#define __TIMESTEPDISTRIBUTION__
+
+#include <vector>
+
+#include "analysisplugin.h"
+
+
+/*! \brief Class for collecting the histogram of the time between the
+ *         registered steps of a simulation.
+ */
+class TimeStepDistribution : public AnalysisPlugin {
+
+public:
+
+    /*! \brief Constructor for the time step distribution.
+     *  \param binsize : The size of the bins in the histogram.
+     */
+    TimeStepDistribution(const double binsize);
+
+    /*! \brief Store the time to measure the first time step from.
+     *  \param step          : The step number of the simulation.
+     *  \param time          : The time of the simulation.
+     *  \param configuration : The configuration of the simulation.
+     */
+    void setup(const int step,
+               const double time,
+               const Configuration & configuration);
+
+    /*! \brief Register the time since the last registered step.
+     *  \param step          : The step number of the simulation.
+     *  \param time          : The time of the simulation after the step.
+     *  \param delta_time    : The time increment of the step.
+     *  \param process       : The process performed in the step.
+     *  \param site_index    : The index of the site the process was performed on.
+     *  \param configuration : The configuration after the step.
+     */
+    void registerStep(const int step,
+                      const double time,
+                      const double delta_time,
+                      const Process & process,
+                      const int site_index,
+                      const Configuration & configuration);
+
+    /*! \brief Register the time since the last registered time in the
+     *         histogram.
+     *  \param time : The time to register.
+     */
+    void registerTime(const double time);
+
+    /*! \brief Set the time to measure the next time step from.
+     *  \param time : The time.
+     */
+    void setLastTime(const double time) { last_time_ = time; }
+
+    /*! \brief Query for the histogram.
+     *  \return : The number of time steps in each bin.
+     */
+    const std::vector<int> & histogram() const { return histogram_; }
+
+    /*! \brief Query for the bin size.
+     *  \return : The size of the bins in the histogram.
+     */
+    double binsize() const { return binsize_; }
+
+protected:
+
+private:
+
+    /// The size of the bins.
+    double binsize_;
+
+    /// The last registered time.
+    double last_time_;
+
+    /// The histogram, extended as needed.
+    std::vector<int> histogram_;
+
+};
+
+
+#endif // __TIMESTEPDISTRIBUTION__
+
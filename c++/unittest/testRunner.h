@@ -40,6 +40,16 @@
 //#include "test_blocker.h"
 //#include "test_sitesmap.h"
 //#include "test_distributor.h"
+//#include "test_sumtree.h"
+//#include "test_neighbourhoodtemplates.h"
+//#include "test_matchtrie.h"
+//#include "test_dependencyindex.h"
+//#include "test_nativeratecalculator.h"
+//#include "test_ratecache.h"
+//#include "test_latticegasratecalculator.h"
+//#include "test_supersetbuilder.h"
+//#include "test_analysisplugin.h"
+//#include "test_timestepdistribution.h"
 
 // -------------------------------------------------------------------------- //
 // Add tests.
@@ -62,4 +72,14 @@ CPPUNIT_TEST_SUITE_REGISTRATION( Test_LatticeMap );
 //CPPUNIT_TEST_SUITE_REGISTRATION( Test_Blocker );
 //CPPUNIT_TEST_SUITE_REGISTRATION( Test_SitesMap );
 //CPPUNIT_TEST_SUITE_REGISTRATION( Test_Distributor );
+//CPPUNIT_TEST_SUITE_REGISTRATION( Test_SumTree );
+//CPPUNIT_TEST_SUITE_REGISTRATION( Test_NeighbourhoodTemplates );
+//CPPUNIT_TEST_SUITE_REGISTRATION( Test_MatchTrie );
+//CPPUNIT_TEST_SUITE_REGISTRATION( Test_DependencyIndex );
+//CPPUNIT_TEST_SUITE_REGISTRATION( Test_NativeRateCalculator );
+//CPPUNIT_TEST_SUITE_REGISTRATION( Test_RateCache );
+//CPPUNIT_TEST_SUITE_REGISTRATION( Test_LatticeGasRateCalculator );
+//CPPUNIT_TEST_SUITE_REGISTRATION( Test_SupersetBuilder );
+//CPPUNIT_TEST_SUITE_REGISTRATION( Test_AnalysisPlugin );
+//CPPUNIT_TEST_SUITE_REGISTRATION( Test_TimeStepDistribution );
 
@@ -0,0 +1,204 @@
+/*
+  This file is part of the KMCLib project distributed under the terms of the
+  GNU General Public License version 3, see <http://www.gnu.org/licenses/>.
+*/
+
+
+// Include the test definition.
+#include "test_analysisplugin.h"
+
+// Include the files to test.
+#include "analysisplugin.h"
+
+// Other inclusions.
+#include "configuration.h"
+#include "sitesmap.h"
+#include "latticemap.h"
+#include "interactions.h"
+#include "latticemodel.h"
+#include "simulationtimer.h"
+#include "process.h"
+#include "random.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+
+// A plugin recording the calls it gets.
+class RecordingPlugin : public AnalysisPlugin {
+public:
+    void registerStep(const int step,
+                      const double time,
+                      const double delta_time,
+                      const Process & process,
+                      const int site_index,
+                      const Configuration & configuration)
+    {
+        steps.push_back(step);
+        times.push_back(time);
+        delta_times.push_back(delta_time);
+        process_numbers.push_back(process.processNumber());
+        site_indices.push_back(site_index);
+        affected_indices.push_back(process.affectedIndices());
+        types.push_back(configuration.types()[site_index]);
+    }
+
+    std::vector<int> steps;
+    std::vector<double> times;
+    std::vector<double> delta_times;
+    std::vector<int> process_numbers;
+    std::vector<int> site_indices;
+    std::vector<std::vector<int> > affected_indices;
+    std::vector<int> types;
+};
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_AnalysisPlugin::testStepInterval()
+{
+    // {{{
+    RecordingPlugin plugin;
+
+    // By default the plugin is due at each step.
+    for (int step = 1; step < 5; ++step)
+    {
+        CPPUNIT_ASSERT( plugin.due(step, 0.1*step) );
+    }
+
+    // At each third step.
+    plugin.setStepInterval(3);
+    CPPUNIT_ASSERT( !plugin.due(1, 0.0) );
+    CPPUNIT_ASSERT( !plugin.due(2, 0.0) );
+    CPPUNIT_ASSERT(  plugin.due(3, 0.0) );
+    CPPUNIT_ASSERT( !plugin.due(4, 0.0) );
+    CPPUNIT_ASSERT(  plugin.due(300, 0.0) );
+
+    // At each second step from step 4 to step 8.
+    plugin.setStepInterval(2, 4, 8);
+    CPPUNIT_ASSERT( !plugin.due(2, 0.0) );
+    CPPUNIT_ASSERT(  plugin.due(4, 0.0) );
+    CPPUNIT_ASSERT( !plugin.due(5, 0.0) );
+    CPPUNIT_ASSERT(  plugin.due(8, 0.0) );
+    CPPUNIT_ASSERT( !plugin.due(10, 0.0) );
+
+    // The interval must be positive.
+    CPPUNIT_ASSERT_THROW( plugin.setStepInterval(0), std::invalid_argument );
+    // }}}
+}
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_AnalysisPlugin::testTimeInterval()
+{
+    // {{{
+    RecordingPlugin plugin;
+    plugin.setTimeInterval(1.0, 10.0);
+
+    // Due at the first step reaching each interval.
+    CPPUNIT_ASSERT( !plugin.due(1, 10.5) );
+    CPPUNIT_ASSERT(  plugin.due(2, 11.2) );
+    CPPUNIT_ASSERT( !plugin.due(3, 11.9) );
+    CPPUNIT_ASSERT(  plugin.due(4, 12.0) );
+
+    // Intervals passed within a single step give one call.
+    CPPUNIT_ASSERT(  plugin.due(5, 15.5) );
+    CPPUNIT_ASSERT( !plugin.due(6, 15.9) );
+    CPPUNIT_ASSERT(  plugin.due(7, 16.1) );
+
+    // The interval must be positive.
+    CPPUNIT_ASSERT_THROW( plugin.setTimeInterval(0.0), std::invalid_argument );
+    // }}}
+}
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_AnalysisPlugin::testLatticeModelCalls()
+{
+    // {{{
+    // Setup a periodic chain of A and B sites with flipping processes.
+    const int n_sites = 12;
+    std::vector<std::vector<double> > coordinates;
+    std::vector<std::string> elements;
+    std::vector<std::string> site_types;
+    for (int i = 0; i < n_sites; ++i)
+    {
+        coordinates.push_back({static_cast<double>(i), 0.0, 0.0});
+        elements.push_back((i % 2 == 0) ? "A" : "B");
+        site_types.push_back("M");
+    }
+
+    std::map<std::string, int> possible_types;
+    possible_types["*"] = 0;
+    possible_types["A"] = 1;
+    possible_types["B"] = 2;
+
+    std::map<std::string, int> possible_site_types;
+    possible_site_types["*"] = 0;
+    possible_site_types["M"] = 1;
+
+    Configuration configuration(coordinates, elements, possible_types);
+    SitesMap sitesmap(coordinates, site_types, possible_site_types);
+    LatticeMap lattice_map(1, {n_sites, 1, 1}, std::vector<bool>(3, true));
+    configuration.initMatchLists(lattice_map, 1);
+
+    const std::vector<std::vector<double> > process_coordinates(1, std::vector<double>(3, 0.0));
+    Configuration c1(process_coordinates, {"A"}, possible_types);
+    Configuration c2(process_coordinates, {"B"}, possible_types);
+    const std::vector<int> basis_sites(1, 0);
+    const std::vector<int> move_origins;
+    const std::vector<Coordinate> move_vectors;
+    std::vector<Process> processes;
+    processes.push_back(Process(c1, c2, 1.0, basis_sites, move_origins, move_vectors, 0));
+    processes.push_back(Process(c2, c1, 2.0, basis_sites, move_origins, move_vectors, 1));
+
+    Interactions interactions(processes, true);
+    SimulationTimer timer;
+    LatticeModel lattice_model(configuration, sitesmap, timer, lattice_map, interactions);
+    seedRandom(false, 71);
+
+    // Add one plugin called at each step and one at each third step.
+    RecordingPlugin each;
+    RecordingPlugin third;
+    third.setStepInterval(3);
+    lattice_model.addAnalysisPlugin(each);
+    lattice_model.addAnalysisPlugin(third);
+
+    std::vector<double> times;
+    for (int i = 0; i < 10; ++i)
+    {
+        lattice_model.singleStep();
+        times.push_back(timer.simulationTime());
+    }
+    CPPUNIT_ASSERT_EQUAL( lattice_model.step(), 10 );
+
+    // Check the calls of the plugin at each step.
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(each.steps.size()), 10 );
+    for (int i = 0; i < 10; ++i)
+    {
+        CPPUNIT_ASSERT_EQUAL( each.steps[i], i + 1 );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( each.times[i], times[i], 1.0e-12 );
+        CPPUNIT_ASSERT( each.delta_times[i] > 0.0 );
+
+        // The fired process has changed the type of the site it was picked on.
+        CPPUNIT_ASSERT_EQUAL( each.types[i], (each.process_numbers[i] == 0) ? 2 : 1 );
+        CPPUNIT_ASSERT( std::find(each.affected_indices[i].begin(),
+                                  each.affected_indices[i].end(),
+                                  each.site_indices[i]) != each.affected_indices[i].end() );
+    }
+
+    // The other plugin was called at steps 3, 6 and 9.
+    CPPUNIT_ASSERT( third.steps == std::vector<int>({3, 6, 9}) );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( third.times[1], times[5], 1.0e-12 );
+
+    // No calls after the plugins are cleared.
+    lattice_model.clearAnalysisPlugins();
+    lattice_model.setStep(0);
+    lattice_model.singleStep();
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(each.steps.size()), 10 );
+    CPPUNIT_ASSERT_EQUAL( lattice_model.step(), 1 );
+    // }}}
+}
+
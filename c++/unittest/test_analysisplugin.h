@@ -0,0 +1,37 @@
+/*
+  This file is part of the KMCLib project distributed under the terms of the
+  GNU General Public License version 3, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef __TEST_ANALYSISPLUGIN__
+#define __TEST_ANALYSISPLUGIN__
+
+#include <iostream>
+#include <string>
+
+#include <cppunit/TestCase.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestRunner.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class Test_AnalysisPlugin : public CppUnit::TestCase {
+
+public:
+
+    CPPUNIT_TEST_SUITE( Test_AnalysisPlugin );
+    CPPUNIT_TEST( testStepInterval );
+    CPPUNIT_TEST( testTimeInterval );
+    CPPUNIT_TEST( testLatticeModelCalls );
+    CPPUNIT_TEST_SUITE_END();
+
+    void testStepInterval();
+    void testTimeInterval();
+    void testLatticeModelCalls();
+
+};
+
+#endif
+
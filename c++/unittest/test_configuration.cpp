@@ -856,8 +856,7 @@ void Test_Configuration::testMatchLists()
     CPPUNIT_ASSERT_EQUAL( configuration.types()[351],  1 );
     CPPUNIT_ASSERT_EQUAL( configuration.types()[2517], 1 );
 
-    // Check that updating the matchlist gets us the correct values.
-    configuration.updateMatchList(1434);
+    // Check that the matchlist now gets us the updated values.
 
     // Reference.
     const std::vector<ConfigMatchListEntry> ref2_1434 =        \
@@ -927,6 +926,26 @@ void Test_Configuration::testTypeNameQuery()
     CPPUNIT_ASSERT_EQUAL( config.typeName(5), std::string("J") );
     CPPUNIT_ASSERT_EQUAL( config.typeName(6), std::string("G") );
 
+    // Query for the names of a list of types.
+    const std::vector<int> types = {3, 0, 3, 6};
+    const std::vector<std::string> names = config.typeNames(types);
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(names.size()), 4 );
+    CPPUNIT_ASSERT_EQUAL( names[0], std::string("D") );
+    CPPUNIT_ASSERT_EQUAL( names[1], std::string("*") );
+    CPPUNIT_ASSERT_EQUAL( names[2], std::string("D") );
+    CPPUNIT_ASSERT_EQUAL( names[3], std::string("G") );
+
+    // Flag the types of some names, ignoring names that are not types.
+    const std::vector<bool> flags = config.typeFlags({"B", "X", "G"});
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(flags.size()), 7 );
+    CPPUNIT_ASSERT( !flags[0] );
+    CPPUNIT_ASSERT( !flags[1] );
+    CPPUNIT_ASSERT(  flags[2] );
+    CPPUNIT_ASSERT( !flags[3] );
+    CPPUNIT_ASSERT( !flags[4] );
+    CPPUNIT_ASSERT( !flags[5] );
+    CPPUNIT_ASSERT(  flags[6] );
+
     // DONE
     // }}}
 }
@@ -1005,13 +1024,16 @@ void Test_Configuration::testAtomIDElementsCoordinatesMovedIDs()
 
     // Test the atom id elements. Should initially be the same as the types of
     // the lattice configuration.
-    CPPUNIT_ASSERT_EQUAL( static_cast<int>(configuration.elements().size()),
-                          static_cast<int>(configuration.atomIDElements().size()) );
+    const std::vector<std::string> lattice_elements = configuration.elements();
+    const std::vector<std::string> atom_id_elements = configuration.atomIDElements();
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(lattice_elements.size()),
+                          static_cast<int>(atom_id_elements.size()) );
 
-    for (size_t i = 0; i < configuration.elements().size(); ++i)
+    for (size_t i = 0; i < lattice_elements.size(); ++i)
     {
-        CPPUNIT_ASSERT_EQUAL(configuration.elements()[i],
-                             configuration.atomIDElements()[i]);
+        CPPUNIT_ASSERT_EQUAL(lattice_elements[i], atom_id_elements[i]);
+        CPPUNIT_ASSERT_EQUAL(configuration.types()[i],
+                             configuration.atomIDTypes()[i]);
     }
 
     // Setup the lattice map.
@@ -1202,7 +1224,6 @@ void Test_Configuration::testAtomIDElementsCoordinatesMovedIDs()
     p2.addSite(1434, 0.0);
 
     // Peform the process.
-    configuration.updateMatchList(1434);
     configuration.performProcess(p2, 1434);
 
     // Get the moved atom_id:s out.
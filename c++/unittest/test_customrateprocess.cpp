@@ -16,6 +16,8 @@
 #include "random.h"
 
 #include <cmath>
+#include <sstream>
+#include <stdexcept>
 
 // -------------------------------------------------------------------------- //
 //
@@ -364,6 +366,105 @@ void Test_CustomRateProcess::testAddAndRemoveSite()
 }
 
 
+// -------------------------------------------------------------------------- //
+//
+void Test_CustomRateProcess::testUpdateSite()
+{
+    // Default construct a process.
+    CustomRateProcess process;
+
+    // Add sites.
+    process.addSite(199, 2.00);
+    process.addSite(12,  5.00);
+    process.addSite(19,  3.00);
+    process.addSite(7,   1.00);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(process.totalRate(), 11.0, 1.0e-12);
+
+    // Update the rates in place.
+    process.updateSite(12, 0.5);
+    process.updateSite(7,  4.0);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(process.totalRate(), 9.5, 1.0e-12);
+
+    // The order of the sites is kept.
+    CPPUNIT_ASSERT_EQUAL(static_cast<int>(process.nSites()), 4);
+    CPPUNIT_ASSERT_EQUAL(process.sites()[0], 199);
+    CPPUNIT_ASSERT_EQUAL(process.sites()[1], 12);
+    CPPUNIT_ASSERT_EQUAL(process.sites()[2], 19);
+    CPPUNIT_ASSERT_EQUAL(process.sites()[3], 7);
+
+    // Remove a site and check that the moved rate follows its site.
+    process.removeSite(199);
+    CPPUNIT_ASSERT_EQUAL(process.sites()[0], 7);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(process.totalRate(), 7.5, 1.0e-12);
+
+    process.updateSite(7, 0.0);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(process.totalRate(), 3.5, 1.0e-12);
+
+    // Site 7 has zero rate and should never be picked.
+    seedRandom(false, 13);
+    for (int i = 0; i < 10000; ++i)
+    {
+        const int site = process.pickSite();
+        CPPUNIT_ASSERT( site == 12 || site == 19 );
+    }
+
+    // DONE
+}
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_CustomRateProcess::testCheckpoint()
+{
+    // Setup a process with removed and updated sites.
+    CustomRateProcess process;
+    process.addSite(199, 2.00);
+    process.addSite(12,  5.00);
+    process.addSite(19,  3.00);
+    process.addSite(7,   1.00);
+    process.removeSite(12);
+    process.updateSite(19, 0.25);
+
+    std::stringstream stream;
+    process.writeCheckpoint(stream);
+
+    // Read into a process with other sites.
+    CustomRateProcess restored;
+    restored.addSite(3, 1.0);
+    restored.readCheckpoint(stream);
+
+    CPPUNIT_ASSERT( restored.sites() == process.sites() );
+    CPPUNIT_ASSERT_EQUAL( restored.totalRate(), process.totalRate() );
+    CPPUNIT_ASSERT( !restored.isListed(3) );
+
+    // The restored sites can be removed and updated.
+    restored.removeSite(199);
+    restored.updateSite(19, 1.0);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( restored.totalRate(), 2.0, 1.0e-12 );
+
+    // The same sites are picked.
+    seedRandom(false, 13);
+    process.removeSite(199);
+    process.updateSite(19, 1.0);
+    std::vector<int> picked;
+    for (int i = 0; i < 100; ++i)
+    {
+        picked.push_back(process.pickSite());
+    }
+    seedRandom(false, 13);
+    for (int i = 0; i < 100; ++i)
+    {
+        CPPUNIT_ASSERT_EQUAL( restored.pickSite(), picked[i] );
+    }
+
+    // A truncated stream throws.
+    std::stringstream truncated(stream.str().substr(0, 4));
+    CPPUNIT_ASSERT_THROW( restored.readCheckpoint(truncated), std::runtime_error );
+
+    // DONE
+}
+
+
 // -------------------------------------------------------------------------- //
 //
 void Test_CustomRateProcess::testPickSite()
@@ -28,6 +28,8 @@ public:
     CPPUNIT_TEST( testMatchListLong );
     CPPUNIT_TEST( testTotalRate );
     CPPUNIT_TEST( testAddAndRemoveSite );
+    CPPUNIT_TEST( testUpdateSite );
+    CPPUNIT_TEST( testCheckpoint );
     CPPUNIT_TEST( testPickSite );
     CPPUNIT_TEST( testAffectedIndices );
     CPPUNIT_TEST( testCutoffAndRange );
@@ -38,6 +40,8 @@ public:
     void testMatchListLong();
     void testTotalRate();
     void testAddAndRemoveSite();
+    void testUpdateSite();
+    void testCheckpoint();
     void testPickSite();
     void testAffectedIndices();
     void testCutoffAndRange();
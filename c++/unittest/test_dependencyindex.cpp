@@ -0,0 +1,288 @@
+/*
+  This file is part of the KMCLib project distributed under the terms of the
+  GNU General Public License version 3, see <http://www.gnu.org/licenses/>.
+*/
+
+
+// Include the test definition.
+#include "test_dependencyindex.h"
+
+// Include the files to test.
+#include "dependencyindex.h"
+
+#include "configuration.h"
+#include "interactions.h"
+#include "latticemap.h"
+#include "process.h"
+#include "random.h"
+#include "sitesmap.h"
+
+#include <algorithm>
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_DependencyIndex::testConstruction()
+{
+    // {{{
+    const DependencyIndex dependency_index;
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(dependency_index.nDependencies()), 0 );
+    // }}}
+}
+
+
+// -------------------------------------------------------------------------- //
+// Check that the pairs listed after random flips on a two basis lattice
+// cover all pairs changing match status.
+//
+static void checkAffectedPairs(const std::vector<int> & repetitions,
+                               const std::vector<bool> & periodic)
+{
+    // {{{
+    seedRandom(false, 1432);
+
+    std::vector<std::vector<double> > coordinates;
+    std::vector<std::string> elements;
+    std::vector<std::string> site_types;
+
+    for (int i = 0; i < repetitions[0]; ++i)
+    {
+        for (int j = 0; j < repetitions[1]; ++j)
+        {
+            for (int k = 0; k < repetitions[2]; ++k)
+            {
+                std::vector<double> coord(3);
+                coord[0] = 0.0 + i*1.0;
+                coord[1] = 0.0 + j*1.0;
+                coord[2] = 0.0 + k*1.0;
+                coordinates.push_back(coord);
+
+                coord[0] = 0.5 + i*1.0;
+                coord[1] = 0.5 + j*1.0;
+                coord[2] = 0.5 + k*1.0;
+                coordinates.push_back(coord);
+
+                elements.push_back(randomDouble01() < 0.5 ? "A" : "B");
+                elements.push_back(randomDouble01() < 0.5 ? "A" : "B");
+                site_types.push_back("M");
+                site_types.push_back("M");
+            }
+        }
+    }
+
+    std::map<std::string, int> possible_types;
+    possible_types["*"] = 0;
+    possible_types["A"] = 1;
+    possible_types["B"] = 2;
+
+    std::map<std::string, int> possible_site_types;
+    possible_site_types["*"] = 0;
+    possible_site_types["M"] = 1;
+
+    Configuration configuration(coordinates, elements, possible_types);
+    const SitesMap sitesmap(coordinates, site_types, possible_site_types);
+    const LatticeMap lattice_map(2, repetitions, periodic);
+
+    // Setup processes on different basis sites and of different ranges.
+    std::vector<Process> processes;
+    std::vector<int> basis_sites(1, 0);
+    std::vector<int> both_basis_sites(2);
+    both_basis_sites[0] = 0;
+    both_basis_sites[1] = 1;
+
+    // Flip A to B and B to A on both basis sites.
+    {
+        const std::vector<std::vector<double> > process_coordinates(1, std::vector<double>(3, 0.0));
+        const Configuration c1(process_coordinates, std::vector<std::string>(1, "A"), possible_types);
+        const Configuration c2(process_coordinates, std::vector<std::string>(1, "B"), possible_types);
+        processes.push_back(Process(c1, c2, 1.0, both_basis_sites));
+        processes.push_back(Process(c2, c1, 1.0, both_basis_sites));
+    }
+
+    // An A with a B in the 1,1,1 direction, on basis site 0.
+    {
+        std::vector<std::vector<double> > process_coordinates(2, std::vector<double>(3, 0.0));
+        process_coordinates[1][0] = 0.5;
+        process_coordinates[1][1] = 0.5;
+        process_coordinates[1][2] = 0.5;
+
+        std::vector<std::string> elements1(2, "A");
+        elements1[1] = "B";
+        std::vector<std::string> elements2(2, "B");
+        elements2[1] = "A";
+
+        const Configuration c1(process_coordinates, elements1, possible_types);
+        const Configuration c2(process_coordinates, elements2, possible_types);
+        processes.push_back(Process(c1, c2, 1.0, basis_sites));
+    }
+
+    // A B with two A neighbours in the c direction, on basis site 1.
+    {
+        std::vector<std::vector<double> > process_coordinates(3, std::vector<double>(3, 0.0));
+        process_coordinates[1][2] =  1.0;
+        process_coordinates[2][2] = -1.0;
+
+        std::vector<std::string> elements1(3, "A");
+        elements1[0] = "B";
+        std::vector<std::string> elements2(3, "A");
+
+        const Configuration c1(process_coordinates, elements1, possible_types);
+        const Configuration c2(process_coordinates, elements2, possible_types);
+        basis_sites[0] = 1;
+        processes.push_back(Process(c1, c2, 1.0, basis_sites));
+    }
+
+    // Setup the interactions and match lists as in the lattice model.
+    Interactions interactions(processes, true);
+    configuration.initMatchLists(lattice_map, interactions.maxRange());
+    interactions.updateProcessMatchLists(configuration, lattice_map);
+    interactions.compileProcessMatchLists(configuration, lattice_map);
+
+    DependencyIndex dependency_index;
+    dependency_index.init(interactions, configuration, lattice_map);
+
+    // The single site processes only read the site itself.
+    CPPUNIT_ASSERT( dependency_index.nDependencies() > 0 );
+    CPPUNIT_ASSERT( dependency_index.nDependencies() < 20 );
+
+    // All sites have a template, also at the boundaries.
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(dependency_index.nSiteDependents()), 0 );
+
+    // Get the matching of all pairs.
+    const int n_sites = elements.size();
+    const int n_processes = processes.size();
+
+    std::vector<int> process_basis(n_processes);
+    for (int p = 0; p < n_processes; ++p)
+    {
+        process_basis[p] = interactions.processes()[p]->basisSites().size() == 2 ? \
+            -1 : interactions.processes()[p]->basisSites()[0];
+    }
+
+    std::vector<bool> matches(n_sites*n_processes, false);
+    for (int index = 0; index < n_sites; ++index)
+    {
+        for (int p = 0; p < n_processes; ++p)
+        {
+            const bool listed_basis = process_basis[p] < 0 || \
+                process_basis[p] == lattice_map.basisSiteFromIndex(index);
+
+            matches[index*n_processes + p] = listed_basis && \
+                whateverMatch(interactions.processes()[p]->matchList(),
+                              configuration.matchList(index));
+        }
+    }
+
+    // Flip types at random sites and check that all pairs changing match
+    // status are listed.
+    std::vector<std::pair<int, int> > index_process_to_match;
+    int n_changed = 0;
+    size_t n_pairs = 0;
+    size_t n_range_pairs = 0;
+
+    for (int step = 0; step < 200; ++step)
+    {
+        const int index = static_cast<int>(randomDouble01() * n_sites);
+        Process & flip = *interactions.processes()[configuration.types()[index] == 1 ? 0 : 1];
+        configuration.performProcess(flip, index);
+
+        dependency_index.indexProcessToMatch(flip.affectedIndices(),
+                                             interactions,
+                                             configuration,
+                                             sitesmap,
+                                             index_process_to_match);
+
+        // The pairs are sorted and unique.
+        for (size_t i = 1; i < index_process_to_match.size(); ++i)
+        {
+            CPPUNIT_ASSERT( index_process_to_match[i-1] < index_process_to_match[i] );
+        }
+
+        for (int site = 0; site < n_sites; ++site)
+        {
+            for (int p = 0; p < n_processes; ++p)
+            {
+                const bool listed_basis = process_basis[p] < 0 || \
+                    process_basis[p] == lattice_map.basisSiteFromIndex(site);
+
+                const bool is_match = listed_basis && \
+                    whateverMatch(interactions.processes()[p]->matchList(),
+                                  configuration.matchList(site));
+
+                if (is_match != matches[site*n_processes + p])
+                {
+                    const std::pair<int, int> pair(site, p);
+                    CPPUNIT_ASSERT( std::binary_search(index_process_to_match.begin(),
+                                                       index_process_to_match.end(),
+                                                       pair) );
+                    ++n_changed;
+                }
+
+                matches[site*n_processes + p] = is_match;
+            }
+        }
+
+        // Count the pairs of all sites within range.
+        n_pairs += index_process_to_match.size();
+        const std::vector<int> neighbours = \
+            lattice_map.supersetNeighbourIndices(flip.affectedIndices(),
+                                                 interactions.maxRange());
+        for (size_t i = 0; i < neighbours.size(); ++i)
+        {
+            const int basis_site = lattice_map.basisSiteFromIndex(neighbours[i]);
+            n_range_pairs += interactions.basisSiteProcesses()[basis_site].size();
+        }
+    }
+
+    CPPUNIT_ASSERT( n_changed > 200 );
+
+    // Far fewer pairs than for all sites within range.
+    CPPUNIT_ASSERT( 3*n_pairs < n_range_pairs );
+    // }}}
+}
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_DependencyIndex::testAffectedPairs()
+{
+    // {{{
+    // Non-periodic in the c direction.
+    std::vector<int> repetitions(3);
+    repetitions[0] = 5;
+    repetitions[1] = 4;
+    repetitions[2] = 8;
+
+    std::vector<bool> periodic(3, true);
+    periodic[2] = false;
+
+    checkAffectedPairs(repetitions, periodic);
+    // }}}
+}
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_DependencyIndex::testSlab()
+{
+    // {{{
+    // A single layer, non-periodic in the c direction.
+    std::vector<int> repetitions(3);
+    repetitions[0] = 8;
+    repetitions[1] = 8;
+    repetitions[2] = 1;
+
+    std::vector<bool> periodic(3, true);
+    periodic[2] = false;
+
+    checkAffectedPairs(repetitions, periodic);
+
+    // A chain, non-periodic in the b and c directions.
+    repetitions[0] = 12;
+    repetitions[1] = 1;
+    periodic[1] = false;
+
+    checkAffectedPairs(repetitions, periodic);
+    // }}}
+}
+
@@ -0,0 +1,37 @@
+/*
+  This file is part of the KMCLib project distributed under the terms of the
+  GNU General Public License version 3, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef __TEST_DEPENDENCYINDEX__
+#define __TEST_DEPENDENCYINDEX__
+
+#include <iostream>
+#include <string>
+
+#include <cppunit/TestCase.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestRunner.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class Test_DependencyIndex : public CppUnit::TestCase {
+
+public:
+
+    CPPUNIT_TEST_SUITE( Test_DependencyIndex );
+    CPPUNIT_TEST( testConstruction );
+    CPPUNIT_TEST( testAffectedPairs );
+    CPPUNIT_TEST( testSlab );
+    CPPUNIT_TEST_SUITE_END();
+
+    void testConstruction();
+    void testAffectedPairs();
+    void testSlab();
+
+};
+
+#endif
+
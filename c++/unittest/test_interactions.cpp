@@ -158,6 +158,66 @@ void Test_Interactions::testQuery()
     // }}}
 }
 
+// -------------------------------------------------------------------------- //
+//
+void Test_Interactions::testBasisSiteProcesses()
+{
+    // {{{
+    std::map<std::string, int> possible_types;
+    possible_types["A"] = 0;
+    possible_types["B"] = 1;
+
+    const std::vector<std::string> process_elements1(1,"A");
+    const std::vector<std::string> process_elements2(1,"B");
+    const std::vector<std::vector<double> > process_coordinates(1, std::vector<double>(3, 0.0));
+    Configuration c1(process_coordinates, process_elements1, possible_types);
+    Configuration c2(process_coordinates, process_elements2, possible_types);
+
+    // Processes on different sets of basis sites.
+    std::vector<int> basis_sites(1, 0);
+    std::vector<Process> processes;
+    processes.push_back(Process(c1, c2, 1.0, basis_sites));
+
+    basis_sites[0] = 1;
+    basis_sites.push_back(3);
+    processes.push_back(Process(c1, c2, 1.0, basis_sites));
+
+    basis_sites[0] = 3;
+    basis_sites[1] = 0;
+    processes.push_back(Process(c1, c2, 1.0, basis_sites, true));
+
+    const Interactions interactions(processes, false);
+
+    // Check the process indices for each basis site.
+    const std::vector< std::vector<int> > & table = interactions.basisSiteProcesses();
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(table.size()), 4 );
+
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(table[0].size()), 2 );
+    CPPUNIT_ASSERT_EQUAL( table[0][0], 0 );
+    CPPUNIT_ASSERT_EQUAL( table[0][1], 2 );
+
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(table[1].size()), 1 );
+    CPPUNIT_ASSERT_EQUAL( table[1][0], 1 );
+
+    CPPUNIT_ASSERT( table[2].empty() );
+
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(table[3].size()), 2 );
+    CPPUNIT_ASSERT_EQUAL( table[3][0], 1 );
+    CPPUNIT_ASSERT_EQUAL( table[3][1], 2 );
+
+    // The fast process table refers to the fast processes only.
+    const std::vector< std::vector<int> > & fast_table = interactions.basisSiteFastProcesses();
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(fast_table.size()), 4 );
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(fast_table[0].size()), 1 );
+    CPPUNIT_ASSERT_EQUAL( fast_table[0][0], 0 );
+    CPPUNIT_ASSERT( fast_table[1].empty() );
+    CPPUNIT_ASSERT( fast_table[2].empty() );
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(fast_table[3].size()), 1 );
+    CPPUNIT_ASSERT_EQUAL( fast_table[3][0], 0 );
+    // }}}
+}
+
+
 // -------------------------------------------------------------------------- //
 //
 void Test_Interactions::testUpdateAndPick()
@@ -989,3 +1049,293 @@ void Test_Interactions::testUpdateProcessIDMoves()
     // }}}
 }
 
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_Interactions::testSelectionType()
+{
+    // {{{
+    // Setup a list of processes.
+    std::vector<Process> processes;
+
+    std::vector<std::string> process_elements1(1, "A");
+    std::vector<std::string> process_elements2(1, "B");
+    std::vector<std::vector<double> > process_coordinates(1, std::vector<double>(3, 0.0));
+
+    std::map<std::string, int> possible_types;
+    possible_types["A"] = 0;
+    possible_types["B"] = 1;
+
+    Configuration c1(process_coordinates, process_elements1, possible_types);
+    Configuration c2(process_coordinates, process_elements2, possible_types);
+    std::vector<int> sites_vector(1,0);
+
+    for (int i = 0; i < 37; ++i)
+    {
+        processes.push_back(Process(c1, c2, 1.0 + 0.1*i, sites_vector));
+    }
+
+    // Fast processes are not part of the selection.
+    processes.push_back(Process(c1, c2, 100.0, sites_vector, true));
+
+    for (int i = 0; i < 37; i += 3)
+    {
+        processes[i].addSite(i);
+        processes[i].addSite(i+100);
+    }
+    processes[37].addSite(1000);
+
+    Interactions interactions(processes, false);
+    CPPUNIT_ASSERT_EQUAL( interactions.selectionType(), TREE_SELECTION );
+
+    // Full update.
+    interactions.updateProbabilityTable();
+    interactions.updateProcessAvailableSites();
+    const double total_rate = interactions.probabilityTable().back().first;
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( interactions.totalRate(), total_rate, 1.0e-12 );
+
+    // The tree and the linear table must pick the same processes.
+    std::vector<int> tree_picks;
+    seedRandom(false, 113);
+    for (int i = 0; i < 1000; ++i)
+    {
+        tree_picks.push_back(interactions.pickProcessIndex());
+    }
+
+    interactions.setSelectionType(LINEAR_SELECTION);
+    CPPUNIT_ASSERT_EQUAL( interactions.selectionType(), LINEAR_SELECTION );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( interactions.totalRate(), total_rate, 1.0e-12 );
+
+    seedRandom(false, 113);
+    for (int i = 0; i < 1000; ++i)
+    {
+        CPPUNIT_ASSERT_EQUAL( interactions.pickProcessIndex(), tree_picks[i] );
+    }
+
+    // Change a few processes and update only the marked ones.
+    interactions.setSelectionType(TREE_SELECTION);
+
+    interactions.processes()[1]->addSite(1);
+    interactions.markProcessUpdated(1);
+    interactions.processes()[3]->removeSite(3);
+    interactions.markProcessUpdated(3);
+    interactions.markProcessUpdated(3);
+    interactions.processes()[37]->addSite(1001);
+    interactions.markProcessUpdated(37);
+
+    interactions.updateMarkedProcesses();
+
+    const double ref_total = total_rate + 1.1 - 1.3;
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( interactions.totalRate(), ref_total, 1.0e-12 );
+    CPPUNIT_ASSERT_EQUAL( interactions.processAvailableSites()[1], 1 );
+    CPPUNIT_ASSERT_EQUAL( interactions.processAvailableSites()[3], 1 );
+    CPPUNIT_ASSERT_EQUAL( interactions.processAvailableSites()[37], 2 );
+    CPPUNIT_ASSERT_EQUAL( interactions.availableSites(), interactions.totalAvailableSites() );
+
+    // The marks are cleared.
+    interactions.processes()[5]->addSite(5);
+    interactions.updateMarkedProcesses();
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( interactions.totalRate(), ref_total, 1.0e-12 );
+
+    // The same result in the linear reference mode.
+    interactions.setSelectionType(LINEAR_SELECTION);
+    interactions.processes()[5]->removeSite(5);
+    interactions.markProcessUpdated(5);
+    interactions.updateMarkedProcesses();
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( interactions.totalRate(), ref_total, 1.0e-12 );
+    CPPUNIT_ASSERT_EQUAL( interactions.availableSites(), interactions.totalAvailableSites() );
+    // }}}
+}
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_Interactions::testCompileProcessMatchLists()
+{
+    // {{{
+    // Setup two processes with a wildcard.
+    std::vector<Process> processes;
+
+    std::vector<std::string> process_elements1(3);
+    process_elements1[0] = "V";
+    process_elements1[1] = "*";
+    process_elements1[2] = "B";
+
+    std::vector<std::string> process_elements2(3);
+    process_elements2[0] = "A";
+    process_elements2[1] = "*";
+    process_elements2[2] = "B";
+
+    std::vector<std::vector<double> > process_coordinates(3, std::vector<double>(3, 0.0));
+    process_coordinates[1][0] = -1.0;
+    process_coordinates[2][0] =  0.3;
+    process_coordinates[2][1] =  0.3;
+    process_coordinates[2][2] =  0.3;
+
+    std::map<std::string, int> possible_types;
+    possible_types["*"] = 0;
+    possible_types["A"] = 1;
+    possible_types["B"] = 2;
+    possible_types["V"] = 3;
+
+    const double rate = 13.7;
+    const Configuration c1(process_coordinates, process_elements1, possible_types);
+    const Configuration c2(process_coordinates, process_elements2, possible_types);
+
+    // Valid at both basis sites, but the geometry only fits basis site 0.
+    std::vector<int> sites_vector(2,0);
+    sites_vector[1] = 1;
+    processes.push_back(Process(c1,c2,rate,sites_vector));
+
+    // The same process with a type that never matches at basis site 0.
+    process_elements1[2] = "A";
+    const Configuration c3(process_coordinates, process_elements1, possible_types);
+    processes.push_back(Process(c3,c2,rate,sites_vector));
+
+    Interactions interactions(processes, false);
+
+    // Generate a corresponding configuration.
+    std::vector<std::vector<double> > config_coordinates;
+    std::vector<std::string> elements;
+    for (int i = 0; i < 5; ++i)
+    {
+        for (int j = 0; j < 5; ++j)
+        {
+            for (int k = 0; k < 5; ++k)
+            {
+                std::vector<double> coord(3);
+                coord[0] = 0.0 + i*1.0;
+                coord[1] = 0.0 + j*1.0;
+                coord[2] = 0.0 + k*1.0;
+                config_coordinates.push_back(coord);
+                elements.push_back((i+j+k) % 2 ? "V" : "A");
+
+                coord[0] = 0.3 + i*1.0;
+                coord[1] = 0.3 + j*1.0;
+                coord[2] = 0.3 + k*1.0;
+                elements.push_back("B");
+                config_coordinates.push_back(coord);
+            }
+        }
+    }
+
+    Configuration config(config_coordinates, elements, possible_types);
+
+    // Non-periodic, so that the geometry differs at the boundaries.
+    const LatticeMap lattice_map(2, std::vector<int>(3,5), std::vector<bool>(3,false));
+    config.initMatchLists(lattice_map, interactions.maxRange());
+
+    // Check the match list geometries.
+    const NeighbourhoodTemplates & neighbourhoods = config.neighbourhoods();
+    const int central = lattice_map.indicesFromCell(2, 2, 2)[0];
+    const int central_geometry = config.matchListGeometry(central);
+    CPPUNIT_ASSERT_EQUAL( neighbourhoods.templateOrigin(central_geometry), central );
+    CPPUNIT_ASSERT_EQUAL( neighbourhoods.templateBasisSite(central_geometry), 0 );
+    CPPUNIT_ASSERT_EQUAL( config.matchListGeometry(central+1), central_geometry + 1 );
+
+    // The corner has a template cut off by the boundaries.
+    const int corner_geometry = config.matchListGeometry(0);
+    CPPUNIT_ASSERT( corner_geometry >= 0 );
+    CPPUNIT_ASSERT( corner_geometry != central_geometry );
+    CPPUNIT_ASSERT( neighbourhoods.templateArrays(corner_geometry).size() <
+                    neighbourhoods.templateArrays(central_geometry).size() );
+
+    // Compile.
+    CPPUNIT_ASSERT( !interactions.processes()[0]->hasCompiledMatchList() );
+    interactions.compileProcessMatchLists(config, lattice_map);
+
+    const Process & process = *interactions.processes()[0];
+    CPPUNIT_ASSERT( process.hasCompiledMatchList() );
+    CPPUNIT_ASSERT( process.geometryMatches(central_geometry) );
+    CPPUNIT_ASSERT( !process.geometryMatches(central_geometry + 1) );
+
+    // The number of template positions within the cutoff of each process.
+    for (size_t p = 0; p < interactions.processes().size(); ++p)
+    {
+        const double cutoff = interactions.processes()[p]->cutoff();
+
+        for (int geometry = 0; geometry < neighbourhoods.nTemplates(); ++geometry)
+        {
+            const std::vector<double> & distances = neighbourhoods.templateArrays(geometry).distances;
+            int n_within = 0;
+            for (size_t i = 0; i < distances.size(); ++i)
+            {
+                n_within += (distances[i] <= cutoff);
+            }
+            CPPUNIT_ASSERT_EQUAL( interactions.cutoffLength(p, geometry), n_within );
+        }
+    }
+
+    // The wildcard is left out.
+    const CompiledMatchList & compiled = process.compiledMatchList();
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(compiled.size()), 2 );
+    CPPUNIT_ASSERT_EQUAL( compiled[0].slot, 0 );
+    CPPUNIT_ASSERT_EQUAL( compiled[0].match_type, 3 );
+    CPPUNIT_ASSERT_EQUAL( compiled[1].slot, 1 );
+    CPPUNIT_ASSERT_EQUAL( compiled[1].match_type, 2 );
+
+    // The compiled match gives the same result as the full match on all
+    // indices with a template, also at the boundaries.
+    int n_matches = 0;
+    for (size_t p = 0; p < interactions.processes().size(); ++p)
+    {
+        const Process & proc = *interactions.processes()[p];
+
+        for (size_t i = 0; i < elements.size(); ++i)
+        {
+            const int geometry = config.matchListGeometry(i);
+            if (geometry < 0)
+            {
+                continue;
+            }
+
+            std::vector<int> indices;
+            config.matchListIndices(i, indices);
+
+            const bool ref_match = whateverMatch(proc.matchList(), config.matchList(i));
+            const bool is_match = proc.geometryMatches(geometry) && \
+                compiledMatch(proc.compiledMatchList(), indices, config.types());
+
+            CPPUNIT_ASSERT_EQUAL( is_match, ref_match );
+            n_matches += is_match;
+        }
+    }
+
+    // Check that there was something to match.
+    CPPUNIT_ASSERT( n_matches > 0 );
+
+    // The match tries give the same matches.
+    CPPUNIT_ASSERT( !interactions.useMatchTrie() );
+    interactions.setUseMatchTrie(true);
+    CPPUNIT_ASSERT( interactions.useMatchTrie() );
+
+    std::vector<int> indices;
+    std::vector<int> trie_matches;
+    std::vector<int> stack;
+
+    for (size_t i = 0; i < elements.size(); ++i)
+    {
+        const int geometry = config.matchListGeometry(i);
+        if (geometry < 0)
+        {
+            continue;
+        }
+
+        config.matchListIndices(i, indices);
+        interactions.matchTrie(geometry).match(indices, config.types(), trie_matches, stack);
+
+        for (size_t p = 0; p < interactions.processes().size(); ++p)
+        {
+            const Process & proc = *interactions.processes()[p];
+            const bool ref_match = whateverMatch(proc.matchList(), config.matchList(i));
+            const bool in_trie = std::find(trie_matches.begin(),
+                                           trie_matches.end(),
+                                           static_cast<int>(p)) != trie_matches.end();
+            CPPUNIT_ASSERT_EQUAL( in_trie, ref_match );
+        }
+    }
+
+    // }}}
+}
+
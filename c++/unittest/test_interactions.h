@@ -26,20 +26,26 @@ public:
     CPPUNIT_TEST_SUITE( Test_Interactions );
     CPPUNIT_TEST( testConstruction );
     CPPUNIT_TEST( testQuery );
+    CPPUNIT_TEST( testBasisSiteProcesses );
     CPPUNIT_TEST( testUpdateAndPick );
     CPPUNIT_TEST( testUpdateAndPickCustom );
     CPPUNIT_TEST( testMaxRange );
     CPPUNIT_TEST( testUpdateProcessMatchLists );
+    CPPUNIT_TEST( testCompileProcessMatchLists );
     CPPUNIT_TEST( testUpdateProcessIDMoves );
+    CPPUNIT_TEST( testSelectionType );
     CPPUNIT_TEST_SUITE_END();
 
     void testConstruction();
     void testQuery();
+    void testBasisSiteProcesses();
     void testUpdateAndPick();
     void testUpdateAndPickCustom();
     void testMaxRange();
     void testUpdateProcessMatchLists();
+    void testCompileProcessMatchLists();
     void testUpdateProcessIDMoves();
+    void testSelectionType();
 
 };
 
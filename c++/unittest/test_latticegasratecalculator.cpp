@@ -0,0 +1,553 @@
+/*
+  This file is part of the KMCLib project distributed under the terms of the
+  GNU General Public License version 3, see <http://www.gnu.org/licenses/>.
+*/
+
+
+// Include the test definition.
+#include "test_latticegasratecalculator.h"
+
+// Include the files to test.
+#include "latticegasratecalculator.h"
+
+#include "configuration.h"
+#include "latticemap.h"
+#include "process.h"
+#include "customrateprocess.h"
+#include "interactions.h"
+#include "latticemodel.h"
+#include "matcher.h"
+#include "simulationtimer.h"
+#include "sitesmap.h"
+#include "random.h"
+
+#include <cmath>
+#include <stdexcept>
+
+
+// -------------------------------------------------------------------------- //
+// The shells of the test lattice, nearest and next nearest neighbours.
+static const double shell0__ = 1.0;
+static const double shell1__ = std::sqrt(2.0);
+
+// The size of the periodic simple cubic test lattice.
+static const int size__ = 4;
+
+
+// -------------------------------------------------------------------------- //
+// Setup a random A/B configuration on the test lattice.
+static Configuration testConfiguration(const int seed)
+{
+    seedRandom(false, seed);
+
+    std::vector<std::vector<double> > coords;
+    std::vector<std::string> elements;
+
+    for (int i = 0; i < size__; ++i)
+    {
+        for (int j = 0; j < size__; ++j)
+        {
+            for (int k = 0; k < size__; ++k)
+            {
+                std::vector<double> coord(3);
+                coord[0] = i;
+                coord[1] = j;
+                coord[2] = k;
+                coords.push_back(coord);
+                elements.push_back(randomDouble01() < 0.5 ? "A" : "B");
+            }
+        }
+    }
+
+    std::map<std::string, int> possible_types;
+    possible_types["*"] = 0;
+    possible_types["A"] = 1;
+    possible_types["B"] = 2;
+
+    return Configuration(coords, elements, possible_types);
+}
+
+
+// -------------------------------------------------------------------------- //
+// Setup the test interactions.
+static void setupInteractions(LatticeGasRateCalculator & calculator)
+{
+    std::vector<double> shells(2);
+    shells[0] = shell0__;
+    shells[1] = shell1__;
+    calculator.setShells(shells, 3);
+
+    calculator.setPairEnergy(1, 1, 0, -0.10);
+    calculator.setPairEnergy(1, 2, 0,  0.05);
+    calculator.setPairEnergy(2, 2, 0, -0.02);
+    calculator.setPairEnergy(1, 1, 1, -0.03);
+    calculator.setPairEnergy(2, 1, 1,  0.01);
+
+    // Right angled triangles, with the A at the corner of the right angle.
+    calculator.setTripletEnergy(1, 1, 1, 0, 1, 0, 0.07);
+    calculator.setTripletEnergy(2, 1, 1, 0, 1, 0, -0.04);
+}
+
+
+// -------------------------------------------------------------------------- //
+// The shell of two sites on the test lattice, -1 if not in a shell.
+static int testShell(const std::vector<Coordinate> & coordinates, const int a, const int b)
+{
+    Coordinate d = coordinates[a] - coordinates[b];
+    double dist2 = 0.0;
+    for (int i = 0; i < 3; ++i)
+    {
+        double x = std::fabs(d[i]);
+        if (x > size__ / 2.0)
+        {
+            x = size__ - x;
+        }
+        dist2 += x*x;
+    }
+
+    if (std::fabs(dist2 - 1.0) < 1.0e-8)
+    {
+        return 0;
+    }
+    if (std::fabs(dist2 - 2.0) < 1.0e-8)
+    {
+        return 1;
+    }
+    return -1;
+}
+
+
+// -------------------------------------------------------------------------- //
+// The total energy, summed up over all pairs and triplets of the lattice.
+static double testEnergy(const std::vector<Coordinate> & coordinates,
+                         const std::vector<int> & types)
+{
+    // {{{
+    const int n = types.size();
+    double energy = 0.0;
+
+    for (int a = 0; a < n; ++a)
+    {
+        for (int b = a + 1; b < n; ++b)
+        {
+            const int s_ab = testShell(coordinates, a, b);
+            if (s_ab < 0)
+            {
+                continue;
+            }
+
+            // The pairs.
+            const int lo = std::min(types[a], types[b]);
+            const int hi = std::max(types[a], types[b]);
+            if (s_ab == 0)
+            {
+                energy += (lo == 1 && hi == 1) ? -0.10 : (lo == 1) ? 0.05 : -0.02;
+            }
+            else
+            {
+                energy += (lo == 1 && hi == 1) ? -0.03 : (lo == 1) ? 0.01 : 0.0;
+            }
+
+            // The right angled triangles.
+            for (int c = b + 1; c < n; ++c)
+            {
+                const int s_bc = testShell(coordinates, b, c);
+                const int s_ca = testShell(coordinates, c, a);
+                if (s_bc < 0 || s_ca < 0 || s_ab + s_bc + s_ca != 1)
+                {
+                    continue;
+                }
+
+                // The corner of the right angle and the two other sites.
+                const int corner = (s_ab == 1) ? c : (s_bc == 1) ? a : b;
+                const int other1 = (corner == a) ? b : a;
+                const int other2 = (corner == c) ? b : c;
+
+                if (types[other1] == 1 && types[other2] == 1)
+                {
+                    if (types[corner] == 1)
+                    {
+                        energy += 0.07;
+                    }
+                    else
+                    {
+                        energy -= 0.04;
+                    }
+                }
+            }
+        }
+    }
+
+    return energy;
+    // }}}
+}
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_LatticeGasRateCalculator::testConstruction()
+{
+    // {{{
+    LatticeGasRateCalculator calculator;
+    CPPUNIT_ASSERT( calculator.threadSafe() );
+    CPPUNIT_ASSERT( calculator.integerTypes() );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( calculator.temperature(), 300.0, 1.0e-12 );
+
+    calculator.setTemperature(550.0);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( calculator.temperature(), 550.0, 1.0e-12 );
+    CPPUNIT_ASSERT_THROW( calculator.setTemperature(0.0), std::invalid_argument );
+
+    // Shells and types.
+    CPPUNIT_ASSERT_THROW( calculator.setShells(std::vector<double>(), 3),
+                          std::invalid_argument );
+    CPPUNIT_ASSERT_THROW( calculator.setShells(std::vector<double>(1, -1.0), 3),
+                          std::invalid_argument );
+    CPPUNIT_ASSERT_THROW( calculator.setShells(std::vector<double>(1, 1.0), 0),
+                          std::invalid_argument );
+    calculator.setShells(std::vector<double>(1, 1.0), 3);
+
+    // Out of range energies.
+    CPPUNIT_ASSERT_THROW( calculator.setPairEnergy(3, 1, 0, 1.0), std::invalid_argument );
+    CPPUNIT_ASSERT_THROW( calculator.setPairEnergy(1, 1, 1, 1.0), std::invalid_argument );
+    CPPUNIT_ASSERT_THROW( calculator.setTripletEnergy(1, 1, 1, 0, 1, 0, 1.0),
+                          std::invalid_argument );
+    CPPUNIT_ASSERT_THROW( calculator.setTripletEnergy(1, -1, 1, 0, 0, 0, 1.0),
+                          std::invalid_argument );
+
+    // No site energies before the state is setup.
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( calculator.siteEnergy(0, 1), 0.0, 1.0e-12 );
+    // }}}
+}
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_LatticeGasRateCalculator::testEnergyChange()
+{
+    // {{{
+    Configuration config = testConfiguration(8812);
+    const LatticeMap lattice_map(1, std::vector<int>(3, size__), std::vector<bool>(3, true));
+    config.initMatchLists(lattice_map, 1);
+
+    LatticeGasRateCalculator calculator;
+    setupInteractions(calculator);
+    calculator.initLocalState(config, std::vector<Process*>());
+
+    const std::vector<int> & types = config.types();
+    const std::vector<Coordinate> & coordinates = config.coordinates();
+    const double energy = testEnergy(coordinates, types);
+
+    // Swap the central site with each nearest and next nearest neighbour,
+    // and flip it, at a few sites.
+    for (int index = 0; index < 64; index += 7)
+    {
+        std::vector<int> indices;
+        config.matchListIndices(index, indices);
+        const std::vector<double> & distances = \
+            config.neighbourhoods().geometryArrays(index).distances;
+
+        for (size_t q = 0; q < indices.size() && distances[q] < 1.5; ++q)
+        {
+            std::vector<int> update_types(q + 1, 0);
+            std::vector<int> new_types = types;
+
+            if (q == 0)
+            {
+                update_types[0] = 3 - types[index];
+            }
+            else
+            {
+                update_types[0] = types[indices[q]];
+                update_types[q] = types[index];
+            }
+
+            for (size_t p = 0; p < update_types.size(); ++p)
+            {
+                if (update_types[p] > 0)
+                {
+                    new_types[indices[p]] = update_types[p];
+                }
+            }
+
+            KMCRatePluginEnvironment environment;
+            environment.len          = indices.size();
+            environment.indices      = indices.data();
+            environment.types        = types.data();
+            environment.n_update     = update_types.size();
+            environment.update_types = update_types.data();
+
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( calculator.energyChange(environment),
+                                          testEnergy(coordinates, new_types) - energy,
+                                          1.0e-10 );
+        }
+    }
+    // }}}
+}
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_LatticeGasRateCalculator::testRate()
+{
+    // {{{
+    Configuration config = testConfiguration(1231);
+    const LatticeMap lattice_map(1, std::vector<int>(3, size__), std::vector<bool>(3, true));
+    config.initMatchLists(lattice_map, 1);
+
+    LatticeGasRateCalculator calculator;
+    setupInteractions(calculator);
+    calculator.setTemperature(500.0);
+    calculator.setBEPParameters(3, 0.6, 0.5);
+    calculator.initLocalState(config, std::vector<Process*>());
+
+    const std::vector<int> & types = config.types();
+    std::vector<int> indices;
+    config.matchListIndices(5, indices);
+    std::vector<int> update_types(1, 3 - types[5]);
+
+    KMCRatePluginEnvironment environment;
+    environment.len            = indices.size();
+    environment.indices        = indices.data();
+    environment.types          = types.data();
+    environment.n_update       = 1;
+    environment.update_types   = update_types.data();
+    environment.rate_constant  = 1.0e13;
+    environment.process_number = 3;
+
+    const double energy_change = calculator.energyChange(environment);
+    const double barrier = std::max(0.0, std::max(energy_change, 0.6 + 0.5*energy_change));
+    const double kT = 8.617333262e-5 * 500.0;
+
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( calculator.backendIntegerRateCallback(environment) /
+                                  (1.0e13 * std::exp(-barrier / kT)),
+                                  1.0, 1.0e-12 );
+
+    // Processes without BEP parameters keep the rate constant.
+    environment.process_number = 4;
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( calculator.backendIntegerRateCallback(environment),
+                                  1.0e13, 1.0 );
+    // }}}
+}
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_LatticeGasRateCalculator::testUpdateLocalState()
+{
+    // {{{
+    Configuration config = testConfiguration(4451);
+    const LatticeMap lattice_map(1, std::vector<int>(3, size__), std::vector<bool>(3, true));
+    config.initMatchLists(lattice_map, 1);
+
+    LatticeGasRateCalculator calculator;
+    setupInteractions(calculator);
+    calculator.initLocalState(config, std::vector<Process*>());
+
+    // A process turning an A into a B and one turning a B into an A.
+    std::map<std::string, int> possible_types;
+    possible_types["*"] = 0;
+    possible_types["A"] = 1;
+    possible_types["B"] = 2;
+
+    const std::vector<std::vector<double> > process_coords(1, std::vector<double>(3, 0.0));
+    const Configuration config_a(process_coords, std::vector<std::string>(1, "A"), possible_types);
+    const Configuration config_b(process_coords, std::vector<std::string>(1, "B"), possible_types);
+    const std::vector<int> basis_sites(1, 0);
+    Process a_to_b(config_a, config_b, 1.0, basis_sites);
+    Process b_to_a(config_b, config_a, 1.0, basis_sites);
+
+    for (int step = 0; step < 20; ++step)
+    {
+        const int index = (step * 13) % 64;
+        Process & process = (config.types()[index] == 1) ? a_to_b : b_to_a;
+        config.performProcess(process, index);
+        calculator.updateLocalState(config, process.affectedIndices());
+    }
+
+    // The same site energies as set up from scratch.
+    LatticeGasRateCalculator reference;
+    setupInteractions(reference);
+    reference.initLocalState(config, std::vector<Process*>());
+
+    for (int i = 0; i < 64; ++i)
+    {
+        for (int t = 0; t < 3; ++t)
+        {
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( calculator.siteEnergy(i, t),
+                                          reference.siteEnergy(i, t), 1.0e-10 );
+        }
+    }
+    // }}}
+}
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_LatticeGasRateCalculator::testProcessCutoff()
+{
+    // {{{
+    Configuration config = testConfiguration(3017);
+    const LatticeMap lattice_map(1, std::vector<int>(3, size__), std::vector<bool>(3, true));
+    config.initMatchLists(lattice_map, 1);
+
+    LatticeGasRateCalculator calculator;
+    setupInteractions(calculator);
+
+    std::map<std::string, int> possible_types;
+    possible_types["*"] = 0;
+    possible_types["A"] = 1;
+    possible_types["B"] = 2;
+
+    // A hop to the nearest neighbour.
+    std::vector<std::vector<double> > process_coords(2, std::vector<double>(3, 0.0));
+    process_coords[1][0] = 1.0;
+    std::vector<std::string> elements_before(2, "A");
+    elements_before[1] = "B";
+    std::vector<std::string> elements_after(2, "B");
+    elements_after[1] = "A";
+
+    const Configuration config1(process_coords, elements_before, possible_types);
+    const Configuration config2(process_coords, elements_after, possible_types);
+    const std::vector<int> basis_sites(1, 0);
+
+    // The shells around the hop reach a distance of 1 + sqrt(2).
+    CustomRateProcess short_hop(config1, config2, 1.0, basis_sites, 1.0);
+    CustomRateProcess long_hop(config1, config2, 1.0, basis_sites, 2.5);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( calculator.requiredCutoff(short_hop), 1.0 + shell1__, 1.0e-12 );
+
+    // A too short cutoff is rejected.
+    std::vector<Process*> processes(1, &short_hop);
+    CPPUNIT_ASSERT_THROW( calculator.initLocalState(config, processes), std::runtime_error );
+
+    processes[0] = &long_hop;
+    calculator.initLocalState(config, processes);
+
+    // A flip of the central site only needs the shells.
+    elements_after[1] = "B";
+    const Configuration config4(process_coords, elements_after, possible_types);
+    const CustomRateProcess flip(config1, config4, 1.0, basis_sites, 1.0);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( calculator.requiredCutoff(flip), shell1__, 1.0e-12 );
+    // }}}
+}
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_LatticeGasRateCalculator::testRatesAfterSteps()
+{
+    // {{{
+    // A random A/B configuration on a periodic simple cubic lattice, large
+    // enough for the match lists of the hop processes.
+    const int size = 6;
+    seedRandom(false, 5519);
+
+    std::vector<std::vector<double> > coords;
+    std::vector<std::string> elements;
+    std::vector<std::string> site_types;
+
+    for (int i = 0; i < size; ++i)
+    {
+        for (int j = 0; j < size; ++j)
+        {
+            for (int k = 0; k < size; ++k)
+            {
+                std::vector<double> coord(3);
+                coord[0] = i;
+                coord[1] = j;
+                coord[2] = k;
+                coords.push_back(coord);
+                elements.push_back(randomDouble01() < 0.5 ? "A" : "B");
+                site_types.push_back("M");
+            }
+        }
+    }
+
+    std::map<std::string, int> possible_types;
+    possible_types["*"] = 0;
+    possible_types["A"] = 1;
+    possible_types["B"] = 2;
+
+    std::map<std::string, int> possible_site_types;
+    possible_site_types["*"] = 0;
+    possible_site_types["M"] = 1;
+
+    // Hops of an A to a nearest neighbour B in the +x and -x directions,
+    // with the cutoff covering the shells around both changed sites.
+    std::vector<CustomRateProcess> processes;
+    const std::vector<int> basis_sites(1, 0);
+    std::vector<std::string> elements_before(2, "A");
+    elements_before[1] = "B";
+    std::vector<std::string> elements_after(2, "B");
+    elements_after[1] = "A";
+
+    for (int p = 0; p < 2; ++p)
+    {
+        std::vector<std::vector<double> > process_coords(2, std::vector<double>(3, 0.0));
+        process_coords[1][0] = (p == 0) ? 1.0 : -1.0;
+        const Configuration config1(process_coords, elements_before, possible_types);
+        const Configuration config2(process_coords, elements_after, possible_types);
+        processes.push_back(CustomRateProcess(config1, config2, 1.0e13, basis_sites,
+                                              1.0 + shell1__, {}, {}, p));
+    }
+
+    LatticeGasRateCalculator calculator;
+    setupInteractions(calculator);
+    calculator.setBEPParameters(0, 0.6, 0.5);
+    calculator.setBEPParameters(1, 0.7, 0.4);
+
+    Configuration config(coords, elements, possible_types);
+    SitesMap sitesmap(coords, site_types, possible_site_types);
+    LatticeMap lattice_map(1, std::vector<int>(3, size), std::vector<bool>(3, true));
+    config.initMatchLists(lattice_map, 2);
+    Interactions interactions(processes, true, calculator);
+    SimulationTimer timer;
+    LatticeModel lattice_model(config, sitesmap, timer, lattice_map, interactions);
+
+    for (int step = 0; step < 50; ++step)
+    {
+        lattice_model.singleStep();
+    }
+
+    // Each listed rate is the same as calculated from a calculator set up
+    // from scratch for the current types.
+    LatticeGasRateCalculator reference;
+    setupInteractions(reference);
+    reference.setBEPParameters(0, 0.6, 0.5);
+    reference.setBEPParameters(1, 0.7, 0.4);
+    reference.initLocalState(config, interactions.processes());
+
+    const Matcher matcher;
+    for (size_t p = 0; p < interactions.processes().size(); ++p)
+    {
+        const CustomRateProcess & process = \
+            dynamic_cast<const CustomRateProcess &>(*interactions.processes()[p]);
+        const std::vector<int> & sites = process.sites();
+        CPPUNIT_ASSERT( !sites.empty() );
+
+        for (size_t i = 0; i < sites.size(); ++i)
+        {
+            const double rate = matcher.updateSingleRate(sites[i], process, config, reference);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( process.siteRate(i) / rate, 1.0, 1.0e-10 );
+        }
+    }
+
+    // A cutoff not covering the shells around the changed sites is rejected.
+    std::vector<CustomRateProcess> short_processes;
+    {
+        std::vector<std::vector<double> > process_coords(2, std::vector<double>(3, 0.0));
+        process_coords[1][0] = 1.0;
+        const Configuration config1(process_coords, elements_before, possible_types);
+        const Configuration config2(process_coords, elements_after, possible_types);
+        short_processes.push_back(CustomRateProcess(config1, config2, 1.0e13, basis_sites,
+                                                    1.0, {}, {}, 0));
+    }
+
+    Configuration short_config(coords, elements, possible_types);
+    short_config.initMatchLists(lattice_map, 2);
+    Interactions short_interactions(short_processes, true, calculator);
+    SimulationTimer short_timer;
+    CPPUNIT_ASSERT_THROW( LatticeModel(short_config, sitesmap, short_timer,
+                                       lattice_map, short_interactions),
+                          std::runtime_error );
+    // }}}
+}
@@ -0,0 +1,43 @@
+/*
+  This file is part of the KMCLib project distributed under the terms of the
+  GNU General Public License version 3, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef __TEST_LATTICEGASRATECALCULATOR__
+#define __TEST_LATTICEGASRATECALCULATOR__
+
+#include <iostream>
+#include <string>
+
+#include <cppunit/TestCase.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestRunner.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class Test_LatticeGasRateCalculator : public CppUnit::TestCase {
+
+public:
+
+    CPPUNIT_TEST_SUITE( Test_LatticeGasRateCalculator );
+    CPPUNIT_TEST( testConstruction );
+    CPPUNIT_TEST( testEnergyChange );
+    CPPUNIT_TEST( testRate );
+    CPPUNIT_TEST( testUpdateLocalState );
+    CPPUNIT_TEST( testProcessCutoff );
+    CPPUNIT_TEST( testRatesAfterSteps );
+    CPPUNIT_TEST_SUITE_END();
+
+    void testConstruction();
+    void testEnergyChange();
+    void testRate();
+    void testUpdateLocalState();
+    void testProcessCutoff();
+    void testRatesAfterSteps();
+
+};
+
+#endif
+
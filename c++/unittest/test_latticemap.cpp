@@ -703,6 +703,163 @@ void Test_LatticeMap::testSupersetNeighbourIndices()
 }
 
 
+// -------------------------------------------------------------------------- //
+//
+void Test_LatticeMap::testNeighbourTable()
+{
+    // {{{
+    std::vector<int> repetitions(3);
+    repetitions[0] = 5;
+    repetitions[1] = 2;
+    repetitions[2] = 4;
+
+    // Test all combinations of periodicity.
+    for (int p = 0; p < 8; ++p)
+    {
+        std::vector<bool> periodicity(3);
+        periodicity[0] = (p & 1);
+        periodicity[1] = (p & 2);
+        periodicity[2] = (p & 4);
+
+        const LatticeMap reference(2, repetitions, periodicity);
+        LatticeMap map(2, repetitions, periodicity);
+
+        CPPUNIT_ASSERT( !map.hasNeighbourTable(1) );
+        map.initNeighbourTable(1);
+        map.initNeighbourTable(2);
+        CPPUNIT_ASSERT( map.hasNeighbourTable(1) );
+        CPPUNIT_ASSERT( map.hasNeighbourTable(2) );
+        CPPUNIT_ASSERT( !map.hasNeighbourTable(3) );
+
+        std::vector<int> buffer;
+
+        for (int index = 0; index < 80; ++index)
+        {
+            for (int shells = 1; shells <= 3; ++shells)
+            {
+                // The same neighbours with and without the table.
+                const std::vector<int> neighbours = reference.neighbourIndices(index, shells);
+                CPPUNIT_ASSERT( map.neighbourIndices(index, shells) == neighbours );
+
+                const IndexSpan span = map.neighbourSpan(index, shells, buffer);
+                CPPUNIT_ASSERT( std::vector<int>(span.begin(), span.end()) == neighbours );
+                CPPUNIT_ASSERT_EQUAL( span.size(), neighbours.size() );
+
+                // The table is used without the buffer.
+                if (shells < 3)
+                {
+                    CPPUNIT_ASSERT( span.begin() != buffer.data() );
+                }
+                else
+                {
+                    CPPUNIT_ASSERT( buffer == neighbours );
+                }
+            }
+
+            // The same moves, within and outside of the tables.
+            for (int i = -3; i <= 3; ++i)
+            {
+                for (int j = -1; j <= 1; ++j)
+                {
+                    for (int k = -2; k <= 2; ++k)
+                    {
+                        const int basis = -map.basisSiteFromIndex(index) + (i + j + k + 6) % 2;
+                        CPPUNIT_ASSERT_EQUAL( map.indexFromMoveInfo(index, i, j, k, basis),
+                                              reference.indexFromMoveInfo(index, i, j, k, basis) );
+                    }
+                }
+            }
+        }
+
+        // The same superset.
+        std::vector<int> indices;
+        indices.push_back(3);
+        indices.push_back(17);
+        indices.push_back(54);
+        CPPUNIT_ASSERT( map.supersetNeighbourIndices(indices, 2) ==
+                        reference.supersetNeighbourIndices(indices, 2) );
+    }
+    // }}}
+}
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_LatticeMap::testMortonOrder()
+{
+    // {{{
+    std::vector<int> repetitions(3);
+    repetitions[0] = 5;
+    repetitions[1] = 4;
+    repetitions[2] = 3;
+
+    std::vector<bool> periodicity(3, true);
+    periodicity[1] = false;
+
+    const LatticeMap reference(2, repetitions, periodicity);
+    LatticeMap map(2, repetitions, periodicity, true);
+
+    CPPUNIT_ASSERT( !reference.cellOrder().morton() );
+    CPPUNIT_ASSERT( map.cellOrder().morton() );
+
+    // The row-major indices are a permutation keeping the basis sites together.
+    const std::vector<int> row_major_indices = map.rowMajorIndices();
+    std::vector<int> sorted = row_major_indices;
+    std::sort(sorted.begin(), sorted.end());
+    for (int i = 0; i < 120; ++i)
+    {
+        CPPUNIT_ASSERT_EQUAL( sorted[i], i );
+        CPPUNIT_ASSERT_EQUAL( row_major_indices[i] % 2, i % 2 );
+        CPPUNIT_ASSERT_EQUAL( reference.rowMajorIndices()[i], i );
+    }
+
+    // The first cells along the Morton curve.
+    CPPUNIT_ASSERT_EQUAL( map.indicesFromCell(0, 0, 0)[0], 0 );
+    CPPUNIT_ASSERT_EQUAL( map.indicesFromCell(0, 0, 1)[0], 2 );
+    CPPUNIT_ASSERT_EQUAL( map.indicesFromCell(0, 1, 0)[0], 4 );
+    CPPUNIT_ASSERT_EQUAL( map.indicesFromCell(0, 1, 1)[0], 6 );
+    CPPUNIT_ASSERT_EQUAL( map.indicesFromCell(1, 0, 0)[0], 8 );
+
+    // The cells of the indices.
+    for (int index = 0; index < 120; ++index)
+    {
+        int i, j, k;
+        map.indexToCell(index, i, j, k);
+        CPPUNIT_ASSERT_EQUAL( map.indicesFromCell(i, j, k)[index % 2], index );
+
+        int ri, rj, rk;
+        reference.indexToCell(row_major_indices[index], ri, rj, rk);
+        CPPUNIT_ASSERT_EQUAL( i, ri );
+        CPPUNIT_ASSERT_EQUAL( j, rj );
+        CPPUNIT_ASSERT_EQUAL( k, rk );
+    }
+
+    // The same neighbours and moves as in row-major order, before and after
+    // setting up the neighbour tables.
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        for (int index = 0; index < 120; ++index)
+        {
+            const std::vector<int> neighbours = map.neighbourIndices(index, 1);
+            const std::vector<int> ref = reference.neighbourIndices(row_major_indices[index], 1);
+
+            CPPUNIT_ASSERT_EQUAL( neighbours.size(), ref.size() );
+            for (size_t n = 0; n < neighbours.size(); ++n)
+            {
+                CPPUNIT_ASSERT_EQUAL( row_major_indices[neighbours[n]], ref[n] );
+            }
+
+            const int moved = map.indexFromMoveInfo(index, 1, 0, -1, 0);
+            CPPUNIT_ASSERT_EQUAL( row_major_indices[moved],
+                                  reference.indexFromMoveInfo(row_major_indices[index], 1, 0, -1, 0) );
+        }
+
+        map.initNeighbourTable(1);
+    }
+    // }}}
+}
+
+
 // -------------------------------------------------------------------------- //
 //
 void Test_LatticeMap::testWrap()
@@ -862,6 +1019,40 @@ void Test_LatticeMap::testWrapLong()
 }
 
 
+// -------------------------------------------------------------------------- //
+//
+void Test_LatticeMap::testWrapBlock()
+{
+    // {{{
+    std::vector<int> repetitions(3);
+    repetitions[0] = 3;
+    repetitions[1] = 5;
+    repetitions[2] = 6;
+    const std::vector<bool> periodicity(3, true);
+    LatticeMap map(3, repetitions, periodicity);
+
+    // Components inside, outside and on the half cell boundaries.
+    const double values[] = {-4.5, -3.0, -2.5, -1.5, -1.4999, -0.3, 0.0,
+                             0.7, 1.4999, 1.5, 2.5, 2.9, 3.0, 4.4};
+    const size_t n = sizeof(values) / sizeof(values[0]);
+
+    for (int direction = 0; direction < 3; ++direction)
+    {
+        std::vector<double> block(values, values + n);
+        map.wrap(block.data(), n, direction);
+
+        // The same as wrapping each coordinate in the direction.
+        for (size_t i = 0; i < n; ++i)
+        {
+            Coordinate c(values[i], values[i], values[i]);
+            map.wrap(c, direction);
+            CPPUNIT_ASSERT_EQUAL( c[direction], block[i] );
+        }
+    }
+    // }}}
+}
+
+
 // -------------------------------------------------------------------------- //
 //
 void Test_LatticeMap::testBasisSiteFromIndex()
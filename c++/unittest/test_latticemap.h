@@ -35,8 +35,11 @@ public:
     CPPUNIT_TEST( testNeighbourIndicesMinimal2 );
     CPPUNIT_TEST( testNeighbourIndicesLong );
     CPPUNIT_TEST( testSupersetNeighbourIndices );
+    CPPUNIT_TEST( testNeighbourTable );
+    CPPUNIT_TEST( testMortonOrder );
     CPPUNIT_TEST( testWrap );
     CPPUNIT_TEST( testWrapLong );
+    CPPUNIT_TEST( testWrapBlock );
     CPPUNIT_TEST( testBasisSiteFromIndex );
     CPPUNIT_TEST( testSubLatticeConstruction );
     CPPUNIT_TEST( testGlobalIndex );
@@ -54,8 +57,11 @@ public:
     void testNeighbourIndicesMinimal2();
     void testNeighbourIndicesLong();
     void testSupersetNeighbourIndices();
+    void testNeighbourTable();
+    void testMortonOrder();
     void testWrap();
     void testWrapLong();
+    void testWrapBlock();
     void testBasisSiteFromIndex();
     void testSubLatticeConstruction();
     void testGlobalIndex();
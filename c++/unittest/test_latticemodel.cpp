@@ -22,8 +22,12 @@
 #include "matchlist.h"
 #include "sitesmap.h"
 
+#include <cmath>
 #include <ctime>
 #include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
 
 // -------------------------------------------------------------------------- //
 //
@@ -3102,6 +3106,385 @@ void Test_LatticeModel::testSingleStepWithRedistribution()
     // }}}
 }
 
+// -------------------------------------------------------------------------- //
+//
+void Test_LatticeModel::testRun()
+{
+    // {{{
+    // Setup a periodic chain of A and B sites.
+    const int n_sites = 20;
+    std::vector<std::vector<double> > coordinates;
+    std::vector<std::string> elements;
+    std::vector<std::string> site_types;
+    for (int i = 0; i < n_sites; ++i)
+    {
+        coordinates.push_back({static_cast<double>(i), 0.0, 0.0});
+        elements.push_back((i % 3 == 0) ? "B" : "A");
+        site_types.push_back("M");
+    }
+
+    std::map<std::string, int> possible_types;
+    possible_types["*"] = 0;
+    possible_types["A"] = 1;
+    possible_types["B"] = 2;
+
+    std::map<std::string, int> possible_site_types;
+    possible_site_types["*"] = 0;
+    possible_site_types["M"] = 1;
+
+    const std::vector<int> repetitions = {n_sites, 1, 1};
+    const std::vector<bool> periodicity(3, true);
+    const std::vector<int> basis_sites(1, 0);
+    const std::vector<std::vector<double> > process_coordinates(1, std::vector<double>(3, 0.0));
+
+    // Processes flipping A to B and B to A.
+    std::vector<Process> processes;
+    {
+        Configuration c1(process_coordinates, {"A"}, possible_types);
+        Configuration c2(process_coordinates, {"B"}, possible_types);
+        processes.push_back(Process(c1, c2, 1.0, basis_sites));
+        processes.push_back(Process(c2, c1, 2.0, basis_sites));
+    }
+
+    // Take a number of steps with single steps.
+    const int n_steps = 25;
+    std::vector<int> ref_types;
+    double ref_time = 0.0;
+    {
+        Configuration configuration(coordinates, elements, possible_types);
+        SitesMap sitesmap(coordinates, site_types, possible_site_types);
+        LatticeMap lattice_map(1, repetitions, periodicity);
+        configuration.initMatchLists(lattice_map, 1);
+        Interactions interactions(processes, true);
+        SimulationTimer timer;
+        LatticeModel lattice_model(configuration, sitesmap, timer, lattice_map, interactions);
+
+        seedRandom(false, 13);
+        for (int i = 0; i < n_steps; ++i)
+        {
+            lattice_model.singleStep();
+        }
+        ref_types = configuration.types();
+        ref_time = timer.simulationTime();
+    }
+
+    // The same steps taken in one run give the same configuration and time.
+    {
+        Configuration configuration(coordinates, elements, possible_types);
+        SitesMap sitesmap(coordinates, site_types, possible_site_types);
+        LatticeMap lattice_map(1, repetitions, periodicity);
+        configuration.initMatchLists(lattice_map, 1);
+        Interactions interactions(processes, true);
+        SimulationTimer timer;
+        LatticeModel lattice_model(configuration, sitesmap, timer, lattice_map, interactions);
+
+        seedRandom(false, 13);
+        CPPUNIT_ASSERT_EQUAL( lattice_model.run(n_steps, 1.0e10), n_steps );
+        CPPUNIT_ASSERT( configuration.types() == ref_types );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( timer.simulationTime(), ref_time, 1.0e-12 );
+
+        // The run stops after the step passing the time limit.
+        const double time_limit = ref_time + 0.1;
+        const int n_taken = lattice_model.run(100000, time_limit);
+        CPPUNIT_ASSERT( n_taken > 0 );
+        CPPUNIT_ASSERT( n_taken < 100000 );
+        CPPUNIT_ASSERT( timer.simulationTime() > time_limit );
+        CPPUNIT_ASSERT( timer.simulationTime() - timer.deltaTime() <= time_limit );
+    }
+
+    // The run stops when no process is available.
+    {
+        std::vector<Process> one_way(1, processes[0]);
+        Configuration configuration(coordinates, elements, possible_types);
+        SitesMap sitesmap(coordinates, site_types, possible_site_types);
+        LatticeMap lattice_map(1, repetitions, periodicity);
+        configuration.initMatchLists(lattice_map, 1);
+        Interactions interactions(one_way, true);
+        SimulationTimer timer;
+        LatticeModel lattice_model(configuration, sitesmap, timer, lattice_map, interactions);
+
+        const int n_a = static_cast<int>(std::count(elements.begin(), elements.end(), "A"));
+        CPPUNIT_ASSERT_EQUAL( lattice_model.run(100, 1.0e10), n_a );
+        CPPUNIT_ASSERT_EQUAL( interactions.totalAvailableSites(), 0 );
+        CPPUNIT_ASSERT_EQUAL( interactions.availableSites(), 0 );
+        CPPUNIT_ASSERT_EQUAL( lattice_model.run(100, 1.0e10), 0 );
+    }
+
+    // }}}
+}
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_LatticeModel::testCheckpoint()
+{
+    // {{{
+    // Setup a periodic chain of A and B sites.
+    const int n_sites = 30;
+    std::vector<std::vector<double> > coordinates;
+    std::vector<std::string> elements;
+    std::vector<std::string> site_types;
+    for (int i = 0; i < n_sites; ++i)
+    {
+        coordinates.push_back({static_cast<double>(i), 0.0, 0.0});
+        elements.push_back((i % 3 == 0) ? "B" : "A");
+        site_types.push_back("M");
+    }
+
+    std::map<std::string, int> possible_types;
+    possible_types["*"] = 0;
+    possible_types["A"] = 1;
+    possible_types["B"] = 2;
+
+    std::map<std::string, int> possible_site_types;
+    possible_site_types["*"] = 0;
+    possible_site_types["M"] = 1;
+
+    const std::vector<int> repetitions = {n_sites, 1, 1};
+    const std::vector<bool> periodicity(3, true);
+    const std::vector<int> basis_sites(1, 0);
+
+    // A process flipping B to A, and one moving a B to the right
+    // leaving an A behind.
+    std::vector<Process> processes;
+    {
+        const std::vector<std::vector<double> > process_coordinates(1, std::vector<double>(3, 0.0));
+        Configuration c1(process_coordinates, {"B"}, possible_types);
+        Configuration c2(process_coordinates, {"A"}, possible_types);
+        processes.push_back(Process(c1, c2, 0.5, basis_sites));
+    }
+    {
+        const std::vector<std::vector<double> > process_coordinates = {{0.0, 0.0, 0.0},
+                                                                       {1.0, 0.0, 0.0}};
+        Configuration c1(process_coordinates, {"B", "A"}, possible_types);
+        Configuration c2(process_coordinates, {"A", "B"}, possible_types);
+        const std::vector<int> move_origins = {0, 1};
+        const std::vector<Coordinate> move_vectors = {Coordinate(1.0, 0.0, 0.0),
+                                                      Coordinate(-1.0, 0.0, 0.0)};
+        processes.push_back(Process(c1, c2, 3.0, basis_sites, move_origins, move_vectors));
+    }
+    {
+        const std::vector<std::vector<double> > process_coordinates(1, std::vector<double>(3, 0.0));
+        Configuration c1(process_coordinates, {"A"}, possible_types);
+        Configuration c2(process_coordinates, {"B"}, possible_types);
+        processes.push_back(Process(c1, c2, 0.2, basis_sites));
+    }
+
+    const std::string checkpoint_file = "latticemodel_checkpoint.tmp";
+    const int n_steps = 40;
+
+    // Run, write a checkpoint and continue.
+    double checkpoint_time = 0.0;
+    std::vector<int> ref_types;
+    std::vector<int> ref_atom_id;
+    double ref_time = 0.0;
+    {
+        Configuration configuration(coordinates, elements, possible_types);
+        SitesMap sitesmap(coordinates, site_types, possible_site_types);
+        LatticeMap lattice_map(1, repetitions, periodicity);
+        Interactions interactions(processes, true);
+        SimulationTimer timer(2.0);
+        LatticeModel lattice_model(configuration, sitesmap, timer, lattice_map, interactions);
+
+        seedRandom(false, 17);
+        lattice_model.run(n_steps, 1.0e10);
+        CPPUNIT_ASSERT_EQUAL( lattice_model.step(), n_steps );
+        lattice_model.writeCheckpoint(checkpoint_file);
+        checkpoint_time = timer.simulationTime();
+
+        lattice_model.run(n_steps, 1.0e10);
+        ref_types = configuration.types();
+        ref_atom_id = configuration.atomID();
+        ref_time = timer.simulationTime();
+    }
+
+    // Restart from the checkpoint with the initial configuration and
+    // another seed, and take the same steps.
+    {
+        Configuration configuration(coordinates, elements, possible_types);
+        SitesMap sitesmap(coordinates, site_types, possible_site_types);
+        LatticeMap lattice_map(1, repetitions, periodicity);
+        Interactions interactions(processes, true);
+        SimulationTimer timer;
+
+        seedRandom(false, 99);
+        LatticeModel lattice_model(configuration, sitesmap, timer, lattice_map,
+                                   interactions, checkpoint_file);
+        CPPUNIT_ASSERT_EQUAL( timer.simulationTime(), checkpoint_time );
+
+        // The step counter continues from the checkpoint.
+        CPPUNIT_ASSERT_EQUAL( lattice_model.step(), n_steps );
+
+        // The restored process sites are the ones found by matching.
+        Configuration matched_configuration = configuration;
+        Interactions matched_interactions(processes, true);
+        SimulationTimer matched_timer;
+        LatticeModel matched_model(matched_configuration, sitesmap, matched_timer,
+                                   lattice_map, matched_interactions);
+        for (size_t p = 0; p < processes.size(); ++p)
+        {
+            std::vector<int> sites = interactions.processes()[p]->sites();
+            std::vector<int> matched_sites = matched_interactions.processes()[p]->sites();
+            std::sort(sites.begin(), sites.end());
+            std::sort(matched_sites.begin(), matched_sites.end());
+            CPPUNIT_ASSERT( sites == matched_sites );
+        }
+
+        lattice_model.run(n_steps, 1.0e10);
+        CPPUNIT_ASSERT_EQUAL( lattice_model.step(), 2*n_steps );
+        CPPUNIT_ASSERT( configuration.types() == ref_types );
+        CPPUNIT_ASSERT( configuration.atomID() == ref_atom_id );
+        CPPUNIT_ASSERT_EQUAL( timer.simulationTime(), ref_time );
+    }
+
+    // A checkpoint of another lattice size is rejected.
+    {
+        std::vector<std::vector<double> > short_coordinates(coordinates.begin(), coordinates.begin() + 12);
+        std::vector<std::string> short_elements(elements.begin(), elements.begin() + 12);
+        std::vector<std::string> short_site_types(site_types.begin(), site_types.begin() + 12);
+        Configuration configuration(short_coordinates, short_elements, possible_types);
+        SitesMap sitesmap(short_coordinates, short_site_types, possible_site_types);
+        LatticeMap lattice_map(1, {12, 1, 1}, periodicity);
+        Interactions interactions(processes, true);
+        SimulationTimer timer;
+        CPPUNIT_ASSERT_THROW( LatticeModel(configuration, sitesmap, timer, lattice_map,
+                                           interactions, checkpoint_file),
+                              std::runtime_error );
+
+        // So is a file that is not a checkpoint, or is missing.
+        std::ofstream stream(checkpoint_file.c_str());
+        stream << "not a checkpoint";
+        stream.close();
+        CPPUNIT_ASSERT_THROW( LatticeModel(configuration, sitesmap, timer, lattice_map,
+                                           interactions, checkpoint_file),
+                              std::runtime_error );
+
+        std::remove(checkpoint_file.c_str());
+        CPPUNIT_ASSERT_THROW( LatticeModel(configuration, sitesmap, timer, lattice_map,
+                                           interactions, checkpoint_file),
+                              std::runtime_error );
+    }
+
+    // }}}
+}
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_LatticeModel::testRandomStream()
+{
+    // {{{
+    // Setup a periodic chain of A and B sites with flipping processes.
+    const int n_sites = 20;
+    std::vector<std::vector<double> > coordinates;
+    std::vector<std::string> elements;
+    std::vector<std::string> site_types;
+    for (int i = 0; i < n_sites; ++i)
+    {
+        coordinates.push_back({static_cast<double>(i), 0.0, 0.0});
+        elements.push_back((i % 2 == 0) ? "A" : "B");
+        site_types.push_back("M");
+    }
+
+    std::map<std::string, int> possible_types;
+    possible_types["*"] = 0;
+    possible_types["A"] = 1;
+    possible_types["B"] = 2;
+
+    std::map<std::string, int> possible_site_types;
+    possible_site_types["*"] = 0;
+    possible_site_types["M"] = 1;
+
+    const std::vector<int> repetitions = {n_sites, 1, 1};
+    const std::vector<bool> periodicity(3, true);
+    const std::vector<int> basis_sites(1, 0);
+
+    const std::vector<std::vector<double> > process_coordinates(1, std::vector<double>(3, 0.0));
+    Configuration ca(process_coordinates, {"A"}, possible_types);
+    Configuration cb(process_coordinates, {"B"}, possible_types);
+    std::vector<Process> processes;
+    processes.push_back(Process(ca, cb, 1.0, basis_sites));
+    processes.push_back(Process(cb, ca, 3.0, basis_sites));
+
+    const int n_steps = 50;
+    const std::string checkpoint_file = "latticemodel_random_stream.tmp";
+
+    // Run the models of three replicas, the first two with the same
+    // stream, drawing from the global generator in between their steps.
+    std::vector<std::vector<int> > types(3);
+    std::vector<double> times(3);
+    for (int r = 0; r < 3; ++r)
+    {
+        Configuration configuration(coordinates, elements, possible_types);
+        SitesMap sitesmap(coordinates, site_types, possible_site_types);
+        LatticeMap lattice_map(1, repetitions, periodicity);
+        Interactions interactions(processes, true);
+        SimulationTimer timer;
+        LatticeModel lattice_model(configuration, sitesmap, timer, lattice_map, interactions);
+
+        CPPUNIT_ASSERT( !lattice_model.hasRandomStream() );
+        lattice_model.setRandomStream(31, (r < 2) ? 0 : 1);
+        CPPUNIT_ASSERT( lattice_model.hasRandomStream() );
+
+        seedRandom(false, 7 + r);
+        for (int i = 0; i < n_steps; ++i)
+        {
+            lattice_model.singleStep();
+            for (int j = 0; j <= r; ++j)
+            {
+                randomDouble01();
+            }
+        }
+
+        // Write a checkpoint from the first replica and continue.
+        if (r == 0)
+        {
+            lattice_model.writeCheckpoint(checkpoint_file);
+            lattice_model.run(n_steps, 1.0e10);
+        }
+
+        types[r] = configuration.types();
+        times[r] = timer.simulationTime();
+
+        lattice_model.clearRandomStream();
+        CPPUNIT_ASSERT( !lattice_model.hasRandomStream() );
+    }
+
+    // The replicas of the same stream took the same steps, and the other
+    // stream took other steps.
+    Configuration configuration(coordinates, elements, possible_types);
+    SitesMap sitesmap(coordinates, site_types, possible_site_types);
+    LatticeMap lattice_map(1, repetitions, periodicity);
+    Interactions interactions(processes, true);
+    SimulationTimer timer;
+    {
+        LatticeModel lattice_model(configuration, sitesmap, timer, lattice_map, interactions);
+        lattice_model.setRandomStream(31, 0);
+        lattice_model.run(n_steps, 1.0e10);
+        CPPUNIT_ASSERT( configuration.types() == types[1] );
+        CPPUNIT_ASSERT_EQUAL( timer.simulationTime(), times[1] );
+        CPPUNIT_ASSERT( std::abs(times[2] - times[1]) > 1.0e-6 );
+    }
+
+    // The stream is restored from the checkpoint.
+    {
+        Configuration restart_configuration(coordinates, elements, possible_types);
+        Interactions restart_interactions(processes, true);
+        SimulationTimer restart_timer;
+        seedRandom(false, 99);
+        LatticeModel lattice_model(restart_configuration, sitesmap, restart_timer,
+                                   lattice_map, restart_interactions, checkpoint_file);
+        CPPUNIT_ASSERT( lattice_model.hasRandomStream() );
+        lattice_model.run(n_steps, 1.0e10);
+        CPPUNIT_ASSERT( restart_configuration.types() == types[0] );
+        CPPUNIT_ASSERT_EQUAL( restart_timer.simulationTime(), times[0] );
+    }
+
+    std::remove(checkpoint_file.c_str());
+    // }}}
+}
+
+
 // -------------------------------------------------------------------------- //
 //
 void Test_LatticeModel::testTiming()
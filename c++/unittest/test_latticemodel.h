@@ -33,6 +33,9 @@ public:
     CPPUNIT_TEST( testRedistribute );
     CPPUNIT_TEST( testProcessRedistribute );
     CPPUNIT_TEST( testSingleStepWithRedistribution );
+    CPPUNIT_TEST( testRun );
+    CPPUNIT_TEST( testCheckpoint );
+    CPPUNIT_TEST( testRandomStream );
     CPPUNIT_TEST( testTiming );
     CPPUNIT_TEST_SUITE_END();
 
@@ -44,6 +47,9 @@ public:
     void testRedistribute();
     void testProcessRedistribute();
     void testSingleStepWithRedistribution();
+    void testRun();
+    void testCheckpoint();
+    void testRandomStream();
     void testTiming();
 
 };
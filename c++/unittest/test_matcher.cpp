@@ -21,6 +21,12 @@
 #include "random.h"
 #include "sitesmap.h"
 
+#include <stdexcept>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 
 //static const double epsilon__ = 1e-10;
 
@@ -2257,6 +2263,671 @@ public:
     // }}}
 };
 
+// -------------------------------------------------------------------------- //
+// Rate calculator depending on the local types and the global coordinate.
+template <class BaseRateCalc>
+class LocalRateCalc : public BaseRateCalc {
+public:
+    virtual ~LocalRateCalc() {}
+    virtual double backendRateCallback(const std::vector<double> geometry,
+                                       const int len,
+                                       const std::vector<std::string> & types_before,
+                                       const std::vector<std::string> & types_after,
+                                       const double rate_constant,
+                                       const int process_number,
+                                       const double global_x,
+                                       const double global_y,
+                                       const double global_z) const
+        {
+            double rate = rate_constant * (1.0 + global_x + 0.1*global_y);
+            for (int i = 0; i < len; ++i)
+            {
+                if (types_before[i] == "A")
+                {
+                    rate += 0.01 * (geometry[3*i] + 2.0);
+                }
+            }
+            return rate;
+        }
+};
+
+// -------------------------------------------------------------------------- //
+//
+void Test_Matcher::testUpdateRatesThreadSafe()
+{
+    // {{{
+    seedRandom(false, 8712);
+
+    // Setup a random configuration.
+    const std::vector<int> repetitions(3, 8);
+    const std::vector<bool> periodicity(3, true);
+
+    std::vector<std::vector<double> > coords;
+    std::vector<std::string> elements;
+
+    for (int i = 0; i < repetitions[0]; ++i)
+    {
+        for (int j = 0; j < repetitions[1]; ++j)
+        {
+            for (int k = 0; k < repetitions[2]; ++k)
+            {
+                std::vector<double> coord(3);
+                coord[0] = i;
+                coord[1] = j;
+                coord[2] = k;
+                coords.push_back(coord);
+                elements.push_back(randomDouble01() < 0.5 ? "A" : "B");
+            }
+        }
+    }
+
+    std::map<std::string, int> possible_types;
+    possible_types["*"] = 0;
+    possible_types["A"] = 1;
+    possible_types["B"] = 2;
+
+    Configuration config(coords, elements, possible_types);
+    const LatticeMap lattice_map(1, repetitions, periodicity);
+    config.initMatchLists(lattice_map, 2);
+
+    // A process with a cutoff of the next nearest neighbours.
+    const std::vector<std::vector<double> > process_coords(1, std::vector<double>(3, 0.0));
+    const Configuration config1(process_coords, std::vector<std::string>(1, "A"), possible_types);
+    const Configuration config2(process_coords, std::vector<std::string>(1, "B"), possible_types);
+    const std::vector<int> basis_sites(1, 0);
+    const std::vector<CustomRateProcess> processes(1, CustomRateProcess(config1, config2, 1.3,
+                                                                        basis_sites, 1.5));
+
+    // The same rates from the two calculators.
+    const LocalRateCalc<RateCalculator> rate_calculator;
+    const LocalRateCalc<ThreadSafeRateCalculator> ts_rate_calculator;
+    CPPUNIT_ASSERT( !rate_calculator.threadSafe() );
+    CPPUNIT_ASSERT( ts_rate_calculator.threadSafe() );
+
+    const Interactions interactions(processes, false, rate_calculator);
+    const Interactions ts_interactions(processes, false, ts_rate_calculator);
+
+    // A task for each site.
+    std::vector<RateTask> tasks(elements.size());
+    for (size_t i = 0; i < tasks.size(); ++i)
+    {
+        tasks[i].index   = i;
+        tasks[i].process = 0;
+        tasks[i].rate    = 0.0;
+    }
+
+    const Matcher m;
+    std::vector<double> rates(tasks.size(), 0.0);
+    m.updateRates(rates, tasks, interactions, config);
+
+    std::vector<double> ts_rates(tasks.size(), 0.0);
+    m.updateRates(ts_rates, tasks, ts_interactions, config);
+
+    for (size_t i = 0; i < tasks.size(); ++i)
+    {
+        CPPUNIT_ASSERT( rates[i] > 1.3 );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( rates[i], ts_rates[i], 1.0e-12 );
+    }
+
+    // }}}
+}
+
+
+// -------------------------------------------------------------------------- //
+// Rate calculator raising an error, as a failing Python rate plugin does.
+template <class BaseRateCalc>
+class ThrowingRateCalc : public BaseRateCalc {
+public:
+    virtual ~ThrowingRateCalc() {}
+    virtual double backendRateCallback(const std::vector<double> geometry,
+                                       const int len,
+                                       const std::vector<std::string> & types_before,
+                                       const std::vector<std::string> & types_after,
+                                       const double rate_constant,
+                                       const int process_number,
+                                       const double global_x,
+                                       const double global_y,
+                                       const double global_z) const
+        {
+            throw std::runtime_error("Error in the rate callback.");
+        }
+};
+
+// -------------------------------------------------------------------------- //
+//
+void Test_Matcher::testUpdateRatesThrowing()
+{
+    // {{{
+    // Setup a configuration.
+    const std::vector<int> repetitions(3, 4);
+    const std::vector<bool> periodicity(3, true);
+
+    std::vector<std::vector<double> > coords;
+    std::vector<std::string> elements;
+
+    for (int i = 0; i < repetitions[0]; ++i)
+    {
+        for (int j = 0; j < repetitions[1]; ++j)
+        {
+            for (int k = 0; k < repetitions[2]; ++k)
+            {
+                std::vector<double> coord(3);
+                coord[0] = i;
+                coord[1] = j;
+                coord[2] = k;
+                coords.push_back(coord);
+                elements.push_back("A");
+            }
+        }
+    }
+
+    std::map<std::string, int> possible_types;
+    possible_types["*"] = 0;
+    possible_types["A"] = 1;
+    possible_types["B"] = 2;
+
+    Configuration config(coords, elements, possible_types);
+    const LatticeMap lattice_map(1, repetitions, periodicity);
+    config.initMatchLists(lattice_map, 1);
+
+    const std::vector<std::vector<double> > process_coords(1, std::vector<double>(3, 0.0));
+    const Configuration config1(process_coords, std::vector<std::string>(1, "A"), possible_types);
+    const Configuration config2(process_coords, std::vector<std::string>(1, "B"), possible_types);
+    const std::vector<int> basis_sites(1, 0);
+    const std::vector<CustomRateProcess> processes(1, CustomRateProcess(config1, config2, 1.3,
+                                                                        basis_sites, 1.0));
+
+    const ThrowingRateCalc<RateCalculator> rate_calculator;
+    const ThrowingRateCalc<ThreadSafeRateCalculator> ts_rate_calculator;
+    CPPUNIT_ASSERT( !rate_calculator.threadSafe() );
+    CPPUNIT_ASSERT( ts_rate_calculator.threadSafe() );
+
+    const Interactions interactions(processes, false, rate_calculator);
+    const Interactions ts_interactions(processes, false, ts_rate_calculator);
+
+    // A task for each site.
+    std::vector<RateTask> tasks(elements.size());
+    for (size_t i = 0; i < tasks.size(); ++i)
+    {
+        tasks[i].index   = i;
+        tasks[i].process = 0;
+        tasks[i].rate    = 0.0;
+    }
+
+    // The error reaches the caller from the serial and the threaded loops.
+    const Matcher m;
+    std::vector<double> rates(tasks.size(), 0.0);
+    CPPUNIT_ASSERT_THROW( m.updateRates(rates, tasks, interactions, config),
+                          std::runtime_error );
+    CPPUNIT_ASSERT_THROW( m.updateRates(rates, tasks, ts_interactions, config),
+                          std::runtime_error );
+
+    // Also for a single task.
+    tasks.resize(1);
+    rates.resize(1);
+    CPPUNIT_ASSERT_THROW( m.updateRates(rates, tasks, interactions, config),
+                          std::runtime_error );
+
+    // }}}
+}
+
+
+// -------------------------------------------------------------------------- //
+// Rate calculator depending only on the local types, counting the calls.
+class PureLocalRateCalc : public RateCalculator {
+public:
+    PureLocalRateCalc() : n_calls(0) {}
+    virtual ~PureLocalRateCalc() {}
+    virtual bool pureLocalRates() const { return true; }
+    virtual double backendRateCallback(const std::vector<double> geometry,
+                                       const int len,
+                                       const std::vector<std::string> & types_before,
+                                       const std::vector<std::string> & types_after,
+                                       const double rate_constant,
+                                       const int process_number,
+                                       const double global_x,
+                                       const double global_y,
+                                       const double global_z) const
+        {
+            ++n_calls;
+            double rate = rate_constant;
+            for (int i = 0; i < len; ++i)
+            {
+                if (types_before[i] == "A")
+                {
+                    rate += 0.01 * (geometry[3*i] + 2.0);
+                }
+            }
+            return rate;
+        }
+    mutable int n_calls;
+};
+
+// -------------------------------------------------------------------------- //
+//
+void Test_Matcher::testUpdateRatesCached()
+{
+    // {{{
+    seedRandom(false, 3391);
+
+    // Setup a random configuration.
+    const std::vector<int> repetitions(3, 6);
+    const std::vector<bool> periodicity(3, true);
+
+    std::vector<std::vector<double> > coords;
+    std::vector<std::string> elements;
+
+    for (int i = 0; i < repetitions[0]; ++i)
+    {
+        for (int j = 0; j < repetitions[1]; ++j)
+        {
+            for (int k = 0; k < repetitions[2]; ++k)
+            {
+                std::vector<double> coord(3);
+                coord[0] = i;
+                coord[1] = j;
+                coord[2] = k;
+                coords.push_back(coord);
+                elements.push_back(randomDouble01() < 0.5 ? "A" : "B");
+            }
+        }
+    }
+
+    std::map<std::string, int> possible_types;
+    possible_types["*"] = 0;
+    possible_types["A"] = 1;
+    possible_types["B"] = 2;
+
+    Configuration config(coords, elements, possible_types);
+    const LatticeMap lattice_map(1, repetitions, periodicity);
+    config.initMatchLists(lattice_map, 2);
+
+    // A process with a cutoff of the nearest neighbours.
+    const std::vector<std::vector<double> > process_coords(1, std::vector<double>(3, 0.0));
+    const Configuration config1(process_coords, std::vector<std::string>(1, "A"), possible_types);
+    const Configuration config2(process_coords, std::vector<std::string>(1, "B"), possible_types);
+    const std::vector<int> basis_sites(1, 0);
+    const std::vector<CustomRateProcess> processes(1, CustomRateProcess(config1, config2, 1.3,
+                                                                        basis_sites, 1.0));
+
+    // The cache can only be used with pure local rates.
+    const LocalRateCalc<RateCalculator> local_rate_calculator;
+    Interactions local_interactions(processes, false, local_rate_calculator);
+    CPPUNIT_ASSERT_THROW( local_interactions.setRateCacheCapacity(10), std::invalid_argument );
+    local_interactions.setRateCacheCapacity(0);
+
+    const PureLocalRateCalc rate_calculator;
+    Interactions interactions(processes, false, rate_calculator);
+    interactions.setRateCacheCapacity(1000);
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(interactions.rateCache().capacity()), 1000 );
+
+    // A task for each site.
+    std::vector<RateTask> tasks(elements.size());
+    for (size_t i = 0; i < tasks.size(); ++i)
+    {
+        tasks[i].index   = i;
+        tasks[i].process = 0;
+        tasks[i].rate    = 0.0;
+    }
+
+    const Matcher m;
+    std::vector<double> rates(tasks.size(), 0.0);
+    m.updateRates(rates, tasks, interactions, config);
+    const int n_calls = rate_calculator.n_calls;
+    CPPUNIT_ASSERT_EQUAL( n_calls, static_cast<int>(tasks.size()) );
+
+    // With the cache, each of the at most 2^7 environments is calculated once.
+    std::vector<double> cached_rates(tasks.size(), 0.0);
+    m.updateRates(cached_rates, tasks, interactions, config, &interactions.rateCache());
+    CPPUNIT_ASSERT( rate_calculator.n_calls - n_calls <= 128 );
+    CPPUNIT_ASSERT_EQUAL( rate_calculator.n_calls - n_calls,
+                          static_cast<int>(interactions.rateCache().size()) );
+
+    for (size_t i = 0; i < tasks.size(); ++i)
+    {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( rates[i], cached_rates[i], 1.0e-12 );
+    }
+
+    // All found the second time.
+    const unsigned long misses = interactions.rateCache().misses();
+    m.updateRates(cached_rates, tasks, interactions, config, &interactions.rateCache());
+    CPPUNIT_ASSERT_EQUAL( interactions.rateCache().misses(), misses );
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(interactions.rateCache().hits()),
+                          static_cast<int>(2*tasks.size()) - static_cast<int>(misses) );
+
+    for (size_t i = 0; i < tasks.size(); ++i)
+    {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( rates[i], cached_rates[i], 1.0e-12 );
+    }
+
+    // The cache is also used on a slab, non-periodic in the c direction.
+    std::vector<int> slab_repetitions(repetitions);
+    slab_repetitions[2] = 1;
+    std::vector<bool> slab_periodicity(periodicity);
+    slab_periodicity[2] = false;
+
+    std::vector<std::vector<double> > slab_coords;
+    std::vector<std::string> slab_elements;
+    for (size_t i = 0; i < coords.size(); ++i)
+    {
+        if (coords[i][2] == 0.0)
+        {
+            slab_coords.push_back(coords[i]);
+            slab_elements.push_back(elements[i]);
+        }
+    }
+
+    Configuration slab_config(slab_coords, slab_elements, possible_types);
+    const LatticeMap slab_lattice_map(1, slab_repetitions, slab_periodicity);
+    slab_config.initMatchLists(slab_lattice_map, 2);
+
+    std::vector<RateTask> slab_tasks(tasks.begin(), tasks.begin() + slab_elements.size());
+    std::vector<double> slab_rates(slab_tasks.size(), 0.0);
+    m.updateRates(slab_rates, slab_tasks, interactions, slab_config);
+
+    Interactions slab_interactions(processes, false, rate_calculator);
+    slab_interactions.setRateCacheCapacity(1000);
+
+    // Each of the at most 2^5 environments is calculated once.
+    const int slab_n_calls = rate_calculator.n_calls;
+    std::vector<double> slab_cached_rates(slab_tasks.size(), 0.0);
+    m.updateRates(slab_cached_rates, slab_tasks, slab_interactions, slab_config,
+                  &slab_interactions.rateCache());
+    CPPUNIT_ASSERT( rate_calculator.n_calls - slab_n_calls <= 32 );
+    CPPUNIT_ASSERT_EQUAL( rate_calculator.n_calls - slab_n_calls,
+                          static_cast<int>(slab_interactions.rateCache().size()) );
+
+    for (size_t i = 0; i < slab_tasks.size(); ++i)
+    {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( slab_rates[i], slab_cached_rates[i], 1.0e-12 );
+    }
+
+    // }}}
+}
+
+
+// -------------------------------------------------------------------------- //
+// Rate calculator depending on the types before and after, with strings.
+class StringTypesRateCalc : public RateCalculator {
+public:
+    virtual ~StringTypesRateCalc() {}
+    virtual double backendRateCallback(const std::vector<double> geometry,
+                                       const int len,
+                                       const std::vector<std::string> & types_before,
+                                       const std::vector<std::string> & types_after,
+                                       const double rate_constant,
+                                       const int process_number,
+                                       const double global_x,
+                                       const double global_y,
+                                       const double global_z) const
+        {
+            double rate = rate_constant * (1.0 + global_x + 0.1*global_y);
+            for (int i = 0; i < len; ++i)
+            {
+                if (types_before[i] == "A")
+                {
+                    rate += 0.01 * (geometry[3*i] + 2.0);
+                }
+                if (types_after[i] == "B")
+                {
+                    rate += 0.001 * (i + 1);
+                }
+            }
+            return rate;
+        }
+};
+
+// -------------------------------------------------------------------------- //
+// The same rate calculator with integer types.
+class IntegerTypesRateCalc : public ThreadSafeRateCalculator {
+public:
+    IntegerTypesRateCalc() : ThreadSafeRateCalculator(true) {}
+    virtual ~IntegerTypesRateCalc() {}
+    virtual double backendIntegerRateCallback(const KMCRatePluginEnvironment & env) const
+        {
+            double rate = env.rate_constant * (1.0 + env.global_x + 0.1*env.global_y);
+            for (int i = 0; i < env.len; ++i)
+            {
+                const int type_before = env.types[env.indices[i]];
+                const int update_type = i < env.n_update ? env.update_types[i] : 0;
+                const int type_after  = update_type > 0 ? update_type : type_before;
+
+                if (type_before == 1)
+                {
+                    rate += 0.01 * (env.coordinates[3*i] + 2.0);
+                }
+                if (type_after == 2)
+                {
+                    rate += 0.001 * (i + 1);
+                }
+            }
+            return rate;
+        }
+};
+
+// -------------------------------------------------------------------------- //
+//
+void Test_Matcher::testUpdateRatesIntegerTypes()
+{
+    // {{{
+    seedRandom(false, 5519);
+
+    // Setup a random configuration.
+    const std::vector<int> repetitions(3, 5);
+    const std::vector<bool> periodicity(3, true);
+
+    std::vector<std::vector<double> > coords;
+    std::vector<std::string> elements;
+
+    for (int i = 0; i < repetitions[0]; ++i)
+    {
+        for (int j = 0; j < repetitions[1]; ++j)
+        {
+            for (int k = 0; k < repetitions[2]; ++k)
+            {
+                std::vector<double> coord(3);
+                coord[0] = i;
+                coord[1] = j;
+                coord[2] = k;
+                coords.push_back(coord);
+                elements.push_back(randomDouble01() < 0.5 ? "A" : "B");
+            }
+        }
+    }
+
+    std::map<std::string, int> possible_types;
+    possible_types["*"] = 0;
+    possible_types["A"] = 1;
+    possible_types["B"] = 2;
+
+    Configuration config(coords, elements, possible_types);
+    const LatticeMap lattice_map(1, repetitions, periodicity);
+    config.initMatchLists(lattice_map, 2);
+
+    // A process changing the central site, with a cutoff of the next
+    // nearest neighbours.
+    const std::vector<std::vector<double> > process_coords(1, std::vector<double>(3, 0.0));
+    const Configuration config1(process_coords, std::vector<std::string>(1, "A"), possible_types);
+    const Configuration config2(process_coords, std::vector<std::string>(1, "B"), possible_types);
+    const std::vector<int> basis_sites(1, 0);
+    const std::vector<CustomRateProcess> processes(1, CustomRateProcess(config1, config2, 1.3,
+                                                                        basis_sites, 1.5));
+
+    const StringTypesRateCalc string_rate_calculator;
+    const IntegerTypesRateCalc integer_rate_calculator;
+    CPPUNIT_ASSERT( !string_rate_calculator.integerTypes() );
+    CPPUNIT_ASSERT( integer_rate_calculator.integerTypes() );
+
+    const Interactions string_interactions(processes, false, string_rate_calculator);
+    const Interactions integer_interactions(processes, false, integer_rate_calculator);
+
+    // A task for each site.
+    std::vector<RateTask> tasks(elements.size());
+    for (size_t i = 0; i < tasks.size(); ++i)
+    {
+        tasks[i].index   = i;
+        tasks[i].process = 0;
+        tasks[i].rate    = 0.0;
+    }
+
+    const Matcher m;
+    std::vector<double> string_rates(tasks.size(), 0.0);
+    m.updateRates(string_rates, tasks, string_interactions, config);
+
+    std::vector<double> integer_rates(tasks.size(), 0.0);
+    m.updateRates(integer_rates, tasks, integer_interactions, config);
+
+    for (size_t i = 0; i < tasks.size(); ++i)
+    {
+        CPPUNIT_ASSERT( string_rates[i] > 1.3 );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( string_rates[i], integer_rates[i], 1.0e-12 );
+
+        // The same from the single rate.
+        const double rate = m.updateSingleRate(i, *integer_interactions.processes()[0],
+                                               config, integer_rate_calculator);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( rate, integer_rates[i], 1.0e-12 );
+    }
+
+    // }}}
+}
+
+
+// -------------------------------------------------------------------------- //
+// The same rate calculator with the batch callback.
+class BatchTypesRateCalc : public RateCalculator {
+public:
+    BatchTypesRateCalc() : n_calls(0), wrong_size(false) {}
+    virtual ~BatchTypesRateCalc() {}
+    virtual bool batchCallback() const { return true; }
+    virtual std::vector<double> backendBatchRateCallback(const std::vector<double> & geometry,
+                                                         const std::vector<int> & lengths,
+                                                         const std::vector<int> & types_before,
+                                                         const std::vector<int> & types_after,
+                                                         const std::vector<double> & rate_constants,
+                                                         const std::vector<int> & process_numbers,
+                                                         const std::vector<double> & global_coordinates) const
+        {
+            ++n_calls;
+            std::vector<double> rates(lengths.size() + (wrong_size ? 1 : 0), 0.0);
+            int offset = 0;
+            for (size_t j = 0; j < lengths.size(); ++j)
+            {
+                double rate = rate_constants[j] * (1.0 + global_coordinates[3*j] +
+                                                   0.1*global_coordinates[3*j+1]);
+                for (int i = 0; i < lengths[j]; ++i)
+                {
+                    if (types_before[offset + i] == 1)
+                    {
+                        rate += 0.01 * (geometry[3*(offset + i)] + 2.0);
+                    }
+                    if (types_after[offset + i] == 2)
+                    {
+                        rate += 0.001 * (i + 1);
+                    }
+                }
+                offset += lengths[j];
+                rates[j] = rate;
+            }
+            return rates;
+        }
+    mutable int n_calls;
+    bool wrong_size;
+};
+
+// -------------------------------------------------------------------------- //
+//
+void Test_Matcher::testUpdateRatesBatch()
+{
+    // {{{
+    seedRandom(false, 7741);
+
+    // Setup a random configuration.
+    const std::vector<int> repetitions(3, 5);
+    const std::vector<bool> periodicity(3, true);
+
+    std::vector<std::vector<double> > coords;
+    std::vector<std::string> elements;
+
+    for (int i = 0; i < repetitions[0]; ++i)
+    {
+        for (int j = 0; j < repetitions[1]; ++j)
+        {
+            for (int k = 0; k < repetitions[2]; ++k)
+            {
+                std::vector<double> coord(3);
+                coord[0] = i;
+                coord[1] = j;
+                coord[2] = k;
+                coords.push_back(coord);
+                elements.push_back(randomDouble01() < 0.5 ? "A" : "B");
+            }
+        }
+    }
+
+    std::map<std::string, int> possible_types;
+    possible_types["*"] = 0;
+    possible_types["A"] = 1;
+    possible_types["B"] = 2;
+
+    Configuration config(coords, elements, possible_types);
+    const LatticeMap lattice_map(1, repetitions, periodicity);
+    config.initMatchLists(lattice_map, 2);
+
+    // A process changing the central site, with a cutoff of the next
+    // nearest neighbours.
+    const std::vector<std::vector<double> > process_coords(1, std::vector<double>(3, 0.0));
+    const Configuration config1(process_coords, std::vector<std::string>(1, "A"), possible_types);
+    const Configuration config2(process_coords, std::vector<std::string>(1, "B"), possible_types);
+    const std::vector<int> basis_sites(1, 0);
+    const std::vector<CustomRateProcess> processes(1, CustomRateProcess(config1, config2, 1.3,
+                                                                        basis_sites, 1.5));
+
+    const StringTypesRateCalc string_rate_calculator;
+    BatchTypesRateCalc batch_rate_calculator;
+    CPPUNIT_ASSERT( !string_rate_calculator.batchCallback() );
+    CPPUNIT_ASSERT( batch_rate_calculator.batchCallback() );
+
+    const Interactions string_interactions(processes, false, string_rate_calculator);
+    const Interactions batch_interactions(processes, false, batch_rate_calculator);
+
+    // A task for each site.
+    std::vector<RateTask> tasks(elements.size());
+    for (size_t i = 0; i < tasks.size(); ++i)
+    {
+        tasks[i].index   = i;
+        tasks[i].process = 0;
+        tasks[i].rate    = 0.0;
+    }
+
+    const Matcher m;
+    std::vector<double> string_rates(tasks.size(), 0.0);
+    m.updateRates(string_rates, tasks, string_interactions, config);
+
+    // All rates from one call.
+    std::vector<double> batch_rates(tasks.size(), 0.0);
+    m.updateRates(batch_rates, tasks, batch_interactions, config);
+    CPPUNIT_ASSERT_EQUAL( batch_rate_calculator.n_calls, 1 );
+
+    for (size_t i = 0; i < tasks.size(); ++i)
+    {
+        CPPUNIT_ASSERT( string_rates[i] > 1.3 );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( string_rates[i], batch_rates[i], 1.0e-12 );
+    }
+
+    // No call without tasks.
+    std::vector<double> no_rates;
+    m.updateRates(no_rates, std::vector<RateTask>(), batch_interactions, config);
+    CPPUNIT_ASSERT_EQUAL( batch_rate_calculator.n_calls, 1 );
+
+    // One rate must be returned for each task.
+    batch_rate_calculator.wrong_size = true;
+    CPPUNIT_ASSERT_THROW( m.updateRates(batch_rates, tasks, batch_interactions, config),
+                          std::runtime_error );
+
+    // }}}
+}
+
+
 // -------------------------------------------------------------------------- //
 //
 void Test_Matcher::testUpdateSingleRate()
@@ -2538,3 +3209,309 @@ void Test_Matcher::testClassifyConfiguration()
     // }}}
 }
 
+
+// -------------------------------------------------------------------------- //
+//
+void Test_Matcher::testMatchingThreadCount()
+{
+    // {{{
+    seedRandom(false, 4711);
+
+    // Setup a random two element configuration, large enough for the
+    // matching to run over the threads.
+    std::vector<int> repetitions(3, 12);
+    repetitions[2] = 6;
+    const std::vector<bool> periodicity(3, true);
+
+    std::vector<std::vector<double> > coords;
+    std::vector<std::string> elements;
+    std::vector<std::string> site_types;
+
+    for (int i = 0; i < repetitions[0]; ++i)
+    {
+        for (int j = 0; j < repetitions[1]; ++j)
+        {
+            for (int k = 0; k < repetitions[2]; ++k)
+            {
+                std::vector<double> coord(3);
+                coord[0] = i;
+                coord[1] = j;
+                coord[2] = k;
+                coords.push_back(coord);
+                elements.push_back(randomDouble01() < 0.5 ? "A" : "B");
+                site_types.push_back("M");
+            }
+        }
+    }
+
+    std::map<std::string, int> possible_types;
+    possible_types["*"] = 0;
+    possible_types["A"] = 1;
+    possible_types["B"] = 2;
+
+    std::map<std::string, int> possible_site_types;
+    possible_site_types["*"] = 0;
+    possible_site_types["M"] = 1;
+
+    Configuration config(coords, elements, possible_types);
+    SitesMap sitesmap(coords, site_types, possible_site_types);
+    const LatticeMap lattice_map(1, repetitions, periodicity);
+
+    // An A with a B neighbour in each direction, and the flips.
+    std::vector<Process> processes;
+    const std::vector<int> basis_sites(1, 0);
+
+    for (int direction = 0; direction < 3; ++direction)
+    {
+        std::vector<std::vector<double> > process_coords(2, std::vector<double>(3, 0.0));
+        process_coords[1][direction] = 1.0;
+
+        std::vector<std::string> elements1(2, "A");
+        elements1[1] = "B";
+        std::vector<std::string> elements2(2, "B");
+        elements2[1] = "A";
+
+        const Configuration config1(process_coords, elements1, possible_types);
+        const Configuration config2(process_coords, elements2, possible_types);
+        processes.push_back(Process(config1, config2, 1.0, basis_sites));
+    }
+
+    {
+        const std::vector<std::vector<double> > process_coords(1, std::vector<double>(3, 0.0));
+        const Configuration config1(process_coords, std::vector<std::string>(1, "A"), possible_types);
+        const Configuration config2(process_coords, std::vector<std::string>(1, "B"), possible_types);
+        processes.push_back(Process(config1, config2, 1.0, basis_sites));
+        processes.push_back(Process(config2, config1, 1.0, basis_sites));
+    }
+
+    Interactions interactions(processes, true);
+    config.initMatchLists(lattice_map, interactions.maxRange());
+    sitesmap.initMatchLists(lattice_map, interactions.maxRange());
+    interactions.updateProcessMatchLists(config, lattice_map);
+    interactions.compileProcessMatchLists(config, lattice_map);
+
+    std::vector<int> indices(elements.size());
+    for (size_t i = 0; i < indices.size(); ++i)
+    {
+        indices[i] = i;
+    }
+
+    const Matcher m;
+
+    // Get the pairs and tasks with one thread.
+#ifdef _OPENMP
+    const int max_threads = omp_get_max_threads();
+    omp_set_num_threads(1);
+#endif
+
+    const std::vector<std::pair<int, int> > ref_pairs = \
+        m.indexProcessToMatch(interactions.processes(),
+                              interactions.basisSiteProcesses(),
+                              config, sitesmap, lattice_map, indices);
+
+    std::vector<RemoveTask> ref_remove_tasks;
+    std::vector<RateTask>   ref_update_tasks;
+    std::vector<RateTask>   ref_add_tasks;
+    m.matchIndicesWithProcesses(ref_pairs, interactions, config,
+                                ref_remove_tasks, ref_update_tasks, ref_add_tasks);
+
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(ref_pairs.size()),
+                          static_cast<int>(indices.size() * processes.size()) );
+    CPPUNIT_ASSERT( !ref_add_tasks.empty() );
+
+    // The same pairs and tasks in the same order with more threads.
+#ifdef _OPENMP
+    omp_set_num_threads(4);
+#endif
+
+    const std::vector<std::pair<int, int> > pairs = \
+        m.indexProcessToMatch(interactions.processes(),
+                              interactions.basisSiteProcesses(),
+                              config, sitesmap, lattice_map, indices);
+
+    std::vector<RemoveTask> remove_tasks;
+    std::vector<RateTask>   update_tasks;
+    std::vector<RateTask>   add_tasks;
+    m.matchIndicesWithProcesses(pairs, interactions, config,
+                                remove_tasks, update_tasks, add_tasks);
+
+#ifdef _OPENMP
+    omp_set_num_threads(max_threads);
+#endif
+
+    CPPUNIT_ASSERT( pairs == ref_pairs );
+    CPPUNIT_ASSERT( remove_tasks.empty() );
+    CPPUNIT_ASSERT( update_tasks.empty() );
+    CPPUNIT_ASSERT_EQUAL( ref_add_tasks.size(), add_tasks.size() );
+
+    for (size_t i = 0; i < add_tasks.size(); ++i)
+    {
+        CPPUNIT_ASSERT_EQUAL( ref_add_tasks[i].index,   add_tasks[i].index );
+        CPPUNIT_ASSERT_EQUAL( ref_add_tasks[i].process, add_tasks[i].process );
+        CPPUNIT_ASSERT_EQUAL( ref_add_tasks[i].rate,    add_tasks[i].rate );
+    }
+
+    // }}}
+}
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_Matcher::testMatchingTrie()
+{
+    // {{{
+    seedRandom(false, 2718);
+
+    // Setup a random two element configuration, non-periodic in the c
+    // direction.
+    std::vector<int> repetitions(3, 8);
+    repetitions[2] = 4;
+    std::vector<bool> periodicity(3, true);
+    periodicity[2] = false;
+
+    std::vector<std::vector<double> > coords;
+    std::vector<std::string> elements;
+    std::vector<std::string> site_types;
+
+    for (int i = 0; i < repetitions[0]; ++i)
+    {
+        for (int j = 0; j < repetitions[1]; ++j)
+        {
+            for (int k = 0; k < repetitions[2]; ++k)
+            {
+                std::vector<double> coord(3);
+                coord[0] = i;
+                coord[1] = j;
+                coord[2] = k;
+                coords.push_back(coord);
+                elements.push_back(randomDouble01() < 0.5 ? "A" : "B");
+                site_types.push_back(k == 0 ? "S" : "M");
+            }
+        }
+    }
+
+    std::map<std::string, int> possible_types;
+    possible_types["*"] = 0;
+    possible_types["A"] = 1;
+    possible_types["B"] = 2;
+
+    std::map<std::string, int> possible_site_types;
+    possible_site_types["*"] = 0;
+    possible_site_types["M"] = 1;
+    possible_site_types["S"] = 2;
+
+    Configuration ref_config(coords, elements, possible_types);
+    Configuration config(coords, elements, possible_types);
+    SitesMap sitesmap(coords, site_types, possible_site_types);
+    const LatticeMap lattice_map(1, repetitions, periodicity);
+
+    // An A with a B neighbour in each direction, and the flips. The flips
+    // from B to A only take place at the surface sites.
+    std::vector<Process> processes;
+    const std::vector<int> basis_sites(1, 0);
+
+    for (int direction = 0; direction < 3; ++direction)
+    {
+        std::vector<std::vector<double> > process_coords(2, std::vector<double>(3, 0.0));
+        process_coords[1][direction] = 1.0;
+
+        std::vector<std::string> elements1(2, "A");
+        elements1[1] = "B";
+        std::vector<std::string> elements2(2, "B");
+        elements2[1] = "A";
+
+        const Configuration config1(process_coords, elements1, possible_types);
+        const Configuration config2(process_coords, elements2, possible_types);
+        processes.push_back(Process(config1, config2, 1.0, basis_sites));
+    }
+
+    {
+        const std::vector<std::vector<double> > process_coords(1, std::vector<double>(3, 0.0));
+        const Configuration config1(process_coords, std::vector<std::string>(1, "A"), possible_types);
+        const Configuration config2(process_coords, std::vector<std::string>(1, "B"), possible_types);
+        processes.push_back(Process(config1, config2, 1.0, basis_sites));
+        processes.push_back(Process(config2, config1, 1.0, basis_sites,
+                                    std::vector<int>(), std::vector<Coordinate>(), -1,
+                                    std::vector<int>(1, 2)));
+    }
+
+    Interactions ref_interactions(processes, true);
+    Interactions interactions(processes, true);
+
+    ref_config.initMatchLists(lattice_map, interactions.maxRange());
+    config.initMatchLists(lattice_map, interactions.maxRange());
+    sitesmap.initMatchLists(lattice_map, interactions.maxRange());
+
+    ref_interactions.updateProcessMatchLists(ref_config, lattice_map);
+    ref_interactions.compileProcessMatchLists(ref_config, lattice_map);
+    interactions.updateProcessMatchLists(config, lattice_map);
+    interactions.compileProcessMatchLists(config, lattice_map);
+    interactions.setUseMatchTrie(true);
+
+    std::vector<int> indices(elements.size());
+    for (size_t i = 0; i < indices.size(); ++i)
+    {
+        indices[i] = i;
+    }
+
+    const Matcher m;
+
+    // Far fewer pairs than for all processes at all sites.
+    const std::vector<std::pair<int, int> > ref_pairs = \
+        m.indexProcessToMatch(ref_interactions.processes(),
+                              ref_interactions.basisSiteProcesses(),
+                              ref_config, sitesmap, lattice_map, indices);
+    const std::vector<std::pair<int, int> > pairs = \
+        m.trieIndexProcessToMatch(interactions, config, sitesmap, lattice_map, indices);
+
+    CPPUNIT_ASSERT( !pairs.empty() );
+    CPPUNIT_ASSERT( 2*pairs.size() < ref_pairs.size() );
+
+    m.calculateMatching(ref_interactions, ref_config, sitesmap, lattice_map, indices);
+    m.calculateMatching(interactions, config, sitesmap, lattice_map, indices);
+
+    // Flip random sites and re-match the sites around them, with the same
+    // sites listed for each process after each step.
+    for (int step = 0; step < 100; ++step)
+    {
+        const int n_processes = processes.size();
+
+        for (int p = 0; p < n_processes; ++p)
+        {
+            CPPUNIT_ASSERT( ref_interactions.processes()[p]->sites() ==
+                            interactions.processes()[p]->sites() );
+        }
+
+        for (size_t index = 0; index < indices.size(); ++index)
+        {
+            std::vector<int> listing = interactions.siteProcesses(index);
+            std::sort(listing.begin(), listing.end());
+
+            std::vector<int> ref_listing;
+            for (int p = 0; p < n_processes; ++p)
+            {
+                if (interactions.processes()[p]->isListed(index))
+                {
+                    ref_listing.push_back(p);
+                }
+            }
+
+            CPPUNIT_ASSERT( listing == ref_listing );
+        }
+
+        const int index = static_cast<int>(randomDouble01() * indices.size());
+        const int flip = config.types()[index] == 1 ? 3 : 4;
+
+        ref_config.performProcess(*ref_interactions.processes()[flip], index);
+        config.performProcess(*interactions.processes()[flip], index);
+
+        const std::vector<int> neighbours = \
+            lattice_map.supersetNeighbourIndices(std::vector<int>(1, index),
+                                                 interactions.maxRange());
+
+        m.calculateMatching(ref_interactions, ref_config, sitesmap, lattice_map, neighbours);
+        m.calculateMatching(interactions, config, sitesmap, lattice_map, neighbours);
+    }
+
+    // }}}
+}
@@ -38,8 +38,15 @@ public:
     CPPUNIT_TEST( testCalculateMatchingInteractionsWithSiteTypes2 );
     CPPUNIT_TEST( testCalculateMatchingInteractionsWithSiteTypes2D );
     CPPUNIT_TEST( testUpdateRates );
+    CPPUNIT_TEST( testUpdateRatesThreadSafe );
+    CPPUNIT_TEST( testUpdateRatesThrowing );
+    CPPUNIT_TEST( testUpdateRatesCached );
+    CPPUNIT_TEST( testUpdateRatesIntegerTypes );
+    CPPUNIT_TEST( testUpdateRatesBatch );
     CPPUNIT_TEST( testUpdateSingleRate );
     CPPUNIT_TEST( testClassifyConfiguration );
+    CPPUNIT_TEST( testMatchingThreadCount );
+    CPPUNIT_TEST( testMatchingTrie );
     CPPUNIT_TEST_SUITE_END();
 
     void testConstruction();
@@ -55,8 +62,15 @@ public:
     void testCalculateMatchingInteractionsWithSiteTypes2();
     void testCalculateMatchingInteractionsWithSiteTypes2D();
     void testUpdateRates();
+    void testUpdateRatesThreadSafe();
+    void testUpdateRatesThrowing();
+    void testUpdateRatesCached();
+    void testUpdateRatesIntegerTypes();
+    void testUpdateRatesBatch();
     void testUpdateSingleRate();
     void testClassifyConfiguration();
+    void testMatchingThreadCount();
+    void testMatchingTrie();
 
 };
 
@@ -350,3 +350,64 @@ void Test_MatchList::test_WhateverMatchProcessSite()
     // }}}
 }
 
+
+// -------------------------------------------------------------------------- //
+//
+void Test_MatchList::testMatchListArrays()
+{
+    // {{{
+
+    // Setup a configuration match list.
+    ConfigMatchList config_match_list(3);
+
+    config_match_list[0].match_type = 2;
+    config_match_list[0].index      = 17;
+    config_match_list[0].distance   = 0.0;
+    config_match_list[0].coordinate = Coordinate(0.0, 0.0, 0.0);
+
+    config_match_list[1].match_type = 1;
+    config_match_list[1].index      = 4;
+    config_match_list[1].distance   = 1.0;
+    config_match_list[1].coordinate = Coordinate(1.0, 0.0, 0.0);
+
+    config_match_list[2].match_type = 3;
+    config_match_list[2].index      = 9;
+    config_match_list[2].distance   = 1.5;
+    config_match_list[2].coordinate = Coordinate(0.5, -1.0, 0.5);
+
+    // Store it as arrays.
+    MatchListArrays arrays;
+    CPPUNIT_ASSERT( arrays.empty() );
+    arrays.assign(config_match_list);
+
+    CPPUNIT_ASSERT( !arrays.empty() );
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(arrays.size()), 3 );
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(arrays.match_types.size()), 3 );
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(arrays.distances.size()), 3 );
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(arrays.coordinates.size()), 9 );
+
+    CPPUNIT_ASSERT_EQUAL( arrays.match_types[2], 3 );
+    CPPUNIT_ASSERT_EQUAL( arrays.indices[1], 4 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( arrays.distances[2], 1.5, 1.0e-12 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( arrays.coordinates[6], 0.5, 1.0e-12 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( arrays.coordinates[7], -1.0, 1.0e-12 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( arrays.coordinates[8], 0.5, 1.0e-12 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( arrays.coordinate(1).x(), 1.0, 1.0e-12 );
+
+    // Construct a sites match list from the arrays.
+    SiteMatchList site_match_list;
+    arrays.toList(site_match_list);
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(site_match_list.size()), 3 );
+
+    for (size_t i = 0; i < config_match_list.size(); ++i)
+    {
+        CPPUNIT_ASSERT_EQUAL( site_match_list[i].match_type,
+                              config_match_list[i].match_type );
+        CPPUNIT_ASSERT_EQUAL( site_match_list[i].index,
+                              config_match_list[i].index );
+        CPPUNIT_ASSERT( site_match_list[i].samePoint(config_match_list[i]) );
+    }
+
+    // }}}
+}
+
@@ -26,12 +26,14 @@ public:
     CPPUNIT_TEST( test_ConfigurationsToMatchList );
     CPPUNIT_TEST( test_WhateverMatchProcessConfig );
     CPPUNIT_TEST( test_WhateverMatchProcessSite );
+    CPPUNIT_TEST( testMatchListArrays );
     CPPUNIT_TEST_SUITE_END();
 
     void testCall();
     void test_ConfigurationsToMatchList();
     void test_WhateverMatchProcessConfig();
     void test_WhateverMatchProcessSite(); 
+    void testMatchListArrays();
 
 };
 
@@ -0,0 +1,194 @@
+/*
+  This file is part of the KMCLib project distributed under the terms of the
+  GNU General Public License version 3, see <http://www.gnu.org/licenses/>.
+*/
+
+
+// Include the test definition.
+#include "test_matchtrie.h"
+
+// Include the files to test.
+#include "matchtrie.h"
+
+#include <algorithm>
+
+#include "random.h"
+
+
+// -------------------------------------------------------------------------- //
+//
+static CompiledMatchList compiledList(const int n, const int * slots, const int * types)
+{
+    CompiledMatchList compiled_list(n);
+    for (int i = 0; i < n; ++i)
+    {
+        compiled_list[i].slot = slots[i];
+        compiled_list[i].match_type = types[i];
+    }
+    return compiled_list;
+}
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_MatchTrie::testConstruction()
+{
+    // {{{
+    // An empty trie has only the root and matches nothing.
+    const MatchTrie trie;
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(trie.nNodes()), 1 );
+
+    std::vector<int> process_indices(3, 1);
+    std::vector<int> stack;
+    trie.match(std::vector<int>(2, 0), std::vector<int>(1, 1), process_indices, stack);
+    CPPUNIT_ASSERT( process_indices.empty() );
+    // }}}
+}
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_MatchTrie::testInsertAndMatch()
+{
+    // {{{
+    MatchTrie trie;
+
+    // Three processes sharing the first entry, two of them sharing the
+    // first two entries.
+    const int slots0[3] = {0, 1, 3};
+    const int types0[3] = {1, 2, 2};
+    trie.insert(compiledList(3, slots0, types0), 0);
+
+    const int slots1[3] = {0, 1, 2};
+    const int types1[3] = {1, 2, 1};
+    trie.insert(compiledList(3, slots1, types1), 1);
+
+    const int slots2[2] = {0, 2};
+    const int types2[2] = {1, 1};
+    trie.insert(compiledList(2, slots2, types2), 2);
+
+    // A process with only wildcards matches everywhere.
+    trie.insert(CompiledMatchList(), 3);
+
+    // Root, (0,1), (1,2), (3,2), (2,1), (2,1).
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(trie.nNodes()), 6 );
+
+    // The types at the match list positions.
+    std::vector<int> indices(4);
+    indices[0] = 7;
+    indices[1] = 2;
+    indices[2] = 5;
+    indices[3] = 0;
+
+    std::vector<int> types(8, 0);
+    types[7] = 1;
+    types[2] = 2;
+    types[5] = 1;
+    types[0] = 2;
+
+    std::vector<int> process_indices;
+    std::vector<int> stack;
+    trie.match(indices, types, process_indices, stack);
+    std::sort(process_indices.begin(), process_indices.end());
+
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(process_indices.size()), 4 );
+    CPPUNIT_ASSERT_EQUAL( process_indices[0], 0 );
+    CPPUNIT_ASSERT_EQUAL( process_indices[1], 1 );
+    CPPUNIT_ASSERT_EQUAL( process_indices[2], 2 );
+    CPPUNIT_ASSERT_EQUAL( process_indices[3], 3 );
+
+    // Change the type at position 2.
+    types[5] = 2;
+    trie.match(indices, types, process_indices, stack);
+    std::sort(process_indices.begin(), process_indices.end());
+
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(process_indices.size()), 2 );
+    CPPUNIT_ASSERT_EQUAL( process_indices[0], 0 );
+    CPPUNIT_ASSERT_EQUAL( process_indices[1], 3 );
+
+    // Change the type at position 0.
+    types[7] = 3;
+    trie.match(indices, types, process_indices, stack);
+
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(process_indices.size()), 1 );
+    CPPUNIT_ASSERT_EQUAL( process_indices[0], 3 );
+    // }}}
+}
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_MatchTrie::testRandomCatalogue()
+{
+    // {{{
+    // Setup a catalogue of random processes on a small number of types,
+    // with wildcards left out.
+    seedRandom(false, 4711);
+
+    const int n_slots = 9;
+    const int n_types = 3;
+    const int n_processes = 500;
+
+    MatchTrie trie;
+    std::vector<CompiledMatchList> compiled_lists(n_processes);
+
+    for (int p = 0; p < n_processes; ++p)
+    {
+        for (int slot = 0; slot < n_slots; ++slot)
+        {
+            const int match_type = static_cast<int>(randomDouble01() * (n_types + 1));
+            if (match_type > 0 && match_type <= n_types)
+            {
+                CompiledMatchListEntry entry;
+                entry.slot = slot;
+                entry.match_type = match_type;
+                compiled_lists[p].push_back(entry);
+            }
+        }
+        trie.insert(compiled_lists[p], p);
+    }
+
+    // The shared prefixes give fewer nodes than entries.
+    size_t n_entries = 0;
+    for (int p = 0; p < n_processes; ++p)
+    {
+        n_entries += compiled_lists[p].size();
+    }
+    CPPUNIT_ASSERT( trie.nNodes() < n_entries );
+
+    // Compare with matching one process at a time.
+    std::vector<int> indices(n_slots);
+    std::vector<int> types(n_slots);
+    std::vector<int> process_indices;
+    std::vector<int> stack;
+    int n_matches = 0;
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        for (int slot = 0; slot < n_slots; ++slot)
+        {
+            indices[slot] = n_slots - 1 - slot;
+            types[slot] = 1 + static_cast<int>(randomDouble01() * 2);
+        }
+
+        trie.match(indices, types, process_indices, stack);
+        std::sort(process_indices.begin(), process_indices.end());
+
+        std::vector<int> ref_indices;
+        for (int p = 0; p < n_processes; ++p)
+        {
+            if (compiledMatch(compiled_lists[p], indices, types))
+            {
+                ref_indices.push_back(p);
+            }
+        }
+
+        CPPUNIT_ASSERT( process_indices == ref_indices );
+        n_matches += ref_indices.size();
+    }
+
+    // Check that there was something to match.
+    CPPUNIT_ASSERT( n_matches > 0 );
+    // }}}
+}
+
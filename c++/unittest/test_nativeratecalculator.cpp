@@ -0,0 +1,180 @@
+/*
+  This file is part of the KMCLib project distributed under the terms of the
+  GNU General Public License version 3, see <http://www.gnu.org/licenses/>.
+*/
+
+
+// Include the test definition.
+#include "test_nativeratecalculator.h"
+
+// Include the files to test.
+#include "nativeratecalculator.h"
+
+#include "configuration.h"
+#include "customrateprocess.h"
+#include "interactions.h"
+#include "latticemap.h"
+#include "matcher.h"
+#include "random.h"
+
+#include <stdexcept>
+
+// The path to the test plugin library is set by the build.
+#ifndef TEST_RATE_PLUGIN
+#define TEST_RATE_PLUGIN "./libtestrateplugin.so"
+#endif
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_NativeRateCalculator::testConstruction()
+{
+    // {{{
+    const NativeRateCalculator rate_calculator(TEST_RATE_PLUGIN);
+
+    CPPUNIT_ASSERT( rate_calculator.threadSafe() );
+    CPPUNIT_ASSERT_EQUAL( rate_calculator.libraryPath(), std::string(TEST_RATE_PLUGIN) );
+
+    // Call the plugin with an environment of only the central site.
+    const int indices[1]      = { 0 };
+    const int types[1]        = { 1 };
+    const int update_types[1] = { 0 };
+    const double distances[1]   = { 0.0 };
+    const double coordinates[3] = { 0.0, 0.0, 0.0 };
+
+    KMCRatePluginEnvironment environment;
+    environment.len            = 1;
+    environment.indices        = indices;
+    environment.types          = types;
+    environment.n_update       = 1;
+    environment.update_types   = update_types;
+    environment.distances      = distances;
+    environment.coordinates    = coordinates;
+    environment.rate_constant  = 3.5;
+    environment.process_number = 0;
+    environment.index          = 0;
+    environment.global_x       = 0.0;
+    environment.global_y       = 0.0;
+    environment.global_z       = 0.0;
+
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( rate_calculator.rate(environment), 3.5, 1.0e-12 );
+    // }}}
+}
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_NativeRateCalculator::testLoadFail()
+{
+    // {{{
+    CPPUNIT_ASSERT_THROW( NativeRateCalculator rate_calculator("./no_such_rate_plugin.so"),
+                          std::runtime_error );
+    // }}}
+}
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_NativeRateCalculator::testUpdateSingleRate()
+{
+    // {{{
+    seedRandom(false, 9182);
+
+    // Setup a random configuration of A and B.
+    const std::vector<int> repetitions(3, 6);
+    const std::vector<bool> periodicity(3, true);
+
+    std::vector<std::vector<double> > coords;
+    std::vector<std::string> elements;
+
+    for (int i = 0; i < repetitions[0]; ++i)
+    {
+        for (int j = 0; j < repetitions[1]; ++j)
+        {
+            for (int k = 0; k < repetitions[2]; ++k)
+            {
+                std::vector<double> coord(3);
+                coord[0] = i;
+                coord[1] = j;
+                coord[2] = k;
+                coords.push_back(coord);
+                elements.push_back(randomDouble01() < 0.5 ? "A" : "B");
+            }
+        }
+    }
+
+    std::map<std::string, int> possible_types;
+    possible_types["*"] = 0;
+    possible_types["A"] = 1;
+    possible_types["B"] = 2;
+
+    Configuration config(coords, elements, possible_types);
+    const LatticeMap lattice_map(1, repetitions, periodicity);
+    config.initMatchLists(lattice_map, 2);
+
+    // A B at the center and an A in the x direction swapping places,
+    // with a cutoff including the next nearest neighbours.
+    std::vector<std::vector<double> > process_coords(2, std::vector<double>(3, 0.0));
+    process_coords[1][0] = 1.0;
+
+    std::vector<std::string> elements1(2, "B");
+    elements1[1] = "A";
+    std::vector<std::string> elements2(2, "A");
+    elements2[1] = "B";
+
+    const Configuration config1(process_coords, elements1, possible_types);
+    const Configuration config2(process_coords, elements2, possible_types);
+    const std::vector<int> basis_sites(1, 0);
+    const double rate_constant = 2.1;
+    const double cutoff = 1.5;
+
+    const std::vector<CustomRateProcess> processes(1, CustomRateProcess(config1, config2,
+                                                                        rate_constant,
+                                                                        basis_sites, cutoff));
+
+    const NativeRateCalculator rate_calculator(TEST_RATE_PLUGIN);
+    Interactions interactions(processes, true, rate_calculator);
+    interactions.updateProcessMatchLists(config, lattice_map);
+
+    const Matcher m;
+    const Process & process = *interactions.processes()[0];
+
+    // Check against the rate calculated from the match list, with and
+    // without a compiled process match list.
+    for (int compiled = 0; compiled < 2; ++compiled)
+    {
+        if (compiled == 1)
+        {
+            interactions.compileProcessMatchLists(config, lattice_map);
+        }
+
+        for (size_t index = 0; index < elements.size(); ++index)
+        {
+            const ConfigMatchList match_list = config.matchList(index);
+            const ProcessMatchList & process_match_list = process.matchList();
+
+            double ref_rate = rate_constant;
+            for (size_t i = 0; i < match_list.size() && match_list[i].distance <= cutoff; ++i)
+            {
+                const bool changed = i < process_match_list.size() && \
+                    process_match_list[i].update_type != process_match_list[i].match_type;
+
+                if (changed)
+                {
+                    ref_rate += 1000.0;
+                }
+                else if (match_list[i].match_type == 1)
+                {
+                    ref_rate += match_list[i].distance;
+                }
+            }
+
+            // Through the drop in updateSingleRate.
+            const double rate = m.updateSingleRate(index, process, config, rate_calculator);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( ref_rate, rate, 1.0e-10 );
+            CPPUNIT_ASSERT( rate > 2000.0 );
+        }
+    }
+    // }}}
+}
+
@@ -0,0 +1,297 @@
+/*
+  This file is part of the KMCLib project distributed under the terms of the
+  GNU General Public License version 3, see <http://www.gnu.org/licenses/>.
+*/
+
+
+// Include the test definition.
+#include "test_neighbourhoodtemplates.h"
+
+// Include the files to test.
+#include "neighbourhoodtemplates.h"
+
+#include "configuration.h"
+#include "latticemap.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+
+// -------------------------------------------------------------------------- //
+// Compare the templates with the match lists calculated site by site.
+//
+static int compareWithSiteMatchLists(const std::vector<int> & repetitions,
+                                     const std::vector<bool> & periodic,
+                                     const int range,
+                                     const bool morton_order = false)
+{
+    // {{{
+
+    const LatticeMap lattice_map(2, repetitions, periodic, morton_order);
+
+    // Setup a lattice with two basis sites.
+    std::vector<std::vector<double> > coordinates;
+    std::vector<std::string> elements;
+    for (int i = 0; i < repetitions[0]; ++i)
+    {
+        for (int j = 0; j < repetitions[1]; ++j)
+        {
+            for (int k = 0; k < repetitions[2]; ++k)
+            {
+                std::vector<double> coord(3);
+                coord[0] = 0.0 + i*1.0;
+                coord[1] = 0.0 + j*1.0;
+                coord[2] = 0.0 + k*1.0;
+                coordinates.push_back(coord);
+                elements.push_back((i+j) % 2 ? "A" : "B");
+
+                coord[0] = 0.5 + i*1.0;
+                coord[1] = 0.5 + j*1.0;
+                coord[2] = 0.3 + k*1.0;
+                coordinates.push_back(coord);
+                elements.push_back(k % 3 ? "A" : "V");
+            }
+        }
+    }
+
+    std::map<std::string, int> possible_types;
+    possible_types["*"] = 0;
+    possible_types["A"] = 1;
+    possible_types["B"] = 2;
+    possible_types["V"] = 3;
+
+    // Put the sites in the order of the lattice map.
+    const std::vector<int> row_major_indices = lattice_map.rowMajorIndices();
+    const std::vector<std::vector<double> > row_major_coordinates = coordinates;
+    const std::vector<std::string> row_major_elements = elements;
+
+    for (size_t index = 0; index < elements.size(); ++index)
+    {
+        coordinates[index] = row_major_coordinates[row_major_indices[index]];
+        elements[index] = row_major_elements[row_major_indices[index]];
+    }
+
+    const Configuration configuration(coordinates, elements, possible_types);
+
+    NeighbourhoodTemplates templates;
+    templates.init(configuration.coordinates(), lattice_map, range);
+
+    int n_templated = 0;
+    std::vector<int> indices;
+
+    for (size_t index = 0; index < elements.size(); ++index)
+    {
+        const ConfigMatchList ref = \
+            configuration.matchList(index,
+                                    lattice_map.neighbourIndices(index, range),
+                                    lattice_map);
+
+        ConfigMatchList match_list;
+        templates.matchList(index, configuration.types(), match_list);
+        templates.neighbourIndices(index, indices);
+
+        CPPUNIT_ASSERT_EQUAL( match_list.size(), ref.size() );
+        CPPUNIT_ASSERT_EQUAL( indices.size(), ref.size() );
+        CPPUNIT_ASSERT( templates.maxSize() >= ref.size() );
+
+        for (size_t i = 0; i < ref.size(); ++i)
+        {
+            CPPUNIT_ASSERT_EQUAL( match_list[i].index, ref[i].index );
+            CPPUNIT_ASSERT_EQUAL( indices[i], ref[i].index );
+            CPPUNIT_ASSERT_EQUAL( match_list[i].match_type, ref[i].match_type );
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( match_list[i].distance, ref[i].distance, 1.0e-10 );
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( match_list[i].coordinate.x(), ref[i].coordinate.x(), 1.0e-10 );
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( match_list[i].coordinate.y(), ref[i].coordinate.y(), 1.0e-10 );
+            CPPUNIT_ASSERT_DOUBLES_EQUAL( match_list[i].coordinate.z(), ref[i].coordinate.z(), 1.0e-10 );
+        }
+
+        const int geometry = templates.geometry(index);
+        if (geometry >= 0)
+        {
+            CPPUNIT_ASSERT_EQUAL( templates.templateBasisSite(geometry),
+                                  lattice_map.basisSiteFromIndex(index) );
+            ++n_templated;
+        }
+    }
+
+    return n_templated;
+
+    // }}}
+}
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_NeighbourhoodTemplates::testConstruction()
+{
+    // {{{
+    // No neighbourhoods before init.
+    const NeighbourhoodTemplates templates;
+    CPPUNIT_ASSERT_EQUAL( templates.geometry(3), -1 );
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(templates.maxSize()), 0 );
+
+    std::vector<int> indices(3, 1);
+    templates.neighbourIndices(3, indices);
+    CPPUNIT_ASSERT( indices.empty() );
+
+    ConfigMatchList match_list(3);
+    templates.matchList(3, std::vector<int>(10, 1), match_list);
+    CPPUNIT_ASSERT( match_list.empty() );
+    // }}}
+}
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_NeighbourhoodTemplates::testPeriodic()
+{
+    // {{{
+    std::vector<int> repetitions(3);
+    repetitions[0] = 6;
+    repetitions[1] = 5;
+    repetitions[2] = 4;
+
+    // All sites use the templates on a periodic lattice.
+    const std::vector<bool> periodic(3, true);
+    CPPUNIT_ASSERT_EQUAL( compareWithSiteMatchLists(repetitions, periodic, 1), 240 );
+
+    repetitions[2] = 5;
+    CPPUNIT_ASSERT_EQUAL( compareWithSiteMatchLists(repetitions, periodic, 2), 300 );
+
+    // Also when the neighbourhood wraps around the lattice.
+    repetitions[2] = 2;
+    CPPUNIT_ASSERT_EQUAL( compareWithSiteMatchLists(repetitions, periodic, 1), 120 );
+
+    // Sites where the wrapped coordinates end up on the other side of the
+    // half cell boundary get their own lists, which still agree.
+    repetitions[2] = 4;
+    CPPUNIT_ASSERT( compareWithSiteMatchLists(repetitions, periodic, 2) > 0 );
+    // }}}
+}
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_NeighbourhoodTemplates::testNonPeriodic()
+{
+    // {{{
+    std::vector<int> repetitions(3);
+    repetitions[0] = 6;
+    repetitions[1] = 5;
+    repetitions[2] = 4;
+
+    // The cells at the boundary in the c direction use the templates of
+    // their boundary class.
+    std::vector<bool> periodic(3, true);
+    periodic[2] = false;
+    CPPUNIT_ASSERT_EQUAL( compareWithSiteMatchLists(repetitions, periodic, 1), 240 );
+
+    // Also when no cells are interior in the c direction.
+    CPPUNIT_ASSERT_EQUAL( compareWithSiteMatchLists(repetitions, periodic, 2), 240 );
+
+    // Non-periodic in all directions.
+    CPPUNIT_ASSERT_EQUAL( compareWithSiteMatchLists(repetitions, std::vector<bool>(3, false), 1), 240 );
+    // }}}
+}
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_NeighbourhoodTemplates::testSlab()
+{
+    // {{{
+    // A single layer, non-periodic in the c direction.
+    std::vector<int> repetitions(3);
+    repetitions[0] = 20;
+    repetitions[1] = 20;
+    repetitions[2] = 1;
+
+    std::vector<bool> periodic(3, true);
+    periodic[2] = false;
+
+    // All sites use the templates.
+    CPPUNIT_ASSERT_EQUAL( compareWithSiteMatchLists(repetitions, periodic, 1), 800 );
+    CPPUNIT_ASSERT_EQUAL( compareWithSiteMatchLists(repetitions, periodic, 2), 800 );
+
+    // With a single boundary class there is one template per basis site.
+    const LatticeMap lattice_map(1, repetitions, periodic);
+    std::vector<Coordinate> coordinates;
+    for (int i = 0; i < 20; ++i)
+    {
+        for (int j = 0; j < 20; ++j)
+        {
+            coordinates.push_back(Coordinate(i*1.0, j*1.0, 0.0));
+        }
+    }
+
+    NeighbourhoodTemplates templates;
+    templates.init(coordinates, lattice_map, 1);
+    CPPUNIT_ASSERT_EQUAL( templates.nTemplates(), 1 );
+
+    for (int index = 0; index < 400; ++index)
+    {
+        CPPUNIT_ASSERT_EQUAL( templates.geometry(index), 0 );
+    }
+
+    // A chain, non-periodic in the b and c directions.
+    repetitions[0] = 10;
+    repetitions[1] = 1;
+    periodic[1] = false;
+    CPPUNIT_ASSERT_EQUAL( compareWithSiteMatchLists(repetitions, periodic, 1), 20 );
+    // }}}
+}
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_NeighbourhoodTemplates::testMortonOrder()
+{
+    // {{{
+    std::vector<int> repetitions(3);
+    repetitions[0] = 6;
+    repetitions[1] = 5;
+    repetitions[2] = 4;
+
+    // The same templates with the cells in Morton order.
+    const std::vector<bool> periodic(3, true);
+    CPPUNIT_ASSERT_EQUAL( compareWithSiteMatchLists(repetitions, periodic, 1, true), 240 );
+
+    std::vector<bool> non_periodic(3, true);
+    non_periodic[2] = false;
+    CPPUNIT_ASSERT_EQUAL( compareWithSiteMatchLists(repetitions, non_periodic, 1, true), 240 );
+    // }}}
+}
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_NeighbourhoodTemplates::testThreads()
+{
+    // {{{
+    std::vector<int> repetitions(3);
+    repetitions[0] = 6;
+    repetitions[1] = 5;
+    repetitions[2] = 4;
+
+    // The sites are set up over the threads, with the same result as on
+    // a single thread.
+#ifdef _OPENMP
+    const int max_threads = omp_get_max_threads();
+    omp_set_num_threads(3);
+#endif
+
+    std::vector<bool> periodic(3, true);
+    periodic[2] = false;
+    const int n_periodic = compareWithSiteMatchLists(repetitions, periodic, 1);
+    const int n_non_periodic = compareWithSiteMatchLists(repetitions, std::vector<bool>(3, false), 1);
+
+#ifdef _OPENMP
+    omp_set_num_threads(max_threads);
+#endif
+
+    CPPUNIT_ASSERT_EQUAL( n_periodic, 240 );
+    CPPUNIT_ASSERT_EQUAL( n_non_periodic, 240 );
+    // }}}
+}
+
@@ -0,0 +1,43 @@
+/*
+  This file is part of the KMCLib project distributed under the terms of the
+  GNU General Public License version 3, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef __TEST_NEIGHBOURHOODTEMPLATES__
+#define __TEST_NEIGHBOURHOODTEMPLATES__
+
+#include <iostream>
+#include <string>
+
+#include <cppunit/TestCase.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestRunner.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class Test_NeighbourhoodTemplates : public CppUnit::TestCase {
+
+public:
+
+    CPPUNIT_TEST_SUITE( Test_NeighbourhoodTemplates );
+    CPPUNIT_TEST( testConstruction );
+    CPPUNIT_TEST( testPeriodic );
+    CPPUNIT_TEST( testNonPeriodic );
+    CPPUNIT_TEST( testSlab );
+    CPPUNIT_TEST( testMortonOrder );
+    CPPUNIT_TEST( testThreads );
+    CPPUNIT_TEST_SUITE_END();
+
+    void testConstruction();
+    void testPeriodic();
+    void testNonPeriodic();
+    void testSlab();
+    void testMortonOrder();
+    void testThreads();
+
+};
+
+#endif
+
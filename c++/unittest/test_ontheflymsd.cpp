@@ -253,7 +253,6 @@ void Test_OnTheFlyMSD::testStepX()
     Process p2(c3, c4, rate, basis_sites, move_origins, move_vectors);
 
     p2.addSite(2, 0.0);
-    configuration.updateMatchList(2);
     configuration.performProcess(p2, 2);
     time = 5.4;
     msd.registerStep(time, configuration);
@@ -288,11 +287,9 @@ void Test_OnTheFlyMSD::testStepX()
     // ---------------------------------------------------------------------
 
     // Apply the processes to the zeroth index.
-    configuration.updateMatchList(0);
     configuration.performProcess(p1, 0);
     time += 5.2;
     msd.registerStep(time, configuration);
-    configuration.updateMatchList(0);
     configuration.performProcess(p2, 0);
     time += 1.3;
     msd.registerStep(time, configuration);
@@ -302,11 +299,9 @@ void Test_OnTheFlyMSD::testStepX()
     // Apply each process again, 4 times.
     for (int i = 0; i < 4; ++i)
     {
-        configuration.updateMatchList(2);
         configuration.performProcess(p1, 2);
         time += 5.2;
         msd.registerStep(time, configuration);
-        configuration.updateMatchList(2);
         configuration.performProcess(p2, 2);
         time += 1.3;
         msd.registerStep(time, configuration);
@@ -525,7 +520,6 @@ void Test_OnTheFlyMSD::testStepY()
     Process p2(c3, c4, rate, basis_sites, move_origins, move_vectors);
 
     p2.addSite(2, 0.0);
-    configuration.updateMatchList(2);
     configuration.performProcess(p2, 2);
     time = 5.4;
     msd.registerStep(time, configuration);
@@ -560,11 +554,9 @@ void Test_OnTheFlyMSD::testStepY()
     // ---------------------------------------------------------------------
 
     // Apply the processes to the zeroth index.
-    configuration.updateMatchList(0);
     configuration.performProcess(p1, 0);
     time += 5.2;
     msd.registerStep(time, configuration);
-    configuration.updateMatchList(0);
     configuration.performProcess(p2, 0);
     time += 1.3;
     msd.registerStep(time, configuration);
@@ -574,11 +566,9 @@ void Test_OnTheFlyMSD::testStepY()
     // Apply each process again, 4 times.
     for (int i = 0; i < 4; ++i)
     {
-        configuration.updateMatchList(2);
         configuration.performProcess(p1, 2);
         time += 5.2;
         msd.registerStep(time, configuration);
-        configuration.updateMatchList(2);
         configuration.performProcess(p2, 2);
         time += 1.3;
         msd.registerStep(time, configuration);
@@ -796,7 +786,6 @@ void Test_OnTheFlyMSD::testStepZ()
     Process p2(c3, c4, rate, basis_sites, move_origins, move_vectors);
 
     p2.addSite(2, 0.0);
-    configuration.updateMatchList(2);
     configuration.performProcess(p2, 2);
     time = 5.4;
     msd.registerStep(time, configuration);
@@ -831,11 +820,9 @@ void Test_OnTheFlyMSD::testStepZ()
     // ---------------------------------------------------------------------
 
     // Apply the processes to the zeroth index.
-    configuration.updateMatchList(0);
     configuration.performProcess(p1, 0);
     time += 5.2;
     msd.registerStep(time, configuration);
-    configuration.updateMatchList(0);
     configuration.performProcess(p2, 0);
     time += 1.3;
     msd.registerStep(time, configuration);
@@ -845,11 +832,9 @@ void Test_OnTheFlyMSD::testStepZ()
     // Apply each process again, 4 times.
     for (int i = 0; i < 4; ++i)
     {
-        configuration.updateMatchList(2);
         configuration.performProcess(p1, 2);
         time += 5.2;
         msd.registerStep(time, configuration);
-        configuration.updateMatchList(2);
         configuration.performProcess(p2, 2);
         time += 1.3;
         msd.registerStep(time, configuration);
@@ -921,6 +921,54 @@ void Test_Process::testAddAndRemoveSite()
 }
 
 
+// -------------------------------------------------------------------------- //
+//
+void Test_Process::testRemoveSiteOrder()
+{
+    // {{{
+
+    // Default construct a process.
+    Process process;
+
+    // Add sites.
+    for (int i = 0; i < 6; ++i)
+    {
+        process.addSite(10*i);
+    }
+
+    // Removing a site moves the last site into its place.
+    process.removeSite(10);
+    CPPUNIT_ASSERT_EQUAL(static_cast<int>(process.nSites()), 5);
+    CPPUNIT_ASSERT_EQUAL(process.sites()[1], 50);
+    CPPUNIT_ASSERT( !process.isListed(10) );
+    CPPUNIT_ASSERT( process.isListed(50) );
+
+    // Remove the moved site and the last site.
+    process.removeSite(50);
+    CPPUNIT_ASSERT_EQUAL(process.sites()[1], 40);
+    process.removeSite(40);
+    CPPUNIT_ASSERT_EQUAL(static_cast<int>(process.nSites()), 3);
+
+    const std::vector<int> & sites = process.sites();
+    CPPUNIT_ASSERT_EQUAL(sites[0], 0);
+    CPPUNIT_ASSERT_EQUAL(sites[1], 30);
+    CPPUNIT_ASSERT_EQUAL(sites[2], 20);
+
+    for (int i = 0; i < 6; ++i)
+    {
+        const bool listed = (i == 0 || i == 2 || i == 3);
+        CPPUNIT_ASSERT_EQUAL( process.isListed(10*i), listed );
+    }
+
+    // Add a removed site back again.
+    process.addSite(10);
+    CPPUNIT_ASSERT( process.isListed(10) );
+    CPPUNIT_ASSERT_EQUAL(process.sites()[3], 10);
+
+    // }}}
+}
+
+
 // -------------------------------------------------------------------------- //
 //
 void Test_Process::testPickSite()
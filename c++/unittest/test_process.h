@@ -32,6 +32,7 @@ public:
     CPPUNIT_TEST( testMatchList );
     CPPUNIT_TEST( testMatchListLong );
     CPPUNIT_TEST( testAddAndRemoveSite );
+    CPPUNIT_TEST( testRemoveSiteOrder );
     CPPUNIT_TEST( testPickSite );
     CPPUNIT_TEST( testAffectedIndices );
     CPPUNIT_TEST( testCutoffAndRange );
@@ -46,6 +47,7 @@ public:
     void testMatchList();
     void testMatchListLong();
     void testAddAndRemoveSite();
+    void testRemoveSiteOrder();
     void testPickSite();
     void testAffectedIndices();
     void testCutoffAndRange();
@@ -14,8 +14,11 @@
 #include "random.h"
 
 #include <cmath>
+#include <set>
+#include <stdexcept>
 #include <unistd.h>
 #include <iostream>
+#include <sstream>
 
 // -------------------------------------------------------------------------- //
 //
@@ -392,3 +395,180 @@ void Test_Random::testCallMINSTD()
     // }}}
 }
 
+
+// -------------------------------------------------------------------------- //
+//
+void Test_Random::testRandomState()
+{
+    // {{{
+    const RNG_TYPE types[5] = {MT, MINSTD, RANLUX24, RANLUX48, PHILOX};
+
+    for (int t = 0; t < 5; ++t)
+    {
+        setRngType(types[t]);
+        seedRandom(false, 71);
+        randomDouble01();
+
+        // Write the state and draw a few numbers.
+        std::stringstream stream;
+        writeRandomState(stream);
+
+        std::vector<double> ref(5);
+        for (size_t i = 0; i < ref.size(); ++i)
+        {
+            ref[i] = randomDouble01();
+        }
+
+        // Draw from another type and seed, then restore the state.
+        setRngType(MT);
+        seedRandom(false, 5);
+        randomDouble01();
+        readRandomState(stream);
+
+        // The same numbers follow.
+        for (size_t i = 0; i < ref.size(); ++i)
+        {
+            CPPUNIT_ASSERT_EQUAL( randomDouble01(), ref[i] );
+        }
+    }
+
+    // A broken state throws.
+    std::stringstream empty;
+    CPPUNIT_ASSERT_THROW( readRandomState(empty), std::runtime_error );
+
+    setRngType(MT);
+    // }}}
+}
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_Random::testCounterRandom()
+{
+    // {{{
+    // The known answers of Philox4x32-10 from the Random123 distribution.
+    CounterRandom rng;
+    {
+        const uint32_t key[2] = {0, 0};
+        const uint32_t counter[4] = {0, 0, 0, 0};
+        rng.setKeyAndCounter(key, counter);
+        const std::vector<uint32_t> ref = {0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8};
+        CPPUNIT_ASSERT( rng.block() == ref );
+    }
+    {
+        const uint32_t key[2] = {0xffffffff, 0xffffffff};
+        const uint32_t counter[4] = {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff};
+        rng.setKeyAndCounter(key, counter);
+        const std::vector<uint32_t> ref = {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd};
+        CPPUNIT_ASSERT( rng.block() == ref );
+    }
+    {
+        const uint32_t key[2] = {0xa4093822, 0x299f31d0};
+        const uint32_t counter[4] = {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344};
+        rng.setKeyAndCounter(key, counter);
+        const std::vector<uint32_t> ref = {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1};
+        CPPUNIT_ASSERT( rng.block() == ref );
+
+        // The integers are the words of the block, in order.
+        for (int i = 0; i < 4; ++i)
+        {
+            CPPUNIT_ASSERT_EQUAL( rng(), ref[i] );
+        }
+    }
+
+    // The doubles are on (0.0,1.0) with a mean close to 0.5.
+    rng.seed(13, 0);
+    const int n = 100000;
+    double sum = 0.0;
+    for (int i = 0; i < n; ++i)
+    {
+        const double rnd = rng.randomDouble01();
+        CPPUNIT_ASSERT( rnd > 0.0 );
+        CPPUNIT_ASSERT( rnd < 1.0 );
+        sum += rnd;
+    }
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( sum / n, 0.5, 0.005 );
+
+    // The generator works with the standard algorithms.
+    std::vector<int> v = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    std::shuffle(v.begin(), v.end(), rng);
+    std::vector<int> sorted = v;
+    std::sort(sorted.begin(), sorted.end());
+    CPPUNIT_ASSERT( sorted == std::vector<int>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9}) );
+    // }}}
+}
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_Random::testCounterRandomStreams()
+{
+    // {{{
+    // The same seed and stream give the same numbers.
+    CounterRandom rng1(71, 3);
+    CounterRandom rng2(71, 3);
+    CPPUNIT_ASSERT_EQUAL( rng1.streamId(), static_cast<uint64_t>(3) );
+    for (int i = 0; i < 100; ++i)
+    {
+        CPPUNIT_ASSERT_EQUAL( rng1.randomDouble01(), rng2.randomDouble01() );
+    }
+
+    // Different streams of the same seed do not overlap.
+    std::set<uint32_t> drawn;
+    for (uint64_t stream = 0; stream < 4; ++stream)
+    {
+        CounterRandom rng(71, stream);
+        for (int i = 0; i < 1000; ++i)
+        {
+            drawn.insert(rng());
+        }
+        CPPUNIT_ASSERT_EQUAL( rng.streamId(), stream );
+    }
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(drawn.size()), 4000 );
+
+    // A filled buffer holds the numbers of repeated calls.
+    CounterRandom rng3(5, 1);
+    CounterRandom rng4(5, 1);
+    std::vector<double> buffer(37);
+    rng3.fill(buffer);
+    for (size_t i = 0; i < buffer.size(); ++i)
+    {
+        CPPUNIT_ASSERT_EQUAL( buffer[i], rng4.randomDouble01() );
+    }
+    CPPUNIT_ASSERT_EQUAL( rng3.randomDouble01(), rng4.randomDouble01() );
+    // }}}
+}
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_Random::testCounterRandomState()
+{
+    // {{{
+    CounterRandom rng(17, 2);
+
+    // Save the state in the middle of a block.
+    rng();
+    std::stringstream stream;
+    rng.writeState(stream);
+
+    std::vector<uint32_t> ref(9);
+    for (size_t i = 0; i < ref.size(); ++i)
+    {
+        ref[i] = rng();
+    }
+
+    // Restore it in another generator.
+    CounterRandom restored(3, 8);
+    restored.readState(stream);
+    CPPUNIT_ASSERT_EQUAL( restored.streamId(), static_cast<uint64_t>(2) );
+    for (size_t i = 0; i < ref.size(); ++i)
+    {
+        CPPUNIT_ASSERT_EQUAL( restored(), ref[i] );
+    }
+
+    // A broken state throws.
+    std::stringstream empty;
+    CPPUNIT_ASSERT_THROW( restored.readState(empty), std::runtime_error );
+    // }}}
+}
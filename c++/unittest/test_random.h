@@ -31,6 +31,10 @@ public:
     CPPUNIT_TEST( testCallRANLUX24 );
     CPPUNIT_TEST( testCallRANLUX48 );
     CPPUNIT_TEST( testCallMINSTD );
+    CPPUNIT_TEST( testRandomState );
+    CPPUNIT_TEST( testCounterRandom );
+    CPPUNIT_TEST( testCounterRandomStreams );
+    CPPUNIT_TEST( testCounterRandomState );
     CPPUNIT_TEST_SUITE_END();
 
     void testSeedAndCall();
@@ -40,6 +44,10 @@ public:
     void testCallRANLUX24();
     void testCallRANLUX48();
     void testCallMINSTD();
+    void testRandomState();
+    void testCounterRandom();
+    void testCounterRandomStreams();
+    void testCounterRandomState();
 
 };
 
@@ -0,0 +1,147 @@
+/*
+  This file is part of the KMCLib project distributed under the terms of the
+  GNU General Public License version 3, see <http://www.gnu.org/licenses/>.
+*/
+
+
+// Include the test definition.
+#include "test_ratecache.h"
+
+// Include the files to test.
+#include "ratecache.h"
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_RateCache::testConstruction()
+{
+    // {{{
+    const RateCache disabled;
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(disabled.capacity()), 0 );
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(disabled.size()), 0 );
+
+    const RateCache cache(10);
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(cache.capacity()), 10 );
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(cache.size()), 0 );
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(cache.hits()), 0 );
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(cache.misses()), 0 );
+    // }}}
+}
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_RateCache::testFindInsert()
+{
+    // {{{
+    RateCache cache(4);
+
+    std::vector<int> key1(3);
+    key1[0] = 0;
+    key1[1] = 1;
+    key1[2] = 2;
+
+    std::vector<int> key2 = key1;
+    key2[2] = 3;
+
+    double rate = -1.0;
+    CPPUNIT_ASSERT( !cache.find(key1, rate) );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( rate, -1.0, 1.0e-12 );
+
+    cache.insert(key1, 12.5);
+    cache.insert(key2, 3.25);
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(cache.size()), 2 );
+
+    CPPUNIT_ASSERT( cache.find(key1, rate) );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( rate, 12.5, 1.0e-12 );
+    CPPUNIT_ASSERT( cache.find(key2, rate) );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( rate, 3.25, 1.0e-12 );
+
+    // Inserting a stored key replaces the rate.
+    cache.insert(key2, 4.0);
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(cache.size()), 2 );
+    CPPUNIT_ASSERT( cache.find(key2, rate) );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( rate, 4.0, 1.0e-12 );
+
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(cache.hits()), 3 );
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(cache.misses()), 1 );
+
+    // Clear.
+    cache.clear();
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(cache.size()), 0 );
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(cache.hits()), 0 );
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(cache.misses()), 0 );
+    CPPUNIT_ASSERT( !cache.find(key1, rate) );
+
+    // A disabled cache stores nothing.
+    RateCache disabled;
+    disabled.insert(key1, 1.0);
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(disabled.size()), 0 );
+    CPPUNIT_ASSERT( !disabled.find(key1, rate) );
+    // }}}
+}
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_RateCache::testClockEviction()
+{
+    // {{{
+    RateCache cache(3);
+
+    std::vector< std::vector<int> > keys(5, std::vector<int>(1));
+    for (int i = 0; i < 5; ++i)
+    {
+        keys[i][0] = i;
+    }
+
+    cache.insert(keys[0], 0.0);
+    cache.insert(keys[1], 1.0);
+    cache.insert(keys[2], 2.0);
+
+    // No entry is used yet, the first one is replaced.
+    double rate = 0.0;
+    cache.insert(keys[3], 3.0);
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(cache.size()), 3 );
+    CPPUNIT_ASSERT( !cache.find(keys[0], rate) );
+
+    // Use key 1, key 2 is then the first one not used since the hand passed.
+    CPPUNIT_ASSERT( cache.find(keys[1], rate) );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( rate, 1.0, 1.0e-12 );
+
+    cache.insert(keys[4], 4.0);
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(cache.size()), 3 );
+    CPPUNIT_ASSERT( !cache.find(keys[2], rate) );
+    CPPUNIT_ASSERT( cache.find(keys[1], rate) );
+    CPPUNIT_ASSERT( cache.find(keys[3], rate) );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( rate, 3.0, 1.0e-12 );
+    CPPUNIT_ASSERT( cache.find(keys[4], rate) );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( rate, 4.0, 1.0e-12 );
+    // }}}
+}
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_RateCache::testSetCapacity()
+{
+    // {{{
+    RateCache cache(2);
+    std::vector<int> key(2, 1);
+    cache.insert(key, 1.0);
+
+    cache.setCapacity(5);
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(cache.capacity()), 5 );
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(cache.size()), 0 );
+
+    // Never more entries than the capacity.
+    for (int i = 0; i < 20; ++i)
+    {
+        key[0] = i;
+        cache.insert(key, static_cast<double>(i));
+        CPPUNIT_ASSERT( cache.size() <= 5 );
+    }
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(cache.size()), 5 );
+    // }}}
+}
+
@@ -56,3 +56,58 @@ void Test_RateCalculator::testRateCallback()
     // DONE
 }
 
+
+// -------------------------------------------------------------------------- //
+//
+void Test_RateCalculator::testThreadSafe()
+{
+    // The base class may call back into Python and is not thread safe.
+    const RateCalculator r;
+    CPPUNIT_ASSERT( !r.threadSafe() );
+
+    // The native thread safe variant.
+    const ThreadSafeRateCalculator ts;
+    CPPUNIT_ASSERT( ts.threadSafe() );
+
+    // Which still returns the rate constant from the base class.
+    const std::vector<double> geometry(3, 0.0);
+    const std::vector<std::string> types;
+    const RateCalculator & r_ts = ts;
+    CPPUNIT_ASSERT( r_ts.threadSafe() );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( r_ts.backendRateCallback(geometry, 1, types, types,
+                                                           2.3, 1, 0.0, 0.0, 0.0),
+                                  2.3, 1.0e-12 );
+}
+
+
+// -------------------------------------------------------------------------- //
+// A thread safe rate calculator using the integer types.
+class IntegerRateCalc : public ThreadSafeRateCalculator {
+public:
+    IntegerRateCalc() : ThreadSafeRateCalculator(true) {}
+    virtual ~IntegerRateCalc() {}
+};
+
+// -------------------------------------------------------------------------- //
+//
+void Test_RateCalculator::testIntegerTypes()
+{
+    // The string callback is used by default.
+    const RateCalculator r;
+    CPPUNIT_ASSERT( !r.integerTypes() );
+    const ThreadSafeRateCalculator ts;
+    CPPUNIT_ASSERT( !ts.integerTypes() );
+
+    // Unless declared by the derived class.
+    const IntegerRateCalc integer_rc;
+    CPPUNIT_ASSERT( integer_rc.integerTypes() );
+    CPPUNIT_ASSERT( integer_rc.threadSafe() );
+
+    // The base class integer callback returns the rate constant.
+    KMCRatePluginEnvironment environment;
+    environment.len           = 0;
+    environment.rate_constant = 4.5;
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( integer_rc.backendIntegerRateCallback(environment),
+                                  4.5, 1.0e-12 );
+}
+
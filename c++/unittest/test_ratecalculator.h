@@ -26,10 +26,14 @@ public:
     CPPUNIT_TEST_SUITE( Test_RateCalculator );
     CPPUNIT_TEST( testConstruction );
     CPPUNIT_TEST( testRateCallback );
+    CPPUNIT_TEST( testThreadSafe );
+    CPPUNIT_TEST( testIntegerTypes );
     CPPUNIT_TEST_SUITE_END();
 
     void testConstruction();
     void testRateCallback();
+    void testThreadSafe();
+    void testIntegerTypes();
 
 };
 
@@ -0,0 +1,139 @@
+/*
+  This file is part of the KMCLib project distributed under the terms of the
+  GNU General Public License version 3, see <http://www.gnu.org/licenses/>.
+*/
+
+
+// Include the test definition.
+#include "test_sumtree.h"
+
+// Include the files to test.
+#include "sumtree.h"
+
+#include "random.h"
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_SumTree::testConstruction()
+{
+    // {{{
+    // Default construction gives an empty tree.
+    SumTree tree;
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(tree.size()), 0 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( tree.total(), 0.0, 1.0e-14 );
+
+    // Construct with a size.
+    SumTree tree2(5);
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(tree2.size()), 5 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( tree2.total(), 0.0, 1.0e-14 );
+
+    // Build from values.
+    const std::vector<double> values = {1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0};
+    tree2.build(values);
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(tree2.size()), 7 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( tree2.total(), 28.0, 1.0e-14 );
+
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( tree2.value(i), values[i], 1.0e-14 );
+    }
+    // }}}
+}
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_SumTree::testUpdate()
+{
+    // {{{
+    SumTree tree(3);
+    tree.update(0, 1.5);
+    tree.update(2, 2.5);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( tree.total(), 4.0, 1.0e-14 );
+
+    tree.update(0, 0.5);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( tree.total(), 3.0, 1.0e-14 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( tree.value(0), 0.5, 1.0e-14 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( tree.value(1), 0.0, 1.0e-14 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( tree.value(2), 2.5, 1.0e-14 );
+
+    // Growing keeps the values.
+    tree.resize(9);
+    tree.update(8, 1.0);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( tree.total(), 4.0, 1.0e-14 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( tree.value(2), 2.5, 1.0e-14 );
+
+    // Shrinking drops the values.
+    tree.resize(2);
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(tree.size()), 2 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( tree.total(), 0.5, 1.0e-14 );
+    // }}}
+}
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_SumTree::testPushAndPop()
+{
+    // {{{
+    SumTree tree;
+    double ref_total = 0.0;
+    for (int i = 0; i < 100; ++i)
+    {
+        tree.pushBack(1.0*i);
+        ref_total += 1.0*i;
+        CPPUNIT_ASSERT_EQUAL( static_cast<int>(tree.size()), i+1 );
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( tree.total(), ref_total, 1.0e-10 );
+    }
+
+    for (int i = 99; i >= 50; --i)
+    {
+        tree.popBack();
+        ref_total -= 1.0*i;
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( tree.total(), ref_total, 1.0e-10 );
+    }
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(tree.size()), 50 );
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( tree.value(49), 49.0, 1.0e-14 );
+    // }}}
+}
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_SumTree::testPick()
+{
+    // {{{
+    const std::vector<double> values = {1.0, 0.0, 3.0, 0.0, 4.0};
+    SumTree tree;
+    tree.build(values);
+
+    // Check the boundaries.
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(tree.pick(0.0)), 0 );
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(tree.pick(0.999)), 0 );
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(tree.pick(1.0)), 2 );
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(tree.pick(3.999)), 2 );
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(tree.pick(4.0)), 4 );
+
+    // The total never picks a zero weight or an empty leaf.
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(tree.pick(8.0)), 4 );
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(tree.pick(8.0 + 1.0e-12)), 4 );
+
+    // Pick with enough statistics.
+    seedRandom(false, 871);
+    std::vector<int> picked(values.size(), 0);
+    const int n_loop = 1000000;
+    for (int i = 0; i < n_loop; ++i)
+    {
+        ++picked[tree.pick(randomDouble01()*tree.total())];
+    }
+
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL( 1.0*picked[i]/n_loop,
+                                      values[i]/tree.total(),
+                                      1.0e-2 );
+    }
+    // }}}
+}
+
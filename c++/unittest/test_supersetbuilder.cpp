@@ -0,0 +1,89 @@
+/*
+  This file is part of the KMCLib project distributed under the terms of the
+  GNU General Public License version 3, see <http://www.gnu.org/licenses/>.
+*/
+
+
+// Include the test definition.
+#include "test_supersetbuilder.h"
+
+// Include the files to test.
+#include "supersetbuilder.h"
+
+#include "latticemap.h"
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_SupersetBuilder::testBuild()
+{
+    // {{{
+    std::vector<int> repetitions(3);
+    repetitions[0] = 6;
+    repetitions[1] = 4;
+    repetitions[2] = 5;
+
+    std::vector<bool> periodicity(3, true);
+    periodicity[1] = false;
+
+    const LatticeMap lattice_map(2, repetitions, periodicity);
+
+    SupersetBuilder builder;
+    CPPUNIT_ASSERT( builder.superset().empty() );
+
+    // The same supersets as from the lattice map, over repeated calls.
+    std::vector<int> indices;
+    for (int i = 0; i < 30; ++i)
+    {
+        indices.push_back((i * 37) % 240);
+
+        for (int shells = 1; shells <= 2; ++shells)
+        {
+            const std::vector<int> & superset = builder.build(lattice_map, indices, shells);
+            CPPUNIT_ASSERT( superset == lattice_map.supersetNeighbourIndices(indices, shells) );
+            CPPUNIT_ASSERT( builder.superset() == superset );
+        }
+    }
+
+    // No indices give an empty superset.
+    CPPUNIT_ASSERT( builder.build(lattice_map, std::vector<int>(), 1).empty() );
+
+    // A different lattice.
+    const LatticeMap small_map(1, std::vector<int>(3, 3), std::vector<bool>(3, false));
+    const std::vector<int> small_indices(1, 13);
+    CPPUNIT_ASSERT( builder.build(small_map, small_indices, 1) ==
+                    small_map.supersetNeighbourIndices(small_indices, 1) );
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(builder.superset().size()), 27 );
+    // }}}
+}
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_SupersetBuilder::testBuildNeighbourTable()
+{
+    // {{{
+    std::vector<int> repetitions(3);
+    repetitions[0] = 7;
+    repetitions[1] = 7;
+    repetitions[2] = 2;
+
+    const LatticeMap reference(3, repetitions, std::vector<bool>(3, true));
+    LatticeMap lattice_map(3, repetitions, std::vector<bool>(3, true));
+    lattice_map.initNeighbourTable(2);
+
+    SupersetBuilder builder;
+
+    std::vector<int> indices;
+    indices.push_back(5);
+    indices.push_back(6);
+    indices.push_back(100);
+    indices.push_back(280);
+
+    CPPUNIT_ASSERT( builder.build(lattice_map, indices, 2) ==
+                    reference.supersetNeighbourIndices(indices, 2) );
+    CPPUNIT_ASSERT( builder.build(lattice_map, indices, 1) ==
+                    reference.supersetNeighbourIndices(indices, 1) );
+    // }}}
+}
+
@@ -0,0 +1,35 @@
+/*
+  This file is part of the KMCLib project distributed under the terms of the
+  GNU General Public License version 3, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef __TEST_SUPERSETBUILDER__
+#define __TEST_SUPERSETBUILDER__
+
+#include <iostream>
+#include <string>
+
+#include <cppunit/TestCase.h>
+#include <cppunit/TestSuite.h>
+#include <cppunit/TestCaller.h>
+#include <cppunit/TestRunner.h>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+class Test_SupersetBuilder : public CppUnit::TestCase {
+
+public:
+
+    CPPUNIT_TEST_SUITE( Test_SupersetBuilder );
+    CPPUNIT_TEST( testBuild );
+    CPPUNIT_TEST( testBuildNeighbourTable );
+    CPPUNIT_TEST_SUITE_END();
+
+    void testBuild();
+    void testBuildNeighbourTable();
+
+};
+
+#endif
+
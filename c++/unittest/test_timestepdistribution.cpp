@@ -0,0 +1,92 @@
+/*
+  This file is part of the KMCLib project distributed under the terms of the
+  GNU General Public License version 3, see <http://www.gnu.org/licenses/>.
+*/
+
+
+// Include the test definition.
+#include "test_timestepdistribution.h"
+
+// Include the files to test.
+#include "timestepdistribution.h"
+
+// Other inclusions.
+#include "configuration.h"
+#include "process.h"
+
+#include <stdexcept>
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_TimeStepDistribution::testConstruction()
+{
+    // {{{
+    const TimeStepDistribution tsd(2.3);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL( tsd.binsize(), 2.3, 1.0e-12 );
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(tsd.histogram().size()), 10 );
+    CPPUNIT_ASSERT( tsd.histogram() == std::vector<int>(10, 0) );
+
+    // The binsize must be positive.
+    CPPUNIT_ASSERT_THROW( TimeStepDistribution(0.0), std::invalid_argument );
+    CPPUNIT_ASSERT_THROW( TimeStepDistribution(-1.0), std::invalid_argument );
+    // }}}
+}
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_TimeStepDistribution::testRegisterTime()
+{
+    // {{{
+    TimeStepDistribution tsd(1.23);
+    tsd.setLastTime(0.4);
+
+    // A step of 3.0 ends up in bin 2.
+    tsd.registerTime(3.4);
+    std::vector<int> ref(10, 0);
+    ref[2] = 1;
+    CPPUNIT_ASSERT( tsd.histogram() == ref );
+
+    // A step in bin 10 extends the histogram to 11 bins.
+    tsd.registerTime(10.0);
+    tsd.registerTime(23.0);
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(tsd.histogram().size()), 11 );
+    CPPUNIT_ASSERT_EQUAL( tsd.histogram()[10], 1 );
+
+    // A step in bin 20 extends it by a tenth at a time to 22 bins.
+    tsd.registerTime(48.0);
+    CPPUNIT_ASSERT_EQUAL( static_cast<int>(tsd.histogram().size()), 22 );
+    CPPUNIT_ASSERT_EQUAL( tsd.histogram()[20], 1 );
+    // }}}
+}
+
+
+// -------------------------------------------------------------------------- //
+//
+void Test_TimeStepDistribution::testRegisterStep()
+{
+    // {{{
+    // Setup a configuration and a process to pass on.
+    std::map<std::string, int> possible_types;
+    possible_types["*"] = 0;
+    possible_types["A"] = 1;
+    possible_types["B"] = 2;
+
+    const std::vector<std::vector<double> > coordinates(1, std::vector<double>(3, 0.0));
+    Configuration c1(coordinates, std::vector<std::string>(1, "A"), possible_types);
+    Configuration c2(coordinates, std::vector<std::string>(1, "B"), possible_types);
+    const Process process(c1, c2, 1.0, std::vector<int>(1, 0));
+
+    // The time since the setup is registered.
+    TimeStepDistribution tsd(0.5);
+    tsd.setup(0, 1.0, c1);
+    tsd.registerStep(1, 2.2, 1.2, process, 0, c1);
+    CPPUNIT_ASSERT_EQUAL( tsd.histogram()[2], 1 );
+
+    // Then the time since the last registered step.
+    tsd.registerStep(2, 2.3, 0.1, process, 0, c1);
+    CPPUNIT_ASSERT_EQUAL( tsd.histogram()[0], 1 );
+    // }}}
+}
+
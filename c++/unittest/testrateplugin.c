@@ -0,0 +1,43 @@
+/*
+  This file is part of the KMCLib project distributed under the terms of the
+  GNU General Public License version 3, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/* Native rate plugin used by the NativeRateCalculator tests. The rate is
+ * the rate constant plus the summed distances to the sites that are of
+ * type 1 before the process and not changed by it, plus 1000 times the
+ * number of changed sites.
+ */
+
+#include "rateplugin.h"
+
+
+int kmc_rate_plugin_abi_version(void)
+{
+    return KMC_RATE_PLUGIN_ABI_VERSION;
+}
+
+
+double kmc_rate_plugin_rate(const KMCRatePluginEnvironment * environment)
+{
+    double rate = environment->rate_constant;
+    int i;
+
+    for (i = 0; i < environment->len; ++i)
+    {
+        const int type = environment->types[environment->indices[i]];
+        const int changed = (i < environment->n_update && environment->update_types[i] != 0);
+
+        if (changed)
+        {
+            rate += 1000.0;
+        }
+        else if (type == 1)
+        {
+            rate += environment->distances[i];
+        }
+    }
+
+    return rate;
+}
@@ -15,6 +15,8 @@
 // Define the content of our modeule.
 %module(directors="1") Backend
 %{
+#include <stdexcept>
+
 #include "latticemodel.h"
 #include "latticemap.h"
 #include "configuration.h"
@@ -29,8 +31,13 @@
 #include "matchlistentry.h"
 #include "simulationtimer.h"
 #include "ratecalculator.h"
+#include "nativeratecalculator.h"
+#include "ratecache.h"
+#include "latticegasratecalculator.h"
 #include "mpicommons.h"
 #include "ontheflymsd.h"
+#include "analysisplugin.h"
+#include "timestepdistribution.h"
 #include "random.h"
 %}
 
@@ -38,6 +45,11 @@
 %feature("director") SimpleDummyBaseClass;
 %feature("director") RateCalculator;
 
+// The local state hooks are for native rate calculators only, and are not
+// called back into Python at each step.
+%feature("nodirector") RateCalculator::initLocalState;
+%feature("nodirector") RateCalculator::updateLocalState;
+
 // Exception handling for overloaded RateCalculators in Python.
 %feature("director:except") {
     if ($error != NULL) {
@@ -49,11 +61,110 @@
     catch (Swig::DirectorException &e) { SWIG_fail; }
 }
 
+// Report native rate plugins failing to load as Python RuntimeErrors.
+%exception NativeRateCalculator::NativeRateCalculator {
+    try { $action }
+    catch (std::runtime_error &e) {
+        PyErr_SetString(PyExc_RuntimeError, e.what());
+        SWIG_fail;
+    }
+}
+
+// Report invalid lattice gas interactions as Python ValueErrors.
+%exception LatticeGasRateCalculator::setShells {
+    try { $action }
+    catch (std::invalid_argument &e) {
+        PyErr_SetString(PyExc_ValueError, e.what());
+        SWIG_fail;
+    }
+}
+%exception LatticeGasRateCalculator::setPairEnergy {
+    try { $action }
+    catch (std::invalid_argument &e) {
+        PyErr_SetString(PyExc_ValueError, e.what());
+        SWIG_fail;
+    }
+}
+%exception LatticeGasRateCalculator::setTripletEnergy {
+    try { $action }
+    catch (std::invalid_argument &e) {
+        PyErr_SetString(PyExc_ValueError, e.what());
+        SWIG_fail;
+    }
+}
+%exception LatticeGasRateCalculator::setTemperature {
+    try { $action }
+    catch (std::invalid_argument &e) {
+        PyErr_SetString(PyExc_ValueError, e.what());
+        SWIG_fail;
+    }
+}
+
+// Report failing checkpoint reads and writes as Python RuntimeErrors.
+%exception LatticeModel::LatticeModel {
+    try { $action }
+    catch (std::runtime_error &e) {
+        PyErr_SetString(PyExc_RuntimeError, e.what());
+        SWIG_fail;
+    }
+}
+%exception LatticeModel::writeCheckpoint {
+    try { $action }
+    catch (std::runtime_error &e) {
+        PyErr_SetString(PyExc_RuntimeError, e.what());
+        SWIG_fail;
+    }
+}
+
+// Run the steps of the lattice model without holding the Python GIL, unless
+// the rate calculator is a Python object calling back into Python.
+%exception LatticeModel::run {
+    PyThreadState * thread_state = NULL;
+    if (dynamic_cast<const Swig::Director *>(&(arg1->interactions().rateCalculator())) == NULL)
+    {
+        thread_state = PyEval_SaveThread();
+    }
+    try { $action }
+    catch (Swig::DirectorException &e) {
+        SWIG_fail;
+    }
+    catch (std::exception &e) {
+        if (thread_state != NULL) { PyEval_RestoreThread(thread_state); }
+        PyErr_SetString(PyExc_RuntimeError, e.what());
+        SWIG_fail;
+    }
+    if (thread_state != NULL) { PyEval_RestoreThread(thread_state); }
+}
+
+// Report invalid analysis plugin parameters as Python ValueErrors.
+%exception AnalysisPlugin::setStepInterval {
+    try { $action }
+    catch (std::invalid_argument &e) {
+        PyErr_SetString(PyExc_ValueError, e.what());
+        SWIG_fail;
+    }
+}
+%exception AnalysisPlugin::setTimeInterval {
+    try { $action }
+    catch (std::invalid_argument &e) {
+        PyErr_SetString(PyExc_ValueError, e.what());
+        SWIG_fail;
+    }
+}
+%exception TimeStepDistribution::TimeStepDistribution {
+    try { $action }
+    catch (std::invalid_argument &e) {
+        PyErr_SetString(PyExc_ValueError, e.what());
+        SWIG_fail;
+    }
+}
+
 // Include SWIG files for the std containers.
 %include "std_vector.i"
 %include "std_map.i"
 %include "std_string.i"
 %include "std_pair.i"
+%include "stdint.i"
 
 // Define the templates to use in Python.
 %template(StdVectorString) std::vector<std::string>;
@@ -87,8 +198,13 @@
 %include "matchlistentry.h"
 %include "simulationtimer.h"
 %include "ratecalculator.h"
+%include "nativeratecalculator.h"
+%include "ratecache.h"
+%include "latticegasratecalculator.h"
 %include "mpicommons.h"
 %include "ontheflymsd.h"
+%include "analysisplugin.h"
+%include "timestepdistribution.h"
 %include "random.h"
 
 // This extends the Coordinate class with python indexing support.
@@ -13,67 +13,81 @@ import sys
 from KMCLib.PluginInterfaces.KMCAnalysisPlugin import KMCAnalysisPlugin
 from KMCLib.Utilities.CheckUtilities import checkPositiveFloat
 from KMCLib.Backend.Backend import MPICommons
+from KMCLib.Backend import Backend
 
 class TimeStepDistribution(KMCAnalysisPlugin):
     """
     Class for collecting the time step distribution during a simulation.
+    The histogram is collected by a native backend plugin, called by the
+    C++ lattice model directly after each scheduled step.
     """
     def __init__(self,
-                 binsize=None):
+                 binsize=None,
+                 time_interval=None):
         """
         Constructor for the time step distribution analysis object.
 
         :param binsize: The size of the bins in the histogram.
         :type binsize: float
+
+        :param time_interval: If given, register the first step reaching each
+                              multiple of this simulation time, instead of
+                              the steps given by the analysis interval.
+        :type time_interval: float
         """
         # Check the input parameters.
         self.__binsize = checkPositiveFloat(binsize, 1.0, "binsize")
 
-        # Setup an initial histogram of 10 entries.
-        self.__histogram = numpy.zeros(10, dtype=int)
+        if time_interval is not None:
+            time_interval = checkPositiveFloat(time_interval, None, "time_interval")
+        self.__time_interval = time_interval
+
+        # Setup the backend, with an initial histogram of 10 entries.
+        self.__backend = Backend.TimeStepDistribution(self.__binsize)
 
-    def setup(self, step, time, configuration):
+    def setup(self, step, time, configuration, interactions=None):
         """
         Recieves the setup call from before the MC loop.
         """
-        self.__last_time = time
+        self.__backend.setLastTime(time)
+
+        # Schedule the backend by time if a time interval is given.
+        if self.__time_interval is not None:
+            self.__backend.setTimeInterval(self.__time_interval, time)
 
-    def registerStep(self, step, time, configuration):
+    def registerStep(self, step, time, configuration, interactions=None):
         """
-        Recieves the step call from the MC loop.
+        Recieves the step call from the MC loop, when not called natively.
         """
-        # Calculate the delta t since last time.
-        dt = time - self.__last_time
-        self.__last_time = time
-
-        # Calculate the bin.
-        b = int(dt / self.__binsize)
-
-        # Make sure we have place for the bin.
-        while len(self.__histogram) <= b:
-            new_len = len(self.__histogram) + len(self.__histogram)//10
-            self.__histogram.resize(new_len)
-
-        # Increment the value at this bin.
-        self.__histogram[b] += 1
+        self.__backend.registerTime(time)
 
     def finalize(self):
         """
         Recieves the finalize call after the MC loop.
         """
+        self.__histogram = numpy.array(self.__backend.histogram(), dtype=int)
+
         n_bins = len(self.__histogram)
         self.__time_steps = (numpy.arange(n_bins)+1)*self.__binsize - self.__binsize / 2.0
 
         n_samples = float(numpy.sum(self.__histogram))
         self.__normalized_histogram = self.__histogram / n_samples
 
+    def _backend(self):
+        """
+        Query for the native backend plugin collecting the histogram.
+
+        :returns: The Backend.TimeStepDistribution object.
+        """
+        return self.__backend
+
     def histogram(self):
         """
         Query function for the histogram.
 
         :returns: The raw histogram as a numpy array.
         """
-        return self.__histogram
+        return numpy.array(self.__backend.histogram(), dtype=int)
 
     def normalizedHistogram(self):
         """
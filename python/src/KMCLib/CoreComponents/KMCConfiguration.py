@@ -181,7 +181,7 @@ class KMCConfiguration(object):
         :returns: The stored types list.
         """
         # Update the types with what ever has been changed in the backend.
-        self.__types = list(self._backend().elements())
+        self.__types = self._fromBackendOrder(list(self._backend().elements()))
 
         # Return the types.
         return self.__types
@@ -190,13 +190,14 @@ class KMCConfiguration(object):
         """
         Query for the types indexed according to the atom_ids.
         """
-        return self._backend().atomIDElements()
+        return tuple(self._fromBackendOrder(list(self._backend().atomIDElements())))
 
     def atomIDCoordinates(self):
         """
         Query for the coordinates per atom id.
         """
-        return stdVectorCoordinateToNumpy2DArray(self._backend().atomIDCoordinates())
+        coordinates = stdVectorCoordinateToNumpy2DArray(self._backend().atomIDCoordinates())
+        return self._fromBackendOrder(coordinates)
 
     def sites(self):
         """
@@ -224,7 +225,13 @@ class KMCConfiguration(object):
         """
         Query for the moved atom_id:s of the last move.
         """
-        return self._backend().movedAtomIDs()
+        moved_atom_ids = self._backend().movedAtomIDs()
+
+        # The atom ids are the row-major indices of the sites the atoms started at.
+        site_order = self.__lattice._siteOrder()
+        if site_order is None:
+            return moved_atom_ids
+        return tuple([int(site_order[atom_id]) for atom_id in moved_atom_ids])
 
     def lattice(self):
         """
@@ -238,8 +245,9 @@ class KMCConfiguration(object):
         """
         if self.__backend is None:
             # Construct the c++ backend object.
-            cpp_types = stringListToStdVectorString(self.__types)
-            cpp_coords = numpy2DArrayToStdVectorStdVectorDouble(self.__lattice.sites())
+            cpp_types = stringListToStdVectorString(self._toBackendOrder(self.__types))
+            cpp_coords = numpy2DArrayToStdVectorStdVectorDouble(
+                self._toBackendOrder(self.__lattice.sites()))
             cpp_possible_types = Backend.StdMapStringInt(self.__possible_types)
 
             # Send in the coordinates and types to construct the backend configuration.
@@ -250,6 +258,46 @@ class KMCConfiguration(object):
         # Return the backend.
         return self.__backend
 
+    def _toBackendOrder(self, values):
+        """
+        Private helper function to reorder values per site from the
+        row-major order to the site order of the backend.
+
+        :param values: A list or numpy array with a value per site.
+
+        :returns: The values in the backend order.
+        """
+        site_order = self.__lattice._siteOrder()
+        if site_order is None:
+            return values
+
+        if isinstance(values, numpy.ndarray):
+            return values[site_order]
+        return [values[i] for i in site_order]
+
+    def _fromBackendOrder(self, values):
+        """
+        Private helper function to reorder values per site from the site
+        order of the backend to the row-major order.
+
+        :param values: A list or numpy array with a value per site.
+
+        :returns: The values in the row-major order.
+        """
+        site_order = self.__lattice._siteOrder()
+        if site_order is None:
+            return values
+
+        if isinstance(values, numpy.ndarray):
+            row_major_values = numpy.empty_like(values)
+            row_major_values[site_order] = values
+            return row_major_values
+
+        row_major_values = [None]*len(values)
+        for value, i in zip(values, site_order):
+            row_major_values[i] = value
+        return row_major_values
+
     def _latticeMap(self):
         """
         Get a c++ lattice map describing the lattice.
@@ -66,7 +66,9 @@ class KMCControlParameters(object):
                          'MT' for Mersenne-Twister (Default) [rng = std::mt19937],
                          'MINSTD' for the 'minimum standard' rng [rng = std::minstd_rand],
                          'RANLUX24' for the 24-bit version of the ranlux rng [rng = std::ranlux24],
-                         'RANLUX48' for the 48-bit version of the ranlux rng [rng = std::ranlux48].
+                         'RANLUX48' for the 48-bit version of the ranlux rng [rng = std::ranlux48],
+                         'PHILOX' for the counter based Philox4x32-10 rng, which is not
+                         in the standard C++ library and draws 53-bit numbers.
 
                          The sequence of pseudo-random numbers is generated by repeated calls to
                          std::generate_canonical<double, 32>(rng);
@@ -81,6 +83,13 @@ class KMCControlParameters(object):
                          since this has not been tested with a random device by the KMCLib developers.
         :type rng_type: str
 
+        :param random_stream: The id of a counter based Philox random stream for the
+                              model to draw from, seeded with the seed value, instead
+                              of the global generator set by rng_type. Replicas given
+                              different ids draw independent reproducible sequences.
+                              By default the global generator is used.
+        :type random_stream: int
+
         :param start_time: The start time for KMC loop, default value is 0.0
         :type start_time: float
 
@@ -146,6 +155,12 @@ class KMCControlParameters(object):
         rng_type = kwargs.pop("rng_type", None)
         self.__rng_type = self.__checkRngType(rng_type, "MT")
 
+        # Check the random stream id.
+        random_stream = kwargs.pop("random_stream", None)
+        if random_stream is not None:
+            random_stream = checkPositiveInteger(random_stream, None, "random_stream")
+        self.__random_stream = random_stream
+
         # Check and set start time.
         start_time = kwargs.pop("start_time", None)
         self.__start_time = self.__checkStartTime(start_time, 0.0)
@@ -245,6 +260,7 @@ class KMCControlParameters(object):
                      "RANLUX24" : Backend.RANLUX24,
                      "RANLUX48" : Backend.RANLUX48,
                      "DEVICE"   : Backend.DEVICE,
+                     "PHILOX"   : Backend.PHILOX,
                      }
 
         if not rng_type in rng_dict.keys():
@@ -405,6 +421,12 @@ class KMCControlParameters(object):
         """
         return self.__rng_type
 
+    def randomStream(self):
+        """
+        Query for the random stream id, None if the global generator is used.
+        """
+        return self.__random_stream
+
     def startTime(self):
         """
         Query for the start time.
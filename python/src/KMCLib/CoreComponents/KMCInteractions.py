@@ -17,6 +17,8 @@ from KMCLib.Utilities.CheckUtilities import checkSequenceOf
 from KMCLib.Exceptions.Error import Error
 from KMCLib.CoreComponents.KMCProcess import KMCProcess
 from KMCLib.PluginInterfaces.KMCRateCalculatorPlugin import KMCRateCalculatorPlugin
+from KMCLib.PluginInterfaces.KMCNativeRateCalculatorPlugin import KMCNativeRateCalculatorPlugin
+from KMCLib.PluginInterfaces.KMCLatticeGasRateCalculatorPlugin import KMCLatticeGasRateCalculatorPlugin
 from KMCLib.CoreComponents.KMCSitesMap import KMCSitesMap
 
 
@@ -97,7 +99,9 @@ class KMCInteractions(object):
         set before the backend is generated to take effect.
 
         :param rate_calculator:    A class inheriting from the
-                                   KMCRateCalculatorPlugin interface. If not given
+                                   KMCRateCalculatorPlugin, the
+                                   KMCNativeRateCalculatorPlugin or the
+                                   KMCLatticeGasRateCalculatorPlugin interface. If not given
                                    the rates specified for each process will be used unmodified.
 
         """
@@ -115,7 +119,9 @@ class KMCInteractions(object):
             self.__rate_calculator_str = str(rate_calculator).replace("'>", "").split('.')[-1]
             # Instantiate.
             rate_calculator = rate_calculator()
-            if not isinstance(rate_calculator, KMCRateCalculatorPlugin):
+            if not isinstance(rate_calculator, (KMCRateCalculatorPlugin,
+                                                KMCNativeRateCalculatorPlugin,
+                                                KMCLatticeGasRateCalculatorPlugin)):
                 msg = ("\nThe 'rate_calculator' input to the KMCInteractions constructor " +
                        "must be a class inheriting from the KMCRateCalculatorPlugin.")
                 raise Error(msg)
@@ -258,6 +264,11 @@ class KMCInteractions(object):
                     if cutoff is None:
                         cutoff = 1.0
 
+                        # The lattice gas rates depend on the shells around
+                        # the changed sites.
+                        if isinstance(self.__rate_calculator, KMCLatticeGasRateCalculatorPlugin):
+                            cutoff = max(cutoff, self.__rate_calculator._processCutoff(process))
+
                     cpp_processes.push_back(Backend.CustomRateProcess(cpp_config1,
                                                                       cpp_config2,
                                                                       rate_constant,
@@ -285,9 +296,18 @@ class KMCInteractions(object):
 
             # Construct the C++ interactions object.
             if self.__rate_calculator is not None:
+                # Setup the lattice gas interactions with the type numbers.
+                if isinstance(self.__rate_calculator, KMCLatticeGasRateCalculatorPlugin):
+                    self.__rate_calculator._setup(possible_types)
+
                 self.__backend = Backend.Interactions(cpp_processes,
                                                       self.__implicit_wildcards,
                                                       self.__rate_calculator)
+
+                # Cache the pure local rates if asked for.
+                if (isinstance(self.__rate_calculator, KMCRateCalculatorPlugin) and
+                        self.__rate_calculator.pureLocalRates()):
+                    self.__backend.setRateCacheCapacity(self.__rate_calculator.rateCacheSize())
             else:
                 self.__backend = Backend.Interactions(cpp_processes,
                                                       self.__implicit_wildcards)
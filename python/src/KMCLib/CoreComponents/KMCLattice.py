@@ -25,7 +25,8 @@ class KMCLattice(object):
     def __init__(self,
                  unit_cell=None,
                  repetitions=None,
-                 periodic=None):
+                 periodic=None,
+                 cell_ordering=None):
         """
         Constructor for the Lattice used in the KMC simulations.
 
@@ -38,6 +39,13 @@ class KMCLattice(object):
         :param periodic: A list or tuple indicating if periodicity should be used along the
                          a, b and c directions. If not specified it defaults to (True,True,True)
         :type periodic: (bool,bool,bool)
+
+        :param cell_ordering: The ordering of the cells in the backend, "row_major" or
+                              "morton". The Morton ordering keeps the sites of nearby
+                              cells close in memory, which speeds up large 3D lattices.
+                              The site indices seen in Python are always in row-major
+                              order. If not specified it defaults to "row_major".
+        :type cell_ordering: str
         """
         # Check and store the unit cell.
         if not isinstance(unit_cell, KMCUnitCell):
@@ -51,11 +59,15 @@ class KMCLattice(object):
         # Check the periodic input.
         self.__periodic = self.__checkPeriodic(periodic)
 
+        # Check the cell ordering input.
+        self.__cell_ordering = self.__checkCellOrdering(cell_ordering)
+
         # Generate the lattice sites.
         self.__sites = self.__generateLatticeSites()
 
         # Set the lattice map to be generated at first query.
         self.__lattice_map = None
+        self.__site_order = None
 
     def __checkRepetitions(self, repetitions):
         """
@@ -116,6 +128,21 @@ class KMCLattice(object):
         # Done.
         return periodic
 
+    def __checkCellOrdering(self, cell_ordering):
+        """
+        Private helper routine to check the cell ordering input.
+        """
+        # Handle the default case.
+        if cell_ordering is None:
+            cell_ordering = "row_major"
+
+        if cell_ordering not in ("row_major", "morton"):
+            raise Error("The 'cell_ordering' input parameter must be " +
+                        "'row_major' or 'morton'.")
+
+        # Done.
+        return cell_ordering
+
     def __generateLatticeSites(self):
         """
         Private helper function to generate the sites data
@@ -213,10 +240,35 @@ class KMCLattice(object):
         if self.__lattice_map is None:
             self.__lattice_map = Backend.LatticeMap(len(self.__unit_cell.basis()),
                                                     Backend.StdVectorInt(self.__repetitions),
-                                                    Backend.StdVectorBool(self.__periodic))
+                                                    Backend.StdVectorBool(self.__periodic),
+                                                    self.__cell_ordering == "morton")
         # Return the lattice map.
         return self.__lattice_map
 
+    def cellOrdering(self):
+        """
+        Query for the cell ordering.
+
+        :returns: The ordering of the cells in the backend.
+        """
+        return self.__cell_ordering
+
+    def _siteOrder(self):
+        """
+        Query for the row-major index of each site in the backend ordering.
+
+        :returns: The row-major indices as a numpy array, or None if the
+                  backend uses the row-major ordering.
+        """
+        if self.__cell_ordering == "row_major":
+            return None
+
+        # Generate the site order if not done allready.
+        if self.__site_order is None:
+            self.__site_order = numpy.array(self._map().rowMajorIndices(), dtype=int)
+
+        return self.__site_order
+
     def indexToCoordinate(self, index):
         """
         Get coordinate of a given index.
@@ -292,7 +344,13 @@ class KMCLattice(object):
                           " = KMCLattice(\n" +
                           "    unit_cell=unit_cell,\n" +
                           "    repetitions=(%i,%i,%i),\n" +
-                          "    periodic=%s)\n") % (nI, nJ, nK, str(self.__periodic))
+                          "    periodic=%s") % (nI, nJ, nK, str(self.__periodic))
+
+        # Add the cell ordering if not the default.
+        if self.__cell_ordering != "row_major":
+            lattice_string += ",\n    cell_ordering=\"%s\"" % (self.__cell_ordering)
+
+        lattice_string += ")\n"
 
         # Add the comment.
         comment_string = """
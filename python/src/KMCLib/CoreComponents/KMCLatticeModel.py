@@ -99,13 +99,19 @@ class KMCLatticeModel(object):
         """
         return self.__interactions
 
-    def _backend(self, start_time):
+    def _backend(self, start_time, restart_filename=None):
         """
         Function for generating the C++ backend reperesentation of this object.
 
         :param start_time: The start time for kMC loop
         :type: float.
 
+        :param restart_filename: The name of a checkpoint file to restore the
+                                 types, process sites, time and random number
+                                 generator state from, instead of matching the
+                                 processes from the start.
+        :type restart_filename: str
+
         :returns: The C++ LatticeModel based on the parameters given to this
                   class on construction.
         """
@@ -122,11 +128,23 @@ class KMCLatticeModel(object):
             self.__cpp_timer = Backend.SimulationTimer(start_time=start_time)
 
             # Construct the backend object.
-            self.__backend = Backend.LatticeModel(cpp_config,
-                                                  cpp_sitesmap,
-                                                  self.__cpp_timer,
-                                                  cpp_lattice_map,
-                                                  cpp_interactions)
+            if restart_filename is None:
+                self.__backend = Backend.LatticeModel(cpp_config,
+                                                      cpp_sitesmap,
+                                                      self.__cpp_timer,
+                                                      cpp_lattice_map,
+                                                      cpp_interactions)
+            else:
+                self.__backend = Backend.LatticeModel(cpp_config,
+                                                      cpp_sitesmap,
+                                                      self.__cpp_timer,
+                                                      cpp_lattice_map,
+                                                      cpp_interactions,
+                                                      restart_filename)
+
+        elif restart_filename is not None:
+            raise Error("Only a lattice model that has not been run can be restarted " +
+                        "from a checkpoint.")
         # Return.
         return self.__backend
         # }}}
@@ -135,7 +153,9 @@ class KMCLatticeModel(object):
             control_parameters=None,
             trajectory_filename=None,
             trajectory_type=None,
-            analysis=None):
+            analysis=None,
+            checkpoint_filename=None,
+            restart_filename=None):
         """
         Run the KMC lattice model simulation with specified parameters.
 
@@ -152,6 +172,19 @@ class KMCLatticeModel(object):
 
         :param analysis: A list of instantiated analysis objects that should be
                          used for on-the-fly analysis.
+
+        :param checkpoint_filename: The filename of a binary checkpoint of the
+                                    model, written at each dump interval and at
+                                    the end of the run. If not given no
+                                    checkpoint is written.
+
+        :param restart_filename: The filename of a checkpoint to restart the
+                                 model from, restoring the types, the matched
+                                 processes, the time, the step and the random
+                                 number generator state without matching again.
+                                 The run continues from the restored step up
+                                 to the number of steps of the control
+                                 parameters.
         """
         # {{{
         # Check the input.
@@ -175,6 +208,11 @@ class KMCLatticeModel(object):
                    "run function must be given as str or unicode.")
             raise Error(msg)
 
+        # Check the checkpoint filenames.
+        for filename in (checkpoint_filename, restart_filename):
+            if not (filename is None or isinstance(filename, str)):
+                raise Error("The checkpoint and restart filenames must be given as str.")
+
         # Check the analysis type.
         if trajectory_type is None:
             trajectory_type = 'lattice'
@@ -206,7 +244,19 @@ class KMCLatticeModel(object):
             self.__logger.info("setting up the backend C++ object.")
 
         start_time = control_parameters.startTime()
-        cpp_model = self._backend(start_time)
+        cpp_model = self._backend(start_time, restart_filename)
+
+        # Let the model draw from its own random stream if one is given, as
+        # the global generator is seeded above. A restarted model continues
+        # the stream of the checkpoint.
+        if control_parameters.randomStream() is not None and restart_filename is None:
+            cpp_model.setRandomStream(control_parameters.seed(),
+                                      control_parameters.randomStream())
+
+        # A restarted model continues from the step of the checkpoint.
+        if restart_filename is None:
+            cpp_model.setStep(0)
+        start_step = cpp_model.step()
 
         # Print the initial matching information if above the verbosity threshold.
         if self.__verbosity_level > 9:
@@ -231,21 +281,16 @@ class KMCLatticeModel(object):
 
             # Add the first step.
             trajectory.append(simulation_time=self.__cpp_timer.simulationTime(),
-                              step=0,
+                              step=start_step,
                               configuration=self.__configuration)
 
-        # Setup the analysis objects.
-        for ap in analysis:
-            step = 0
-            ap.setup(step=step,
-                     time=self.__cpp_timer.simulationTime(),
-                     configuration=self.__configuration,
-                     interactions=self.__interactions)
-
         # Get the needed parameters.
         end_time = control_parameters.timeLimit()
         n_steps = control_parameters.numberOfSteps()
         n_dump = control_parameters.dumpInterval()
+
+        if start_step >= n_steps:
+            raise Error("The model is restarted at step %i, which is not before the number of steps to run."%(start_step))
         analysis_interv = control_parameters.analysisInterval()
         extra_traj = control_parameters.extraTraj()
 
@@ -269,31 +314,72 @@ class KMCLatticeModel(object):
             # Convert to list.
             analysis_interv = [analysis_interv]*len(analysis)
 
+        # Let the backend call the native analysis plugins directly after the
+        # steps they are scheduled for, and keep the others for the Python loop.
+        cpp_model.clearAnalysisPlugins()
+        python_analysis = []
+
+        for intv, ap in zip(analysis_interv, analysis):
+            native = ap._backend()
+            if native is None:
+                python_analysis.append((intv, ap))
+                continue
+
+            if type(intv) is int:
+                native.setStepInterval(intv)
+            else:
+                start, end, interval = intv
+                native.setStepInterval(interval, start, end)
+            cpp_model.addAnalysisPlugin(native)
+
+        # Setup the analysis objects, which may reschedule native plugins.
+        for ap in analysis:
+            ap.setup(step=start_step,
+                     time=self.__cpp_timer.simulationTime(),
+                     configuration=self.__configuration,
+                     interactions=self.__interactions)
+
         #prettyPrint(" KMCLib: Runing for %i steps, starting from time: %f\n" %
         #            (n_steps, self.__cpp_timer.simulationTime()))
         if MPICommons.isMaster():
             msg = "Runing for {:,d} steps, starting from time: {:f}\n"
-            self.__logger.info(msg.format(n_steps, self.__cpp_timer.simulationTime()))
+            self.__logger.info(msg.format(n_steps - start_step, self.__cpp_timer.simulationTime()))
 
         # Run the KMC simulation.
         try:
             # Loop over the steps.
-            step = 0
+            step = start_step
             current_time = 0.0
-            redistribution_counter = 0
+            redistribution_counter = start_step
 
             while(1):
-                # Start from step 1.
-                step += 1
-                redistribution_counter += 1
-
                 # Check if it is possible to take a step.
-                nP = cpp_model.interactions().totalAvailableSites()
+                nP = cpp_model.interactions().availableSites()
                 if nP == 0:
                     raise Error("No more available processes.")
 
-                # Take a step.
-                cpp_model.singleStep()
+                # Find the next step at which the Python side has work to do.
+                next_steps = [n_steps, self.__nextStep(step, n_dump)]
+
+                if extra_traj is not None:
+                    next_steps.append(self.__nextStep(step, *extra_traj[::-1]))
+
+                for intv, ap in python_analysis:
+                    if type(intv) is int:
+                        next_steps.append(self.__nextStep(step, intv))
+                    elif type(intv) in (list, tuple):
+                        next_steps.append(self.__nextStep(step, *intv[::-1]))
+
+                if do_redistribution:
+                    next_steps.append(step + redistribution_interval -
+                                      redistribution_counter % redistribution_interval)
+
+                # Take the steps up to there in the backend, which stops early
+                # when the time limit is passed or no process is available.
+                n_requested = min(s for s in next_steps if s is not None) - step
+                n_taken = cpp_model.run(n_requested, end_time)
+                step += n_taken
+                redistribution_counter += n_taken
 
                 # Time increase.
                 current_time = self.__cpp_timer.simulationTime()
@@ -317,6 +403,10 @@ class KMCLatticeModel(object):
                                           step=step,
                                           configuration=self.__configuration)
 
+                    # Write the checkpoint for restarting from this step.
+                    if checkpoint_filename is not None and MPICommons.isMaster():
+                        cpp_model.writeCheckpoint(checkpoint_filename)
+
                 # Extra trajectorie output.
                 if extra_traj is not None:
                     start, end, interval = extra_traj
@@ -326,7 +416,7 @@ class KMCLatticeModel(object):
                                           configuration=self.__configuration)
 
                 # Run all other python analysis.
-                for intv, ap in zip(analysis_interv, analysis):
+                for intv, ap in python_analysis:
                     # NOTE: intv(interval) can be int or list/tuple of int here.
 
                     if type(intv) is int and ((step % intv) == 0):
@@ -396,12 +486,19 @@ class KMCLatticeModel(object):
                                           step=step,
                                           configuration=self.__configuration)
 
+            # Write the final checkpoint.
+            if checkpoint_filename is not None and MPICommons.isMaster():
+                cpp_model.writeCheckpoint(checkpoint_filename)
+
         finally:
 
             # Flush the trajectory buffers when done.
             if use_trajectory:
                 trajectory.flush()
 
+            # Stop calling the native analysis plugins.
+            cpp_model.clearAnalysisPlugins()
+
             # Perform the analysis post processing.
             for ap in analysis:
                 ap.finalize()
@@ -438,6 +535,24 @@ class KMCLatticeModel(object):
                 comment_string + lattice_model_string)
         # }}}
 
+    def __nextStep(self, step, interval, end=None, start=0):
+        """
+        Private helper to get the first step after the given step that is
+        a multiple of an interval, optionally within a range of steps.
+
+        :param step: The current step.
+        :param interval: The step interval.
+        :param end: The last step of the range, if any.
+        :param start: The first step of the range.
+
+        :returns: The next step in the range, or None if there is none.
+        """
+        next_step = max(step + 1, start)
+        next_step = ((next_step + interval - 1) // interval) * interval
+        if end is not None and next_step > end:
+            return None
+        return next_step
+
     def __printMatchInfo(self, cpp_model):
         """ """
         """
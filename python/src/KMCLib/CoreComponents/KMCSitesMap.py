@@ -68,7 +68,7 @@ class KMCSitesMap(KMCConfiguration):
         """
         # Update the types with what ever has been changed in the backend.
         mangled_name = self.__mangled_name("__types")
-        setattr(self, mangled_name, list(self._backend().sites()))
+        setattr(self, mangled_name, self._fromBackendOrder(list(self._backend().sites())))
 
         # Return the types.
         return getattr(self, mangled_name)
@@ -100,11 +100,12 @@ class KMCSitesMap(KMCConfiguration):
         if getattr(self, backend_mangled_name) is None:
             # Construct the c++ backend object.
             mangled_name = self.__mangled_name("__types")
-            cpp_types = stringListToStdVectorString(getattr(self, mangled_name))
+            cpp_types = stringListToStdVectorString(
+                self._toBackendOrder(getattr(self, mangled_name)))
 
             mangled_name = self.__mangled_name("__lattice")
             cpp_coords = numpy2DArrayToStdVectorStdVectorDouble(
-                getattr(self, mangled_name).sites())
+                self._toBackendOrder(getattr(self, mangled_name).sites()))
 
             mangled_name = self.__mangled_name("__possible_types")
             cpp_possible_types = Backend.StdMapStringInt(getattr(self, mangled_name))
@@ -62,3 +62,15 @@ class KMCAnalysisPlugin(object):
         post-processing of collected data.
         """
         pass
+
+    def _backend(self):
+        """
+        Query for a native C++ analysis plugin doing the work of this object.
+        A native plugin is called by the C++ lattice model directly after the
+        steps it is scheduled for, and registerStep() of this object is then
+        not called from the KMC loop.
+
+        :returns: The native Backend.AnalysisPlugin, or None for analysis done
+                  in Python, which is the base class implementation.
+        """
+        return None
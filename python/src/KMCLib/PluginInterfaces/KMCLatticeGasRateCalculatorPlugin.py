@@ -0,0 +1,155 @@
+""" Module for the KMCLatticeGasRateCalculatorPlugin class """
+
+
+# This file is part of the KMCLib project distributed under the terms of the
+# GNU General Public License version 3, see <http://www.gnu.org/licenses/>.
+#
+
+
+import numpy
+
+from KMCLib.Backend import Backend
+from KMCLib.Exceptions.Error import Error
+
+class KMCLatticeGasRateCalculatorPlugin(Backend.LatticeGasRateCalculator):
+    """
+    Class for calculating the individual rates in the KMC simulation with
+    the built in lattice gas model. The energy is a sum of pair and triplet
+    energies by the types and distance shells of the sites, and the barrier
+    of each process is given by a Bronsted-Evans-Polanyi relation,
+
+        Ea = max(0, dE, E0 + alpha * dE),    k = A * exp(-Ea / kB T)
+
+    with A the rate constant of the process. The site energies are updated
+    incrementally in C++ after each step, without calling back into Python.
+    """
+
+    def __init__(self):
+        """
+        Base class constructor.
+        """
+        # Call the C++ base class constructor.
+        Backend.LatticeGasRateCalculator.__init__(self)
+
+    def interactionShells(self):
+        """
+        Called to get the distance of each interaction shell. Any class
+        inheriting from the plugin base class must provide an implementation
+        of this function.
+
+        :returns: The shell distances in primitive cell internal coordinates.
+        :rtype: list of float
+        """
+        raise Error("The interactionShells(self) API function in the 'KMCLatticeGasRateCalculatorPlugin' base class must be overloaded when using a lattice gas rate calculator.")
+
+    def pairEnergies(self):
+        """
+        Called to get the pair energies. If not implemented by derived
+        classes there are no pair energies.
+
+        :returns: A list of (type_a, type_b, shell, energy) tuples with the
+                  types given as strings, the shell as an index in the list
+                  of interaction shells and the energy in eV.
+        :rtype: list
+        """
+        return []
+
+    def tripletEnergies(self):
+        """
+        Called to get the triplet energies. If not implemented by derived
+        classes there are no triplet energies.
+
+        :returns: A list of (type_a, type_b, type_c, shell_ab, shell_bc, shell_ca, energy)
+                  tuples with the types given as strings, the shells as indices
+                  in the list of interaction shells and the energy in eV.
+        :rtype: list
+        """
+        return []
+
+    def bepParameters(self):
+        """
+        Called to get the BEP parameters of the processes. Processes without
+        BEP parameters keep their rate constant.
+
+        :returns: A dict from process number to a (barrier, alpha) tuple,
+                  with the barrier in eV.
+        :rtype: dict
+        """
+        return {}
+
+    def simulationTemperature(self):
+        """
+        Called to get the temperature of the simulation.
+
+        :returns: The temperature in K.
+        :rtype: float
+        """
+        return 300.0
+
+    def cutoff(self):
+        """
+        To determine the radial cutoff of the geometry around the central
+        lattice site. The cutoff must cover the interaction shells around
+        every site changed by a process, for the rates to be updated when
+        the site energies change, or the backend rejects the process. If not
+        implemented by derived classes the cutoff of each process is set
+        to cover the shells around its changed sites.
+
+        :returns: The desired cutoff in primitive cell internal coordinates.
+        :rtype: float
+        """
+        # Returning None results in default behaviour.
+        return None
+
+    def _processCutoff(self, process):
+        """
+        Private function for getting the smallest cutoff of a process for
+        its rate to be updated when the energies of its changed sites change,
+        i.e. the largest distance of a changed site plus the largest shell.
+
+        :param process: The process to get the cutoff for.
+        :type process: KMCProcess
+
+        :returns: The cutoff in primitive cell internal coordinates.
+        :rtype: float
+        """
+        before, after = process.localConfigurations()
+        coordinates = before.coordinates()
+
+        # The distances are taken from the first coordinate, as in the backend.
+        max_distance = 0.0
+        for i, (type_before, type_after) in enumerate(zip(before.types(), after.types())):
+            if type_after != "*" and type_after != type_before:
+                distance = numpy.linalg.norm(coordinates[i] - coordinates[0])
+                max_distance = max(max_distance, distance)
+
+        return max_distance + max([float(s) for s in self.interactionShells()])
+
+    def _setup(self, possible_types):
+        """
+        Private function for setting up the interactions on the C++ base
+        class, called when the interactions backend is generated.
+
+        :param possible_types: A dict with the global mapping of type strings
+                               to integers.
+        """
+        def typeNumber(name):
+            if name not in possible_types:
+                raise Error("The type '%s' of the lattice gas energies is not a possible type."%(name))
+            return possible_types[name]
+
+        shells = Backend.StdVectorDouble([float(s) for s in self.interactionShells()])
+        n_types = max(possible_types.values()) + 1
+        self.setShells(shells, n_types)
+
+        for (a, b, shell, energy) in self.pairEnergies():
+            self.setPairEnergy(typeNumber(a), typeNumber(b), shell, energy)
+
+        for (a, b, c, s_ab, s_bc, s_ca, energy) in self.tripletEnergies():
+            self.setTripletEnergy(typeNumber(a), typeNumber(b), typeNumber(c),
+                                  s_ab, s_bc, s_ca, energy)
+
+        for process_number, (barrier, alpha) in self.bepParameters().items():
+            self.setBEPParameters(process_number, barrier, alpha)
+
+        self.setTemperature(self.simulationTemperature())
@@ -0,0 +1,47 @@
+""" Module for the KMCNativeRateCalculatorPlugin class """
+
+
+# This file is part of the KMCLib project distributed under the terms of the
+# GNU General Public License version 3, see <http://www.gnu.org/licenses/>.
+#
+
+
+from KMCLib.Backend import Backend
+from KMCLib.Exceptions.Error import Error
+
+class KMCNativeRateCalculatorPlugin(Backend.NativeRateCalculator):
+    """
+    Class for calculating the individual rates in the KMC simulation with
+    a native shared library implementing the C interface in rateplugin.h.
+    The rates are calculated in C++ without calling back into Python.
+    """
+
+    def __init__(self):
+        """
+        Base class constructor, loading the library.
+        """
+        # Call the C++ base class constructor.
+        Backend.NativeRateCalculator.__init__(self, self.library())
+
+    def library(self):
+        """
+        Called from the base class constructor to get the path to the
+        rate plugin library. Any class inheriting from the plugin base class
+        must provide an implementation of this function.
+
+        :returns: The path to the shared library.
+        :rtype: str
+        """
+        raise Error("The library(self) API function in the 'KMCNativeRateCalculatorPlugin' base class must be overloaded when using a native rate calculator.")
+
+    def cutoff(self):
+        """
+        To determine the radial cutoff of the geometry around the central
+        lattice site to send to the rate plugin. If not implemented by
+        derived classes the default cutoff is used.
+
+        :returns: The desired cutoff in primitive cell internal coordinates.
+        :rtype: float
+        """
+        # Returning None results in default behaviour.
+        return None
@@ -54,6 +54,40 @@ class KMCRateCalculatorPlugin(Backend.RateCalculator):
                          process_number,
                          global_coordinate)
 
+    def backendBatchRateCallback(self,
+                                 cpp_coords,
+                                 lengths,
+                                 types_before,
+                                 types_after,
+                                 rate_constants,
+                                 process_numbers,
+                                 global_coordinates):
+        """
+        Function called from C++ to get the rates of all tasks at once, if
+        the rates(self,...) function is overloaded. It parses the data to
+        NumPy arrays and sends it forward to the custom rates function.
+        """
+        rates = self.rates(numpy.array(cpp_coords).reshape(-1,3),
+                           numpy.array(lengths, dtype=int),
+                           numpy.array(types_before, dtype=int),
+                           numpy.array(types_after, dtype=int),
+                           numpy.array(rate_constants),
+                           numpy.array(process_numbers, dtype=int),
+                           numpy.array(global_coordinates).reshape(-1,3))
+        return numpy.asarray(rates, dtype=float).tolist()
+
+    def batchCallback(self):
+        """
+        Function called from C++ to determine if the rates should be calculated
+        for all tasks at once with the rates(self,...) function, which is the
+        case if it is overloaded by the derrived class.
+
+        :returns: True if the rates(self,...) function is overloaded.
+        """
+        base_rates = KMCRateCalculatorPlugin.rates
+        return (getattr(self.rates, "__func__", None) is not
+                getattr(base_rates, "__func__", base_rates))
+
     def initialize(self):
         """
         Called as the last statement in the base class constructor
@@ -92,6 +126,44 @@ class KMCRateCalculatorPlugin(Backend.RateCalculator):
         """
         raise Error("The rate(self,...) API function in the 'KMCRateCalculator' base class must be overloaded when using a custom rate calculator.")
 
+    def rates(self,
+              coords,
+              lengths,
+              types_before,
+              types_after,
+              rate_constants,
+              process_numbers,
+              global_coordinates):
+        """
+        Called from the base class to get the rates of all processes to update
+        in a step at once, as an alternative to the rate(self,...) function
+        allowing the rate formula to be vectorised with NumPy. The data of
+        task i is found at the sites lengths[:i].sum() to lengths[:i+1].sum().
+        The integer types are given by the possible types mapping of the
+        configuration.
+
+        :param coords: The coordinates of the sites of all tasks as a Mx3 numpy
+                       array in fractional units of the primitive cell.
+
+        :param lengths: The number of sites of each task as a numpy array.
+
+        :param types_before: The integer types before the processes, for the
+                             sites of all tasks, as a numpy array.
+
+        :param types_after: The integer types after the processes, for the
+                            sites of all tasks, as a numpy array.
+
+        :param rate_constants: The rate constant of the process of each task.
+
+        :param process_numbers: The process id number of each task.
+
+        :param global_coordinates: The global coordinate of the central index
+                                   of each task as a Nx3 numpy array.
+
+        :returns: The custom rates of the tasks, as a sequence of length N.
+        """
+        raise Error("The rates(self,...) API function in the 'KMCRateCalculator' base class must be overloaded when using batched rates.")
+
     def cutoff(self):
         """
         To determine the radial cutoff of the geometry around the central
@@ -105,3 +177,25 @@ class KMCRateCalculatorPlugin(Backend.RateCalculator):
         # Returning None results in default behaviour.
         return None
 
+    def pureLocalRates(self):
+        """
+        To declare that the rate only depends on the local geometry, the types
+        before and after, the rate constant and the process number, and not on
+        the global coordinate or any other state. Only then the calculated
+        rates may be reused from the rate cache.
+
+        :returns: True if the rates are pure functions of the local environment.
+        :rtype: bool
+        """
+        return False
+
+    def rateCacheSize(self):
+        """
+        To determine the maximum number of rates to keep in the rate cache,
+        keyed on the process and the local types. Only used if pureLocalRates()
+        returns True. The default is to use no cache.
+
+        :returns: The maximum number of cached rates.
+        :rtype: int
+        """
+        return 0
@@ -36,6 +36,8 @@ from KMCLib.Analysis.TimeStepDistribution import TimeStepDistribution
 from KMCLib.Utilities.SaveAndReadUtilities import KMCInteractionsFromScript
 from KMCLib.Utilities.SaveAndReadUtilities import KMCConfigurationFromScript
 from KMCLib.PluginInterfaces.KMCRateCalculatorPlugin import KMCRateCalculatorPlugin
+from KMCLib.PluginInterfaces.KMCNativeRateCalculatorPlugin import KMCNativeRateCalculatorPlugin
+from KMCLib.PluginInterfaces.KMCLatticeGasRateCalculatorPlugin import KMCLatticeGasRateCalculatorPlugin
 from KMCLib.PluginInterfaces.KMCAnalysisPlugin import KMCAnalysisPlugin
 from KMCLib.Backend.Backend import MPICommons
 from KMCLib.Utilities.PrintUtilities import printHeader
@@ -44,6 +46,7 @@ __all__ = ['KMCLocalConfiguration', 'KMCInteractions', 'KMCConfiguration',
            'KMCLattice', 'KMCLatticeModel', 'KMCUnitCell', 'KMCSitesMap',
            'KMCControlParameters', 'KMCInteractionsFromScript',
            'KMCConfigurationFromScript', 'KMCRateCalculatorPlugin',
+           'KMCNativeRateCalculatorPlugin', 'KMCLatticeGasRateCalculatorPlugin',
            'KMCAnalysisPlugin', 'KMCProcess', 'OnTheFlyMSD',
            'TimeStepDistribution', 'MPICommons']
 
@@ -19,6 +19,15 @@ else:
 
 # Import from the module we test.
 from KMCLib.Analysis.TimeStepDistribution import TimeStepDistribution
+from KMCLib.CoreComponents.KMCUnitCell import KMCUnitCell
+from KMCLib.CoreComponents.KMCLattice import KMCLattice
+from KMCLib.CoreComponents.KMCConfiguration import KMCConfiguration
+from KMCLib.CoreComponents.KMCSitesMap import KMCSitesMap
+from KMCLib.CoreComponents.KMCProcess import KMCProcess
+from KMCLib.CoreComponents.KMCInteractions import KMCInteractions
+from KMCLib.CoreComponents.KMCLatticeModel import KMCLatticeModel
+from KMCLib.CoreComponents.KMCControlParameters import KMCControlParameters
+from KMCLib.Exceptions.Error import Error
 from KMCLib.Backend.Backend import MPICommons
 
 
@@ -31,28 +40,31 @@ class TimeStepDistributionTest(unittest.TestCase):
         # Check default member data.
         tsd = TimeStepDistribution()
         self.assertAlmostEqual(tsd._TimeStepDistribution__binsize, 1.0, 12)
-        self.assertEqual(len(tsd._TimeStepDistribution__histogram), 10)
-        self.assertEqual(numpy.linalg.norm(tsd._TimeStepDistribution__histogram - numpy.zeros(10, dtype=int)), 0)
+        self.assertTrue(tsd._TimeStepDistribution__time_interval is None)
+        self.assertEqual(len(tsd.histogram()), 10)
+        self.assertEqual(numpy.linalg.norm(tsd.histogram() - numpy.zeros(10, dtype=int)), 0)
 
         # Check construction with a given binsize.
-        tsd = TimeStepDistribution(binsize=2.3)
-        self.assertAlmostEqual(tsd._TimeStepDistribution__binsize, 2.3, 12)
-        self.assertEqual(len(tsd._TimeStepDistribution__histogram), 10)
-        self.assertEqual(numpy.linalg.norm(tsd._TimeStepDistribution__histogram - numpy.zeros(10, dtype=int)), 0)
+        tsd = TimeStepDistribution(binsize=2.3, time_interval=0.5)
+        self.assertAlmostEqual(tsd._backend().binsize(), 2.3, 12)
+        self.assertAlmostEqual(tsd._TimeStepDistribution__time_interval, 0.5, 12)
+        self.assertEqual(len(tsd.histogram()), 10)
+
+        # Wrong time interval input.
+        self.assertRaises(Error, lambda: TimeStepDistribution(time_interval=1))
 
     def testSetup(self):
         """ Test the setup interface function. """
         # Construct.
         tsd = TimeStepDistribution()
 
-        # Set the time.
+        # Call setup with a time.
         time = numpy.random.rand()
-
-        # Call setup.
         tsd.setup("step", time, "configuration")
 
-        # Check that the time was saved.
-        self.assertAlmostEqual(tsd._TimeStepDistribution__last_time, time, 12)
+        # Check that the time was saved, by registering a step in bin 2.
+        tsd.registerStep("step", time + 2.5, "configuration")
+        self.assertEqual(tsd.histogram()[2], 1)
 
     def testRegisterStep(self):
         """ Test the register step interface function. """
@@ -60,9 +72,6 @@ class TimeStepDistributionTest(unittest.TestCase):
         binsize = 1.23
         tsd = TimeStepDistribution(binsize=binsize)
 
-        # Store the histogram size for reference.
-        h_size = len(tsd._TimeStepDistribution__histogram)
-
         # Set the first time and call setup.
         t0 = numpy.random.rand()
         tsd.setup("step", t0, "configuration")
@@ -75,36 +84,35 @@ class TimeStepDistributionTest(unittest.TestCase):
         b = int((t1 - t0) / binsize)
 
         # Check that this bin was incremented.
-        self.assertEqual(tsd._TimeStepDistribution__histogram[b], 1)
+        self.assertEqual(tsd.histogram()[b], 1)
         for i in range(10):
             if i != b:
-                self.assertEqual(tsd._TimeStepDistribution__histogram[i], 0)
+                self.assertEqual(tsd.histogram()[i], 0)
 
         # Give a new value that requires the histogram to be extended.
-        t2 = 10
+        t2 = 10.0
         tsd.registerStep("step", t2, "configuration")
-        t3 = 23
+        t3 = 23.0
         tsd.registerStep("step", t3, "configuration")
 
         # Check that the length has incresed to 11.
-        self.assertEqual(len(tsd._TimeStepDistribution__histogram), 11)
-        self.assertEqual(tsd._TimeStepDistribution__histogram[10], 1)
+        self.assertEqual(len(tsd.histogram()), 11)
+        self.assertEqual(tsd.histogram()[10], 1)
 
         # Increment again. This should end up with a length of 22.
-        t4 = 48
+        t4 = 48.0
         tsd.registerStep("step", t4, "configuration")
-        self.assertEqual(len(tsd._TimeStepDistribution__histogram), 22)
+        self.assertEqual(len(tsd.histogram()), 22)
 
     def testFinalizeAndQuery(self):
         """ Test the finalization and query functions. """
-        tsd = TimeStepDistribution()
+        binsize = 2.13
+        tsd = TimeStepDistribution(binsize=binsize)
 
-        # Set the member data.
-        histogram = numpy.array(numpy.random.rand(12)*34, dtype=int)
+        # Register steps giving a random histogram of 12 bins.
+        histogram = numpy.array(numpy.random.rand(12)*34, dtype=int) + 1
+        self.__registerHistogram(tsd, histogram, binsize)
         normalized_histogram = histogram / float(numpy.sum(histogram))
-        binsize = 2.13
-        tsd._TimeStepDistribution__binsize   = binsize
-        tsd._TimeStepDistribution__histogram = histogram
 
         # Call the finalize function.
         tsd.finalize()
@@ -122,20 +130,81 @@ class TimeStepDistributionTest(unittest.TestCase):
         time_steps = (numpy.arange(12)+1)*binsize - binsize/2.0
         self.assertAlmostEqual(numpy.linalg.norm(ret_time_steps - time_steps), 0.0, 12)
 
+    def testNativeRun(self):
+        """ Test that the lattice model calls the backend plugin in a run. """
+        # Setup a periodic 1D chain of A and B flipping into each other.
+        unit_cell = KMCUnitCell(cell_vectors=numpy.array([[1.0,0.0,0.0],
+                                                          [0.0,1.0,0.0],
+                                                          [0.0,0.0,1.0]]),
+                                basis_points=[[0.0,0.0,0.0]])
+
+        lattice = KMCLattice(unit_cell=unit_cell,
+                             repetitions=(10,1,1),
+                             periodic=(True,True,True))
+
+        config = KMCConfiguration(lattice=lattice,
+                                  types=["A","B"]*5,
+                                  possible_types=["A","B"])
+
+        sitesmap = KMCSitesMap(lattice=lattice,
+                               types=["a"]*10,
+                               possible_types=["a"])
+
+        p0 = KMCProcess(coordinates=[[0.0, 0.0, 0.0]],
+                        elements_before=["A"],
+                        elements_after=["B"],
+                        basis_sites=[0],
+                        rate_constant=1.0)
+
+        p1 = KMCProcess(coordinates=[[0.0, 0.0, 0.0]],
+                        elements_before=["B"],
+                        elements_after=["A"],
+                        basis_sites=[0],
+                        rate_constant=1.0)
+
+        interactions = KMCInteractions(processes=[p0, p1],
+                                       implicit_wildcards=True)
+
+        model = KMCLatticeModel(configuration=config,
+                                sitesmap=sitesmap,
+                                interactions=interactions)
+
+        # Run with one plugin at each step and one at each fourth step.
+        tsd1 = TimeStepDistribution(binsize=0.01)
+        tsd4 = TimeStepDistribution(binsize=0.01)
+
+        control_parameters = KMCControlParameters(number_of_steps=100,
+                                                  dump_interval=100,
+                                                  analysis_interval=[1, 4],
+                                                  seed=2013)
+        model.run(control_parameters=control_parameters,
+                  analysis=[tsd1, tsd4])
+
+        # Check the number of registered steps.
+        self.assertEqual(numpy.sum(tsd1.histogram()), 100)
+        self.assertEqual(numpy.sum(tsd4.histogram()), 25)
+
+    def __registerHistogram(self, tsd, histogram, binsize):
+        """ Helper to register time steps giving a histogram. """
+        # Fill the histogram from the last bin, to grow it to 12 bins.
+        time = 0.0
+        tsd.setup("step", time, "configuration")
+        for b in reversed(range(len(histogram))):
+            for i in range(histogram[b]):
+                time += (b + 0.5)*binsize
+                tsd.registerStep("step", time, "configuration")
+
     def testPrintResults(self):
         """ Test the time step distribution print result function. """
-        tsd = TimeStepDistribution()
-
-        # Set the member data.
+        binsize = 2.13
+        tsd = TimeStepDistribution(binsize=binsize)
 
+        # Register steps giving the histogram.
         histogram = numpy.array([12,41,55,
                                  23,43,12,
                                  11,19,98,
                                  97,95,93])
-        normalized_histogram = histogram / float(numpy.sum(histogram))
-        binsize = 2.13
-        tsd._TimeStepDistribution__binsize   = binsize
-        tsd._TimeStepDistribution__histogram = histogram
+        self.__registerHistogram(tsd, histogram, binsize)
 
         # Call the finalize function.
         tsd.finalize()
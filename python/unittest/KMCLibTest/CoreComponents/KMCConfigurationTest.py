@@ -420,6 +420,43 @@ class KMCConfigurationTest(unittest.TestCase):
         # Check the type of the cpp backend.
         self.assertTrue(isinstance(cpp_backend, Backend.Configuration))
 
+    def testBackendMortonOrder(self):
+        """ Make sure the types are reordered to and from a Morton ordered backend. """
+        unit_cell = KMCUnitCell(cell_vectors=numpy.eye(3),
+                                basis_points=[[0.0,0.0,0.0],
+                                              [0.5,0.5,0.5]])
+
+        lattice = KMCLattice(unit_cell=unit_cell,
+                             repetitions=(4,2,3),
+                             periodic=(True,True,False),
+                             cell_ordering="morton")
+
+        types = ['a','b','c','a','b','a','a','c']*6
+
+        config = KMCConfiguration(lattice=lattice,
+                                  types=types,
+                                  possible_types=['a','c','b'])
+
+        # The backend has the types in the Morton order.
+        site_order = lattice._siteOrder()
+        cpp_types = list(config._backend().elements())
+        self.assertEqual(cpp_types, [types[i] for i in site_order])
+
+        # The coordinates follow the types.
+        cpp_coords = config._backend().coordinates()
+        sites = lattice.sites()
+        for index in range(len(types)):
+            coordinate = cpp_coords[index]
+            site = sites[site_order[index]]
+            self.assertAlmostEqual(coordinate.x(), site[0], 10)
+            self.assertAlmostEqual(coordinate.y(), site[1], 10)
+            self.assertAlmostEqual(coordinate.z(), site[2], 10)
+
+        # The queries are in the row-major order.
+        self.assertEqual(config.types(), types)
+        self.assertEqual(list(config.atomIDTypes()), types)
+        self.assertAlmostEqual(numpy.linalg.norm(config.atomIDCoordinates() - sites), 0.0, 10)
+
     def testQueries(self):
         """ Test the configuration's query functions. """
         config = KMCConfiguration.__new__(KMCConfiguration)
@@ -97,6 +97,9 @@ class KMCControlParametersTest(unittest.TestCase):
         control_params = KMCControlParameters(rng_type='DEVICE')
         self.assertEqual(control_params.rngType(), Backend.DEVICE)
 
+        control_params = KMCControlParameters(rng_type='PHILOX')
+        self.assertEqual(control_params.rngType(), Backend.PHILOX)
+
         # Wrong value.
         self.assertRaises( Error,
                            lambda : KMCControlParameters(rng_type='ABC'))
@@ -106,6 +109,22 @@ class KMCControlParametersTest(unittest.TestCase):
                            lambda : KMCControlParameters(rng_type=123))
         # }}}
 
+    def testRandomStream(self):
+        """ Test the random stream id parameter. """
+        # {{{
+        control_params = KMCControlParameters()
+        self.assertTrue(control_params.randomStream() is None)
+
+        control_params = KMCControlParameters(random_stream=3)
+        self.assertEqual(control_params.randomStream(), 3)
+
+        # Negative value.
+        self.assertRaises(Error, KMCControlParameters, random_stream=-1)
+
+        # Wrong type.
+        self.assertRaises(Error, KMCControlParameters, random_stream=1.0)
+        # }}}
+
     def testStartTime(self):
         """ Make sure we can set start time correctly. """
         # {{{
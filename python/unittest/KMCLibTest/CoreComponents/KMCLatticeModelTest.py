@@ -729,6 +729,83 @@ class KMCLatticeModelTest(unittest.TestCase):
                           trajectory_filename=trajectory_filename)
         # }}}
 
+    def testRunCheckpointRestart(self):
+        """ Test the restart of a run from a checkpoint. """
+        # {{{
+        def setupModel():
+            unit_cell = KMCUnitCell(
+                cell_vectors=[[1.0, 0.0, 0.0], [0.0, 1.0, 0.0], [0.0, 0.0, 1.0]],
+                basis_points=[[0.0, 0.0, 0.0]])
+
+            lattice = KMCLattice(
+                unit_cell=unit_cell,
+                repetitions=(10,10,1),
+                periodic=(True, True, False))
+
+            configuration = KMCConfiguration(
+                lattice=lattice,
+                types=['B']*100,
+                possible_types=['A','B'])
+
+            sitesmap = KMCSitesMap(
+                lattice=lattice,
+                types=['b']*100,
+                possible_types=['a', 'b'])
+
+            coordinates = [[0.0, 0.0, 0.0]]
+            process_0 = KMCProcess(coordinates, ['A'], ['B'],
+                                   basis_sites=[0], rate_constant=4.0)
+            process_1 = KMCProcess(coordinates, ['B'], ['A'],
+                                   basis_sites=[0], rate_constant=1.0)
+            interactions = KMCInteractions([process_0, process_1])
+
+            return KMCLatticeModel(configuration, sitesmap, interactions), configuration
+
+        name = os.path.abspath(os.path.dirname(__file__))
+        name = os.path.join(name, "..", "TestUtilities", "Scratch")
+        checkpoint_filename = str(os.path.join(name, "ab_flip_checkpoint.bin"))
+        self.__files_to_remove.append(checkpoint_filename)
+
+        # The reference run.
+        control_parameters = KMCControlParameters(number_of_steps=1000,
+                                                  dump_interval=500,
+                                                  seed=2013)
+        ref_model, ref_configuration = setupModel()
+        ref_model.run(control_parameters)
+
+        # Run a model writing a checkpoint half way.
+        half_control_parameters = KMCControlParameters(number_of_steps=500,
+                                                       dump_interval=500,
+                                                       seed=2013)
+        model, configuration = setupModel()
+        model.run(half_control_parameters, checkpoint_filename=checkpoint_filename)
+
+        # An already run model can not be restarted.
+        self.assertRaises(Error, lambda: model.run(control_parameters,
+                                                   restart_filename=checkpoint_filename))
+
+        # Restore a new model from the checkpoint.
+        restarted_model, restarted_configuration = setupModel()
+        restarted_model._backend(0.0, checkpoint_filename)
+        self.assertEqual(restarted_configuration.types(), configuration.types())
+        self.assertEqual(restarted_model._KMCLatticeModel__cpp_timer.simulationTime(),
+                         model._KMCLatticeModel__cpp_timer.simulationTime())
+
+        # Continue the run from the checkpoint, which takes the remaining
+        # steps and ends as the reference run.
+        restarted_model, restarted_configuration = setupModel()
+        restarted_model.run(control_parameters, restart_filename=checkpoint_filename)
+        self.assertEqual(restarted_model._backend(0.0).step(), 1000)
+        self.assertEqual(restarted_configuration.types(), ref_configuration.types())
+        self.assertAlmostEqual(restarted_model._KMCLatticeModel__cpp_timer.simulationTime(),
+                               ref_model._KMCLatticeModel__cpp_timer.simulationTime(), 10)
+
+        # A checkpoint at or past the number of steps can not be continued.
+        restarted_model, restarted_configuration = setupModel()
+        self.assertRaises(Error, lambda: restarted_model.run(half_control_parameters,
+                                                             restart_filename=checkpoint_filename))
+        # }}}
+
     def testRun2WithSiteTypes(self):
         """ Test the run of an A-B flip model with site types provided. """
         # {{{
@@ -2545,6 +2622,144 @@ model = KMCLatticeModel(
                   trajectory_filename=trajectory_filename)
         # }}}
 
+    def testRunBatchedSteps(self):
+        " Make sure the steps taken in batches give the same output steps as single steps. "
+        # {{{
+        def abFlipModel(types, processes_to_use=(0, 1)):
+            # Cell.
+            cell_vectors = [[1.0, 0.0, 0.0],
+                            [0.0, 1.0, 0.0],
+                            [0.0, 0.0, 1.0]]
+
+            basis_points = [[0.0, 0.0, 0.0]]
+
+            unit_cell = KMCUnitCell(cell_vectors, basis_points)
+
+            # Lattice.
+            lattice = KMCLattice(unit_cell=unit_cell,
+                                 repetitions=(10, 10, 1),
+                                 periodic=(True, True, False))
+
+            # Configuration.
+            configuration = KMCConfiguration(lattice=lattice,
+                                             types=types,
+                                             possible_types=["A", "B"])
+
+            # Sitesmap.
+            sitesmap = KMCSitesMap(lattice=lattice,
+                                   types=["b"]*100,
+                                   possible_types=["a", "b"])
+
+            # Interactions.
+            coordinates = [[0.0, 0.0, 0.0]]
+            process_0 = KMCProcess(coordinates, ["A"], ["B"],
+                                   basis_sites=[0],
+                                   rate_constant=4.0)
+            process_1 = KMCProcess(coordinates, ["B"], ["A"],
+                                   basis_sites=[0],
+                                   rate_constant=1.0)
+
+            processes = [process_0, process_1]
+            processes = [processes[i] for i in processes_to_use]
+            interactions = KMCInteractions(processes)
+
+            return KMCLatticeModel(configuration, sitesmap, interactions)
+
+        # Analysis object recording the steps and times it is called at.
+        class StepRecorder(KMCAnalysisPlugin):
+            def __init__(self):
+                self.steps = []
+                self.times = []
+
+            def registerStep(self, step, time, configuration, interactions=None):
+                self.steps.append(step)
+                self.times.append(time)
+
+        # Run with dumps, extra trajectory frames, analysis and redistribution
+        # at different intervals.
+        name = os.path.abspath(os.path.dirname(__file__))
+        name = os.path.join(name, "..", "TestUtilities", "Scratch")
+        trajectory_filename = str(os.path.join(name, "batched_steps_traj.py"))
+        self.__files_to_remove.append(trajectory_filename)
+
+        control_parameters = KMCControlParameters(number_of_steps=100,
+                                                  dump_interval=30,
+                                                  analysis_interval=11,
+                                                  extra_traj=(40, 60, 7),
+                                                  seed=2013,
+                                                  do_redistribution=True,
+                                                  redistribution_interval=25,
+                                                  redist_dump_interval=25,
+                                                  fast_species=["A"])
+        recorder = StepRecorder()
+        model = abFlipModel(["B"]*100)
+        model.run(control_parameters,
+                  trajectory_filename=trajectory_filename,
+                  analysis=[recorder])
+
+        # The analysis is called at each multiple of its interval.
+        self.assertEqual(recorder.steps, [11, 22, 33, 44, 55, 66, 77, 88, 99])
+
+        # The frames are written at the start, at the dumps (30, 60, 90),
+        # at the extra frames (42, 49, 56) and after the redistributions
+        # (25, 50, 75).
+        with open(trajectory_filename, "r") as t:
+            steps = [int(line.strip()[len("steps.append("):-1])
+                     for line in t if line.startswith("steps.append(")]
+        self.assertEqual(steps, [0, 25, 30, 42, 49, 50, 56, 60, 75, 90])
+
+        # Stop at the time limit, in the same step with single steps as with
+        # a batch of steps.
+        time_limit = 0.2
+        control_parameters = KMCControlParameters(number_of_steps=1000,
+                                                  dump_interval=1000,
+                                                  analysis_interval=1,
+                                                  seed=2013,
+                                                  time_limit=time_limit)
+        recorder = StepRecorder()
+        single_model = abFlipModel(["B"]*100)
+        single_model.run(control_parameters, analysis=[recorder])
+
+        n_stop = recorder.steps[-1]
+        self.assertTrue(n_stop < 1000)
+        self.assertEqual(recorder.steps, list(range(1, n_stop + 1)))
+        self.assertTrue(recorder.times[-2] <= time_limit)
+        self.assertTrue(recorder.times[-1] > time_limit)
+
+        control_parameters = KMCControlParameters(number_of_steps=1000,
+                                                  dump_interval=1000,
+                                                  analysis_interval=1000,
+                                                  seed=2013,
+                                                  time_limit=time_limit)
+        recorder = StepRecorder()
+        batched_model = abFlipModel(["B"]*100)
+        batched_model.run(control_parameters, analysis=[recorder])
+
+        self.assertEqual(recorder.steps, [])
+        self.assertEqual(batched_model._KMCLatticeModel__configuration.types(),
+                         single_model._KMCLatticeModel__configuration.types())
+        self.assertEqual(batched_model._KMCLatticeModel__cpp_timer.simulationTime(),
+                         single_model._KMCLatticeModel__cpp_timer.simulationTime())
+
+        # Stop with an error when no process is available, after all
+        # A have been flipped in a single batch.
+        control_parameters = KMCControlParameters(number_of_steps=1000,
+                                                  dump_interval=1000,
+                                                  analysis_interval=[1000, 50],
+                                                  seed=2013)
+        recorder_1000 = StepRecorder()
+        recorder_50 = StepRecorder()
+        one_way_model = abFlipModel(["A"]*100, processes_to_use=(0,))
+        self.assertRaises( Error,
+                           lambda : one_way_model.run(control_parameters,
+                                                      analysis=[recorder_1000, recorder_50]) )
+
+        self.assertEqual(recorder_1000.steps, [])
+        self.assertEqual(recorder_50.steps, [50, 100])
+        self.assertEqual(one_way_model._KMCLatticeModel__configuration.types(),
+                         ["B"]*100)
+        # }}}
+
 if __name__ == '__main__':
     unittest.main()
 
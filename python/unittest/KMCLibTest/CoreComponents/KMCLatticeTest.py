@@ -401,6 +401,45 @@ class KMCLatticeTest(unittest.TestCase):
         # Check the instance.
         self.assertTrue(cpp_lattice_map == cpp_lattice_map2)
 
+    def testCellOrdering(self):
+        """ Check the Morton ordering of the cells in the lattice map. """
+        unit_cell = KMCUnitCell(cell_vectors=numpy.eye(3),
+                                basis_points=[[0.0, 0.0, 0.0],
+                                              [0.5, 0.5, 0.5]])
+
+        # The default is the row-major ordering.
+        lattice = KMCLattice(unit_cell=unit_cell,
+                             repetitions=(4, 3, 5))
+        self.assertEqual(lattice.cellOrdering(), "row_major")
+        self.assertTrue(lattice._siteOrder() is None)
+
+        # With the Morton ordering the backend sites are a permutation.
+        lattice = KMCLattice(unit_cell=unit_cell,
+                             repetitions=(4, 3, 5),
+                             cell_ordering="morton")
+        self.assertEqual(lattice.cellOrdering(), "morton")
+
+        site_order = lattice._siteOrder()
+        self.assertEqual(sorted(site_order), list(range(120)))
+        self.assertTrue((site_order != numpy.arange(120)).any())
+
+        # The basis sites of a cell stay together.
+        self.assertTrue((site_order[1::2] == site_order[0::2] + 1).all())
+
+        # The map gives the cells in the backend order.
+        cpp_lattice_map = lattice._map()
+        for index in range(0, 120, 7):
+            i, j, k, b = lattice.indexToCell(int(site_order[index]))
+            self.assertEqual(cpp_lattice_map.indicesFromCell(i, j, k)[b], index)
+
+        # The script includes the ordering.
+        self.assertTrue('cell_ordering="morton"' in lattice._script())
+
+        # Wrong input.
+        self.assertRaises(Error, lambda: KMCLattice(unit_cell=unit_cell,
+                                                    repetitions=(4, 3, 5),
+                                                    cell_ordering="hilbert"))
+
     def testIndexToCell(self):
         " Make sure we can get correct position of an index. "
         cell_vectors = [[1.0, 0.0, 0.0],
@@ -0,0 +1,92 @@
+"""" Module for testing the KMCLatticeGasRateCalculatorPlugin """
+
+
+# This file is part of the KMCLib project distributed under the terms of the
+# GNU General Public License version 3, see <http://www.gnu.org/licenses/>.
+#
+
+
+import unittest
+
+
+# Import the module to test.
+from KMCLib.PluginInterfaces.KMCLatticeGasRateCalculatorPlugin import KMCLatticeGasRateCalculatorPlugin
+from KMCLib.CoreComponents.KMCProcess import KMCProcess
+from KMCLib.Exceptions.Error import Error
+from KMCLib.Backend import Backend
+
+# Implementing the tests.
+class KMCLatticeGasRateCalculatorPluginTest(unittest.TestCase):
+    """ Class for testing the KMCLatticeGasRateCalculatorPlugin class """
+
+    def testConstruction(self):
+        """ Test that the class can be constructed and is a native calculator. """
+        calculator = KMCLatticeGasRateCalculatorPlugin()
+        self.assertTrue(isinstance(calculator, Backend.LatticeGasRateCalculator))
+        self.assertTrue(calculator.threadSafe())
+        self.assertTrue(calculator.integerTypes())
+
+    def testShellsMissing(self):
+        """ Test that the interaction shells must be given. """
+        calculator = KMCLatticeGasRateCalculatorPlugin()
+        self.assertRaises(Error, lambda: calculator._setup({"*": 0, "A": 1}))
+
+    def testSetup(self):
+        """ Test the setup of the interactions with type names. """
+        class RateCalc(KMCLatticeGasRateCalculatorPlugin):
+            def interactionShells(self):
+                return [1.0, 1.4142]
+            def pairEnergies(self):
+                return [("A", "B", 0, 0.1), ("A", "A", 1, -0.05)]
+            def tripletEnergies(self):
+                return [("A", "A", "A", 0, 1, 0, 0.02)]
+            def bepParameters(self):
+                return {0: (0.8, 0.5)}
+            def simulationTemperature(self):
+                return 450.0
+
+        calculator = RateCalc()
+        calculator._setup({"*": 0, "A": 1, "B": 2})
+        self.assertAlmostEqual(calculator.temperature(), 450.0, 10)
+
+        # Unknown type names.
+        class RateCalc2(RateCalc):
+            def pairEnergies(self):
+                return [("A", "C", 0, 0.1)]
+
+        self.assertRaises(Error, lambda: RateCalc2()._setup({"*": 0, "A": 1, "B": 2}))
+
+        # Shells out of range.
+        class RateCalc3(RateCalc):
+            def pairEnergies(self):
+                return [("A", "B", 2, 0.1)]
+
+        self.assertRaises(ValueError, lambda: RateCalc3()._setup({"*": 0, "A": 1, "B": 2}))
+
+    def testCutoff(self):
+        """ Test that the base class has the cutoff function. """
+        self.assertTrue(hasattr(KMCLatticeGasRateCalculatorPlugin, "cutoff"))
+        self.assertTrue(KMCLatticeGasRateCalculatorPlugin().cutoff() is None)
+
+    def testProcessCutoff(self):
+        """ Test the cutoff needed for the shells around the changed sites. """
+        class RateCalc(KMCLatticeGasRateCalculatorPlugin):
+            def interactionShells(self):
+                return [1.0, 1.5]
+
+        calculator = RateCalc()
+
+        # A hop to the nearest neighbour, with a wildcard further away.
+        coords = [[0.0, 0.0, 0.0], [1.0, 0.0, 0.0], [0.0, 2.0, 0.0]]
+        process = KMCProcess(coords, ["A", "B", "*"], ["B", "A", "*"],
+                             basis_sites=[0], rate_constant=1.0)
+        self.assertAlmostEqual(calculator._processCutoff(process), 2.5, 10)
+
+        # A flip of the central site, with an unchanged neighbour.
+        process = KMCProcess(coords, ["A", "B", "*"], ["B", "B", "*"],
+                             basis_sites=[0], rate_constant=1.0)
+        self.assertAlmostEqual(calculator._processCutoff(process), 1.5, 10)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,40 @@
+"""" Module for testing the KMCNativeRateCalculatorPlugin """
+
+
+# This file is part of the KMCLib project distributed under the terms of the
+# GNU General Public License version 3, see <http://www.gnu.org/licenses/>.
+#
+
+
+import unittest
+
+
+# Import the module to test.
+from KMCLib.PluginInterfaces.KMCNativeRateCalculatorPlugin import KMCNativeRateCalculatorPlugin
+from KMCLib.Exceptions.Error import Error
+from KMCLib.Backend import Backend
+
+# Implementing the tests.
+class KMCNativeRateCalculatorPluginTest(unittest.TestCase):
+    """ Class for testing the KMCNativeRateCalculatorPlugin class """
+
+    def testConstructionBaseClass(self):
+        """ Test that the base class can not be constructed without a library. """
+        self.assertRaises(Error, KMCNativeRateCalculatorPlugin)
+
+    def testConstructionMissingLibrary(self):
+        """ Test that a missing library is reported on construction. """
+        class RateCalc(KMCNativeRateCalculatorPlugin):
+            def library(self):
+                return "./no_such_rate_plugin.so"
+
+        self.assertRaises(RuntimeError, RateCalc)
+
+    def testCutoff(self):
+        """ Test that the base class has the cutoff function. """
+        self.assertTrue(hasattr(KMCNativeRateCalculatorPlugin, "cutoff"))
+        self.assertTrue(issubclass(KMCNativeRateCalculatorPlugin, Backend.NativeRateCalculator))
+
+
+if __name__ == '__main__':
+    unittest.main()
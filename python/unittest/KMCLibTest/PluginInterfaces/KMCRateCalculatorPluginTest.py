@@ -148,6 +148,49 @@ class KMCRateCalculatorPluginTest(unittest.TestCase):
         # Check the reference coordinate.
         self.assertAlmostEqual( numpy.linalg.norm( global_xyz - numpy.array(ref_coordinates)), 0.0, 10 )
 
+    def testBatchRates(self):
+        """ Test the batched rate callback. """
+        # The base class has no batched rates.
+        calculator = KMCRateCalculatorPlugin()
+        self.assertFalse( calculator.batchCallback() )
+
+        # Define a derrived class vectorising the rates.
+        class RateCalc(KMCRateCalculatorPlugin):
+            def rates(self, coords, lengths, types_before, types_after,
+                      rate_constants, process_numbers, global_coordinates):
+                self.data = (coords, lengths, types_before, types_after,
+                             rate_constants, process_numbers, global_coordinates)
+                ends = numpy.cumsum(lengths)
+                changed = (types_before != types_after).astype(int)
+                n_changed = numpy.add.reduceat(changed, ends - lengths)
+                return rate_constants * (1.0 + n_changed) + global_coordinates[:,0]
+
+        calculator = RateCalc()
+        self.assertTrue( calculator.batchCallback() )
+
+        # Two tasks, with two and one sites.
+        rates = calculator.backendBatchRateCallback((0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0, 0.0),
+                                                    (2, 1),
+                                                    (1, 2, 1),
+                                                    (2, 2, 1),
+                                                    (1.5, 3.0),
+                                                    (4, 7),
+                                                    (0.5, 0.0, 0.0, 2.0, 1.0, 1.0))
+
+        # Check the returned rates.
+        self.assertTrue( isinstance(rates, list) )
+        self.assertAlmostEqual( rates[0], 1.5*2.0 + 0.5, 12 )
+        self.assertAlmostEqual( rates[1], 3.0 + 2.0, 12 )
+
+        # Check the arrays passed on.
+        (coords, lengths, types_before, types_after,
+         rate_constants, process_numbers, global_coordinates) = calculator.data
+        self.assertEqual( coords.shape, (3,3) )
+        self.assertEqual( global_coordinates.shape, (2,3) )
+        self.assertEqual( list(lengths), [2, 1] )
+        self.assertEqual( list(types_before), [1, 2, 1] )
+        self.assertEqual( list(process_numbers), [4, 7] )
+
 
 if __name__ == '__main__':
     unittest.main()
@@ -11,11 +11,15 @@ import unittest
 
 from .KMCAnalysisPluginTest import KMCAnalysisPluginTest
 from .KMCRateCalculatorPluginTest import KMCRateCalculatorPluginTest
+from .KMCNativeRateCalculatorPluginTest import KMCNativeRateCalculatorPluginTest
+from .KMCLatticeGasRateCalculatorPluginTest import KMCLatticeGasRateCalculatorPluginTest
 
 def suite():
     suite = unittest.TestSuite(
         [unittest.TestLoader().loadTestsFromTestCase(KMCAnalysisPluginTest),
          unittest.TestLoader().loadTestsFromTestCase(KMCRateCalculatorPluginTest),
+         unittest.TestLoader().loadTestsFromTestCase(KMCNativeRateCalculatorPluginTest),
+         unittest.TestLoader().loadTestsFromTestCase(KMCLatticeGasRateCalculatorPluginTest),
          ])
     return suite
 